@@ -0,0 +1,203 @@
+#include <limits.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "access/heap_file.h"
+#include "access/relationship.h"
+#include "order/icbl.h"
+
+static const size_t n_nodes       = 2000;
+static const size_t n_rels        = 16000;
+static const size_t n_rounds      = 10;
+static const size_t n_churn       = 1000;
+static const size_t n_sampled     = 500;
+static const size_t s_to_mus      = 1000000;
+static const size_t ns_to_mus     = 1000;
+static const size_t buf_sz        = 81920;
+static const char*  mode_names[2] = { "append", "id order" };
+
+heap_file*
+prepare(void)
+{
+    char* file_name = "bench";
+
+    char* log_name_phf   = "log_bench_pdb";
+    char* log_name_cache = "log_bench_pc";
+    char* log_name_file  = "log_bench_hf";
+
+    phy_database* pdb = phy_database_create(file_name, log_name_phf);
+
+    page_cache* pc = page_cache_create(pdb, buf_sz / PAGE_SIZE, log_name_cache);
+
+    heap_file* hf = heap_file_create(pc, log_name_file);
+
+    return hf;
+}
+
+void
+clean_up(heap_file* hf)
+{
+    page_cache*   pc  = hf->cache;
+    phy_database* pdb = pc->pdb;
+    heap_file_destroy(hf);
+    page_cache_destroy(pc);
+    phy_database_delete(pdb);
+}
+
+static unsigned long
+next_random(unsigned long* state)
+{
+    *state = *state * 6364136223846793005UL + 1442695040888963407UL;
+    return *state >> 33;
+}
+
+static int
+page_cmp(const void* a, const void* b)
+{
+    unsigned long fst = *(const unsigned long*)a;
+    unsigned long snd = *(const unsigned long*)b;
+
+    return (fst > snd) - (fst < snd);
+}
+
+/* An expand pins the relationship page again whenever the incidence list
+ * moves on to another page, so the page touches are the page changes along
+ * the list. A list that is sorted by id touches each of its pages once, the
+ * touches beyond that are due to the order of the list. */
+static void
+page_touches(heap_file* hf, double* touches, double* excess)
+{
+    array_list_relationship* rels;
+    unsigned long*           pages;
+    size_t                   n;
+    unsigned long            n_touches = 0;
+    unsigned long            n_pages   = 0;
+
+    for (size_t i = 0; i < n_sampled; ++i) {
+        rels  = expand(hf, i * (n_nodes / n_sampled), BOTH, false);
+        n     = array_list_relationship_size(rels);
+        pages = malloc((n + 1) * sizeof(unsigned long));
+
+        for (size_t j = 0; j < n; ++j) {
+            pages[j] = array_list_relationship_get(rels, j)->id >> CHAR_BIT;
+            n_touches += j == 0 || pages[j] != pages[j - 1];
+        }
+        array_list_relationship_destroy(rels);
+
+        qsort(pages, n, sizeof(unsigned long), page_cmp);
+        for (size_t j = 0; j < n; ++j) {
+            n_pages += j == 0 || pages[j] != pages[j - 1];
+        }
+        free(pages);
+    }
+
+    *touches = (double)n_touches / (double)n_sampled;
+    *excess  = (double)(n_touches - n_pages) / (double)n_sampled;
+}
+
+static void
+print_touches(heap_file* hf, insertion_mode mode, size_t round)
+{
+    double touches;
+    double excess;
+
+    page_touches(hf, &touches, &excess);
+    printf("%s insertion: round %lu %f pages per expand, %f more than the "
+           "pages of the list\n",
+           mode_names[mode],
+           round,
+           touches,
+           excess);
+}
+
+/* Starts from the incidence-clustered layout, in which the incidence lists
+ * run through few pages, and replaces random relationships round by round.
+ * The deletes of a round free slots all over the file, which the following
+ * creates reuse, so that new relationships do not have the largest ids. Only
+ * the creates are timed. */
+void
+bench_insertion(insertion_mode mode)
+{
+    struct timespec start;
+    struct timespec end;
+    unsigned long   total = 0;
+    unsigned long   state = 1;
+    size_t          victim;
+
+    heap_file* hf     = prepare();
+    hf->rel_insertion = mode;
+
+    for (size_t i = 0; i < n_nodes; ++i) {
+        create_node(hf, i, false);
+    }
+
+    unsigned long* rel_ids = malloc(n_rels * sizeof(unsigned long));
+    size_t*        victims = malloc(n_churn * sizeof(size_t));
+    for (size_t i = 0; i < n_rels; ++i) {
+        rel_ids[i] = create_relationship(hf,
+                                         next_random(&state) % n_nodes,
+                                         next_random(&state) % n_nodes,
+                                         1.0,
+                                         0,
+                                         false);
+    }
+    icbl_layout(hf, false);
+
+    // The layout moved the relationships
+    array_list_relationship* rels = get_relationships(hf, false);
+    for (size_t i = 0; i < n_rels; ++i) {
+        rel_ids[i] = array_list_relationship_get(rels, i)->id;
+    }
+    array_list_relationship_destroy(rels);
+
+    print_touches(hf, mode, 0);
+
+    for (size_t r = 1; r <= n_rounds; ++r) {
+        for (size_t i = 0; i < n_churn; ++i) {
+            victims[i] = next_random(&state) % n_rels;
+            if (rel_ids[victims[i]] != UNINITIALIZED_LONG) {
+                delete_relationship(hf, rel_ids[victims[i]], false);
+                rel_ids[victims[i]] = UNINITIALIZED_LONG;
+            }
+        }
+
+        for (size_t i = 0; i < n_churn; ++i) {
+            victim = victims[i];
+            if (rel_ids[victim] != UNINITIALIZED_LONG) {
+                continue;
+            }
+
+            timespec_get(&start, TIME_UTC);
+
+            rel_ids[victim] = create_relationship(hf,
+                                                  next_random(&state) % n_nodes,
+                                                  next_random(&state) % n_nodes,
+                                                  1.0,
+                                                  0,
+                                                  false);
+
+            timespec_get(&end, TIME_UTC);
+            total += ((end.tv_sec * s_to_mus + end.tv_nsec / ns_to_mus)
+                      - (start.tv_sec * s_to_mus + start.tv_nsec / ns_to_mus));
+        }
+
+        print_touches(hf, mode, r);
+    }
+
+    printf("%s insertion: Average create call takes %f mu s\n",
+           mode_names[mode],
+           (float)total / (float)(n_rounds * n_churn));
+
+    free(rel_ids);
+    free(victims);
+    clean_up(hf);
+}
+
+int
+main(void)
+{
+    bench_insertion(APPEND_INSERT);
+    bench_insertion(ID_ORDER_INSERT);
+
+    return 0;
+}
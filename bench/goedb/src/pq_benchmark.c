@@ -0,0 +1,234 @@
+#include <stdlib.h>
+#include <time.h>
+
+#include "access/heap_file.h"
+#include "data-struct/priority_queue.h"
+#include "query/a-star.h"
+#include "query/alt.h"
+#include "query/bidirectional.h"
+#include "query/dijkstra.h"
+#include "query/result_types.h"
+#include "query/snap_importer.h"
+
+static const size_t n_sources     = 10;
+static const size_t n_landmarks   = 8;
+static const size_t n_heap_values = 1000000;
+static const size_t s_to_mus      = 1000000;
+static const size_t ns_to_mus     = 1000;
+static const size_t buf_sz        = 81920;
+
+typedef enum
+{
+    A_STAR_SEARCH,
+    ALT_SEARCH,
+    DIJKSTRA_P2P_SEARCH,
+    ALT_BIDIRECTIONAL_SEARCH,
+    N_SEARCHES
+} p2p_search;
+
+static const char* search_names[N_SEARCHES] = { "A*",
+                                                "ALT",
+                                                "Bidirectional Dijkstra",
+                                                "Bidirectional ALT" };
+
+heap_file*
+prepare(void)
+{
+    char* file_name = "bench";
+
+    char* log_name_phf   = "log_bench_pdb";
+    char* log_name_cache = "log_bench_pc";
+    char* log_name_file  = "log_bench_hf";
+
+    phy_database* pdb = phy_database_create(file_name, log_name_phf);
+
+    page_cache* pc = page_cache_create(pdb, buf_sz / PAGE_SIZE, log_name_cache);
+
+    heap_file* hf = heap_file_create(pc, log_name_file);
+
+    return hf;
+}
+
+void
+clean_up(heap_file* hf)
+{
+    page_cache*   pc  = hf->cache;
+    phy_database* pdb = pc->pdb;
+    heap_file_destroy(hf);
+    page_cache_destroy(pc);
+    phy_database_delete(pdb);
+}
+
+/* Runs a Dijkstra-like sequence of operations on the heap alone: after every
+ * extract a few values are pushed or decreased with keys that are not
+ * smaller than the extracted one. */
+void
+bench_heap_ops(pq_type type)
+{
+    struct timespec start;
+    struct timespec end;
+    unsigned long   total;
+    unsigned long   state = 1;
+    double          key;
+
+    priority_queue* pq = priority_queue_create(type);
+
+    timespec_get(&start, TIME_UTC);
+
+    priority_queue_push(pq, 0, 0);
+    for (size_t i = 0; i < n_heap_values && priority_queue_size(pq) > 0;
+         ++i) {
+        priority_queue_extract_min(pq, &key);
+
+        for (size_t j = 0; j < 4; ++j) {
+            state = state * 6364136223846793005UL + 1442695040888963407UL;
+            priority_queue_push(pq,
+                                key + (double)((state >> 33) % 1000),
+                                (state >> 17) % n_heap_values);
+        }
+    }
+
+    timespec_get(&end, TIME_UTC);
+    total = ((end.tv_sec * s_to_mus + end.tv_nsec / ns_to_mus)
+             - (start.tv_sec * s_to_mus + start.tv_nsec / ns_to_mus));
+
+    priority_queue_destroy(pq);
+
+    printf("%s heap: %lu extract min and %lu push operations took %f mu s per "
+           "operation\n",
+           priority_queue_type_name(type),
+           n_heap_values,
+           4 * n_heap_values,
+           (float)total / (float)(5 * n_heap_values));
+}
+
+void
+bench_dijkstra(heap_file* hf, pq_type type)
+{
+    struct timespec start;
+    struct timespec end;
+    unsigned long   total = 0;
+    sssp_result*    result;
+
+    array_list_node* nodes = get_nodes(hf, false);
+
+    srand(0);
+    for (size_t i = 0; i < n_sources; ++i) {
+        unsigned long source =
+              array_list_node_get(nodes, rand() % hf->n_nodes)->id;
+
+        timespec_get(&start, TIME_UTC);
+
+        result = dijkstra_pq(hf, source, BOTH, type, false, NULL);
+
+        timespec_get(&end, TIME_UTC);
+        total += ((end.tv_sec * s_to_mus + end.tv_nsec / ns_to_mus)
+                  - (start.tv_sec * s_to_mus + start.tv_nsec / ns_to_mus));
+
+        sssp_result_destroy(result);
+    }
+    array_list_node_destroy(nodes);
+
+    printf("Dijkstra with a %s heap: Average call takes %f mu s\n",
+           priority_queue_type_name(type),
+           (float)total / (float)n_sources);
+}
+
+/* Runs the point-to-point searches on the same random pairs for each heap.
+ * The bidirectional searches with potentials may not use the radix heap. */
+void
+bench_p2p(heap_file* hf, alt_landmarks* landmarks, pq_type type)
+{
+    struct timespec start;
+    struct timespec end;
+    unsigned long   total;
+    unsigned long   source;
+    unsigned long   target;
+    path*           result = NULL;
+
+    array_list_node* nodes = get_nodes(hf, false);
+
+    for (p2p_search search = A_STAR_SEARCH; search < N_SEARCHES; ++search) {
+        if (search == ALT_BIDIRECTIONAL_SEARCH && type == radix_pq) {
+            continue;
+        }
+
+        total = 0;
+        srand(0);
+        for (size_t i = 0; i < n_sources; ++i) {
+            source = array_list_node_get(nodes, rand() % hf->n_nodes)->id;
+            target = array_list_node_get(nodes, rand() % hf->n_nodes)->id;
+
+            timespec_get(&start, TIME_UTC);
+
+            switch (search) {
+                case A_STAR_SEARCH:
+                    result = a_star_pq(hf,
+                                       NULL,
+                                       NULL,
+                                       source,
+                                       target,
+                                       BOTH,
+                                       type,
+                                       false,
+                                       NULL);
+                    break;
+                case ALT_SEARCH:
+                    result = alt_pq(
+                          hf, landmarks, source, target, type, false, NULL);
+                    break;
+                case DIJKSTRA_P2P_SEARCH:
+                    result = dijkstra_p2p_pq(
+                          hf, source, target, BOTH, type, false, NULL);
+                    break;
+                case ALT_BIDIRECTIONAL_SEARCH:
+                    result = alt_bidirectional_pq(
+                          hf, landmarks, source, target, type, false, NULL);
+                    break;
+                default:
+                    break;
+            }
+
+            timespec_get(&end, TIME_UTC);
+            total += ((end.tv_sec * s_to_mus + end.tv_nsec / ns_to_mus)
+                      - (start.tv_sec * s_to_mus + start.tv_nsec / ns_to_mus));
+
+            path_destroy(result);
+        }
+
+        printf("%s with a %s heap: Average call takes %f mu s\n",
+               search_names[search],
+               priority_queue_type_name(type),
+               (float)total / (float)n_sources);
+    }
+    array_list_node_destroy(nodes);
+}
+
+int
+main(int argc, char** argv)
+{
+    dataset_t data = argc > 1 ? (dataset_t)strtol(argv[1], NULL, 10) : DBLP;
+
+    for (pq_type type = fibonacci_pq; type < invalid_pq; ++type) {
+        bench_heap_ops(type);
+    }
+
+    heap_file* hf = prepare();
+    import(hf, true, data);
+
+    for (pq_type type = fibonacci_pq; type < invalid_pq; ++type) {
+        bench_dijkstra(hf, type);
+    }
+
+    alt_landmarks* landmarks =
+          alt_preprocess(hf, BOTH, n_landmarks, alt_avoid, false, NULL);
+
+    for (pq_type type = fibonacci_pq; type < invalid_pq; ++type) {
+        bench_p2p(hf, landmarks, type);
+    }
+
+    alt_landmarks_destroy(landmarks);
+    clean_up(hf);
+
+    return 0;
+}
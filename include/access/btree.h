@@ -0,0 +1,139 @@
+/*!
+ * \file btree.h
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief A persistent B+-tree from unsigned long keys to unsigned long
+ * values, stored in a header-less record file and accessed through the page
+ * cache.
+ *
+ * Page 0 of the file holds the root page number, the height and the number of
+ * entries. Every other page is a node starting with a header of three ulongs:
+ * a leaf flag, the number of keys and the page of the right sibling on the
+ * same level, 0 for the rightmost node. Leaves store their keys followed by
+ * the values, inner nodes their separator keys followed by one more child page
+ * than keys. The keys of child i + 1 are at least separator i.
+ *
+ * Inserts split full nodes on the way down, so that a split never propagates
+ * back up. Each operation thus descends once from the root, pinning the child
+ * before releasing its parent and holding at most two nodes at a time, as
+ * required for latch crabbing. Together with the sibling links that allow
+ * moving right after a concurrent split, this keeps the protocol open for
+ * latches on the pages without changing the layout.
+ *
+ * Removing a key does not merge nodes. Leaves may become empty and are skipped
+ * by scans, which is cheap for the insert-mostly indexes on top of the tree.
+ * Rebuilding with \ref btree_bulk_load compacts the tree.
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#ifndef BTREE_H
+#define BTREE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "constants.h"
+#include "page_cache.h"
+#include "physical_database.h"
+
+#define BTREE_NODE_HEADER_SIZE (3 * sizeof(unsigned long))
+#define BTREE_LEAF_CAPACITY                                                    \
+    ((PAGE_SIZE - BTREE_NODE_HEADER_SIZE) / (2 * sizeof(unsigned long)))
+#define BTREE_INNER_CAPACITY                                                   \
+    ((PAGE_SIZE - BTREE_NODE_HEADER_SIZE - sizeof(unsigned long))             \
+     / (2 * sizeof(unsigned long)))
+
+/* Bulk loading leaves room in each node, so that the first inserts into a
+ * freshly loaded tree do not split every node they touch. */
+static const float BTREE_BULK_LOAD_FILL = 0.9F;
+
+/*!
+ * A range scan over a B+-tree. The iterator remembers its position as page
+ * number and index and pins the leaf only while reading from it.
+ */
+typedef struct
+{
+    page_cache*   pc;
+    file_type     ft;
+    unsigned long page_no;
+    size_t        pos;
+    unsigned long high;
+    bool          log;
+} btree_iterator;
+
+/*!
+ * Maps \p key to \p value in the tree stored in the file of type \p ft,
+ * replacing the previous value if the key is present.
+ */
+void
+btree_insert(page_cache*   pc,
+             file_type     ft,
+             unsigned long key,
+             unsigned long value,
+             bool          log);
+
+/*!
+ * Removes \p key from the tree. Returns false if it is not present.
+ */
+bool
+btree_remove(page_cache* pc, file_type ft, unsigned long key, bool log);
+
+/*!
+ * Returns the value of \p key or UNINITIALIZED_LONG if it is not present.
+ */
+unsigned long
+btree_find(page_cache* pc, file_type ft, unsigned long key, bool log);
+
+/*!
+ * Builds the tree bottom up from \p n_entries pairs with strictly increasing
+ * keys, filling each node up to \ref BTREE_BULK_LOAD_FILL. The tree must be
+ * empty and not have been written to before.
+ */
+void
+btree_bulk_load(page_cache*          pc,
+                file_type            ft,
+                const unsigned long* keys,
+                const unsigned long* values,
+                size_t               n_entries,
+                bool                 log);
+
+/*!
+ * Returns the number of entries in the tree.
+ */
+unsigned long
+btree_size(page_cache* pc, file_type ft, bool log);
+
+/*!
+ * Returns the number of levels of the tree, 0 for a tree without nodes.
+ */
+unsigned long
+btree_height(page_cache* pc, file_type ft, bool log);
+
+/*!
+ * Starts a scan over the entries with keys in [\p low, \p high] in ascending
+ * order of the keys.
+ */
+btree_iterator*
+btree_range(page_cache*   pc,
+            file_type     ft,
+            unsigned long low,
+            unsigned long high,
+            bool          log);
+
+/*!
+ * Advances the scan. Returns false once the range is exhausted and stores the
+ * next entry in \p key and \p value otherwise.
+ */
+bool
+btree_iterator_next(btree_iterator* it,
+                    unsigned long*  key,
+                    unsigned long*  value);
+
+void
+btree_iterator_destroy(btree_iterator* it);
+
+#endif
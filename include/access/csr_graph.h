@@ -0,0 +1,78 @@
+/*!
+ * \file csr_graph.h
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief A read-only snapshot of a heap file in compressed sparse row format.
+ * The page cache is not thread-safe, so algorithms that work on the whole
+ * graph in parallel read it once into this structure and run on the arrays.
+ * Nodes are addressed by a dense index in [0, n_nodes) in the order of their
+ * ids. The outgoing and incoming adjacency of every node is stored
+ * separately and sorted by the neighbour's dense index. A self-loop occurs
+ * once in both lists.
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "access/heap_file.h"
+#include "access/relationship.h"
+
+typedef struct
+{
+    unsigned long neighbour;
+    unsigned long rel_id;
+    double        weight;
+} csr_edge;
+
+typedef struct
+{
+    unsigned long n_nodes;
+    unsigned long n_rels;
+    /* node id and label per dense index */
+    unsigned long* node_ids;
+    unsigned long* node_labels;
+    /* dense index per node id / NUM_SLOTS_PER_NODE, UNINITIALIZED_LONG for
+     * free slots */
+    unsigned long* index_of;
+    unsigned long  index_bound;
+    /* adjacency per direction, indexed by OUTGOING and INCOMING. The edges of
+     * node i are edges[d][offsets[d][i]] to edges[d][offsets[d][i + 1] - 1] */
+    unsigned long* offsets[2];
+    csr_edge*      edges[2];
+} csr_graph;
+
+/*!
+ * Reads all nodes and relationships of the heap file into a new snapshot.
+ * Updates to the heap file are not reflected in the snapshot.
+ */
+csr_graph*
+csr_graph_create(heap_file* hf, bool log);
+
+void
+csr_graph_destroy(csr_graph* graph);
+
+/*!
+ * Returns the dense index of the node with the given id or
+ * UNINITIALIZED_LONG if the snapshot does not contain it.
+ */
+unsigned long
+csr_graph_index(const csr_graph* graph, unsigned long node_id);
+
+/*!
+ * Returns the number of outgoing or incoming edges of the node with the given
+ * dense index. BOTH sums up both.
+ */
+unsigned long
+csr_graph_degree(const csr_graph* graph,
+                 unsigned long    node_idx,
+                 direction_t      direction);
+
+#endif
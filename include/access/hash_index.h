@@ -0,0 +1,90 @@
+/*!
+ * \file hash_index.h
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief A persistent hash index from pairs of keys to values, stored in a
+ * header-less record file.
+ *
+ * The index is an open addressing hash table with linear probing. Each entry
+ * holds both keys and a value, so that a pair of keys may map to several
+ * values, e.g. parallel relationships in the adjacency index, see
+ * \ref adjacency_ft. Removing an entry shifts the following entries of the
+ * probe sequence back instead of leaving tombstones.
+ *
+ * The first entry of the file is not part of the table but holds its capacity
+ * and the number of entries. The table is rebuilt with twice the number of
+ * pages when it becomes half full.
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#ifndef HASH_INDEX_H
+#define HASH_INDEX_H
+
+#include <stdbool.h>
+
+#include "constants.h"
+#include "page_cache.h"
+#include "physical_database.h"
+
+#define ON_DISK_HASH_ENTRY_SIZE (3 * sizeof(unsigned long))
+#define HASH_ENTRIES_PER_PAGE   (PAGE_SIZE / ON_DISK_HASH_ENTRY_SIZE)
+
+/*!
+ * Adds an entry mapping the pair of keys to \p value to the index stored in
+ * the file of type \p ft.
+ */
+void
+hash_index_insert(page_cache*   pc,
+                  file_type     ft,
+                  unsigned long fst_key,
+                  unsigned long snd_key,
+                  unsigned long value,
+                  bool          log);
+
+/*!
+ * Removes the entry mapping the pair of keys to \p value. Fails if there is
+ * none.
+ */
+void
+hash_index_remove(page_cache*   pc,
+                  file_type     ft,
+                  unsigned long fst_key,
+                  unsigned long snd_key,
+                  unsigned long value,
+                  bool          log);
+
+/*!
+ * Returns a value the pair of keys maps to or UNINITIALIZED_LONG if there is
+ * none.
+ */
+unsigned long
+hash_index_find(page_cache*   pc,
+                file_type     ft,
+                unsigned long fst_key,
+                unsigned long snd_key,
+                bool          log);
+
+/*!
+ * Returns the number of entries in the index.
+ */
+unsigned long
+hash_index_size(page_cache* pc, file_type ft, bool log);
+
+/*!
+ * Returns the slot at which the probe sequence of the pair of keys starts in
+ * a table with the given capacity, for bulk loads that write the file
+ * themselves. Entry k + 1 of the file holds slot k as the two keys and the
+ * value plus one, zero marking an empty slot. Entry 0 holds the capacity and
+ * the number of entries. An entry belongs to the first empty slot from its
+ * home slot on.
+ */
+unsigned long
+hash_index_home_slot(unsigned long fst_key,
+                     unsigned long snd_key,
+                     unsigned long capacity);
+
+#endif
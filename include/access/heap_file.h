@@ -15,23 +15,72 @@
 
 #include <stdio.h>
 
+#include "data-struct/set.h"
 #include "node.h"
 #include "page_cache.h"
 #include "physical_database.h"
 #include "relationship.h"
 
+/*!
+ * The number of nodes with each degree for one direction. The counts are
+ * maintained together with the degree file, so that aggregates over all nodes
+ * need no page accesses.
+ */
 typedef struct
 {
-    page_cache*   cache;
-    unsigned long n_nodes;
-    unsigned long n_rels;
-    unsigned long last_alloc_node_id;
-    unsigned long last_alloc_rel_id;
-    unsigned long num_reads_nodes;
-    unsigned long num_updates_nodes;
-    unsigned long num_reads_rels;
-    unsigned long num_update_rels;
-    FILE*         log_file;
+    unsigned long* counts;
+    size_t         capacity;
+    unsigned long  min;
+    unsigned long  max;
+} degree_histogram;
+
+/*!
+ * Called with each node or relationship that is read from the heap file, e.g.
+ * to sample the accesses of the queries, see \ref draw.h.
+ */
+typedef void (*record_access_hook)(void*         context,
+                                   bool          node,
+                                   unsigned long id);
+
+/*!
+ * Where \ref create_relationship links a new relationship into the incidence
+ * lists of its end points. Freed slots are reused, so new relationships do not
+ * necessarily have the largest id.
+ */
+typedef enum
+{
+    /* At the end of the list or of the run of its group */
+    APPEND_INSERT,
+    /* Before the first relationship with a larger id, which keeps sorted lists
+     * in the order of the pages at the cost of following the list. The new
+     * relationship takes a free slot on the page that the list of its source
+     * or target starts on if there is one, so that the lists gain fewer
+     * pages. */
+    ID_ORDER_INSERT
+} insertion_mode;
+
+typedef struct
+{
+    page_cache*        cache;
+    unsigned long      n_nodes;
+    unsigned long      n_rels;
+    unsigned long      last_alloc_node_id;
+    unsigned long      last_alloc_rel_id;
+    unsigned long      num_reads_nodes;
+    unsigned long      num_updates_nodes;
+    unsigned long      num_reads_rels;
+    unsigned long      num_update_rels;
+    /* Indexed by direction_t */
+    degree_histogram   degree_hist[BOTH + 1];
+    unsigned long      n_self_loops;
+    /* Nodes whose incidence lists may no longer be sorted by id, kept in
+     * memory only, see \ref sort_incidence_list_incremental */
+    set_ul*            unsorted_nodes;
+    insertion_mode     rel_insertion;
+    /* NULL if no one observes the reads */
+    record_access_hook access_hook;
+    void*              access_context;
+    FILE*              log_file;
 } heap_file;
 
 heap_file*
@@ -66,15 +115,92 @@ read_relationship(heap_file* hf, unsigned long rel_id, bool log);
 void
 update_node(heap_file* hf, node_t* node_to_write, bool log);
 
+/*!
+ * Writes the relationship. If its label, source or target changed, it leaves
+ * the incidence lists, groups and indexes of the stored version and is
+ * inserted like a new relationship with the same id, which sets its chain
+ * pointers. Otherwise the record is written as given.
+ */
 void
 update_relationship(heap_file* hf, relationship_t* rel_to_write, bool log);
 
+/*!
+ * Writes the record as given, without touching the incidence lists, groups or
+ * indexes. Used when moving records, where the caller keeps them consistent.
+ */
+void
+write_relationship_record(heap_file*      hf,
+                          relationship_t* rel_to_write,
+                          bool            log);
+
 void
 delete_node(heap_file* hf, unsigned long node_id, bool log);
 
 void
 delete_relationship(heap_file* hf, unsigned long rel_id, bool log);
 
+/*!
+ * Returns the number of relationships of a node in the given direction from
+ * the degree file. Like in \ref expand, a self loop is counted once for BOTH.
+ */
+unsigned long
+node_degree(heap_file*    hf,
+            unsigned long node_id,
+            direction_t   direction,
+            bool          log);
+
+/*!
+ * Exchanges the degree entries of two node slots. Used when moving nodes.
+ */
+void
+swap_node_degrees(heap_file*    hf,
+                  unsigned long fst,
+                  unsigned long snd,
+                  bool          log);
+
+/*!
+ * Replaces the first or last relationship of the groups of a dense node, if it
+ * is one of the two, by the other one. Used when moving relationships.
+ */
+void
+swap_group_relationships(heap_file*    hf,
+                         unsigned long node_id,
+                         unsigned long fst,
+                         unsigned long snd,
+                         bool          log);
+
+/*!
+ * Links the incidence list of a node in the given order. The ids must be the
+ * relationships of the node, each once. For dense nodes, the relationships are
+ * grouped by label and direction, keeping the given order within each group,
+ * see \ref relationship_group.h.
+ */
+void
+relink_incidence_list(heap_file*           hf,
+                      unsigned long        node_id,
+                      const unsigned long* rel_ids,
+                      size_t               num_rels,
+                      bool                 log);
+
+/*!
+ * Links the incidence lists of several nodes, each as \ref
+ * relink_incidence_list does. The list of node_ids[i] consists of
+ * rel_ids[offsets[i]] to rel_ids[offsets[i + 1] - 1].
+ *
+ * Instead of rewriting a relationship once per endpoint, the pointer updates
+ * of all lists are sorted by relationship id and applied in a single pass over
+ * the relationship pages, which pins each page once and writes each
+ * relationship once, followed by a pass over the node pages. Dense nodes are
+ * relinked one by one, as their groups are built anew.
+ */
+void
+relink_incidence_lists(heap_file*           hf,
+                       size_t               n_nodes,
+                       const unsigned long* node_ids,
+                       const unsigned long* offsets,
+                       const unsigned long* rel_ids,
+                       bool                 log);
+
 array_list_node*
 get_nodes(heap_file* hf, bool log);
 
@@ -91,6 +217,17 @@ next_relationship_id(heap_file*      hf,
 array_list_relationship*
 expand(heap_file* hf, unsigned long node_id, direction_t direction, bool log);
 
+/*!
+ * Returns the relationships of a node with the given label and direction.
+ * Dense nodes read only the relationships of the matching groups.
+ */
+array_list_relationship*
+expand_with_label(heap_file*    hf,
+                  unsigned long node_id,
+                  direction_t   direction,
+                  unsigned long label,
+                  bool          log);
+
 relationship_t*
 contains_relationship_from_to(heap_file*    hf,
                               unsigned long node_from,
@@ -98,12 +235,27 @@ contains_relationship_from_to(heap_file*    hf,
                               direction_t   direction,
                               bool          log);
 
+/*!
+ * Returns the first relationship with the given label from the label index,
+ * see \ref label_index.h. Fails if there is none.
+ */
 relationship_t*
 find_relationships(heap_file* hf, unsigned long label, bool log);
 
+/*!
+ * Returns the first node with the given label from the label index, see
+ * \ref label_index.h. Fails if there is none.
+ */
 node_t*
 find_node(heap_file* hf, unsigned long label, bool log);
 
+/*!
+ * Returns all nodes with the given label, starting with the one that
+ * \ref find_node returns.
+ */
+array_list_node*
+find_nodes_by_label(heap_file* hf, unsigned long label, bool log);
+
 void
 heap_file_swap_log_file(heap_file* hf, const char* log_file_path);
 
@@ -0,0 +1,98 @@
+/*!
+ * \file label_index.h
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief A persistent index from labels to the nodes or relationships
+ * carrying them.
+ *
+ * The records with the same label are linked in a circular doubly linked
+ * chain. Each node or relationship slot has an entry in the chain file of its
+ * record type, see \ref node_label_ft and \ref relationship_label_ft, holding
+ * whether the record is indexed, its label and the previous and next record in
+ * the chain. The hash index in the file of type \ref label_ft maps the record
+ * type and the label to the head of the chain, see \ref hash_index.h.
+ *
+ * Records are appended at the tail of their chain, so that the head is the
+ * oldest record with a label that has not been moved or relabelled since.
+ * Chain files grow lazily, entries beyond their end are not indexed.
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#ifndef LABEL_INDEX_H
+#define LABEL_INDEX_H
+
+#include <stdbool.h>
+
+#include "constants.h"
+#include "data-struct/array_list.h"
+#include "page_cache.h"
+#include "physical_database.h"
+
+#define ON_DISK_LABEL_ENTRY_SIZE (4 * sizeof(unsigned long))
+#define LABEL_ENTRIES_PER_PAGE   (PAGE_SIZE / ON_DISK_LABEL_ENTRY_SIZE)
+
+/*!
+ * Adds the record with the given id and label to the index. \p ft is the
+ * record type, i.e. \ref node_ft or \ref relationship_ft. Fails if the record
+ * is already indexed.
+ */
+void
+label_index_insert(page_cache*   pc,
+                   file_type     ft,
+                   unsigned long id,
+                   unsigned long label,
+                   bool          log);
+
+/*!
+ * Removes the record with the given id from the index. Fails if it is not
+ * indexed.
+ */
+void
+label_index_remove(page_cache* pc, file_type ft, unsigned long id, bool log);
+
+/*!
+ * Moves an indexed record to the chain of \p label if its label changed.
+ * Records that are not indexed are left alone.
+ */
+void
+label_index_update(page_cache*   pc,
+                   file_type     ft,
+                   unsigned long id,
+                   unsigned long label,
+                   bool          log);
+
+/*!
+ * Exchanges the index entries of two record slots. Used when moving records.
+ */
+void
+label_index_swap(page_cache*   pc,
+                 file_type     ft,
+                 unsigned long fst,
+                 unsigned long snd,
+                 bool          log);
+
+/*!
+ * Returns the id of the first record with the given label or
+ * UNINITIALIZED_LONG if there is none.
+ */
+unsigned long
+label_index_first(page_cache*   pc,
+                  file_type     ft,
+                  unsigned long label,
+                  bool          log);
+
+/*!
+ * Returns the ids of all records with the given label, starting with the
+ * first.
+ */
+array_list_ul*
+label_index_find_all(page_cache*   pc,
+                     file_type     ft,
+                     unsigned long label,
+                     bool          log);
+
+#endif
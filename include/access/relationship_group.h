@@ -0,0 +1,76 @@
+/*!
+ * \file relationship_group.h
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief Relationship groups of dense nodes, similar to the ones of Neo4j.
+ *
+ * Once a node has more than \ref DENSE_NODE_THRESHOLD relationships, its
+ * incidence list is ordered such that the relationships with the same label
+ * and direction form a contiguous run. A group record stores the first and the
+ * last relationship of such a run and the number of relationships in it, so
+ * that filtered expansions only read the relationships of the matching runs.
+ * The incidence list stays a valid circular list, so that unfiltered
+ * traversals are not affected by the grouping.
+ *
+ * The groups of a node form a singly linked list starting at the degree entry
+ * of the node. Group records are stored in the group file, see \ref group_ft.
+ * The first entry of the file is not a group but holds the head of the list of
+ * free groups and the next unused group id, so that id 0 marks the end of a
+ * list.
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#ifndef RELATIONSHIP_GROUP_H
+#define RELATIONSHIP_GROUP_H
+
+#include <stddef.h>
+
+#include "constants.h"
+#include "page.h"
+#include "relationship.h"
+
+/* Nodes with more relationships than this are grouped. */
+#define DENSE_NODE_THRESHOLD (50)
+
+#define ON_DISK_GROUP_SIZE (6 * sizeof(unsigned long))
+#define GROUPS_PER_PAGE    (PAGE_SIZE / ON_DISK_GROUP_SIZE)
+
+/* Ends the list of groups of a node and the list of free groups. */
+#define NO_GROUP (0UL)
+
+typedef struct
+{
+    unsigned long id;
+    unsigned long label;
+    /* OUTGOING and INCOMING for relationships to other nodes, BOTH for self
+     * loops */
+    direction_t   direction;
+    unsigned long first_rel;
+    unsigned long last_rel;
+    unsigned long num_rels;
+    unsigned long next_group;
+} relationship_group_t;
+
+relationship_group_t*
+new_relationship_group(void);
+
+/*!
+ * Reads the group with the id of \p group from its page.
+ */
+void
+relationship_group_read(relationship_group_t* group, page* read_from_page);
+
+void
+relationship_group_write(relationship_group_t* group, page* write_to_page);
+
+/*!
+ * Returns the direction of the group the relationship belongs to at the node.
+ */
+direction_t
+relationship_group_direction(const relationship_t* rel, unsigned long node_id);
+
+#endif
@@ -31,6 +31,14 @@ static const double        UNINITIALIZED_WEIGHT = 0x1.FFFFFFFFFF666p-1;
 #define SLOT_SIZE      (16)
 #define SLOTS_PER_PAGE (PAGE_SIZE / SLOT_SIZE)
 
+/* The degree file stores the out degree, the in degree and the number of self
+ * loops of each node slot, followed by the first relationship group of dense
+ * nodes. Entries do not cross page boundaries. */
+#define NUM_DEGREE_COUNTERS (3)
+#define DEGREE_ENTRY_SIZE                                                      \
+    ((NUM_DEGREE_COUNTERS + 1) * sizeof(unsigned long))
+#define DEGREE_ENTRIES_PER_PAGE (PAGE_SIZE / DEGREE_ENTRY_SIZE)
+
 /* size of the cache for the actual graph */
 #define CACHE_SIZE    (PAGE_SIZE * 100)
 #define CACHE_N_PAGES (CACHE_SIZE / PAGE_SIZE)
@@ -41,4 +49,11 @@ static const double        UNINITIALIZED_WEIGHT = 0x1.FFFFFFFFFF666p-1;
 static const float EVICT_LRU_K_SHARE = 0.1F;
 #define EVICT_LRU_K ((1 + (size_t)((size_t)CACHE_N_PAGES * EVICT_LRU_K_SHARE)))
 
+/* The build sets THREADS to half the number of cores, which is zero on single
+ * core machines. Parallel algorithms use at least one thread. */
+#ifndef THREADS
+#define THREADS (1)
+#endif
+#define N_THREADS ((THREADS) > 0 ? (size_t)(THREADS) : 1)
+
 #endif
@@ -0,0 +1,70 @@
+/*!
+ * \file d_ary_heap.h
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief An indexed min heap with D_ARY_HEAP_ARITY children per node. The
+ * values are dense indices (e.g. node ids), so the position of a value in the
+ * heap can be kept in an array and decrease key is a single sift up.
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#ifndef D_ARY_HEAP_H
+#define D_ARY_HEAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define D_ARY_HEAP_ARITY (4)
+
+typedef struct
+{
+    double        key;
+    unsigned long value;
+} d_ary_heap_entry;
+
+typedef struct
+{
+    d_ary_heap_entry* entries;
+    size_t            size;
+    size_t            capacity;
+    /* position of a value in entries, SIZE_MAX if absent */
+    size_t* positions;
+    size_t  index_capacity;
+} d_ary_heap;
+
+d_ary_heap*
+d_ary_heap_create(void);
+
+void
+d_ary_heap_destroy(d_ary_heap* heap);
+
+size_t
+d_ary_heap_size(d_ary_heap* heap);
+
+bool
+d_ary_heap_contains(d_ary_heap* heap, unsigned long value);
+
+/*!
+ * Inserts a value that is not yet contained in the heap.
+ */
+void
+d_ary_heap_insert(d_ary_heap* heap, double key, unsigned long value);
+
+/*!
+ * Lowers the key of a contained value. Keys larger than the current one are
+ * ignored.
+ */
+void
+d_ary_heap_decrease_key(d_ary_heap* heap, unsigned long value, double key);
+
+double
+d_ary_heap_min_key(d_ary_heap* heap);
+
+unsigned long
+d_ary_heap_extract_min(d_ary_heap* heap, double* key);
+
+#endif
@@ -25,7 +25,7 @@
     FIB_HEAP_STRUCTS(typename, T);                                             \
     typename* typename##_create(void);                                         \
     void typename##_destroy(typename* fh);                                     \
-    void typename##_insert(typename* fh, double key, T value);                 \
+    typename##_node* typename##_insert(typename* fh, double key, T value);     \
     typename##_node* typename##_min(typename* fh);                             \
     void typename##_make_child(typename##_node* x, typename##_node* y);        \
     void typename##_consolidate(typename* fh);                                 \
@@ -136,7 +136,7 @@ exit(EXIT_FAILURE);                                                            \
     }
 
 #define FIB_HEAP_INSERT(typename, T)                                           \
-    void typename##_insert(typename* fh, double key, T value)                  \
+    typename##_node* typename##_insert(typename* fh, double key, T value)      \
     {                                                                          \
         if (!fh) {                                                             \
             printf("fibonacci heap - insert: Invalid Argumentd!\n");           \
@@ -189,6 +189,8 @@ exit(EXIT_FAILURE);                                                            \
         }                                                                      \
                                                                                \
         fh->num_nodes++;                                                       \
+                                                                               \
+        return node;                                                           \
     }
 
 #define FIB_HEAP_MIN(typename)                                                 \
@@ -250,27 +252,47 @@ exit(EXIT_FAILURE);                                                            \
 exit(EXIT_FAILURE);                                                            \
         }                                                                      \
         unsigned int max_degree =                                              \
-              floor(log_golden_ratio_factor * logf((float)fh->num_nodes));     \
+              floor(log_golden_ratio_factor * logf((float)fh->num_nodes)) + 2; \
         typename##_node** nodes_w_degree =                                     \
               calloc(max_degree, sizeof(typename##_node*));                    \
                                                                                \
-        typename##_node* first = fh->min->right;                               \
+        /* The old minimum is already unlinked, start with its neighbour */    \
+        size_t           n_roots = 0;                                          \
+        typename##_node* start   = fh->min->right;                             \
+        typename##_node* x       = start;                                      \
+        do {                                                                   \
+            n_roots++;                                                         \
+            x = x->right;                                                      \
+        } while (x != start);                                                  \
+                                                                               \
+        /* Collect the roots first, as linking changes the root list. */       \
+        typename##_node** roots = calloc(n_roots, sizeof(typename##_node*));   \
+                                                                               \
+        if (!nodes_w_degree || !roots) {                                       \
+            printf("fibonacci heap - consolidate: Memory Allocation "          \
+                   "failed!\n");                                               \
+            print_trace();                                                     \
+            exit(EXIT_FAILURE);                                                \
+        }                                                                      \
+                                                                               \
+        for (size_t i = 0; i < n_roots; ++i) {                                 \
+            roots[i] = x;                                                      \
+            x        = x->right;                                               \
+        }                                                                      \
+                                                                               \
         typename##_node* temp;                                                 \
-        typename##_node* x = fh->min->right;                                   \
         typename##_node* y;                                                    \
         unsigned int     d;                                                    \
                                                                                \
         /* Collapse all nodes with the same degree until all degrees are       \
          * unique */                                                           \
-        do {                                                                   \
+        for (size_t i = 0; i < n_roots; ++i) {                                 \
+            x = roots[i];                                                      \
             d = x->degree;                                                     \
                                                                                \
             /* Find roots with the same degree */                              \
             while (nodes_w_degree[d]) {                                        \
                 y = nodes_w_degree[d];                                         \
-                if (x == y) {                                                  \
-                    break;                                                     \
-                }                                                              \
                                                                                \
                 /* Make the root with the smaller key a child of the other. */ \
                 /* Clear mark, increment degree */                             \
@@ -282,16 +304,12 @@ exit(EXIT_FAILURE);                                                            \
                                                                                \
                 typename##_make_child(x, y);                                   \
                                                                                \
-                if (y == first) {                                              \
-                    first = x;                                                 \
-                }                                                              \
-                                                                               \
                 nodes_w_degree[d] = NULL;                                      \
                 ++d;                                                           \
             }                                                                  \
             nodes_w_degree[d] = x;                                             \
-            x                 = x->right;                                      \
-        } while (x != first);                                                  \
+        }                                                                      \
+        free(roots);                                                           \
                                                                                \
         /* rebuild root list */                                                \
         fh->min = NULL;                                                        \
@@ -0,0 +1,263 @@
+/*!
+ * \file pairing_heap.h
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief A pairing heap with two-pass pairing on extract min. Like the
+ * fibonacci heap, insert returns a node handle that can be passed to decrease
+ * key.
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#ifndef PAIRING_HEAP_H
+#define PAIRING_HEAP_H
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "strace.h"
+
+#define PAIRING_HEAP_DECL(typename, T)                                         \
+    PAIRING_HEAP_STRUCTS(typename, T);                                         \
+    typename* typename##_create(void);                                         \
+    void typename##_destroy(typename* ph);                                     \
+    typename##_node* typename##_insert(typename* ph, double key, T value);     \
+    typename##_node* typename##_min(typename* ph);                             \
+    typename##_node* typename##_extract_min(typename* ph);                     \
+    void typename##_decrease_key(                                              \
+          typename* ph, typename##_node* node, double new_key);
+
+#define PAIRING_HEAP_IMPL(typename, T)                                         \
+    PAIRING_HEAP_MELD(typename)                                                \
+    PAIRING_HEAP_CREATE(typename)                                              \
+    PAIRING_HEAP_DESTROY(typename)                                             \
+    PAIRING_HEAP_INSERT(typename, T)                                           \
+    PAIRING_HEAP_MIN(typename)                                                 \
+    PAIRING_HEAP_EXTRACT_MIN(typename)                                         \
+    PAIRING_HEAP_DECREASE_KEY(typename)
+
+#define PAIRING_HEAP_STRUCTS(typename, T)                                      \
+    typedef struct typename##_nd                                               \
+    {                                                                          \
+        double                key;                                             \
+        T                     value;                                           \
+        struct typename##_nd* child;                                           \
+        struct typename##_nd* sibling;                                         \
+        /* The left sibling or the parent for the leftmost child */            \
+        struct typename##_nd* prev;                                            \
+    } typename##_node;                                                         \
+                                                                               \
+    typedef struct                                                             \
+    {                                                                          \
+        typename##_node* root;                                                 \
+        unsigned long    num_nodes;                                            \
+    } typename;
+
+#define PAIRING_HEAP_MELD(typename)                                            \
+    static typename##_node* typename##_meld(typename##_node* a,                \
+                                            typename##_node* b)                \
+    {                                                                          \
+        if (!a) {                                                              \
+            return b;                                                          \
+        }                                                                      \
+        if (!b) {                                                              \
+            return a;                                                          \
+        }                                                                      \
+                                                                               \
+        if (b->key < a->key) {                                                 \
+            typename##_node* temp = a;                                         \
+            a                     = b;                                         \
+            b                     = temp;                                      \
+        }                                                                      \
+                                                                               \
+        /* b becomes the leftmost child of a */                                \
+        b->prev    = a;                                                        \
+        b->sibling = a->child;                                                 \
+        if (a->child) {                                                        \
+            a->child->prev = b;                                                \
+        }                                                                      \
+        a->child   = b;                                                        \
+        a->sibling = NULL;                                                     \
+        a->prev    = NULL;                                                     \
+                                                                               \
+        return a;                                                              \
+    }
+
+#define PAIRING_HEAP_CREATE(typename)                                          \
+    typename* typename##_create(void)                                          \
+    {                                                                          \
+        typename* ph = malloc(sizeof(*ph));                                    \
+                                                                               \
+        if (!ph) {                                                             \
+            printf("pairing heap - create: Memory Allocation failed!\n");      \
+            print_trace();                                                     \
+            exit(EXIT_FAILURE);                                                \
+        }                                                                      \
+                                                                               \
+        ph->root      = NULL;                                                  \
+        ph->num_nodes = 0;                                                     \
+                                                                               \
+        return ph;                                                             \
+    }
+
+#define PAIRING_HEAP_DESTROY(typename)                                         \
+    void typename##_destroy(typename* ph)                                      \
+    {                                                                          \
+        if (!ph) {                                                             \
+            printf("pairing heap - destroy: Invalid Arguments!\n");            \
+            print_trace();                                                     \
+            exit(EXIT_FAILURE);                                                \
+        }                                                                      \
+                                                                               \
+        /* Free the tree iteratively by splicing children into the sibling */  \
+        /* list of the current node. */                                        \
+        typename##_node* node = ph->root;                                      \
+        typename##_node* next;                                                 \
+        typename##_node* last;                                                 \
+        while (node) {                                                         \
+            if (node->child) {                                                 \
+                last = node->child;                                            \
+                while (last->sibling) {                                        \
+                    last = last->sibling;                                      \
+                }                                                              \
+                last->sibling = node->sibling;                                 \
+                next          = node->child;                                   \
+            } else {                                                           \
+                next = node->sibling;                                          \
+            }                                                                  \
+            free(node);                                                        \
+            node = next;                                                       \
+        }                                                                      \
+                                                                               \
+        free(ph);                                                              \
+    }
+
+#define PAIRING_HEAP_INSERT(typename, T)                                       \
+    typename##_node* typename##_insert(typename* ph, double key, T value)      \
+    {                                                                          \
+        if (!ph) {                                                             \
+            printf("pairing heap - insert: Invalid Arguments!\n");             \
+            print_trace();                                                     \
+            exit(EXIT_FAILURE);                                                \
+        }                                                                      \
+                                                                               \
+        typename##_node* node = malloc(sizeof(*node));                         \
+                                                                               \
+        if (!node) {                                                           \
+            printf("pairing heap - insert: Memory Allocation failed!\n");      \
+            print_trace();                                                     \
+            exit(EXIT_FAILURE);                                                \
+        }                                                                      \
+                                                                               \
+        node->key     = key;                                                   \
+        node->value   = value;                                                 \
+        node->child   = NULL;                                                  \
+        node->sibling = NULL;                                                  \
+        node->prev    = NULL;                                                  \
+                                                                               \
+        ph->root = typename##_meld(ph->root, node);                            \
+        ph->num_nodes++;                                                       \
+                                                                               \
+        return node;                                                           \
+    }
+
+#define PAIRING_HEAP_MIN(typename)                                             \
+    typename##_node* typename##_min(typename* ph)                              \
+    {                                                                          \
+        if (!ph || !ph->root) {                                                \
+            printf("pairing heap - min: Invalid Arguments!\n");                \
+            print_trace();                                                     \
+            exit(EXIT_FAILURE);                                                \
+        }                                                                      \
+                                                                               \
+        return ph->root;                                                       \
+    }
+
+#define PAIRING_HEAP_EXTRACT_MIN(typename)                                     \
+    typename##_node* typename##_extract_min(typename* ph)                      \
+    {                                                                          \
+        if (!ph || !ph->root) {                                                \
+            printf("pairing heap - extract min: Invalid Arguments!\n");        \
+            print_trace();                                                     \
+            exit(EXIT_FAILURE);                                                \
+        }                                                                      \
+                                                                               \
+        typename##_node* min = ph->root;                                       \
+        typename##_node* a   = min->child;                                     \
+        typename##_node* b;                                                    \
+        typename##_node* next;                                                 \
+        typename##_node* pairs = NULL;                                         \
+                                                                               \
+        /* First pass: meld pairs from left to right, collect the results */   \
+        /* in reverse order through their sibling pointers. */                 \
+        while (a) {                                                            \
+            b = a->sibling;                                                    \
+            if (b) {                                                           \
+                next = b->sibling;                                             \
+                a    = typename##_meld(a, b);                                  \
+            } else {                                                           \
+                next       = NULL;                                             \
+                a->prev    = NULL;                                             \
+                a->sibling = NULL;                                             \
+            }                                                                  \
+            a->sibling = pairs;                                                \
+            pairs      = a;                                                    \
+            a          = next;                                                 \
+        }                                                                      \
+                                                                               \
+        /* Second pass: meld the pairs from right to left. */                  \
+        typename##_node* root = NULL;                                          \
+        while (pairs) {                                                        \
+            next = pairs->sibling;                                             \
+            root = typename##_meld(root, pairs);                               \
+            pairs = next;                                                      \
+        }                                                                      \
+                                                                               \
+        ph->root = root;                                                       \
+        ph->num_nodes--;                                                       \
+                                                                               \
+        min->child   = NULL;                                                   \
+        min->sibling = NULL;                                                   \
+        min->prev    = NULL;                                                   \
+                                                                               \
+        return min;                                                            \
+    }
+
+#define PAIRING_HEAP_DECREASE_KEY(typename)                                    \
+    void typename##_decrease_key(                                              \
+          typename* ph, typename##_node* node, double new_key)                 \
+    {                                                                          \
+        if (!ph || !node || new_key > node->key) {                             \
+            printf("pairing heap - decrease key: Invalid Arguments!\n");       \
+            print_trace();                                                     \
+            exit(EXIT_FAILURE);                                                \
+        }                                                                      \
+                                                                               \
+        node->key = new_key;                                                   \
+                                                                               \
+        if (node == ph->root) {                                                \
+            return;                                                            \
+        }                                                                      \
+                                                                               \
+        /* Cut the subtree rooted at node and meld it with the root. */        \
+        if (node->prev->child == node) {                                       \
+            node->prev->child = node->sibling;                                 \
+        } else {                                                               \
+            node->prev->sibling = node->sibling;                               \
+        }                                                                      \
+        if (node->sibling) {                                                   \
+            node->sibling->prev = node->prev;                                  \
+        }                                                                      \
+        node->sibling = NULL;                                                  \
+        node->prev    = NULL;                                                  \
+                                                                               \
+        ph->root = typename##_meld(ph->root, node);                            \
+    }
+
+PAIRING_HEAP_DECL(pairing_heap_ul, unsigned long);
+
+#endif
@@ -0,0 +1,84 @@
+/*!
+ * \file priority_queue.h
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief A common interface over the heaps in data-struct, so that the
+ * shortest path algorithms can be run with either of them. Values are dense
+ * indices (e.g. node ids). Each value is contained at most once, pushing a
+ * contained value lowers its key if the new key is smaller.
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#ifndef PRIORITY_QUEUE_H
+#define PRIORITY_QUEUE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "data-struct/d_ary_heap.h"
+#include "data-struct/fibonacci_heap.h"
+#include "data-struct/pairing_heap.h"
+#include "data-struct/radix_heap.h"
+
+/*!
+ * The heap implementation backing a priority queue. The radix heap is
+ * monotone and only accepts non-negative keys that are not smaller than the
+ * last extracted one.
+ */
+typedef enum
+{
+    fibonacci_pq = 0,
+    d_ary_pq     = 1,
+    radix_pq     = 2,
+    pairing_pq   = 3,
+    invalid_pq   = 4
+} pq_type;
+
+typedef struct
+{
+    pq_type type;
+    union
+    {
+        fib_heap_ul*     fibonacci;
+        d_ary_heap*      d_ary;
+        radix_heap*      radix;
+        pairing_heap_ul* pairing;
+    } heap;
+    /* node handles per value for the pointer based heaps */
+    void** handles;
+    size_t n_handles;
+} priority_queue;
+
+priority_queue*
+priority_queue_create(pq_type type);
+
+void
+priority_queue_destroy(priority_queue* pq);
+
+size_t
+priority_queue_size(priority_queue* pq);
+
+bool
+priority_queue_contains(priority_queue* pq, unsigned long value);
+
+/*!
+ * Inserts the value or lowers its key if it is already contained and the new
+ * key is smaller.
+ */
+void
+priority_queue_push(priority_queue* pq, double key, unsigned long value);
+
+double
+priority_queue_min_key(priority_queue* pq);
+
+unsigned long
+priority_queue_extract_min(priority_queue* pq, double* key);
+
+const char*
+priority_queue_type_name(pq_type type);
+
+#endif
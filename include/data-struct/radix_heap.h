@@ -0,0 +1,76 @@
+/*!
+ * \file radix_heap.h
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief A monotone radix heap on non-negative double keys. Keys are
+ * compared by their IEEE 754 bit pattern, which orders non-negative doubles
+ * like unsigned integers. An element lives in the bucket given by the highest
+ * bit in which its key differs from the last extracted minimum. Inserted and
+ * decreased keys must not be smaller than the last extracted minimum, which
+ * holds for Dijkstra's algorithm and A* with consistent heuristics.
+ * Like \ref d_ary_heap.h the values are dense indices.
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#ifndef RADIX_HEAP_H
+#define RADIX_HEAP_H
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define RADIX_HEAP_N_BUCKETS (sizeof(unsigned long) * CHAR_BIT + 1)
+
+typedef struct
+{
+    unsigned long key_bits;
+    unsigned long value;
+} radix_heap_entry;
+
+typedef struct
+{
+    radix_heap_entry* entries;
+    size_t            size;
+    size_t            capacity;
+} radix_heap_bucket;
+
+typedef struct
+{
+    radix_heap_bucket buckets[RADIX_HEAP_N_BUCKETS];
+    unsigned long     last_min;
+    size_t            size;
+    /* bucket and position in the bucket per value, SIZE_MAX if absent */
+    size_t* bucket_of;
+    size_t* position_of;
+    size_t  index_capacity;
+} radix_heap;
+
+radix_heap*
+radix_heap_create(void);
+
+void
+radix_heap_destroy(radix_heap* heap);
+
+size_t
+radix_heap_size(radix_heap* heap);
+
+bool
+radix_heap_contains(radix_heap* heap, unsigned long value);
+
+void
+radix_heap_insert(radix_heap* heap, double key, unsigned long value);
+
+void
+radix_heap_decrease_key(radix_heap* heap, unsigned long value, double key);
+
+double
+radix_heap_min_key(radix_heap* heap);
+
+unsigned long
+radix_heap_extract_min(radix_heap* heap, double* key);
+
+#endif
@@ -0,0 +1,112 @@
+/*!
+ * \file draw.h
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief An online reorganizer in the spirit of DRAW that adapts the layout
+ * to the accesses of the queries instead of the structure of the graph.
+ *
+ * The reorganizer counts how often nodes and relationships are read within a
+ * window of \p window accesses of the same record type, which yields a
+ * co-access graph. The accesses are either sampled in-process through the
+ * access hook of the heap file or read from the logs that the queries and the
+ * heap file write.
+ *
+ * \ref draw_reorganize clusters the records greedily along the most frequent
+ * co-accesses, with at most a page of records per cluster, and moves the
+ * records of each cluster to the page that already holds most of them by
+ * swapping them with free slots or the least accessed records of that page.
+ * At most \p max_swaps records are moved per call, so that the caller can
+ * migrate incrementally whenever the database is idle. Once a call finishes
+ * all clusters within its budget, the counts are halved, so that the layout
+ * follows the recent query mix.
+ *
+ * The heap file is not synchronised, so the reorganizer runs in the thread
+ * that issues the queries, between them. Moving records changes their ids, as
+ * with all reorderings.
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#ifndef DRAW_H
+#define DRAW_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "access/heap_file.h"
+#include "data-struct/htable.h"
+#include "physical_database.h"
+
+#define DRAW_DEFAULT_WINDOW (8)
+/* Records that were accessed together less often are not clustered. */
+#define DRAW_MIN_CO_ACCESSES (2)
+
+/*!
+ * The accesses to the records of one type. Pairs are keyed by the dense
+ * indexes of both records, 32 bits each, so that records beyond the first
+ * 2^32 of a file are not clustered.
+ */
+typedef struct
+{
+    /* id -> number of accesses */
+    dict_ul_ul*    heat;
+    /* pair of dense indexes -> number of co-accesses */
+    dict_ul_ul*    co_access;
+    /* ring buffer of the ids of the last accesses */
+    unsigned long* recent;
+    size_t         n_recent;
+    size_t         next_recent;
+} draw_statistics;
+
+typedef struct
+{
+    heap_file*      hf;
+    size_t          window;
+    /* Only every sample_interval-th access through the hook is counted */
+    size_t          sample_interval;
+    unsigned long   n_accesses;
+    /* Suppresses the reads of the migration itself */
+    bool            migrating;
+    draw_statistics stats[NUM_SLOTTED_FILE_TYPES];
+} draw_reorganizer;
+
+/*!
+ * Creates a reorganizer for the heap file and installs it as its access hook.
+ * A \p sample_interval of 1 counts all reads.
+ */
+draw_reorganizer*
+draw_reorganizer_create(heap_file* hf, size_t window, size_t sample_interval);
+
+/*!
+ * Removes the access hook and frees the reorganizer.
+ */
+void
+draw_reorganizer_destroy(draw_reorganizer* reorganizer);
+
+/*!
+ * Counts an access to the node or relationship with the given id.
+ */
+void
+draw_record_access(draw_reorganizer* reorganizer,
+                   bool              node,
+                   unsigned long     id);
+
+/*!
+ * Counts the accesses in a log file. Lines of the form "<query> N <id>" and
+ * "<query> R <id>", as the queries write them, and the read_node and read_rel
+ * lines of the heap file are used, all others are skipped.
+ */
+void
+draw_read_log(draw_reorganizer* reorganizer, const char* log_path);
+
+/*!
+ * Clusters the co-accessed records and moves at most \p max_swaps records
+ * to the pages of their clusters. Returns the number of swaps.
+ */
+size_t
+draw_reorganize(draw_reorganizer* reorganizer, size_t max_swaps, bool log);
+
+#endif
@@ -0,0 +1,63 @@
+/*!
+ * \file g_store.h
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief The multilevel layout of G-Store (Steinhaus and Olteanu), which
+ * places nodes that are connected by many relationships on the same page and
+ * connected pages next to each other.
+ *
+ * The graph is treated as undirected, every relationship counts once.
+ *
+ * Coarsening contracts heavy-edge matchings level by level, as long as the
+ * contracted nodes fit on one page together. The coarsest graph is numbered
+ * by a breadth-first search that visits heavier edges first. Uncoarsening
+ * expands each node into its two children and uses the turnaround numbering:
+ * the child with the stronger connection to the previously placed node comes
+ * first, so that the order turns around at each contraction.
+ *
+ * On the finest level the order is cut into pages. Vertex refinement swaps
+ * pairs of nodes between two pages whenever that reduces the number of
+ * relationships crossing pages. Page reordering then chains the full pages,
+ * following the page with the most relationships to the current one.
+ *
+ * The relationships are placed in the order of their source nodes and within
+ * a source in the order of their targets, which keeps the incidence chains of
+ * a node on as few pages as possible.
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#ifndef G_STORE_H
+#define G_STORE_H
+
+#include <stdbool.h>
+
+#include "access/csr_graph.h"
+#include "access/heap_file.h"
+#include "data-struct/htable.h"
+
+/*!
+ * Maps the current ids to the new ids. Pass \p node_order to
+ * \ref reorder_nodes and \p relationship_order to
+ * \ref reorder_relationships, which leave the dictionaries unchanged. Free
+ * the layout with \ref g_store_layout_destroy.
+ */
+typedef struct
+{
+    dict_ul_ul* node_order;
+    dict_ul_ul* relationship_order;
+} g_store_layout;
+
+g_store_layout*
+g_store_order(heap_file* hf, bool log);
+
+g_store_layout*
+g_store_order_csr(const csr_graph* graph);
+
+void
+g_store_layout_destroy(g_store_layout* layout);
+
+#endif
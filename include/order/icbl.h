@@ -0,0 +1,51 @@
+/*!
+ * \file icbl.h
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief An incidence-clustered layout of the relationships: Each
+ * relationship is stored with the outgoing relationships of its source node,
+ * and the outgoing relationships of a node occupy a contiguous run of slots
+ * that does not cross a page, unless they do not fit into one page. Such hubs
+ * start on a new page and continue on the following overflow pages.
+ *
+ * Within a run the relationships are ordered by their targets. Runs that
+ * would cross a page start on the next one, leaving the rest of the page free
+ * for later insertions. The nodes keep their order, so a node order
+ * should be applied before.
+ *
+ * After \ref sort_incidence_list the run of a node is a contiguous part of its
+ * incidence list, which \ref expand then reads with a single pin per page.
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#ifndef ICBL_H
+#define ICBL_H
+
+#include <stdbool.h>
+
+#include "access/csr_graph.h"
+#include "access/heap_file.h"
+#include "data-struct/htable.h"
+
+/*!
+ * Maps the current relationship ids to the new ones, as \ref
+ * reorder_relationships expects.
+ */
+dict_ul_ul*
+icbl_relationship_order(heap_file* hf, bool log);
+
+dict_ul_ul*
+icbl_relationship_order_csr(const csr_graph* graph);
+
+/*!
+ * Moves the relationships to the incidence-clustered layout and sorts the
+ * incidence lists, so that the runs are contiguous in them.
+ */
+void
+icbl_layout(heap_file* hf, bool log);
+
+#endif
@@ -0,0 +1,85 @@
+/*!
+ * \file layout_metrics.h
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief Estimates the quality of a node and relationship order on a
+ * \ref csr_graph.h snapshot, without reordering the records or reading pages,
+ * so that orders can be compared before one is applied.
+ *
+ * The orders map the current ids to the new ones, as \ref reorder_nodes and
+ * \ref reorder_relationships expect. NULL keeps the current ids. Positions and
+ * pages are those the records would have after the reordering.
+ *
+ * The cost terms are those of G-Store and of Yasar and Gedik, see
+ * literature/summary.md: the linear arrangement cost, the relationships that
+ * cross node pages, the relationship pages of the incidence lists and, per
+ * node page, the conductance, the cohesiveness and the block locality
+ * sqrt(conductance * (1 - cohesiveness)).
+ *
+ * \ref layout_simulate_misses replays the page accesses of breadth-first
+ * searches or Dijkstra's algorithm against a simulated LRU cache. An expand
+ * reads the page of the node and then walks the incidence list, which is
+ * assumed to be sorted by relationship id as after \ref sort_incidence_list.
+ * Consecutive relationships on the same page cost one access.
+ *
+ * Both run in parallel over the nodes or the start nodes.
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#ifndef LAYOUT_METRICS_H
+#define LAYOUT_METRICS_H
+
+#include <stddef.h>
+
+#include "access/csr_graph.h"
+#include "data-struct/htable.h"
+
+typedef enum
+{
+    LAYOUT_BFS,
+    LAYOUT_DIJKSTRA
+} layout_traversal;
+
+typedef struct
+{
+    unsigned long n_node_pages;
+    unsigned long n_rel_pages;
+    /* Sum of the distances of the positions of the endpoints of each
+     * relationship */
+    double        linear_arrangement;
+    /* Relationships whose endpoints lie on different node pages */
+    unsigned long cross_page_rels;
+    /* Sum of the number of relationship pages of each incidence list */
+    unsigned long incidence_pages;
+    /* Means over the node pages */
+    double        conductance;
+    double        cohesiveness;
+    double        block_locality;
+} layout_metrics;
+
+/*!
+ * Computes the cost terms of the order. The caller frees the result.
+ */
+layout_metrics*
+layout_metrics_compute(const csr_graph* graph,
+                       dict_ul_ul*      node_order,
+                       dict_ul_ul*      rel_order);
+
+/*!
+ * Runs \p n_starts traversals along the outgoing relationships, starting at
+ * nodes spread evenly over the graph, each with an empty cache of \p n_frames
+ * pages. Returns the mean number of page misses per traversal.
+ */
+double
+layout_simulate_misses(const csr_graph* graph,
+                       dict_ul_ul*      node_order,
+                       dict_ul_ul*      rel_order,
+                       layout_traversal traversal,
+                       size_t           n_starts,
+                       size_t           n_frames);
+
+#endif
@@ -0,0 +1,68 @@
+/*!
+ * \file locality_order.h
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief Node orders that are cheap to compute and place neighbours close to
+ * each other, without partitioning the graph. Each returns the mapping from
+ * the current to the new node ids that \ref reorder_nodes expects and works on
+ * a \ref csr_graph.h snapshot of the heap file.
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#ifndef LOCALITY_ORDER_H
+#define LOCALITY_ORDER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "access/heap_file.h"
+#include "data-struct/htable.h"
+
+/* The window of the Gorder paper, larger ones barely improve the order. */
+#define GORDER_DEFAULT_WINDOW (5)
+
+/*!
+ * Numbers the nodes in the order of a breadth-first search over both
+ * directions, starting a new search from the smallest unvisited id.
+ */
+dict_ul_ul*
+bfs_node_order(heap_file* hf, bool log);
+
+/*!
+ * Reverse Cuthill-McKee: a breadth-first search from a pseudo-peripheral node
+ * of each component that visits neighbours with a lower degree first,
+ * reversed. This keeps the bandwidth of the adjacency matrix small.
+ */
+dict_ul_ul*
+rcm_node_order(heap_file* hf, bool log);
+
+/*!
+ * Hub clustering: the nodes with more than the average degree come first,
+ * sorted by descending degree, followed by the others in their current order.
+ */
+dict_ul_ul*
+degree_node_order(heap_file* hf, bool log);
+
+/*!
+ * Gorder (Wei et al.): places next the node with the highest score with the
+ * last \p window placed nodes, counting the relationships between two nodes
+ * and their common in-neighbours. In-neighbours with more than sqrt(n)
+ * out-neighbours are skipped, as in the paper.
+ */
+dict_ul_ul*
+gorder_node_order(heap_file* hf, size_t window, bool log);
+
+/*!
+ * Rabbit Order (Arai et al.): the nodes are merged in parallel in the order of
+ * ascending degree into the neighbour with the largest modularity gain. The
+ * order is a depth-first traversal of the resulting merge trees, so that each
+ * community and its subcommunities are stored together.
+ */
+dict_ul_ul*
+rabbit_node_order(heap_file* hf, bool log);
+
+#endif
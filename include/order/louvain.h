@@ -0,0 +1,89 @@
+/*!
+ * \file louvain.h
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief Community detection by modularity with the Louvain method (Blondel
+ * et al.) and the Leiden algorithm (Traag et al.) on a \ref csr_graph.h
+ * snapshot, used to order the nodes so that communities are stored together.
+ *
+ * The graph is treated as undirected and every relationship counts once, as
+ * the weights stored in the database are distances and not affinities.
+ *
+ * Both methods alternate between moving nodes to the neighbouring community
+ * with the largest modularity gain and aggregating the communities to nodes
+ * of a coarser graph. The nodes are moved in parallel: Within blocks of
+ * consecutive nodes, the threads choose the moves based on the communities
+ * before the block and the moves are applied at the end of the block. A node
+ * alone in its community only joins another single node community with a
+ * smaller id, so that two nodes do not swap their communities. The blocks
+ * have a fixed size, so the result does not depend on the number of threads.
+ *
+ * Leiden refines each community before the aggregation, merging the nodes
+ * within the community greedily into well-connected subcommunities. The
+ * subcommunities become the nodes of the coarser graph, which starts from
+ * the unrefined communities. This guarantees connected communities. The
+ * refinement always picks the best subcommunity instead of sampling one,
+ * which makes it deterministic, and runs in parallel over the communities.
+ *
+ * The order groups the nodes by their final community and within it by the
+ * communities of the finer levels, so that the dendrogram is laid out
+ * recursively.
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#ifndef LOUVAIN_H
+#define LOUVAIN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "access/csr_graph.h"
+#include "access/heap_file.h"
+
+typedef enum
+{
+    louvain_method = 0,
+    leiden_method  = 1,
+    /*! Used to validate parameters. */
+    invalid_community_method = 2
+} community_method;
+
+/*!
+ * The communities of the nodes of a snapshot. \p sequence holds the node ids
+ * in the order described above and can be passed to
+ * \ref reorder_nodes_by_sequence.
+ */
+typedef struct
+{
+    unsigned long  n_nodes;
+    unsigned long  n_communities;
+    /* community per dense index of the snapshot, numbered in the order of the
+     * sequence */
+    unsigned long* community;
+    unsigned long* sequence;
+    double         modularity;
+} community_result;
+
+/*!
+ * Reads the graph into a snapshot and detects its communities. Larger values
+ * of \p resolution yield smaller communities, 1 is the classic modularity.
+ */
+community_result*
+communities(heap_file*       hf,
+            community_method method,
+            double           resolution,
+            bool             log);
+
+community_result*
+communities_csr(const csr_graph* graph,
+                community_method method,
+                double           resolution);
+
+void
+community_result_destroy(community_result* result);
+
+#endif
@@ -32,6 +32,29 @@ swap_record_pages(heap_file* hf,
                   file_type  ft,
                   bool       log);
 
+/*!
+ * Moves the nodes and relationships to the ids that \p new_node_ids and
+ * \p new_rel_ids map their current ids to. Records without a new id take the
+ * first free positions in the order of their current ids, without a dict the
+ * records of that type keep their ids. The new ids must be distinct.
+ *
+ * Instead of swapping records in place, all files of the database are written
+ * anew in a few sequential passes over the old files, using buffers of the
+ * size of the cache. Entries that move to another part of a file go through
+ * buckets in a temporary run file. The label chains and the label and
+ * adjacency indexes are remapped to the new ids and keep their order and
+ * capacity. The new files are then swapped in by \ref phy_database_replace.
+ */
+void
+rebuild_records(heap_file*  hf,
+                dict_ul_ul* new_node_ids,
+                dict_ul_ul* new_rel_ids,
+                bool        log);
+
+/*!
+ * Moves the nodes to their new ids, see \ref rebuild_records. Only reads
+ * \p new_ids, which the caller still owns.
+ */
 void
 reorder_nodes(heap_file* hf, dict_ul_ul* new_ids, bool log);
 
@@ -40,6 +63,10 @@ reorder_nodes_by_sequence(heap_file*           hf,
                           const unsigned long* sequence,
                           bool                 log);
 
+/*!
+ * Moves the relationships to their new ids, see \ref rebuild_records. Only
+ * reads \p new_ids, which the caller still owns.
+ */
 void
 reorder_relationships(heap_file* hf, dict_ul_ul* new_ids, bool log);
 
@@ -51,7 +78,21 @@ reorder_relationships_by_sequence(heap_file*           hf,
                                   const unsigned long* sequence,
                                   bool                 log);
 
+/*!
+ * Sorts the incidence list of every node by relationship id. The lists are
+ * taken from a \ref csr_graph.h snapshot and linked in one batch, see
+ * \ref relink_incidence_lists.
+ */
 void
 sort_incidence_list(heap_file* hf, bool log);
 
+/*!
+ * Sorts only the incidence lists of the nodes that gained relationships or
+ * whose relationships moved since the last sort, see
+ * heap_file::unsorted_nodes. The nodes are tracked in memory, so after the
+ * database was reopened, \ref sort_incidence_list has to run once.
+ */
+void
+sort_incidence_list_incremental(heap_file* hf, bool log);
+
 #endif
@@ -0,0 +1,81 @@
+/*!
+ * \file stream_partition.h
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief A semi-external partitioner for graphs that do not fit into memory.
+ *
+ * The relationships are read sequentially from the record file, one page
+ * after the other. The only state kept in memory is the partition of each
+ * node id and a few values per partition, unlike the orders of
+ * \ref locality_order.h and \ref louvain.h, which hold the graph or hash
+ * tables over all records.
+ *
+ * The stream places a node when the run of relationships that it is the
+ * source of ends, greedily in the partition with the best score over the
+ * partitions of its targets (Stanton and Kliot, Tsourakakis et al.):
+ *  - LDG: |N(v) in P| * (1 - |P| / C)
+ *  - Fennel: |N(v) in P| - alpha * gamma * |P|^(gamma - 1), with gamma = 1.5
+ *    and alpha = sqrt(k) * m / n^1.5
+ * Each partition holds at most C = ceil(n / k) nodes. Targets that were not
+ * placed yet follow their source in the first pass, so that nodes without
+ * outgoing relationships are placed as well. Nodes without relationships
+ * fill up the partitions at the end.
+ *
+ * Restreaming (Nishimura and Ugander) repeats the stream, now with all nodes
+ * placed by the previous pass, and moves each source to the best partition.
+ *
+ * The stream works best if the relationships of a node are stored together,
+ * as after an import of an edge list sorted by source or after
+ * \ref reorder_relationships_by_nodes. Otherwise each run of relationships
+ * with the same source places the node anew, from its targets in that run.
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#ifndef STREAM_PARTITION_H
+#define STREAM_PARTITION_H
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "access/heap_file.h"
+
+/* Marks the ids without a node in the result of \ref stream_partition. */
+#define STREAM_NO_PARTITION (UINT_MAX)
+
+typedef enum
+{
+    LDG_PARTITIONER,
+    FENNEL_PARTITIONER
+} stream_partitioner;
+
+/*!
+ * Partitions the nodes into \p n_partitions balanced parts with one pass over
+ * the relationships and \p n_restreams further ones. Zero partitions yield one
+ * per page of nodes. Returns the partition of each node, indexed by node id,
+ * up to the end of the last page of nodes. The caller frees the result.
+ */
+unsigned int*
+stream_partition(heap_file*         hf,
+                 size_t             n_partitions,
+                 stream_partitioner partitioner,
+                 size_t             n_restreams,
+                 bool               log);
+
+/*!
+ * Partitions the nodes as \ref stream_partition does and returns the node ids
+ * sorted by partition and then by id, in the form that
+ * \ref reorder_nodes_by_sequence expects. The caller frees the result.
+ */
+unsigned long*
+stream_partition_order(heap_file*         hf,
+                       size_t             n_partitions,
+                       stream_partitioner partitioner,
+                       size_t             n_restreams,
+                       bool               log);
+
+#endif
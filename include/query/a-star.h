@@ -3,7 +3,9 @@
  * \version 1.0
  * \date Sep 15, 2021
  * \author Fabian Klopfer <fabian.klopfer@ieee.org>
- * \brief TODO
+ * \brief A* search guided by a heuristic callback. The heuristic is evaluated
+ * only for nodes the search touches, so it can compute its bounds on demand
+ * instead of requiring a table for the whole graph.
  *
  * \copyright Copyright (c) 2021- University of Konstanz.
  * This software is the proprietary information of the above-mentioned
@@ -15,15 +17,58 @@
 
 #include "access/heap_file.h"
 #include "access/relationship.h"
+#include "data-struct/priority_queue.h"
 #include "result_types.h"
 
+/*!
+ * Returns a lower bound on the length of a shortest path from the first to
+ * the second node along the direction of the search. data is passed through
+ * unchanged.
+ */
+typedef double (*heuristic_fn)(unsigned long from_node_id,
+                               unsigned long to_node_id,
+                               void*         data);
+
+/*!
+ * Heuristic that looks up the bound of the first node in the dict_ul_d passed
+ * as data, which holds estimates of the distance to a fixed target. Missing
+ * nodes and DBL_MAX count as zero.
+ */
+double
+a_star_dict_heuristic(unsigned long from_node_id,
+                      unsigned long to_node_id,
+                      void*         data);
+
+/*!
+ * Finds a shortest path from the source to the target. A NULL heuristic
+ * turns the search into Dijkstra's algorithm. Nodes are reopened when a
+ * shorter path to them is found, so the heuristic needs to be admissible but
+ * not necessarily consistent.
+ */
 path*
 a_star(heap_file*    hf,
-       dict_ul_d*    heuristic,
+       heuristic_fn  heuristic,
+       void*         heuristic_data,
        unsigned long source_node_id,
        unsigned long target_node_id,
        direction_t   direction,
        bool          log,
        FILE*         log_file);
 
+/*!
+ * \ref a_star with the given heap. The radix heap requires a consistent
+ * heuristic, as it only accepts keys that are not smaller than the last
+ * extracted one. Keys that fall below it by rounding are raised to it.
+ */
+path*
+a_star_pq(heap_file*    hf,
+          heuristic_fn  heuristic,
+          void*         heuristic_data,
+          unsigned long source_node_id,
+          unsigned long target_node_id,
+          direction_t   direction,
+          pq_type       queue_type,
+          bool          log,
+          FILE*         log_file);
+
 #endif
@@ -3,7 +3,11 @@
  * \version 1.0
  * \date Sep 15, 2021
  * \author Fabian Klopfer <fabian.klopfer@ieee.org>
- * \brief TODO
+ * \brief A* with landmarks and the triangle inequality (Goldberg and
+ * Harrelson). The preprocessing computes the distances between a few
+ * landmarks and all nodes. Queries derive lower bounds from them for the
+ * nodes they touch. The distances can be saved alongside the database files,
+ * so that the preprocessing runs only once per graph.
  *
  * \copyright Copyright (c) 2021- University of Konstanz.
  * This software is the proprietary information of the above-mentioned
@@ -13,8 +17,14 @@
 #ifndef ALT_H
 #define ALT_H
 
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "access/csr_graph.h"
 #include "access/heap_file.h"
 #include "access/relationship.h"
+#include "data-struct/htable.h"
+#include "data-struct/priority_queue.h"
 #include "result_types.h"
 
 unsigned long
@@ -23,22 +33,157 @@ alt_chose_avg_deg_rand_landmark(heap_file*  hf,
                                 bool        log,
                                 FILE*       log_file);
 
+/*!
+ * How the preprocessing picks the landmarks.
+ */
+typedef enum
+{
+    /*! Random nodes with at least average degree. */
+    alt_random_avg_degree,
+    /*! Starts with a random node and adds the node that is farthest away from
+     * all landmarks chosen so far. Nodes unreachable from the landmarks count
+     * as farthest, so each component gets a landmark. */
+    alt_farthest,
+    /*! Avoid (Goldberg and Werneck): Grows a shortest path tree from a random
+     * root and weights each node by how much its distance exceeds the bound of
+     * the current landmarks. The landmark is the leaf reached by descending
+     * from the heaviest subtree without landmarks along the heaviest child. */
+    alt_avoid,
+    /*! Planar (Goldberg and Harrelson) without coordinates: The shortest path
+     * tree from the node of highest degree takes the place of the embedding.
+     * Its depth first order is cut into equally sized sectors and each sector
+     * contributes the node farthest from the center. */
+    alt_planar
+} alt_landmark_strategy;
+
+/*!
+ * Distances between the landmarks and all nodes along the direction of the
+ * preprocessing. Directed graphs need both the distances from and to the
+ * landmarks for tight bounds, undirected ones only the former.
+ *
+ * The distances are stored node major as floats, so a query reads one
+ * contiguous row per node: Row i starts at dists[i * num_sides *
+ * num_landmarks] and contains d(l, v) for all landmarks followed by d(v, l)
+ * for all landmarks if num_sides is 2. Unreachable pairs are INFINITY.
+ */
+typedef struct
+{
+    direction_t    direction;
+    unsigned long  num_landmarks;
+    unsigned long* landmark_ids;
+    /* the snapshot the distances were computed on */
+    unsigned long  n_nodes;
+    unsigned long  n_rels;
+    /* phy_database::generation and phy_database::n_changes of the database
+     * the snapshot was read from, UNINITIALIZED_LONG without one */
+    unsigned long  generation;
+    unsigned long  n_changes;
+    unsigned long* node_ids;
+    /* dense index per node id / NUM_SLOTS_PER_NODE, UNINITIALIZED_LONG for
+     * free slots */
+    unsigned long* index_of;
+    unsigned long  index_bound;
+    unsigned long  num_sides;
+    float*         dists;
+    /* false if some distance is not representable as float. The bounds then
+     * give up the rounding error to remain admissible. */
+    bool exact;
+} alt_landmarks;
+
+/*!
+ * Reads the graph into a snapshot, picks the landmarks with the given
+ * strategy and computes their distances with \ref delta_stepping_csr.
+ */
+alt_landmarks*
+alt_preprocess(heap_file*            hf,
+               direction_t           d,
+               unsigned long         num_landmarks,
+               alt_landmark_strategy strategy,
+               bool                  log,
+               FILE*                 log_file);
+
+alt_landmarks*
+alt_preprocess_csr(const csr_graph*      graph,
+                   direction_t           d,
+                   unsigned long         num_landmarks,
+                   alt_landmark_strategy strategy);
+
+void
+alt_landmarks_destroy(alt_landmarks* landmarks);
+
+/*!
+ * Writes the landmarks and their distances next to the files of the database
+ * \p db_name, i.e. to "<db_name>_landmarks.alt", overwriting a previous
+ * version.
+ */
+void
+alt_landmarks_save(const alt_landmarks* landmarks, const char* db_name);
+
+/*!
+ * Reads the landmarks saved for the database \p db_name. Returns NULL if no
+ * landmarks were saved, if they were saved by another version or if they were
+ * not computed on the current state of the heap file: Its generation, number
+ * of changes, nodes and relationships must match, so any update, delete or
+ * reordering of the records since the preprocessing rejects the file.
+ */
+alt_landmarks*
+alt_landmarks_load(heap_file* hf, const char* db_name);
+
+/*!
+ * Deletes the file written by \ref alt_landmarks_save, if any.
+ */
 void
-alt_preprocess(heap_file*    hf,
-               direction_t   d,
-               unsigned long num_landmarks,
-               dict_ul_d**   landmark_dists,
-               bool          log,
-               FILE*         log_file);
+alt_landmarks_delete_file(const char* db_name);
+
+/*!
+ * A \ref heuristic_fn taking an alt_landmarks as data. Computes
+ * max_l max(d(l, to) - d(l, from), d(from, l) - d(to, l)) from the landmark
+ * distances of the two nodes only, or max_l |d(l, from) - d(l, to)| for
+ * direction BOTH.
+ */
+double
+alt_heuristic(unsigned long from_node_id, unsigned long to_node_id, void* data);
+
+path*
+alt(heap_file*     hf,
+    alt_landmarks* landmarks,
+    unsigned long  source_node_id,
+    unsigned long  target_node_id,
+    bool           log,
+    FILE*          log_file);
+
+/*!
+ * \ref alt with the given heap. The landmark bounds are consistent, so the
+ * radix heap may be used.
+ */
+path*
+alt_pq(heap_file*     hf,
+       alt_landmarks* landmarks,
+       unsigned long  source_node_id,
+       unsigned long  target_node_id,
+       pq_type        queue_type,
+       bool           log,
+       FILE*          log_file);
 
 path*
-alt(heap_file*    hf,
-    dict_ul_d**   landmark_dists,
-    unsigned long num_landmarks,
-    unsigned long source_node_id,
-    unsigned long target_node_id,
-    direction_t   direction,
-    bool          log,
-    FILE*         log_file);
+alt_bidirectional(heap_file*     hf,
+                  alt_landmarks* landmarks,
+                  unsigned long  source_node_id,
+                  unsigned long  target_node_id,
+                  bool           log,
+                  FILE*          log_file);
+
+/*!
+ * \ref alt_bidirectional with the given heap, which may not be the radix heap
+ * as for \ref bidirectional_a_star_pq.
+ */
+path*
+alt_bidirectional_pq(heap_file*     hf,
+                     alt_landmarks* landmarks,
+                     unsigned long  source_node_id,
+                     unsigned long  target_node_id,
+                     pq_type        queue_type,
+                     bool           log,
+                     FILE*          log_file);
 
 #endif
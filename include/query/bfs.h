@@ -13,8 +13,13 @@
 #ifndef BFS_H
 #define BFS_H
 
+#include <stdbool.h>
+#include <stdio.h>
+
 #include "access/heap_file.h"
 #include "access/relationship.h"
+#include "data-struct/htable.h"
+#include "data-struct/linked_list.h"
 #include "result_types.h"
 
 traversal_result*
@@ -24,4 +29,52 @@ bfs(heap_file*    hf,
     bool          log,
     FILE*         log_file);
 
+/*!
+ * Breadth first traversal that returns one node per call instead of numbering
+ * all nodes. Only the nodes reached so far are kept. A node is expanded on the
+ * call after it has been returned, so stopping early saves its expansion.
+ */
+typedef struct
+{
+    heap_file*            hf;
+    direction_t           direction;
+    unsigned long         max_depth;
+    traversal_edge_filter edge_filter;
+    traversal_node_filter node_filter;
+    void*                 filter_data;
+    queue_ul*             queue;
+    dict_ul_ul*           depths;
+    dict_ul_ul*           parents;
+    /* the node returned last, UNINITIALIZED_LONG if there is none to expand */
+    unsigned long pending;
+    bool          log;
+    FILE*         log_file;
+} bfs_cursor;
+
+/*!
+ * Creates a cursor starting at the source. Nodes further than max_depth hops
+ * away are not reached, pass ULONG_MAX for no bound. Both filters may be NULL
+ * to follow all relationships and to return all nodes.
+ */
+bfs_cursor*
+bfs_cursor_create(heap_file*            hf,
+                  unsigned long         source_node_id,
+                  direction_t           direction,
+                  unsigned long         max_depth,
+                  traversal_edge_filter edge_filter,
+                  traversal_node_filter node_filter,
+                  void*                 filter_data,
+                  bool                  log,
+                  FILE*                 log_file);
+
+void
+bfs_cursor_destroy(bfs_cursor* cursor);
+
+/*!
+ * Stores the next node in breadth first order that passes the node filter in
+ * step. Returns false if there is none.
+ */
+bool
+bfs_cursor_next(bfs_cursor* cursor, traversal_step* step);
+
 #endif
@@ -0,0 +1,75 @@
+/*!
+ * \file bidirectional.h
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief Point-to-point shortest path searches that grow one search tree from
+ * the source along the given direction and one from the target along the
+ * reverse direction, stopping once the two frontiers meet.
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#ifndef BIDIRECTIONAL_H
+#define BIDIRECTIONAL_H
+
+#include "access/heap_file.h"
+#include "access/relationship.h"
+#include "query/a-star.h"
+#include "result_types.h"
+
+direction_t
+reverse_direction(direction_t direction);
+
+path*
+dijkstra_p2p(heap_file*    hf,
+             unsigned long source_node_id,
+             unsigned long target_node_id,
+             direction_t   direction,
+             bool          log,
+             FILE*         log_file);
+
+/*!
+ * \ref dijkstra_p2p with the given heap for both searches.
+ */
+path*
+dijkstra_p2p_pq(heap_file*    hf,
+                unsigned long source_node_id,
+                unsigned long target_node_id,
+                direction_t   direction,
+                pq_type       queue_type,
+                bool          log,
+                FILE*         log_file);
+
+/* The heuristic is asked for lower bounds on d(v, target) and d(source, v)
+ * of the touched nodes. Both searches use the average of the two as
+ * potential, which keeps the potentials consistent. */
+path*
+bidirectional_a_star(heap_file*    hf,
+                     heuristic_fn  heuristic,
+                     void*         heuristic_data,
+                     unsigned long source_node_id,
+                     unsigned long target_node_id,
+                     direction_t   direction,
+                     bool          log,
+                     FILE*         log_file);
+
+/*!
+ * \ref bidirectional_a_star with the given heap for both searches. The keys
+ * are shifted by the potentials and may be negative, so the radix heap is not
+ * accepted.
+ */
+path*
+bidirectional_a_star_pq(heap_file*    hf,
+                        heuristic_fn  heuristic,
+                        void*         heuristic_data,
+                        unsigned long source_node_id,
+                        unsigned long target_node_id,
+                        direction_t   direction,
+                        pq_type       queue_type,
+                        bool          log,
+                        FILE*         log_file);
+
+#endif
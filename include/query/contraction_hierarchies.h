@@ -0,0 +1,113 @@
+/*!
+ * \file contraction_hierarchies.h
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief Contraction Hierarchies (Geisberger et al.) for repeated point to
+ * point shortest path queries.
+ *
+ * Preprocessing contracts the nodes one by one in the order of their edge
+ * difference, i.e. the number of shortcuts contracting the node would insert
+ * minus the number of its remaining edges, plus the number of already
+ * contracted neighbours to spread the contraction evenly over the graph.
+ * Priorities are updated lazily when a node is about to be contracted.
+ * Contracting v inserts a shortcut u -> w for every pair of edges u -> v -> w
+ * unless a bounded local search finds a path from u to w that avoids v and is
+ * not longer.
+ *
+ * Shortcuts are kept in a side structure and reference the two edges they
+ * bridge, so the heap file is not modified. A query runs Dijkstra's algorithm
+ * from both ends, each only relaxing edges towards nodes contracted later,
+ * and unpacks the shortcuts of the resulting path into relationship ids.
+ *
+ * The hierarchy is a snapshot: Updates to the heap file require a new
+ * preprocessing. A hierarchy must not be queried from several threads at
+ * once, as the query reuses buffers of the hierarchy.
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#ifndef CONTRACTION_HIERARCHIES_H
+#define CONTRACTION_HIERARCHIES_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "access/csr_graph.h"
+#include "access/heap_file.h"
+#include "access/relationship.h"
+#include "data-struct/d_ary_heap.h"
+#include "result_types.h"
+
+/* Edge references with this bit set index the shortcuts, all others are
+ * relationship ids. */
+#define CH_SHORTCUT_BIT (1UL << 63)
+
+/* Maximum number of nodes a witness search settles before giving up and
+ * inserting the shortcut. */
+#define CH_WITNESS_SETTLE_LIMIT (128)
+
+typedef struct
+{
+    unsigned long head;
+    double        weight;
+    unsigned long edge;
+} ch_arc;
+
+typedef struct
+{
+    unsigned long first;
+    unsigned long second;
+} ch_shortcut;
+
+typedef struct
+{
+    direction_t    direction;
+    unsigned long  n_nodes;
+    unsigned long* node_ids;
+    unsigned long* index_of;
+    unsigned long  index_bound;
+    /* position of each node in the contraction order */
+    unsigned long* rank;
+    /* Edges towards higher ranked nodes. The forward graph contains the edges
+     * u -> w leaving u, the backward graph contains them at w to search
+     * from the target. */
+    unsigned long* up_offsets[2];
+    ch_arc*        up_arcs[2];
+    ch_shortcut*   shortcuts;
+    unsigned long  n_shortcuts;
+    /* query buffers, reset after each query */
+    double*        query_dist[2];
+    unsigned long* query_parent[2];
+    unsigned long* query_edge[2];
+    d_ary_heap*    query_queue[2];
+} contraction_hierarchy;
+
+/*!
+ * Reads the graph into a snapshot and contracts it. Paths follow the given
+ * direction like in \ref dijkstra.
+ */
+contraction_hierarchy*
+ch_preprocess(heap_file* hf, direction_t direction, bool log);
+
+contraction_hierarchy*
+ch_preprocess_csr(const csr_graph* graph, direction_t direction);
+
+void
+ch_destroy(contraction_hierarchy* ch);
+
+/*!
+ * Returns a shortest path from the source to the target whose edges are
+ * relationship ids. The distance is DBL_MAX and the edge list empty if the
+ * target is unreachable.
+ */
+path*
+ch_query(contraction_hierarchy* ch,
+         unsigned long          source_node_id,
+         unsigned long          target_node_id,
+         bool                   log,
+         FILE*                  log_file);
+
+#endif
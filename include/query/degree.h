@@ -3,7 +3,10 @@
  * \version 1.0
  * \date Sep 15, 2021
  * \author Fabian Klopfer <fabian.klopfer@ieee.org>
- * \brief TODO
+ * \brief Degree queries answered from the degree counters of the heap file.
+ * The degree of a node is read from its entry in the degree file, the
+ * aggregates over all nodes use the degree histograms the heap file maintains
+ * and do not access any page.
  *
  * \copyright Copyright (c) 2021- University of Konstanz.
  * This software is the proprietary information of the above-mentioned
@@ -17,7 +20,12 @@
 
 #include "access/heap_file.h"
 #include "access/relationship.h"
+#include "data-struct/array_list.h"
 
+/*!
+ * Returns the number of relationships of the node in the given direction. A
+ * self loop is counted once for BOTH, like in \ref expand.
+ */
 size_t
 get_degree(heap_file*    hf,
            unsigned long node_id,
@@ -26,18 +34,25 @@ get_degree(heap_file*    hf,
            FILE*         log_file);
 
 float
-get_avg_degree(heap_file*  hf,
-               direction_t direction
-
-               ,
-               bool log,
-
-               FILE* log_file);
+get_avg_degree(heap_file* hf, direction_t direction, bool log, FILE* log_file);
 
+/*!
+ * Returns the smallest degree of all nodes, 0 if there are no nodes.
+ */
 size_t
 get_min_degree(heap_file* hf, direction_t direction, bool log, FILE* log_file);
 
 size_t
 get_max_degree(heap_file* hf, direction_t direction, bool log, FILE* log_file);
 
+/*!
+ * Returns the number of nodes with degree i at index i, up to the maximum
+ * degree.
+ */
+array_list_ul*
+get_degree_histogram(heap_file*  hf,
+                     direction_t direction,
+                     bool        log,
+                     FILE*       log_file);
+
 #endif
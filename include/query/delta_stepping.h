@@ -0,0 +1,56 @@
+/*!
+ * \file delta_stepping.h
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief Parallel single source shortest paths by delta-stepping (Meyer and
+ * Sanders). Tentative distances are kept in buckets of width delta. The
+ * buckets are settled in increasing order: first the light edges (weight at
+ * most delta) of the bucket's nodes are relaxed until the bucket stays empty,
+ * then the heavy edges of all nodes removed from it are relaxed once. Each
+ * phase relaxes the edges of its nodes on N_THREADS threads, using atomic
+ * minimum updates on the distances.
+ *
+ * The algorithm runs on a \ref csr_graph.h snapshot, as the page cache can
+ * not be shared between threads. Weights must be non-negative.
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#ifndef DELTA_STEPPING_H
+#define DELTA_STEPPING_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "access/csr_graph.h"
+#include "access/heap_file.h"
+#include "access/relationship.h"
+#include "result_types.h"
+
+/*!
+ * Computes the same result as \ref dijkstra. Reads the graph into a snapshot
+ * first, so the log contains a scan over all nodes and relationships. A delta
+ * of zero or less picks the maximum weight divided by the average degree.
+ */
+sssp_result*
+delta_stepping(heap_file*    hf,
+               unsigned long source_node_id,
+               direction_t   direction,
+               double        delta,
+               bool          log,
+               FILE*         log_file);
+
+/*!
+ * Runs delta-stepping on an existing snapshot, e.g. to compute the distances
+ * from several landmarks after reading the graph only once.
+ */
+sssp_result*
+delta_stepping_csr(const csr_graph* graph,
+                   unsigned long    source_node_id,
+                   direction_t      direction,
+                   double           delta);
+
+#endif
@@ -13,8 +13,13 @@
 #ifndef DFS_H
 #define DFS_H
 
+#include <stdbool.h>
+#include <stdio.h>
+
 #include "access/heap_file.h"
 #include "access/relationship.h"
+#include "data-struct/htable.h"
+#include "data-struct/linked_list.h"
 #include "result_types.h"
 
 traversal_result*
@@ -24,4 +29,42 @@ dfs(heap_file*    hf,
     bool          log,
     FILE*         log_file);
 
+/*!
+ * Depth first counterpart of \ref bfs_cursor, visiting the nodes in the same
+ * order as \ref dfs.
+ */
+typedef struct
+{
+    heap_file*            hf;
+    direction_t           direction;
+    unsigned long         max_depth;
+    traversal_edge_filter edge_filter;
+    traversal_node_filter node_filter;
+    void*                 filter_data;
+    stack_ul*             stack;
+    dict_ul_ul*           depths;
+    dict_ul_ul*           parents;
+    /* the node returned last, UNINITIALIZED_LONG if there is none to expand */
+    unsigned long pending;
+    bool          log;
+    FILE*         log_file;
+} dfs_cursor;
+
+dfs_cursor*
+dfs_cursor_create(heap_file*            hf,
+                  unsigned long         source_node_id,
+                  direction_t           direction,
+                  unsigned long         max_depth,
+                  traversal_edge_filter edge_filter,
+                  traversal_node_filter node_filter,
+                  void*                 filter_data,
+                  bool                  log,
+                  FILE*                 log_file);
+
+void
+dfs_cursor_destroy(dfs_cursor* cursor);
+
+bool
+dfs_cursor_next(dfs_cursor* cursor, traversal_step* step);
+
 #endif
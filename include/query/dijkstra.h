@@ -13,8 +13,13 @@
 #ifndef DIJKSTRA_H
 #define DIJKSTRA_H
 
+#include <stdbool.h>
+#include <stdio.h>
+
 #include "access/heap_file.h"
 #include "access/relationship.h"
+#include "data-struct/htable.h"
+#include "data-struct/priority_queue.h"
 #include "result_types.h"
 
 sssp_result*
@@ -24,4 +29,58 @@ dijkstra(heap_file*    hf,
          bool          log,
          FILE*         log_file);
 
+sssp_result*
+dijkstra_pq(heap_file*    hf,
+            unsigned long source_node_id,
+            direction_t   direction,
+            pq_type       queue_type,
+            bool          log,
+            FILE*         log_file);
+
+/*!
+ * Returns the nodes one by one in the order of their distance from the
+ * source, e.g. to find the nearest node with some property without settling
+ * the whole graph. Like \ref bfs_cursor, a node is expanded on the call after
+ * it has been returned.
+ */
+typedef struct
+{
+    heap_file*            hf;
+    direction_t           direction;
+    double                max_distance;
+    traversal_edge_filter edge_filter;
+    traversal_node_filter node_filter;
+    void*                 filter_data;
+    priority_queue*       queue;
+    dict_ul_d*            distances;
+    dict_ul_ul*           depths;
+    dict_ul_ul*           parents;
+    /* the node returned last, UNINITIALIZED_LONG if there is none to expand */
+    unsigned long pending;
+    bool          log;
+    FILE*         log_file;
+} dijkstra_cursor;
+
+/*!
+ * Creates a cursor starting at the source. Nodes further away than
+ * max_distance are not reached, pass DBL_MAX for no bound. Both filters may be
+ * NULL.
+ */
+dijkstra_cursor*
+dijkstra_cursor_create(heap_file*            hf,
+                       unsigned long         source_node_id,
+                       direction_t           direction,
+                       double                max_distance,
+                       traversal_edge_filter edge_filter,
+                       traversal_node_filter node_filter,
+                       void*                 filter_data,
+                       bool                  log,
+                       FILE*                 log_file);
+
+void
+dijkstra_cursor_destroy(dijkstra_cursor* cursor);
+
+bool
+dijkstra_cursor_next(dijkstra_cursor* cursor, traversal_step* step);
+
 #endif
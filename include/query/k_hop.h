@@ -0,0 +1,63 @@
+/*!
+ * \file k_hop.h
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief Bounded neighbourhoods of a set of nodes. The traversal proceeds level
+ * by level and marks reached nodes in a bitset over the node slots, so that
+ * every node is reported once at the hop it is reached first. Each level is
+ * sorted by id and thus by page before it is expanded, such that the node
+ * pages are read in order and nodes sharing a page are handled together.
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#ifndef K_HOP_H
+#define K_HOP_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "access/heap_file.h"
+#include "access/relationship.h"
+#include "constants.h"
+#include "data-struct/array_list.h"
+
+/* Disables the relationship or node label filter of \ref k_hop */
+#define K_HOP_ANY_LABEL (UNINITIALIZED_LONG)
+
+/*!
+ * hops[i] holds the ids of the nodes first reached after i hops in ascending
+ * order, hops[0] the distinct sources.
+ */
+typedef struct
+{
+    unsigned long   k;
+    array_list_ul** hops;
+} k_hop_result;
+
+/*!
+ * Computes the nodes within k hops of the sources. Only relationships with
+ * the label rel_label_filter are followed and only nodes with the label
+ * node_label_filter are reached, i.e. reported and expanded further. Pass
+ * K_HOP_ANY_LABEL to disable either filter. The sources are not filtered.
+ * A k larger than the number of nodes is reduced to it, which is reflected in
+ * the k of the result.
+ */
+k_hop_result*
+k_hop(heap_file*           hf,
+      const unsigned long* source_node_ids,
+      size_t               num_sources,
+      unsigned long        k,
+      direction_t          direction,
+      unsigned long        rel_label_filter,
+      unsigned long        node_label_filter,
+      bool                 log,
+      FILE*                log_file);
+
+void
+k_hop_result_destroy(k_hop_result* result);
+
+#endif
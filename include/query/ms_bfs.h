@@ -0,0 +1,37 @@
+/*!
+ * \file ms_bfs.h
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief Multi-source breadth-first search. Runs up to MS_BFS_BATCH_SIZE BFS
+ * instances concurrently by keeping one bit per source in a bitset per
+ * vertex, so that every expand of a vertex is shared across all sources that
+ * reach the vertex in the same level.
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#ifndef MS_BFS_H
+#define MS_BFS_H
+
+#include <limits.h>
+
+#include "access/heap_file.h"
+#include "access/relationship.h"
+#include "result_types.h"
+
+#define MS_BFS_WORD_BITS  (sizeof(unsigned long) * CHAR_BIT)
+#define MS_BFS_WORDS      (4)
+#define MS_BFS_BATCH_SIZE (MS_BFS_WORDS * MS_BFS_WORD_BITS)
+
+traversal_result**
+ms_bfs(heap_file*           hf,
+       const unsigned long* source_node_ids,
+       size_t               num_sources,
+       direction_t          direction,
+       bool                 log,
+       FILE*                log_file);
+
+#endif
@@ -3,7 +3,13 @@
  * \version 1.0
  * \date Sep 15, 2021
  * \author Fabian Klopfer <fabian.klopfer@ieee.org>
- * \brief TODO
+ * \brief Random walks. \ref random_walk performs a single walk on the heap
+ * file. \ref random_walks runs a batch of walks in parallel on a \ref
+ * csr_graph.h snapshot, e.g. to generate training data for node embeddings.
+ * There a neighbour is sampled by drawing an offset below the degree, so no
+ * adjacency list is materialized. Each walk draws from its own generator,
+ * seeded from the batch seed and the index of the walk, so the walks do not
+ * depend on the number of threads.
  *
  * \copyright Copyright (c) 2021- University of Konstanz.
  * This software is the proprietary information of the above-mentioned
@@ -13,8 +19,11 @@
 #ifndef RANDOM_WALK_H
 #define RANDOM_WALK_H
 
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdio.h>
 
+#include "access/csr_graph.h"
 #include "access/heap_file.h"
 #include "access/relationship.h"
 #include "result_types.h"
@@ -27,4 +36,67 @@ random_walk(heap_file*    hf,
             bool          log,
             FILE*         log_file);
 
+/*!
+ * The transition probabilities of the walks in a batch.
+ */
+typedef enum
+{
+    /*! All incident edges are equally likely. */
+    uniform_walk = 0,
+    /*! Edges are chosen proportional to their weight, using an alias table
+     * per node. Nodes whose edges all weigh zero are left uniformly. */
+    weighted_walk = 1,
+    /*! The second order walk of node2vec (Grover and Leskovec): The weight
+     * of an edge to x is multiplied by 1/p if x is the previous node, by 1 if
+     * x is adjacent to the previous node and by 1/q otherwise. Sampled by
+     * rejection from the weighted walk. */
+    node2vec_walk = 2,
+    /*! Used to validate parameters. */
+    invalid_walk = 3
+} walk_type;
+
+/*!
+ * Walk i visits the node ids nodes[i * (walk_length + 1)] to
+ * nodes[(i + 1) * (walk_length + 1) - 1], starting with its start node. A walk
+ * that reaches a node without edges ends there, the remaining entries are
+ * UNINITIALIZED_LONG.
+ */
+typedef struct
+{
+    size_t         num_walks;
+    size_t         walk_length;
+    unsigned long* nodes;
+} walk_batch;
+
+/*!
+ * Reads the graph into a snapshot and runs one walk of walk_length steps from
+ * each start node. The parameters p and q are only used by node2vec_walk.
+ */
+walk_batch*
+random_walks(heap_file*           hf,
+             const unsigned long* start_node_ids,
+             size_t               num_walks,
+             size_t               walk_length,
+             direction_t          direction,
+             walk_type            type,
+             double               p,
+             double               q,
+             unsigned long        seed,
+             bool                 log,
+             FILE*                log_file);
+
+walk_batch*
+random_walks_csr(const csr_graph*     graph,
+                 const unsigned long* start_node_ids,
+                 size_t               num_walks,
+                 size_t               walk_length,
+                 direction_t          direction,
+                 walk_type            type,
+                 double               p,
+                 double               q,
+                 unsigned long        seed);
+
+void
+walk_batch_destroy(walk_batch* batch);
+
 #endif
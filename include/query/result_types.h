@@ -13,7 +13,10 @@
 #ifndef RESULT_TYPES_H
 #define RESULT_TYPES_H
 
+#include <stdbool.h>
+
 #include "access/heap_file.h"
+#include "access/relationship.h"
 #include "data-struct/array_list.h"
 #include "data-struct/htable.h"
 
@@ -39,6 +42,33 @@ typedef struct path
     array_list_ul* edges;
 } path;
 
+/*!
+ * A node reached by a traversal cursor. The depth is the number of hops on the
+ * path the cursor found, the distance is its weight for dijkstra and equals
+ * the depth otherwise. The parent edge is UNINITIALIZED_LONG for the source.
+ */
+typedef struct traversal_step
+{
+    unsigned long node_id;
+    unsigned long depth;
+    double        distance;
+    unsigned long parent_edge;
+} traversal_step;
+
+/*!
+ * Decides if a cursor follows the relationship from the node with the given
+ * id. The relationship is only valid during the call.
+ */
+typedef bool (*traversal_edge_filter)(const relationship_t* rel,
+                                      unsigned long         from_node_id,
+                                      void*                 data);
+
+/*!
+ * Decides if a cursor returns the reached node. Nodes that are not returned
+ * are traversed nonetheless.
+ */
+typedef bool (*traversal_node_filter)(const traversal_step* step, void* data);
+
 traversal_result*
 create_traversal_result(unsigned long source_node,
                         dict_ul_ul*   traversal_numbers,
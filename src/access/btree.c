@@ -0,0 +1,680 @@
+/*!
+ * \file btree.c
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief See \ref btree.h
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "access/btree.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "constants.h"
+#include "page.h"
+#include "page_cache.h"
+#include "physical_database.h"
+#include "strace.h"
+
+/* Page 0 is the meta page, so no node ever has page number 0. */
+#define NO_PAGE (0UL)
+
+enum
+{
+    root_field,
+    height_field,
+    count_field,
+    num_meta_fields
+};
+
+enum
+{
+    leaf_field,
+    num_keys_field,
+    sibling_field
+};
+
+static void
+read_meta(page_cache* pc, file_type ft, unsigned long* meta, bool log)
+{
+    if (pc->pdb->records[ft]->num_pages == 0) {
+        for (size_t i = 0; i < num_meta_fields; ++i) {
+            meta[i] = 0;
+        }
+        return;
+    }
+
+    page* meta_page = pin_page(pc, 0, records, ft, log);
+    for (size_t i = 0; i < num_meta_fields; ++i) {
+        meta[i] = read_ulong(meta_page, i * sizeof(unsigned long));
+    }
+    unpin_page(pc, 0, records, ft, log);
+}
+
+static void
+write_meta(page_cache* pc, file_type ft, const unsigned long* meta, bool log)
+{
+    if (pc->pdb->records[ft]->num_pages == 0) {
+        allocate_pages(pc->pdb, ft, 1, log);
+    }
+
+    page* meta_page = pin_page(pc, 0, records, ft, log);
+    for (size_t i = 0; i < num_meta_fields; ++i) {
+        write_ulong(meta_page, i * sizeof(unsigned long), meta[i]);
+    }
+    unpin_page(pc, 0, records, ft, log);
+}
+
+static unsigned long
+header_field(page* node, size_t field)
+{
+    return read_ulong(node, field * sizeof(unsigned long));
+}
+
+static void
+set_header_field(page* node, size_t field, unsigned long value)
+{
+    write_ulong(node, field * sizeof(unsigned long), value);
+}
+
+static bool
+is_leaf(page* node)
+{
+    return header_field(node, leaf_field) != 0;
+}
+
+static size_t
+num_keys(page* node)
+{
+    return header_field(node, num_keys_field);
+}
+
+static size_t
+capacity(page* node)
+{
+    return is_leaf(node) ? BTREE_LEAF_CAPACITY : BTREE_INNER_CAPACITY;
+}
+
+static unsigned long
+key_at(page* node, size_t i)
+{
+    return read_ulong(node, BTREE_NODE_HEADER_SIZE + i * sizeof(unsigned long));
+}
+
+static void
+set_key_at(page* node, size_t i, unsigned long key)
+{
+    write_ulong(node, BTREE_NODE_HEADER_SIZE + i * sizeof(unsigned long), key);
+}
+
+/* The values of a leaf and the children of an inner node follow the keys. */
+static size_t
+value_offset(page* node, size_t i)
+{
+    return BTREE_NODE_HEADER_SIZE
+           + (capacity(node) + i) * sizeof(unsigned long);
+}
+
+static unsigned long
+value_at(page* node, size_t i)
+{
+    return read_ulong(node, value_offset(node, i));
+}
+
+static void
+set_value_at(page* node, size_t i, unsigned long value)
+{
+    write_ulong(node, value_offset(node, i), value);
+}
+
+static page*
+new_node(page_cache* pc, file_type ft, bool leaf, bool log)
+{
+    page* node = new_page(pc, ft, log);
+    set_header_field(node, leaf_field, leaf);
+    set_header_field(node, num_keys_field, 0);
+    set_header_field(node, sibling_field, NO_PAGE);
+
+    return node;
+}
+
+/* Returns the number of keys that are less than \p key. */
+static size_t
+lower_bound(page* node, unsigned long key)
+{
+    size_t low  = 0;
+    size_t high = num_keys(node);
+    size_t mid;
+
+    while (low < high) {
+        mid = low + (high - low) / 2;
+        if (key_at(node, mid) < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+/* Returns the index of the child of an inner node that covers \p key, i.e.
+ * the number of separators that are less than or equal to it. */
+static size_t
+child_index(page* node, unsigned long key)
+{
+    size_t i = lower_bound(node, key);
+
+    return i < num_keys(node) && key_at(node, i) == key ? i + 1 : i;
+}
+
+/* Descends from the root to the leaf that covers \p key, releasing each node
+ * after its child is pinned. Returns the page number of the pinned leaf. */
+static unsigned long
+find_leaf(page_cache*   pc,
+          file_type     ft,
+          unsigned long root,
+          unsigned long key,
+          page**        leaf,
+          bool          log)
+{
+    unsigned long page_no = root;
+    page*         node    = pin_page(pc, page_no, records, ft, log);
+    unsigned long child_no;
+
+    while (!is_leaf(node)) {
+        child_no = value_at(node, child_index(node, key));
+        page* child = pin_page(pc, child_no, records, ft, log);
+        unpin_page(pc, page_no, records, ft, log);
+
+        page_no = child_no;
+        node    = child;
+    }
+
+    *leaf = node;
+    return page_no;
+}
+
+/* Splits the full child at index \p i of \p parent, which is not full, and
+ * adds the separator and the new right half to the parent. */
+static void
+split_child(page_cache* pc, file_type ft, page* parent, size_t i, bool log)
+{
+    unsigned long child_no = value_at(parent, i);
+    page*         child    = pin_page(pc, child_no, records, ft, log);
+    bool          leaf     = is_leaf(child);
+    page*         right    = new_node(pc, ft, leaf, log);
+    unsigned long right_no = pc->pdb->records[ft]->num_pages - 1;
+    size_t        n        = num_keys(child);
+    size_t        mid      = n / 2;
+    unsigned long separator;
+
+    if (leaf) {
+        // The right leaf starts with the separator
+        separator = key_at(child, mid);
+        for (size_t j = mid; j < n; ++j) {
+            set_key_at(right, j - mid, key_at(child, j));
+            set_value_at(right, j - mid, value_at(child, j));
+        }
+        set_header_field(right, num_keys_field, n - mid);
+        set_header_field(child, num_keys_field, mid);
+    } else {
+        // The separator moves up and is not kept in either half
+        separator = key_at(child, mid);
+        for (size_t j = mid + 1; j < n; ++j) {
+            set_key_at(right, j - mid - 1, key_at(child, j));
+        }
+        for (size_t j = mid + 1; j <= n; ++j) {
+            set_value_at(right, j - mid - 1, value_at(child, j));
+        }
+        set_header_field(right, num_keys_field, n - mid - 1);
+        set_header_field(child, num_keys_field, mid);
+    }
+
+    set_header_field(
+          right, sibling_field, header_field(child, sibling_field));
+    set_header_field(child, sibling_field, right_no);
+
+    size_t parent_keys = num_keys(parent);
+    for (size_t j = parent_keys; j > i; --j) {
+        set_key_at(parent, j, key_at(parent, j - 1));
+        set_value_at(parent, j + 1, value_at(parent, j));
+    }
+    set_key_at(parent, i, separator);
+    set_value_at(parent, i + 1, right_no);
+    set_header_field(parent, num_keys_field, parent_keys + 1);
+
+    unpin_page(pc, right_no, records, ft, log);
+    unpin_page(pc, child_no, records, ft, log);
+}
+
+static bool
+is_full(page_cache* pc, file_type ft, unsigned long page_no, bool log)
+{
+    page* node = pin_page(pc, page_no, records, ft, log);
+    bool  full = num_keys(node) == capacity(node);
+    unpin_page(pc, page_no, records, ft, log);
+
+    return full;
+}
+
+void
+btree_insert(page_cache*   pc,
+             file_type     ft,
+             unsigned long key,
+             unsigned long value,
+             bool          log)
+{
+    if (!pc || ft < NUM_SLOTTED_FILE_TYPES || ft >= invalid_ft) {
+        // LCOV_EXCL_START
+        printf("btree - insert: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    unsigned long meta[num_meta_fields];
+    read_meta(pc, ft, meta, log);
+
+    if (meta[root_field] == NO_PAGE) {
+        // Allocates the meta page first, so that no node lands on page 0
+        write_meta(pc, ft, meta, log);
+        new_node(pc, ft, true, log);
+        meta[root_field]   = pc->pdb->records[ft]->num_pages - 1;
+        meta[height_field] = 1;
+        unpin_page(pc, meta[root_field], records, ft, log);
+    } else if (is_full(pc, ft, meta[root_field], log)) {
+        page* root = new_node(pc, ft, false, log);
+        set_value_at(root, 0, meta[root_field]);
+        meta[root_field] = pc->pdb->records[ft]->num_pages - 1;
+        meta[height_field]++;
+        split_child(pc, ft, root, 0, log);
+        unpin_page(pc, meta[root_field], records, ft, log);
+    }
+
+    unsigned long page_no = meta[root_field];
+    page*         node    = pin_page(pc, page_no, records, ft, log);
+    unsigned long child_no;
+    page*         child;
+    size_t        i;
+
+    // Splits full children before entering them, so the parent never overflows
+    while (!is_leaf(node)) {
+        i        = child_index(node, key);
+        child_no = value_at(node, i);
+
+        if (is_full(pc, ft, child_no, log)) {
+            split_child(pc, ft, node, i, log);
+            i        = child_index(node, key);
+            child_no = value_at(node, i);
+        }
+
+        child = pin_page(pc, child_no, records, ft, log);
+        unpin_page(pc, page_no, records, ft, log);
+        page_no = child_no;
+        node    = child;
+    }
+
+    size_t n   = num_keys(node);
+    size_t pos = lower_bound(node, key);
+
+    if (pos < n && key_at(node, pos) == key) {
+        set_value_at(node, pos, value);
+        unpin_page(pc, page_no, records, ft, log);
+        write_meta(pc, ft, meta, log);
+        return;
+    }
+
+    for (size_t j = n; j > pos; --j) {
+        set_key_at(node, j, key_at(node, j - 1));
+        set_value_at(node, j, value_at(node, j - 1));
+    }
+    set_key_at(node, pos, key);
+    set_value_at(node, pos, value);
+    set_header_field(node, num_keys_field, n + 1);
+    unpin_page(pc, page_no, records, ft, log);
+
+    meta[count_field]++;
+    write_meta(pc, ft, meta, log);
+}
+
+bool
+btree_remove(page_cache* pc, file_type ft, unsigned long key, bool log)
+{
+    if (!pc || ft < NUM_SLOTTED_FILE_TYPES || ft >= invalid_ft) {
+        // LCOV_EXCL_START
+        printf("btree - remove: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    unsigned long meta[num_meta_fields];
+    read_meta(pc, ft, meta, log);
+
+    if (meta[root_field] == NO_PAGE) {
+        return false;
+    }
+
+    page*         leaf;
+    unsigned long page_no =
+          find_leaf(pc, ft, meta[root_field], key, &leaf, log);
+    size_t        n       = num_keys(leaf);
+    size_t        pos     = lower_bound(leaf, key);
+
+    if (pos == n || key_at(leaf, pos) != key) {
+        unpin_page(pc, page_no, records, ft, log);
+        return false;
+    }
+
+    for (size_t j = pos; j + 1 < n; ++j) {
+        set_key_at(leaf, j, key_at(leaf, j + 1));
+        set_value_at(leaf, j, value_at(leaf, j + 1));
+    }
+    set_header_field(leaf, num_keys_field, n - 1);
+    unpin_page(pc, page_no, records, ft, log);
+
+    meta[count_field]--;
+    write_meta(pc, ft, meta, log);
+
+    return true;
+}
+
+unsigned long
+btree_find(page_cache* pc, file_type ft, unsigned long key, bool log)
+{
+    if (!pc || ft < NUM_SLOTTED_FILE_TYPES || ft >= invalid_ft) {
+        // LCOV_EXCL_START
+        printf("btree - find: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    unsigned long meta[num_meta_fields];
+    read_meta(pc, ft, meta, log);
+
+    if (meta[root_field] == NO_PAGE) {
+        return UNINITIALIZED_LONG;
+    }
+
+    page*         leaf;
+    unsigned long page_no =
+          find_leaf(pc, ft, meta[root_field], key, &leaf, log);
+    size_t        pos     = lower_bound(leaf, key);
+    unsigned long value   = pos < num_keys(leaf) && key_at(leaf, pos) == key
+                                  ? value_at(leaf, pos)
+                                  : UNINITIALIZED_LONG;
+    unpin_page(pc, page_no, records, ft, log);
+
+    return value;
+}
+
+/* Distributes \p n items evenly over nodes holding at most \p per_node items
+ * each and returns the number of nodes. */
+static size_t
+num_nodes_for(size_t n, size_t per_node)
+{
+    return (n + per_node - 1) / per_node;
+}
+
+void
+btree_bulk_load(page_cache*          pc,
+                file_type            ft,
+                const unsigned long* keys,
+                const unsigned long* values,
+                size_t               n_entries,
+                bool                 log)
+{
+    if (!pc || ft < NUM_SLOTTED_FILE_TYPES || ft >= invalid_ft
+        || pc->pdb->records[ft]->num_pages != 0
+        || (n_entries > 0 && (!keys || !values))) {
+        // LCOV_EXCL_START
+        printf("btree - bulk load: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    for (size_t i = 1; i < n_entries; ++i) {
+        if (keys[i - 1] >= keys[i]) {
+            // LCOV_EXCL_START
+            printf("btree - bulk load: Keys are not strictly increasing at "
+                   "%lu!\n",
+                   i);
+            print_trace();
+
+            exit(EXIT_FAILURE);
+            // LCOV_EXCL_STOP
+        }
+    }
+
+    unsigned long meta[num_meta_fields] = { NO_PAGE, 0, n_entries };
+    write_meta(pc, ft, meta, log);
+
+    if (n_entries == 0) {
+        return;
+    }
+
+    // The pages and smallest keys of the nodes of the current level
+    size_t leaf_fill = (size_t)((double)BTREE_LEAF_CAPACITY
+                                * BTREE_BULK_LOAD_FILL);
+    size_t n_level   = num_nodes_for(n_entries, leaf_fill);
+    unsigned long* level_pages = malloc(n_level * sizeof(unsigned long));
+    unsigned long* level_keys  = malloc(n_level * sizeof(unsigned long));
+
+    if (!level_pages || !level_keys) {
+        // LCOV_EXCL_START
+        printf("btree - bulk load: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    size_t        next = 0;
+    size_t        n_in_node;
+    page*         node;
+    unsigned long page_no;
+    for (size_t i = 0; i < n_level; ++i) {
+        n_in_node = n_entries / n_level + (i < n_entries % n_level);
+        node      = new_node(pc, ft, true, log);
+        page_no   = pc->pdb->records[ft]->num_pages - 1;
+
+        for (size_t j = 0; j < n_in_node; ++j) {
+            set_key_at(node, j, keys[next + j]);
+            set_value_at(node, j, values[next + j]);
+        }
+        set_header_field(node, num_keys_field, n_in_node);
+        set_header_field(
+              node, sibling_field, i + 1 < n_level ? page_no + 1 : NO_PAGE);
+        unpin_page(pc, page_no, records, ft, log);
+
+        level_pages[i] = page_no;
+        level_keys[i]  = keys[next];
+        next += n_in_node;
+    }
+
+    size_t inner_fill = (size_t)((double)(BTREE_INNER_CAPACITY + 1)
+                                 * BTREE_BULK_LOAD_FILL);
+    size_t height     = 1;
+    size_t n_upper;
+    size_t child;
+    while (n_level > 1) {
+        n_upper = num_nodes_for(n_level, inner_fill);
+        child   = 0;
+
+        for (size_t i = 0; i < n_upper; ++i) {
+            n_in_node = n_level / n_upper + (i < n_level % n_upper);
+            node      = new_node(pc, ft, false, log);
+            page_no   = pc->pdb->records[ft]->num_pages - 1;
+
+            set_value_at(node, 0, level_pages[child]);
+            for (size_t j = 1; j < n_in_node; ++j) {
+                set_key_at(node, j - 1, level_keys[child + j]);
+                set_value_at(node, j, level_pages[child + j]);
+            }
+            set_header_field(node, num_keys_field, n_in_node - 1);
+            set_header_field(node,
+                             sibling_field,
+                             i + 1 < n_upper ? page_no + 1 : NO_PAGE);
+            unpin_page(pc, page_no, records, ft, log);
+
+            // The levels are built in place, as i never exceeds child
+            level_keys[i]  = level_keys[child];
+            level_pages[i] = page_no;
+            child += n_in_node;
+        }
+
+        n_level = n_upper;
+        height++;
+    }
+
+    meta[root_field]   = level_pages[0];
+    meta[height_field] = height;
+    write_meta(pc, ft, meta, log);
+
+    free(level_pages);
+    free(level_keys);
+}
+
+unsigned long
+btree_size(page_cache* pc, file_type ft, bool log)
+{
+    if (!pc || ft < NUM_SLOTTED_FILE_TYPES || ft >= invalid_ft) {
+        // LCOV_EXCL_START
+        printf("btree - size: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    unsigned long meta[num_meta_fields];
+    read_meta(pc, ft, meta, log);
+
+    return meta[count_field];
+}
+
+unsigned long
+btree_height(page_cache* pc, file_type ft, bool log)
+{
+    if (!pc || ft < NUM_SLOTTED_FILE_TYPES || ft >= invalid_ft) {
+        // LCOV_EXCL_START
+        printf("btree - height: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    unsigned long meta[num_meta_fields];
+    read_meta(pc, ft, meta, log);
+
+    return meta[height_field];
+}
+
+btree_iterator*
+btree_range(page_cache*   pc,
+            file_type     ft,
+            unsigned long low,
+            unsigned long high,
+            bool          log)
+{
+    if (!pc || ft < NUM_SLOTTED_FILE_TYPES || ft >= invalid_ft) {
+        // LCOV_EXCL_START
+        printf("btree - range: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    btree_iterator* it = malloc(sizeof(btree_iterator));
+
+    if (!it) {
+        // LCOV_EXCL_START
+        printf("btree - range: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    it->pc      = pc;
+    it->ft      = ft;
+    it->page_no = NO_PAGE;
+    it->pos     = 0;
+    it->high    = high;
+    it->log     = log;
+
+    unsigned long meta[num_meta_fields];
+    read_meta(pc, ft, meta, log);
+
+    if (meta[root_field] == NO_PAGE || low > high) {
+        return it;
+    }
+
+    page* leaf;
+    it->page_no = find_leaf(pc, ft, meta[root_field], low, &leaf, log);
+    it->pos     = lower_bound(leaf, low);
+    unpin_page(pc, it->page_no, records, ft, log);
+
+    return it;
+}
+
+bool
+btree_iterator_next(btree_iterator* it,
+                    unsigned long*  key,
+                    unsigned long*  value)
+{
+    if (!it || !key || !value) {
+        // LCOV_EXCL_START
+        printf("btree - iterator next: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    page*         leaf;
+    unsigned long page_no;
+    while (it->page_no != NO_PAGE) {
+        page_no = it->page_no;
+        leaf    = pin_page(it->pc, page_no, records, it->ft, it->log);
+
+        if (it->pos < num_keys(leaf)) {
+            *key   = key_at(leaf, it->pos);
+            *value = value_at(leaf, it->pos);
+            it->pos++;
+            unpin_page(it->pc, page_no, records, it->ft, it->log);
+
+            if (*key > it->high) {
+                it->page_no = NO_PAGE;
+                return false;
+            }
+            return true;
+        }
+
+        it->page_no = header_field(leaf, sibling_field);
+        it->pos     = 0;
+        unpin_page(it->pc, page_no, records, it->ft, it->log);
+    }
+
+    return false;
+}
+
+void
+btree_iterator_destroy(btree_iterator* it)
+{
+    free(it);
+}
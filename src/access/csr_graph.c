@@ -0,0 +1,249 @@
+/*!
+ * \file csr_graph.c
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief See \ref csr_graph.h
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "access/csr_graph.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "access/node.h"
+#include "constants.h"
+#include "data-struct/array_list.h"
+#include "strace.h"
+
+static int
+csr_edge_compare(const void* a, const void* b)
+{
+    const csr_edge* edge_a = a;
+    const csr_edge* edge_b = b;
+
+    if (edge_a->neighbour != edge_b->neighbour) {
+        return edge_a->neighbour < edge_b->neighbour ? -1 : 1;
+    }
+
+    if (edge_a->rel_id != edge_b->rel_id) {
+        return edge_a->rel_id < edge_b->rel_id ? -1 : 1;
+    }
+
+    return 0;
+}
+
+csr_graph*
+csr_graph_create(heap_file* hf, bool log)
+{
+    if (!hf) {
+        // LCOV_EXCL_START
+        printf("csr graph - create: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    csr_graph* graph = malloc(sizeof(csr_graph));
+
+    if (!graph) {
+        // LCOV_EXCL_START
+        printf("csr graph - create: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    array_list_node*         nodes = get_nodes(hf, log);
+    array_list_relationship* rels  = get_relationships(hf, log);
+
+    graph->n_nodes     = array_list_node_size(nodes);
+    graph->n_rels      = array_list_relationship_size(rels);
+    graph->index_bound = hf->cache->pdb->records[node_ft]->num_pages
+                         * SLOTS_PER_PAGE / NUM_SLOTS_PER_NODE;
+
+    graph->node_ids    = malloc(graph->n_nodes * sizeof(unsigned long));
+    graph->node_labels = malloc(graph->n_nodes * sizeof(unsigned long));
+    graph->index_of    = malloc(graph->index_bound * sizeof(unsigned long));
+
+    for (size_t d = 0; d < 2; ++d) {
+        graph->offsets[d] = calloc(graph->n_nodes + 1, sizeof(unsigned long));
+        graph->edges[d]   = malloc(graph->n_rels * sizeof(csr_edge));
+    }
+
+    if ((graph->n_nodes > 0 && (!graph->node_ids || !graph->node_labels))
+        || (graph->index_bound > 0 && !graph->index_of)
+        || !graph->offsets[OUTGOING] || !graph->offsets[INCOMING]
+        || (graph->n_rels > 0
+            && (!graph->edges[OUTGOING] || !graph->edges[INCOMING]))) {
+        // LCOV_EXCL_START
+        printf("csr graph - create: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    for (size_t i = 0; i < graph->index_bound; ++i) {
+        graph->index_of[i] = UNINITIALIZED_LONG;
+    }
+
+    node_t* node;
+    for (size_t i = 0; i < graph->n_nodes; ++i) {
+        node                  = array_list_node_get(nodes, i);
+        graph->node_ids[i]    = node->id;
+        graph->node_labels[i] = node->label;
+
+        graph->index_of[node->id / NUM_SLOTS_PER_NODE] = i;
+    }
+
+    array_list_node_destroy(nodes);
+
+    // Count the degrees, turn them into offsets and scatter the edges into
+    // their rows. Each row is sorted afterwards.
+    relationship_t* rel;
+    unsigned long   src;
+    unsigned long   tgt;
+    for (size_t i = 0; i < graph->n_rels; ++i) {
+        rel = array_list_relationship_get(rels, i);
+        src = graph->index_of[rel->source_node / NUM_SLOTS_PER_NODE];
+        tgt = graph->index_of[rel->target_node / NUM_SLOTS_PER_NODE];
+
+        graph->offsets[OUTGOING][src + 1]++;
+        graph->offsets[INCOMING][tgt + 1]++;
+    }
+
+    for (size_t d = 0; d < 2; ++d) {
+        for (size_t i = 0; i < graph->n_nodes; ++i) {
+            graph->offsets[d][i + 1] += graph->offsets[d][i];
+        }
+    }
+
+    unsigned long* fill[2] = { malloc(graph->n_nodes * sizeof(unsigned long)),
+                               malloc(graph->n_nodes * sizeof(unsigned long)) };
+
+    if (graph->n_nodes > 0 && (!fill[OUTGOING] || !fill[INCOMING])) {
+        // LCOV_EXCL_START
+        printf("csr graph - create: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    for (size_t d = 0; d < 2; ++d) {
+        for (size_t i = 0; i < graph->n_nodes; ++i) {
+            fill[d][i] = graph->offsets[d][i];
+        }
+    }
+
+    csr_edge* edge;
+    for (size_t i = 0; i < graph->n_rels; ++i) {
+        rel = array_list_relationship_get(rels, i);
+        src = graph->index_of[rel->source_node / NUM_SLOTS_PER_NODE];
+        tgt = graph->index_of[rel->target_node / NUM_SLOTS_PER_NODE];
+
+        edge            = &graph->edges[OUTGOING][fill[OUTGOING][src]++];
+        edge->neighbour = tgt;
+        edge->rel_id    = rel->id;
+        edge->weight    = rel->weight;
+
+        edge            = &graph->edges[INCOMING][fill[INCOMING][tgt]++];
+        edge->neighbour = src;
+        edge->rel_id    = rel->id;
+        edge->weight    = rel->weight;
+    }
+
+    free(fill[OUTGOING]);
+    free(fill[INCOMING]);
+    array_list_relationship_destroy(rels);
+
+    for (size_t d = 0; d < 2; ++d) {
+        for (size_t i = 0; i < graph->n_nodes; ++i) {
+            qsort(graph->edges[d] + graph->offsets[d][i],
+                  graph->offsets[d][i + 1] - graph->offsets[d][i],
+                  sizeof(csr_edge),
+                  csr_edge_compare);
+        }
+    }
+
+    return graph;
+}
+
+void
+csr_graph_destroy(csr_graph* graph)
+{
+    if (!graph) {
+        // LCOV_EXCL_START
+        printf("csr graph - destroy: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    for (size_t d = 0; d < 2; ++d) {
+        free(graph->offsets[d]);
+        free(graph->edges[d]);
+    }
+
+    free(graph->node_ids);
+    free(graph->node_labels);
+    free(graph->index_of);
+    free(graph);
+}
+
+unsigned long
+csr_graph_index(const csr_graph* graph, unsigned long node_id)
+{
+    if (!graph) {
+        // LCOV_EXCL_START
+        printf("csr graph - index: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    if (node_id == UNINITIALIZED_LONG
+        || node_id / NUM_SLOTS_PER_NODE >= graph->index_bound) {
+        return UNINITIALIZED_LONG;
+    }
+
+    return graph->index_of[node_id / NUM_SLOTS_PER_NODE];
+}
+
+unsigned long
+csr_graph_degree(const csr_graph* graph,
+                 unsigned long    node_idx,
+                 direction_t      direction)
+{
+    if (!graph || node_idx >= graph->n_nodes || direction > BOTH) {
+        // LCOV_EXCL_START
+        printf("csr graph - degree: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    unsigned long degree = 0;
+
+    if (direction != INCOMING) {
+        degree += graph->offsets[OUTGOING][node_idx + 1]
+                  - graph->offsets[OUTGOING][node_idx];
+    }
+
+    if (direction != OUTGOING) {
+        degree += graph->offsets[INCOMING][node_idx + 1]
+                  - graph->offsets[INCOMING][node_idx];
+    }
+
+    return degree;
+}
@@ -0,0 +1,381 @@
+/*!
+ * \file hash_index.c
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief See \ref hash_index.h
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "access/hash_index.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "constants.h"
+#include "page.h"
+#include "page_cache.h"
+#include "physical_database.h"
+#include "strace.h"
+
+/* Entries store the value plus one, so that the zeroed pages of a
+ * grown file consist of empty entries. */
+#define EMPTY_ENTRY (0UL)
+
+enum
+{
+    fst_key_field,
+    snd_key_field,
+    value_field,
+    num_fields
+};
+
+static unsigned long
+hash_pair(unsigned long fst_key, unsigned long snd_key)
+{
+    unsigned long hash = fst_key * 0x9E3779B97F4A7C15UL ^ snd_key;
+
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDUL;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53UL;
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+static void
+read_meta(page_cache*    pc,
+          file_type      ft,
+          unsigned long* capacity,
+          unsigned long* count,
+          bool           log)
+{
+    if (pc->pdb->records[ft]->num_pages == 0) {
+        *capacity = 0;
+        *count    = 0;
+        return;
+    }
+
+    page* meta_page = pin_page(pc, 0, records, ft, log);
+    *capacity       = read_ulong(meta_page, 0);
+    *count          = read_ulong(meta_page, sizeof(unsigned long));
+    unpin_page(pc, 0, records, ft, log);
+}
+
+static void
+write_meta(page_cache*   pc,
+           file_type     ft,
+           unsigned long capacity,
+           unsigned long count,
+           bool          log)
+{
+    page* meta_page = pin_page(pc, 0, records, ft, log);
+    write_ulong(meta_page, 0, capacity);
+    write_ulong(meta_page, sizeof(unsigned long), count);
+    unpin_page(pc, 0, records, ft, log);
+}
+
+/* Table slot k is stored in entry k + 1 of the file, after the meta entry. */
+static void
+read_entry(page_cache*    pc,
+           file_type      ft,
+           unsigned long  slot,
+           unsigned long* entry,
+           bool           log)
+{
+    size_t page_no = (slot + 1) / HASH_ENTRIES_PER_PAGE;
+    size_t offset  = ((slot + 1) % HASH_ENTRIES_PER_PAGE)
+                    * ON_DISK_HASH_ENTRY_SIZE;
+
+    page* entry_page = pin_page(pc, page_no, records, ft, log);
+
+    for (size_t i = 0; i < num_fields; ++i) {
+        entry[i] = read_ulong(entry_page, offset + i * sizeof(unsigned long));
+    }
+
+    unpin_page(pc, page_no, records, ft, log);
+}
+
+static void
+write_entry(page_cache*          pc,
+            file_type            ft,
+            unsigned long        slot,
+            const unsigned long* entry,
+            bool                 log)
+{
+    size_t page_no = (slot + 1) / HASH_ENTRIES_PER_PAGE;
+    size_t offset  = ((slot + 1) % HASH_ENTRIES_PER_PAGE)
+                    * ON_DISK_HASH_ENTRY_SIZE;
+
+    page* entry_page = pin_page(pc, page_no, records, ft, log);
+
+    for (size_t i = 0; i < num_fields; ++i) {
+        write_ulong(entry_page, offset + i * sizeof(unsigned long), entry[i]);
+    }
+
+    unpin_page(pc, page_no, records, ft, log);
+}
+
+static void
+place_entry(page_cache*          pc,
+            file_type            ft,
+            unsigned long        capacity,
+            const unsigned long* entry,
+            bool                 log)
+{
+    unsigned long slot =
+          hash_pair(entry[fst_key_field], entry[snd_key_field]) % capacity;
+    unsigned long probe[num_fields];
+
+    read_entry(pc, ft, slot, probe, log);
+    while (probe[value_field] != EMPTY_ENTRY) {
+        slot = (slot + 1) % capacity;
+        read_entry(pc, ft, slot, probe, log);
+    }
+
+    write_entry(pc, ft, slot, entry, log);
+}
+
+/* Doubles the number of pages and reinserts all entries. Returns the new
+ * capacity. */
+static unsigned long
+grow(page_cache*   pc,
+     file_type     ft,
+     unsigned long capacity,
+     unsigned long count,
+     bool          log)
+{
+    unsigned long* entries =
+          calloc(count * num_fields + 1, sizeof(unsigned long));
+
+    if (!entries) {
+        // LCOV_EXCL_START
+        printf("hash index - grow: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    unsigned long       entry[num_fields];
+    const unsigned long empty[num_fields] = { 0, 0, EMPTY_ENTRY };
+    size_t              n_entries         = 0;
+
+    for (unsigned long slot = 0; slot < capacity; ++slot) {
+        read_entry(pc, ft, slot, entry, log);
+
+        if (entry[value_field] != EMPTY_ENTRY) {
+            for (size_t i = 0; i < num_fields; ++i) {
+                entries[n_entries * num_fields + i] = entry[i];
+            }
+            n_entries++;
+            write_entry(pc, ft, slot, empty, log);
+        }
+    }
+
+    size_t num_pages = pc->pdb->records[ft]->num_pages;
+    allocate_pages(pc->pdb, ft, num_pages == 0 ? 1 : num_pages, log);
+
+    unsigned long new_capacity =
+          pc->pdb->records[ft]->num_pages * HASH_ENTRIES_PER_PAGE - 1;
+
+    for (size_t i = 0; i < n_entries; ++i) {
+        place_entry(pc, ft, new_capacity, entries + i * num_fields, log);
+    }
+    free(entries);
+
+    return new_capacity;
+}
+
+void
+hash_index_insert(page_cache*   pc,
+                  file_type     ft,
+                  unsigned long fst_key,
+                  unsigned long snd_key,
+                  unsigned long value,
+                  bool          log)
+{
+    if (!pc || ft < NUM_SLOTTED_FILE_TYPES || ft >= invalid_ft
+        || value == UNINITIALIZED_LONG) {
+        // LCOV_EXCL_START
+        printf("hash index - insert: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    unsigned long capacity;
+    unsigned long count;
+    read_meta(pc, ft, &capacity, &count, log);
+
+    // Keeps the load factor at or below one half
+    if ((count + 1) * 2 > capacity) {
+        capacity = grow(pc, ft, capacity, count, log);
+    }
+
+    const unsigned long entry[num_fields] = { fst_key, snd_key, value + 1 };
+    place_entry(pc, ft, capacity, entry, log);
+
+    write_meta(pc, ft, capacity, count + 1, log);
+}
+
+void
+hash_index_remove(page_cache*   pc,
+                  file_type     ft,
+                  unsigned long fst_key,
+                  unsigned long snd_key,
+                  unsigned long value,
+                  bool          log)
+{
+    if (!pc || ft < NUM_SLOTTED_FILE_TYPES || ft >= invalid_ft) {
+        // LCOV_EXCL_START
+        printf("hash index - remove: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    unsigned long capacity;
+    unsigned long count;
+    read_meta(pc, ft, &capacity, &count, log);
+
+    unsigned long entry[num_fields] = { 0, 0, EMPTY_ENTRY };
+    unsigned long slot              = 0;
+
+    if (capacity > 0) {
+        slot = hash_pair(fst_key, snd_key) % capacity;
+        read_entry(pc, ft, slot, entry, log);
+    }
+
+    while (entry[value_field] != EMPTY_ENTRY
+           && (entry[fst_key_field] != fst_key
+               || entry[snd_key_field] != snd_key
+               || entry[value_field] != value + 1)) {
+        slot = (slot + 1) % capacity;
+        read_entry(pc, ft, slot, entry, log);
+    }
+
+    if (entry[value_field] == EMPTY_ENTRY) {
+        // LCOV_EXCL_START
+        printf("hash index - remove: No entry for value %lu with keys %lu "
+               "and %lu!\n",
+               value,
+               fst_key,
+               snd_key);
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    // Moves back every following entry of the cluster whose home slot is not
+    // between the hole and its position
+    unsigned long hole = slot;
+    unsigned long home;
+    for (;;) {
+        slot = (slot + 1) % capacity;
+        read_entry(pc, ft, slot, entry, log);
+
+        if (entry[value_field] == EMPTY_ENTRY) {
+            break;
+        }
+
+        home = hash_pair(entry[fst_key_field], entry[snd_key_field]) % capacity;
+
+        if (hole <= slot ? (hole < home && home <= slot)
+                         : (hole < home || home <= slot)) {
+            continue;
+        }
+
+        write_entry(pc, ft, hole, entry, log);
+        hole = slot;
+    }
+
+    const unsigned long empty[num_fields] = { 0, 0, EMPTY_ENTRY };
+    write_entry(pc, ft, hole, empty, log);
+
+    write_meta(pc, ft, capacity, count - 1, log);
+}
+
+unsigned long
+hash_index_find(page_cache*   pc,
+                file_type     ft,
+                unsigned long fst_key,
+                unsigned long snd_key,
+                bool          log)
+{
+    if (!pc || ft < NUM_SLOTTED_FILE_TYPES || ft >= invalid_ft) {
+        // LCOV_EXCL_START
+        printf("hash index - find: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    unsigned long capacity;
+    unsigned long count;
+    read_meta(pc, ft, &capacity, &count, log);
+
+    if (count == 0) {
+        return UNINITIALIZED_LONG;
+    }
+
+    unsigned long entry[num_fields];
+    unsigned long slot = hash_pair(fst_key, snd_key) % capacity;
+
+    read_entry(pc, ft, slot, entry, log);
+    while (entry[value_field] != EMPTY_ENTRY) {
+        if (entry[fst_key_field] == fst_key
+            && entry[snd_key_field] == snd_key) {
+            return entry[value_field] - 1;
+        }
+
+        slot = (slot + 1) % capacity;
+        read_entry(pc, ft, slot, entry, log);
+    }
+
+    return UNINITIALIZED_LONG;
+}
+
+unsigned long
+hash_index_size(page_cache* pc, file_type ft, bool log)
+{
+    if (!pc || ft < NUM_SLOTTED_FILE_TYPES || ft >= invalid_ft) {
+        // LCOV_EXCL_START
+        printf("hash index - size: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    unsigned long capacity;
+    unsigned long count;
+    read_meta(pc, ft, &capacity, &count, log);
+
+    return count;
+}
+
+unsigned long
+hash_index_home_slot(unsigned long fst_key,
+                     unsigned long snd_key,
+                     unsigned long capacity)
+{
+    if (capacity == 0) {
+        // LCOV_EXCL_START
+        printf("hash index - home slot: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    return hash_pair(fst_key, snd_key) % capacity;
+}
@@ -15,19 +15,221 @@
 #include <errno.h>
 #include <limits.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "access/hash_index.h"
 #include "access/header_page.h"
+#include "access/label_index.h"
 #include "access/node.h"
 #include "access/relationship.h"
+#include "access/relationship_group.h"
 #include "constants.h"
 #include "page.h"
 #include "page_cache.h"
 #include "physical_database.h"
 #include "strace.h"
 
+#define DEGREE_HISTOGRAM_INITIAL_CAPACITY (64)
+
+/* The third counter of a degree entry, after the out and the in degree. */
+static const size_t self_loops_counter = 2;
+
+static void
+group_incidence_list(heap_file* hf, unsigned long node_id, bool log);
+
+static void
+degree_histogram_add(degree_histogram* hist, unsigned long degree)
+{
+    if (degree >= hist->capacity) {
+        size_t capacity = hist->capacity;
+        while (capacity <= degree) {
+            capacity *= 2;
+        }
+
+        unsigned long* counts =
+              realloc(hist->counts, capacity * sizeof(unsigned long));
+
+        if (!counts) {
+            // LCOV_EXCL_START
+            printf("heap file - degree histogram add: Failed to allocate "
+                   "memory!\n");
+            print_trace();
+
+            exit(EXIT_FAILURE);
+            // LCOV_EXCL_STOP
+        }
+
+        memset(counts + hist->capacity,
+               0,
+               (capacity - hist->capacity) * sizeof(unsigned long));
+        hist->counts   = counts;
+        hist->capacity = capacity;
+    }
+
+    bool empty = hist->counts[hist->min] == 0;
+    hist->counts[degree]++;
+
+    if (empty) {
+        hist->min = degree;
+        hist->max = degree;
+    } else if (degree < hist->min) {
+        hist->min = degree;
+    } else if (degree > hist->max) {
+        hist->max = degree;
+    }
+}
+
+static void
+degree_histogram_remove(degree_histogram* hist, unsigned long degree)
+{
+    hist->counts[degree]--;
+
+    // Degrees change by one at a time, so the bounds move by one step if the
+    // new degree is added before the old one is removed.
+    while (hist->min < hist->max && hist->counts[hist->min] == 0) {
+        hist->min++;
+    }
+
+    while (hist->max > hist->min && hist->counts[hist->max] == 0) {
+        hist->max--;
+    }
+}
+
+static void
+degree_entry_position(unsigned long node_id, size_t* page_no, size_t* offset)
+{
+    size_t absolute_slot =
+          (node_id >> CHAR_BIT) * SLOTS_PER_PAGE + (node_id & UCHAR_MAX);
+
+    *page_no = absolute_slot / DEGREE_ENTRIES_PER_PAGE;
+    *offset  = (absolute_slot % DEGREE_ENTRIES_PER_PAGE) * DEGREE_ENTRY_SIZE;
+}
+
+static void
+read_degree_entry(heap_file*     hf,
+                  unsigned long  node_id,
+                  unsigned long* entry,
+                  bool           log)
+{
+    size_t page_no;
+    size_t offset;
+    degree_entry_position(node_id, &page_no, &offset);
+
+    page* degree_page = pin_page(hf->cache, page_no, records, degree_ft, log);
+
+    for (size_t i = 0; i < NUM_DEGREE_COUNTERS; ++i) {
+        entry[i] = read_ulong(degree_page, offset + i * sizeof(unsigned long));
+    }
+
+    unpin_page(hf->cache, page_no, records, degree_ft, log);
+}
+
+static void
+write_degree_entry(heap_file*           hf,
+                   unsigned long        node_id,
+                   const unsigned long* entry,
+                   bool                 log)
+{
+    size_t page_no;
+    size_t offset;
+    degree_entry_position(node_id, &page_no, &offset);
+
+    page* degree_page = pin_page(hf->cache, page_no, records, degree_ft, log);
+
+    for (size_t i = 0; i < NUM_DEGREE_COUNTERS; ++i) {
+        write_ulong(degree_page, offset + i * sizeof(unsigned long), entry[i]);
+    }
+
+    unpin_page(hf->cache, page_no, records, degree_ft, log);
+}
+
+static void
+entry_to_degrees(const unsigned long* entry, unsigned long* degrees)
+{
+    degrees[OUTGOING] = entry[OUTGOING];
+    degrees[INCOMING] = entry[INCOMING];
+    degrees[BOTH] =
+          entry[OUTGOING] + entry[INCOMING] - entry[self_loops_counter];
+}
+
+static void
+change_degree_entry(heap_file*    hf,
+                    unsigned long node_id,
+                    const long*   delta,
+                    bool          log)
+{
+    unsigned long entry[NUM_DEGREE_COUNTERS];
+    unsigned long old_degrees[BOTH + 1];
+    unsigned long new_degrees[BOTH + 1];
+
+    read_degree_entry(hf, node_id, entry, log);
+    entry_to_degrees(entry, old_degrees);
+
+    for (size_t i = 0; i < NUM_DEGREE_COUNTERS; ++i) {
+        entry[i] += (unsigned long)delta[i];
+    }
+
+    write_degree_entry(hf, node_id, entry, log);
+    entry_to_degrees(entry, new_degrees);
+
+    for (direction_t d = OUTGOING; d <= BOTH; ++d) {
+        if (old_degrees[d] != new_degrees[d]) {
+            degree_histogram_add(&hf->degree_hist[d], new_degrees[d]);
+            degree_histogram_remove(&hf->degree_hist[d], old_degrees[d]);
+        }
+    }
+}
+
+static void
+update_degrees(heap_file*    hf,
+               unsigned long source_node_id,
+               unsigned long target_node_id,
+               long          delta,
+               bool          log)
+{
+    if (source_node_id == target_node_id) {
+        const long loop[] = { delta, delta, delta };
+        change_degree_entry(hf, source_node_id, loop, log);
+        hf->n_self_loops += (unsigned long)delta;
+    } else {
+        const long out[] = { delta, 0, 0 };
+        const long in[]  = { 0, delta, 0 };
+        change_degree_entry(hf, source_node_id, out, log);
+        change_degree_entry(hf, target_node_id, in, log);
+    }
+}
+
+/* Counts the relationships at their end points in a degree file that was
+ * recreated empty on open. */
+static void
+rebuild_degree_entries(heap_file* hf, array_list_relationship* rels)
+{
+    unsigned long   entry[NUM_DEGREE_COUNTERS];
+    relationship_t* rel;
+
+    for (size_t i = 0; i < array_list_relationship_size(rels); ++i) {
+        rel = array_list_relationship_get(rels, i);
+
+        read_degree_entry(hf, rel->source_node, entry, false);
+        entry[OUTGOING]++;
+
+        if (rel->source_node == rel->target_node) {
+            entry[INCOMING]++;
+            entry[self_loops_counter]++;
+            write_degree_entry(hf, rel->source_node, entry, false);
+            continue;
+        }
+        write_degree_entry(hf, rel->source_node, entry, false);
+
+        read_degree_entry(hf, rel->target_node, entry, false);
+        entry[INCOMING]++;
+        write_degree_entry(hf, rel->target_node, entry, false);
+    }
+}
+
 heap_file*
 heap_file_create(page_cache* pc, const char* log_path)
 {
@@ -48,13 +250,90 @@ heap_file_create(page_cache* pc, const char* log_path)
     hf->num_updates_nodes  = 0;
     hf->num_reads_rels     = 0;
     hf->num_update_rels    = 0;
+    hf->n_self_loops       = 0;
+    hf->unsorted_nodes     = s_ul_create();
+    hf->rel_insertion      = APPEND_INSERT;
+    hf->access_hook        = NULL;
+    hf->access_context     = NULL;
+
+    for (direction_t d = OUTGOING; d <= BOTH; ++d) {
+        hf->degree_hist[d].counts = calloc(DEGREE_HISTOGRAM_INITIAL_CAPACITY,
+                                           sizeof(unsigned long));
+        hf->degree_hist[d].capacity = DEGREE_HISTOGRAM_INITIAL_CAPACITY;
+        hf->degree_hist[d].min      = 0;
+        hf->degree_hist[d].max      = 0;
+
+        if (!hf->degree_hist[d].counts) {
+            // LCOV_EXCL_START
+            printf("heap file - create: Failed to allocate memory!\n");
+            print_trace();
+
+            exit(EXIT_FAILURE);
+            // LCOV_EXCL_STOP
+        }
+    }
 
     array_list_node* nodes = get_nodes(hf, false);
     hf->n_nodes            = array_list_node_size(nodes);
-    array_list_node_destroy(nodes);
 
     array_list_relationship* rels = get_relationships(hf, false);
     hf->n_rels                    = array_list_relationship_size(rels);
+
+    // Files that were missing on open are rebuilt from the records, e.g. for
+    // databases written before they existed
+    bool rebuild_degrees = pc->pdb->recreated[degree_ft];
+    if (rebuild_degrees) {
+        rebuild_degree_entries(hf, rels);
+    }
+
+    // The aggregates are built from the degree file alone
+    unsigned long entry[NUM_DEGREE_COUNTERS];
+    unsigned long degrees[BOTH + 1];
+    unsigned long node_id;
+    for (size_t i = 0; i < hf->n_nodes; ++i) {
+        node_id = array_list_node_get(nodes, i)->id;
+        read_degree_entry(hf, node_id, entry, false);
+        entry_to_degrees(entry, degrees);
+        hf->n_self_loops += entry[self_loops_counter];
+
+        for (direction_t d = OUTGOING; d <= BOTH; ++d) {
+            degree_histogram_add(&hf->degree_hist[d], degrees[d]);
+        }
+
+        // The groups were recreated along with the degree file
+        if (rebuild_degrees && degrees[BOTH] > DENSE_NODE_THRESHOLD) {
+            group_incidence_list(hf, node_id, false);
+        }
+    }
+
+    // A recreated label index is filled from the records
+    node_t*         node;
+    relationship_t* rel;
+    if (pc->pdb->recreated[label_ft]) {
+        for (size_t i = 0; i < hf->n_nodes; ++i) {
+            node = array_list_node_get(nodes, i);
+            label_index_insert(pc, node_ft, node->id, node->label, false);
+        }
+
+        for (size_t i = 0; i < hf->n_rels; ++i) {
+            rel = array_list_relationship_get(rels, i);
+            label_index_insert(pc, relationship_ft, rel->id, rel->label, false);
+        }
+    }
+    array_list_node_destroy(nodes);
+
+    // A recreated adjacency index is filled from the relationships
+    if (pc->pdb->recreated[adjacency_ft]) {
+        for (size_t i = 0; i < hf->n_rels; ++i) {
+            rel = array_list_relationship_get(rels, i);
+            hash_index_insert(pc,
+                              adjacency_ft,
+                              rel->source_node,
+                              rel->target_node,
+                              rel->id,
+                              false);
+        }
+    }
     array_list_relationship_destroy(rels);
 
     FILE* log_file = fopen(log_path, "a");
@@ -87,6 +366,12 @@ heap_file_destroy(heap_file* hf)
 
     fclose(hf->log_file);
 
+    set_ul_destroy(hf->unsorted_nodes);
+
+    for (direction_t d = OUTGOING; d <= BOTH; ++d) {
+        free(hf->degree_hist[d].counts);
+    }
+
     free(hf);
 }
 
@@ -137,6 +422,38 @@ check_record_exists(heap_file* hf, unsigned long id, bool node, bool log)
     return result;
 }
 
+/* Marks the slots of the record with the given id as used in the header. */
+static void
+use_record_slots(heap_file* hf, unsigned long id, bool node, bool log)
+{
+    file_type     ft      = node ? node_ft : relationship_ft;
+    unsigned long n_slots = node ? NUM_SLOTS_PER_NODE : NUM_SLOTS_PER_REL;
+
+    unsigned long record_page_id = id >> CHAR_BIT;
+    unsigned char slot_in_page   = id & UCHAR_MAX;
+
+    size_t absolute_slot = record_page_id * SLOTS_PER_PAGE + slot_in_page;
+
+    size_t header_id   = absolute_slot / (PAGE_SIZE * CHAR_BIT);
+    size_t byte_offset = (absolute_slot / CHAR_BIT) % PAGE_SIZE;
+    size_t bit_offset  = absolute_slot % CHAR_BIT;
+
+    page* header_page = pin_page(hf->cache, header_id, header, ft, log);
+
+    unsigned char* used_bits = malloc(sizeof(unsigned char));
+    used_bits[0]             = UCHAR_MAX;
+
+    write_bits(hf->cache,
+               header_page,
+               byte_offset,
+               bit_offset,
+               n_slots,
+               used_bits,
+               log);
+
+    unpin_page(hf->cache, header_id, header, ft, log);
+}
+
 void
 next_free_slots(heap_file* hf, bool node, bool log)
 {
@@ -200,31 +517,46 @@ next_free_slots(heap_file* hf, bool node, bool log)
         }
     }
 
-    record_page_id = *prev_allocd_id >> CHAR_BIT;
-    slot_in_page   = *prev_allocd_id & UCHAR_MAX;
+    use_record_slots(hf, *prev_allocd_id, node, log);
+}
 
-    size_t absolute_slot = record_page_id * SLOTS_PER_PAGE + slot_in_page;
+/* Tries the pages that the incidence lists of the end points start on, so
+ * that the new relationship does not add a page to both lists. */
+static bool
+free_slot_near_lists(heap_file*     hf,
+                     unsigned long  from_node_id,
+                     unsigned long  to_node_id,
+                     unsigned long* rel_id,
+                     bool           log)
+{
+    const unsigned long node_ids[] = { from_node_id, to_node_id };
+    node_t*             node;
+    unsigned long       first_rel;
 
-    size_t header_id   = absolute_slot / (PAGE_SIZE * CHAR_BIT);
-    size_t byte_offset = (absolute_slot / CHAR_BIT) % PAGE_SIZE;
-    size_t bit_offset  = absolute_slot % CHAR_BIT;
+    for (size_t s = 0; s < 2; ++s) {
+        node      = read_node(hf, node_ids[s], log);
+        first_rel = node->first_relationship;
+        free(node);
 
-    page* header_page = pin_page(hf->cache, header_id, header, ft, log);
+        if (first_rel == UNINITIALIZED_LONG) {
+            continue;
+        }
 
-    unsigned char* used_bits = malloc(sizeof(unsigned char));
-    used_bits[0]             = UCHAR_MAX;
+        for (unsigned long slot = 0; slot < SLOTS_PER_PAGE;
+             slot += NUM_SLOTS_PER_REL) {
+            *rel_id = (first_rel >> CHAR_BIT) << CHAR_BIT | slot;
 
-    write_bits(hf->cache,
-               header_page,
-               byte_offset,
-               bit_offset,
-               n_slots,
-               used_bits,
-               log);
+            if (!check_record_exists(hf, *rel_id, false, log)) {
+                use_record_slots(hf, *rel_id, false, log);
+                return true;
+            }
+        }
+    }
 
-    unpin_page(hf->cache, header_id, header, ft, log);
+    return false;
 }
 
+
 static node_t*
 read_node_internal(heap_file*    hf,
                    unsigned long node_id,
@@ -260,6 +592,10 @@ read_node_internal(heap_file*    hf,
 
     hf->num_reads_nodes++;
 
+    if (hf->access_hook) {
+        hf->access_hook(hf->access_context, true, node_id);
+    }
+
     return node;
 }
 
@@ -302,6 +638,10 @@ read_relationship_internal(heap_file*    hf,
 
     hf->num_reads_rels++;
 
+    if (hf->access_hook) {
+        hf->access_hook(hf->access_context, false, rel_id);
+    }
+
     return rel;
 }
 
@@ -338,6 +678,7 @@ update_node_internal(heap_file* hf,
     unpin_page(hf->cache, page_id, records, node_ft, log);
 
     hf->num_updates_nodes++;
+    hf->cache->pdb->n_changes++;
 }
 
 static void
@@ -379,207 +720,723 @@ update_relationship_internal(heap_file*      hf,
     unpin_page(hf->cache, page_id, records, relationship_ft, log);
 
     hf->num_update_rels++;
+    hf->cache->pdb->n_changes++;
 }
 
-unsigned long
-create_node(heap_file* hf, unsigned long label, bool log)
+static unsigned long
+read_first_group(heap_file* hf, unsigned long node_id, bool log)
 {
-    if (!hf) {
-        // LCOV_EXCL_START
-        printf("heap file - create node: Invalid Arguments\n");
-        print_trace();
+    size_t page_no;
+    size_t offset;
+    degree_entry_position(node_id, &page_no, &offset);
 
-        exit(EXIT_FAILURE);
-        // LCOV_EXCL_STOP
-    }
+    page* degree_page = pin_page(hf->cache, page_no, records, degree_ft, log);
 
-    next_free_slots(hf, true, log);
-    unsigned long node_id = hf->last_alloc_node_id;
+    unsigned long group_id = read_ulong(
+          degree_page, offset + NUM_DEGREE_COUNTERS * sizeof(unsigned long));
 
-    node_t* node = new_node();
-    node->id     = node_id;
-    node->label  = label;
+    unpin_page(hf->cache, page_no, records, degree_ft, log);
 
-    update_node_internal(hf, node, false, log);
+    return group_id;
+}
 
-    if (log) {
-        fprintf(hf->log_file, "Create_Node %lu %lu\n", node_id, node->label);
-        fflush(hf->log_file);
-    }
+static void
+write_first_group(heap_file*    hf,
+                  unsigned long node_id,
+                  unsigned long group_id,
+                  bool          log)
+{
+    size_t page_no;
+    size_t offset;
+    degree_entry_position(node_id, &page_no, &offset);
 
-    free(node);
+    page* degree_page = pin_page(hf->cache, page_no, records, degree_ft, log);
 
-    hf->n_nodes++;
+    write_ulong(degree_page,
+                offset + NUM_DEGREE_COUNTERS * sizeof(unsigned long),
+                group_id);
 
-    return node_id;
+    unpin_page(hf->cache, page_no, records, degree_ft, log);
 }
 
-unsigned long
-create_relationship(heap_file*    hf,
-                    unsigned long from_node_id,
-                    unsigned long to_node_id,
-                    double        weight,
-                    unsigned long label,
-                    bool          log)
+static relationship_group_t*
+read_group(heap_file* hf, unsigned long group_id, bool log)
 {
-    if (!hf || from_node_id == UNINITIALIZED_LONG
-        || to_node_id == UNINITIALIZED_LONG || weight == UNINITIALIZED_WEIGHT) {
-        // LCOV_EXCL_START
-        printf("heap file - create relationship: Invalid Arguments\n");
-        print_trace();
+    page* group_page = pin_page(
+          hf->cache, group_id / GROUPS_PER_PAGE, records, group_ft, log);
 
-        exit(EXIT_FAILURE);
-        // LCOV_EXCL_STOP
-    }
-    next_free_slots(hf, false, log);
-    unsigned long rel_id = hf->last_alloc_rel_id;
+    relationship_group_t* group = new_relationship_group();
+    group->id                   = group_id;
+    relationship_group_read(group, group_page);
 
-    relationship_t* rel = new_relationship();
-    rel->id             = rel_id;
-    rel->source_node    = from_node_id;
-    rel->target_node    = to_node_id;
-    rel->weight         = weight;
-    rel->label          = label;
+    unpin_page(hf->cache, group_id / GROUPS_PER_PAGE, records, group_ft, log);
 
-    node_t* from_node = read_node(hf, from_node_id, log);
-    node_t* to_node   = read_node(hf, to_node_id, log);
+    return group;
+}
 
-    relationship_t* first_rel_from;
-    relationship_t* last_rel_from;
-    relationship_t* first_rel_to;
-    relationship_t* last_rel_to;
-    unsigned long   temp_id;
+static void
+write_group(heap_file* hf, relationship_group_t* group, bool log)
+{
+    page* group_page = pin_page(
+          hf->cache, group->id / GROUPS_PER_PAGE, records, group_ft, log);
 
-    // Find first and last relationship in source node's chain
-    if (from_node->first_relationship == UNINITIALIZED_LONG) {
-        last_rel_from  = rel;
-        first_rel_from = rel;
-    } else {
-        first_rel_from =
-              read_relationship(hf, from_node->first_relationship, log);
+    relationship_group_write(group, group_page);
 
-        temp_id = from_node->id == first_rel_from->source_node
-                        ? first_rel_from->prev_rel_source
-                        : first_rel_from->prev_rel_target;
+    unpin_page(hf->cache, group->id / GROUPS_PER_PAGE, records, group_ft, log);
+}
 
-        last_rel_from = temp_id == from_node->first_relationship
-                              ? first_rel_from
-                              : read_relationship(hf, temp_id, log);
+/* The first entry of the group file holds the head of the free list and the
+ * next group id that was never used. */
+static unsigned long
+allocate_group(heap_file* hf, bool log)
+{
+    if (hf->cache->pdb->records[group_ft]->num_pages == 0) {
+        page* first_page = new_page(hf->cache, group_ft, log);
+        unpin_page(hf->cache, first_page->page_no, records, group_ft, log);
     }
 
-    // Find first and last relationship in target node's chain
-    if (to_node->first_relationship == UNINITIALIZED_LONG) {
-        last_rel_to  = rel;
-        first_rel_to = rel;
-    } else {
-        if (to_node->first_relationship == first_rel_from->id) {
-            first_rel_to = first_rel_from;
-        } else if (to_node->first_relationship == last_rel_from->id) {
-            first_rel_to = last_rel_from;
-        } else {
-            first_rel_to =
-                  read_relationship(hf, to_node->first_relationship, log);
-        }
+    page* meta_page = pin_page(hf->cache, 0, records, group_ft, log);
 
-        temp_id = to_node->id == first_rel_to->source_node
-                        ? first_rel_to->prev_rel_source
-                        : first_rel_to->prev_rel_target;
+    unsigned long group_id = read_ulong(meta_page, 0);
 
-        if (temp_id == first_rel_from->id) {
-            last_rel_to = first_rel_from;
-        } else if (temp_id == last_rel_from->id) {
-            last_rel_to = last_rel_from;
-        } else if (temp_id == to_node->first_relationship) {
-            last_rel_to = first_rel_to;
-        } else {
-            last_rel_to = read_relationship(hf, temp_id, log);
+    if (group_id != NO_GROUP) {
+        relationship_group_t* group = read_group(hf, group_id, log);
+        write_ulong(meta_page, 0, group->next_group);
+        free(group);
+    } else {
+        group_id = read_ulong(meta_page, sizeof(unsigned long));
+        group_id = group_id == NO_GROUP ? 1 : group_id;
+        write_ulong(meta_page, sizeof(unsigned long), group_id + 1);
+
+        if (group_id / GROUPS_PER_PAGE
+            >= hf->cache->pdb->records[group_ft]->num_pages) {
+            page* group_page = new_page(hf->cache, group_ft, log);
+            unpin_page(hf->cache, group_page->page_no, records, group_ft, log);
         }
     }
 
-    rel->prev_rel_source = last_rel_from->id;
-    rel->next_rel_source = first_rel_from->id;
-    rel->prev_rel_target = last_rel_to->id;
-    rel->next_rel_target = first_rel_to->id;
-
-    // Adjust next pointer in source node's previous relation
-    if (last_rel_from->source_node == from_node_id) {
-        last_rel_from->next_rel_source = rel->id;
-    }
-    if (last_rel_from->target_node == from_node_id) {
-        last_rel_from->next_rel_target = rel->id;
-    }
-    // Adjust next pointer in target node's previous relation
-    if (last_rel_to->source_node == to_node_id) {
-        last_rel_to->next_rel_source = rel->id;
-    }
-    if (last_rel_to->target_node == to_node_id) {
-        last_rel_to->next_rel_target = rel->id;
-    }
+    unpin_page(hf->cache, 0, records, group_ft, log);
 
-    // Adjust previous pointer in source node's next relation
-    if (first_rel_from->source_node == from_node_id) {
-        first_rel_from->prev_rel_source = rel->id;
-    }
-    if (first_rel_from->target_node == from_node_id) {
-        first_rel_from->prev_rel_target = rel->id;
-    }
-    // Adjust previous pointer in target node's next relation
-    if (first_rel_to->source_node == to_node_id) {
-        first_rel_to->prev_rel_source = rel->id;
-    }
-    if (first_rel_to->target_node == to_node_id) {
-        first_rel_to->prev_rel_target = rel->id;
-    }
+    return group_id;
+}
 
-    // Set the first relationship pointer, if the inserted rel is the first
-    // rel
-    if (from_node->first_relationship == UNINITIALIZED_LONG) {
-        from_node->first_relationship = rel->id;
-        update_node(hf, from_node, log);
-    }
-    free(from_node);
+static void
+free_group(heap_file* hf, relationship_group_t* group, bool log)
+{
+    page* meta_page = pin_page(hf->cache, 0, records, group_ft, log);
 
-    if (to_node->first_relationship == UNINITIALIZED_LONG) {
-        to_node->first_relationship = rel->id;
-        update_node(hf, to_node, log);
-    }
-    free(to_node);
+    group->next_group = read_ulong(meta_page, 0);
+    group->num_rels   = 0;
+    write_group(hf, group, log);
+    write_ulong(meta_page, 0, group->id);
 
-    // in case one of the previous and next pointers of source and target are to
-    // the same relationship, we must only update and free them once!
-    if (first_rel_from != rel && first_rel_from != last_rel_from
-        && first_rel_from != first_rel_to && first_rel_from != last_rel_to) {
-        update_relationship_internal(hf, first_rel_from, false, log);
-        free(first_rel_from);
-    }
+    unpin_page(hf->cache, 0, records, group_ft, log);
+}
 
-    if (last_rel_from != rel && last_rel_from != first_rel_to
-        && last_rel_from != last_rel_to) {
-        update_relationship_internal(hf, last_rel_from, false, log);
-        free(last_rel_from);
-    }
+static relationship_group_t*
+find_group(heap_file*    hf,
+           unsigned long node_id,
+           unsigned long label,
+           direction_t   direction,
+           bool          log)
+{
+    unsigned long         group_id = read_first_group(hf, node_id, log);
+    relationship_group_t* group;
 
-    if (first_rel_to != rel && first_rel_to != last_rel_to) {
-        update_relationship_internal(hf, first_rel_to, false, log);
-        free(first_rel_to);
-    }
-    if (last_rel_to != rel) {
-        update_relationship_internal(hf, last_rel_to, false, log);
-        free(last_rel_to);
-    }
+    while (group_id != NO_GROUP) {
+        group = read_group(hf, group_id, log);
 
-    update_relationship_internal(hf, rel, false, log);
+        if (group->label == label && group->direction == direction) {
+            return group;
+        }
 
-    if (log) {
-        fprintf(hf->log_file, "create_rel %lu %lu\n", rel->id, rel->label);
-        fflush(hf->log_file);
+        group_id = group->next_group;
+        free(group);
     }
 
-    free(rel);
+    return NULL;
+}
 
-    hf->n_rels++;
+static inline unsigned long
+next_in_chain(const relationship_t* rel, unsigned long node_id)
+{
+    return rel->source_node == node_id ? rel->next_rel_source
+                                       : rel->next_rel_target;
+}
 
-    return rel_id;
+static inline unsigned long
+prev_in_chain(const relationship_t* rel, unsigned long node_id)
+{
+    return rel->source_node == node_id ? rel->prev_rel_source
+                                       : rel->prev_rel_target;
+}
+
+/* Removes the relationship from the group of its label and direction at the
+ * node, before it is unlinked from the incidence list. */
+static void
+leave_group(heap_file* hf, unsigned long node_id, relationship_t* rel, bool log)
+{
+    direction_t   direction     = relationship_group_direction(rel, node_id);
+    unsigned long group_id      = read_first_group(hf, node_id, log);
+    unsigned long prev_group_id = NO_GROUP;
+
+    relationship_group_t* group = NULL;
+
+    if (group_id == NO_GROUP) {
+        return;
+    }
+
+    while (group_id != NO_GROUP) {
+        group = read_group(hf, group_id, log);
+
+        if (group->label == rel->label && group->direction == direction) {
+            break;
+        }
+
+        prev_group_id = group_id;
+        group_id      = group->next_group;
+        free(group);
+    }
+
+    if (group_id == NO_GROUP) {
+        // LCOV_EXCL_START
+        printf("heap file - leave group: Relationship %lu is in no group of "
+               "node %lu!\n",
+               rel->id,
+               node_id);
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    if (group->num_rels > 1) {
+        if (group->first_rel == rel->id) {
+            group->first_rel = next_in_chain(rel, node_id);
+        }
+
+        if (group->last_rel == rel->id) {
+            group->last_rel = prev_in_chain(rel, node_id);
+        }
+
+        group->num_rels--;
+        write_group(hf, group, log);
+        free(group);
+        return;
+    }
+
+    if (prev_group_id == NO_GROUP) {
+        write_first_group(hf, node_id, group->next_group, log);
+    } else {
+        relationship_group_t* prev_group = read_group(hf, prev_group_id, log);
+        prev_group->next_group           = group->next_group;
+        write_group(hf, prev_group, log);
+        free(prev_group);
+    }
+
+    free_group(hf, group, log);
+    free(group);
+}
+
+typedef struct
+{
+    relationship_t* rel;
+    direction_t     direction;
+    size_t          position;
+} grouped_relationship;
+
+static int
+grouped_relationship_cmp(const void* a, const void* b)
+{
+    const grouped_relationship* fst = a;
+    const grouped_relationship* snd = b;
+
+    if (fst->rel->label != snd->rel->label) {
+        return fst->rel->label < snd->rel->label ? -1 : 1;
+    }
+
+    if (fst->direction != snd->direction) {
+        return fst->direction < snd->direction ? -1 : 1;
+    }
+
+    return (fst->position > snd->position) - (fst->position < snd->position);
+}
+
+static void
+set_chain_pointer(relationship_t* rel,
+                  unsigned long   node_id,
+                  unsigned long   rel_id,
+                  bool            next)
+{
+    if (rel->source_node == node_id) {
+        if (next) {
+            rel->next_rel_source = rel_id;
+        } else {
+            rel->prev_rel_source = rel_id;
+        }
+    }
+
+    if (rel->target_node == node_id) {
+        if (next) {
+            rel->next_rel_target = rel_id;
+        } else {
+            rel->prev_rel_target = rel_id;
+        }
+    }
+}
+
+/* Returns the already loaded record with the given id or loads it, so that
+ * relationships adjacent to both end points are written only once. */
+static relationship_t*
+load_neighbour(heap_file*       hf,
+               relationship_t** loaded,
+               size_t*          n_loaded,
+               unsigned long    rel_id,
+               bool             log)
+{
+    for (size_t i = 0; i < *n_loaded; ++i) {
+        if (loaded[i]->id == rel_id) {
+            return loaded[i];
+        }
+    }
+
+    loaded[*n_loaded] = read_relationship(hf, rel_id, log);
+
+    return loaded[(*n_loaded)++];
+}
+
+/* Follows the run of the incidence list of the node from first_id to last_id
+ * to the last relationship with an id smaller than rel_id. Stops at last_id
+ * if the run is not sorted. */
+static void
+find_ordered_position(heap_file*     hf,
+                      unsigned long  node_id,
+                      unsigned long  first_id,
+                      unsigned long  last_id,
+                      unsigned long  rel_id,
+                      unsigned long* prev_id,
+                      unsigned long* next_id,
+                      bool           log)
+{
+    relationship_t* rel = read_relationship(hf, first_id, log);
+    *next_id            = next_in_chain(rel, node_id);
+
+    while (rel->id != last_id && *next_id < rel_id) {
+        free(rel);
+        rel      = read_relationship(hf, *next_id, log);
+        *next_id = next_in_chain(rel, node_id);
+    }
+
+    *prev_id = rel->id;
+    free(rel);
+}
+
+/* Groups the incidence list of a node that just became dense. */
+static void
+group_incidence_list(heap_file* hf, unsigned long node_id, bool log)
+{
+    array_list_relationship* rels    = expand(hf, node_id, BOTH, log);
+    size_t                   n_rels  = array_list_relationship_size(rels);
+    unsigned long*           rel_ids = malloc(n_rels * sizeof(unsigned long));
+
+    if (!rel_ids) {
+        // LCOV_EXCL_START
+        printf("heap file - group incidence list: Failed to allocate "
+               "memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    for (size_t i = 0; i < n_rels; ++i) {
+        rel_ids[i] = array_list_relationship_get(rels, i)->id;
+    }
+    array_list_relationship_destroy(rels);
+
+    relink_incidence_list(hf, node_id, rel_ids, n_rels, log);
+    free(rel_ids);
+}
+
+unsigned long
+create_node(heap_file* hf, unsigned long label, bool log)
+{
+    if (!hf) {
+        // LCOV_EXCL_START
+        printf("heap file - create node: Invalid Arguments\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    next_free_slots(hf, true, log);
+    unsigned long node_id = hf->last_alloc_node_id;
+
+    node_t* node = new_node();
+    node->id     = node_id;
+    node->label  = label;
+
+    update_node_internal(hf, node, false, log);
+    label_index_insert(hf->cache, node_ft, node_id, label, log);
+
+    const unsigned long no_degrees[NUM_DEGREE_COUNTERS] = { 0 };
+    write_degree_entry(hf, node_id, no_degrees, log);
+    write_first_group(hf, node_id, NO_GROUP, log);
+
+    for (direction_t d = OUTGOING; d <= BOTH; ++d) {
+        degree_histogram_add(&hf->degree_hist[d], 0);
+    }
+
+    if (log) {
+        fprintf(hf->log_file, "Create_Node %lu %lu\n", node_id, node->label);
+        fflush(hf->log_file);
+    }
+
+    free(node);
+
+    hf->n_nodes++;
+
+    return node_id;
+}
+
+/* Inserts the relationship into the incidence lists of its end points and
+ * into the indexes. The record slot is already allocated. */
+static void
+link_relationship(heap_file* hf, relationship_t* rel, bool log)
+{
+    const unsigned long rel_id       = rel->id;
+    const unsigned long from_node_id = rel->source_node;
+    const unsigned long to_node_id   = rel->target_node;
+    const unsigned long label        = rel->label;
+
+    const unsigned long node_ids[] = { from_node_id, to_node_id };
+    const size_t        n_sides    = from_node_id == to_node_id ? 1 : 2;
+
+    const bool id_order = hf->rel_insertion == ID_ORDER_INSERT;
+
+    unsigned long         prev_ids[2];
+    unsigned long         next_ids[2];
+    bool                  dense[2]    = { false, false };
+    bool                  appended[2] = { false, false };
+    relationship_group_t* groups[2]   = { NULL, NULL };
+    relationship_t*       anchor;
+    node_t*               node;
+    unsigned long         first_id;
+    unsigned long         last_id;
+
+    // Find the neighbours of the new relationship in each incidence list.
+    // Relationships of dense nodes go to the run of their group, all others
+    // to the list itself. Appending places them at the end, the id order
+    // before the first relationship with a larger id.
+    for (size_t s = 0; s < n_sides; ++s) {
+        node = read_node(hf, node_ids[s], log);
+
+        if (node->first_relationship == UNINITIALIZED_LONG) {
+            prev_ids[s]              = rel_id;
+            next_ids[s]              = rel_id;
+            node->first_relationship = rel_id;
+            update_node(hf, node, log);
+            free(node);
+            continue;
+        }
+
+        dense[s] = read_first_group(hf, node_ids[s], log) != NO_GROUP;
+
+        if (dense[s]) {
+            groups[s] = find_group(
+                  hf,
+                  node_ids[s],
+                  label,
+                  relationship_group_direction(rel, node_ids[s]),
+                  log);
+        }
+
+        if (groups[s]) {
+            first_id = groups[s]->first_rel;
+            anchor   = read_relationship(hf, groups[s]->last_rel, log);
+            last_id  = anchor->id;
+        } else {
+            first_id = node->first_relationship;
+            anchor   = read_relationship(hf, first_id, log);
+            last_id  = prev_in_chain(anchor, node_ids[s]);
+        }
+
+        // A relationship that starts a new group is always appended, so that
+        // it does not split the run of another group
+        if (!id_order || (dense[s] && !groups[s]) || rel_id > last_id) {
+            prev_ids[s] = last_id;
+            next_ids[s] = groups[s] ? next_in_chain(anchor, node_ids[s])
+                                    : first_id;
+            appended[s] = true;
+        } else if (rel_id < first_id) {
+            if (groups[s]) {
+                free(anchor);
+                anchor = read_relationship(hf, first_id, log);
+                groups[s]->first_rel = rel_id;
+            }
+            prev_ids[s] = prev_in_chain(anchor, node_ids[s]);
+            next_ids[s] = first_id;
+
+            if (node->first_relationship == first_id) {
+                node->first_relationship = rel_id;
+                update_node(hf, node, log);
+            }
+        } else {
+            find_ordered_position(hf,
+                                  node_ids[s],
+                                  first_id,
+                                  last_id,
+                                  rel_id,
+                                  &prev_ids[s],
+                                  &next_ids[s],
+                                  log);
+            appended[s] = prev_ids[s] == last_id;
+        }
+        free(anchor);
+        free(node);
+    }
+
+    rel->prev_rel_source = prev_ids[0];
+    rel->next_rel_source = next_ids[0];
+    rel->prev_rel_target = prev_ids[n_sides - 1];
+    rel->next_rel_target = next_ids[n_sides - 1];
+
+    // in case the neighbours of source and target are the same relationship,
+    // we must only update and free them once!
+    relationship_t* neighbours[4];
+    size_t          n_neighbours = 0;
+
+    for (size_t s = 0; s < n_sides; ++s) {
+        if (prev_ids[s] == rel_id) {
+            continue;
+        }
+
+        set_chain_pointer(
+              load_neighbour(hf, neighbours, &n_neighbours, prev_ids[s], log),
+              node_ids[s],
+              rel_id,
+              true);
+        set_chain_pointer(
+              load_neighbour(hf, neighbours, &n_neighbours, next_ids[s], log),
+              node_ids[s],
+              rel_id,
+              false);
+    }
+
+    for (size_t i = 0; i < n_neighbours; ++i) {
+        update_relationship_internal(hf, neighbours[i], false, log);
+        free(neighbours[i]);
+    }
+
+    update_relationship_internal(hf, rel, false, log);
+    label_index_insert(hf->cache, relationship_ft, rel_id, label, log);
+    update_degrees(hf, from_node_id, to_node_id, 1, log);
+    hash_index_insert(
+          hf->cache, adjacency_ft, from_node_id, to_node_id, rel_id, log);
+
+    for (size_t s = 0; s < n_sides; ++s) {
+        if (groups[s]) {
+            if (appended[s]) {
+                groups[s]->last_rel = rel_id;
+            }
+            groups[s]->num_rels++;
+            write_group(hf, groups[s], log);
+            free(groups[s]);
+        } else if (dense[s]) {
+            relationship_group_t* group = new_relationship_group();
+
+            group->id         = allocate_group(hf, log);
+            group->label      = label;
+            group->direction  = relationship_group_direction(rel, node_ids[s]);
+            group->first_rel  = rel_id;
+            group->last_rel   = rel_id;
+            group->num_rels   = 1;
+            group->next_group = read_first_group(hf, node_ids[s], log);
+            write_group(hf, group, log);
+            write_first_group(hf, node_ids[s], group->id, log);
+            free(group);
+        } else if (node_degree(hf, node_ids[s], BOTH, log)
+                   > DENSE_NODE_THRESHOLD) {
+            group_incidence_list(hf, node_ids[s], log);
+        }
+    }
+
+    // Appending breaks the order unless the new relationship has the largest
+    // id, inserting in id order keeps it
+    if (!id_order) {
+        set_ul_insert(hf->unsorted_nodes, from_node_id);
+        set_ul_insert(hf->unsorted_nodes, to_node_id);
+    }
+}
+
+/* Removes the relationship from the incidence lists of its end points and
+ * from the indexes. The record slot stays allocated. */
+static void
+unlink_relationship(heap_file* hf, relationship_t* rel, bool log)
+{
+    leave_group(hf, rel->source_node, rel, log);
+    if (rel->source_node != rel->target_node) {
+        leave_group(hf, rel->target_node, rel, log);
+    }
+
+    // Unlink the relationship unless it is the only one in both chains
+    if (rel->id != rel->prev_rel_source || rel->id != rel->prev_rel_target) {
+        relationship_t* prev_rel_from =
+              read_relationship(hf, rel->prev_rel_source, log);
+
+        relationship_t* next_rel_from =
+              rel->next_rel_source == prev_rel_from->id
+                    ? prev_rel_from
+                    : read_relationship(hf, rel->next_rel_source, log);
+
+        relationship_t* prev_rel_to =
+              rel->prev_rel_target == prev_rel_from->id ? prev_rel_from
+              : rel->prev_rel_target == next_rel_from->id
+                    ? next_rel_from
+                    : read_relationship(hf, rel->prev_rel_target, log);
+
+        relationship_t* next_rel_to =
+              rel->next_rel_target == prev_rel_from->id   ? prev_rel_from
+              : rel->next_rel_target == next_rel_from->id ? next_rel_from
+              : rel->next_rel_target == prev_rel_to->id
+                    ? prev_rel_to
+                    : read_relationship(hf, rel->next_rel_target, log);
+
+        // Adjust next pointer in source node's previous relation
+        if (prev_rel_from->source_node == rel->source_node) {
+            prev_rel_from->next_rel_source = rel->next_rel_source;
+        }
+        if (prev_rel_from->target_node == rel->source_node) {
+            prev_rel_from->next_rel_target = rel->next_rel_source;
+        }
+
+        // Adjust previous pointer in source node's next relation
+        if (next_rel_from->source_node == rel->source_node) {
+            next_rel_from->prev_rel_source = rel->prev_rel_source;
+        }
+        if (next_rel_from->target_node == rel->source_node) {
+            next_rel_from->prev_rel_target = rel->prev_rel_source;
+        }
+
+        // Adjust next pointer in target node's previous relation
+        if (prev_rel_to->source_node == rel->target_node) {
+            prev_rel_to->next_rel_source = rel->next_rel_target;
+        }
+        if (prev_rel_to->target_node == rel->target_node) {
+            prev_rel_to->next_rel_target = rel->next_rel_target;
+        }
+
+        // Adjust previous pointer in target node's next relation
+        if (next_rel_to->source_node == rel->target_node) {
+            next_rel_to->prev_rel_source = rel->prev_rel_target;
+        }
+        if (next_rel_to->target_node == rel->target_node) {
+            next_rel_to->prev_rel_target = rel->prev_rel_target;
+        }
+
+        // in case one of the previous and next pointers of source and target
+        // are to the same relationship, we must only update and free them once!
+        if (next_rel_from != rel && next_rel_from != prev_rel_from
+            && next_rel_from != next_rel_to && next_rel_from != prev_rel_to) {
+            update_relationship_internal(hf, next_rel_from, false, log);
+            free(next_rel_from);
+        }
+
+        if (prev_rel_from != rel && prev_rel_from != next_rel_to
+            && prev_rel_from != prev_rel_to) {
+            update_relationship_internal(hf, prev_rel_from, false, log);
+            free(prev_rel_from);
+        }
+
+        if (next_rel_to != rel && next_rel_to != prev_rel_to) {
+            update_relationship_internal(hf, next_rel_to, false, log);
+            free(next_rel_to);
+        }
+        if (prev_rel_to != rel) {
+            update_relationship_internal(hf, prev_rel_to, false, log);
+            free(prev_rel_to);
+        }
+    }
+
+    node_t* node = read_node_internal(hf, rel->source_node, true, log);
+
+    if (node->first_relationship == rel->id) {
+        if (rel->next_rel_source == rel->id) {
+            node->first_relationship = UNINITIALIZED_LONG;
+        } else {
+            node->first_relationship = rel->next_rel_source;
+        }
+
+        update_node(hf, node, log);
+    }
+    free(node);
+
+    node = read_node_internal(hf, rel->target_node, true, log);
+    if (node->first_relationship == rel->id) {
+        if (rel->next_rel_target == rel->id) {
+            node->first_relationship = UNINITIALIZED_LONG;
+        } else {
+            node->first_relationship = rel->next_rel_target;
+        }
+
+        update_node(hf, node, log);
+    }
+    free(node);
+
+    update_degrees(hf, rel->source_node, rel->target_node, -1, log);
+    hash_index_remove(hf->cache,
+                      adjacency_ft,
+                      rel->source_node,
+                      rel->target_node,
+                      rel->id,
+                      log);
+    label_index_remove(hf->cache, relationship_ft, rel->id, log);
+}
+
+unsigned long
+create_relationship(heap_file*    hf,
+                    unsigned long from_node_id,
+                    unsigned long to_node_id,
+                    double        weight,
+                    unsigned long label,
+                    bool          log)
+{
+    if (!hf || from_node_id == UNINITIALIZED_LONG
+        || to_node_id == UNINITIALIZED_LONG || weight == UNINITIALIZED_WEIGHT) {
+        // LCOV_EXCL_START
+        printf("heap file - create relationship: Invalid Arguments\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+    unsigned long rel_id;
+    if (hf->rel_insertion != ID_ORDER_INSERT
+        || !free_slot_near_lists(hf, from_node_id, to_node_id, &rel_id, log)) {
+        next_free_slots(hf, false, log);
+        rel_id = hf->last_alloc_rel_id;
+    }
+
+    relationship_t* rel = new_relationship();
+    rel->id             = rel_id;
+    rel->source_node    = from_node_id;
+    rel->target_node    = to_node_id;
+    rel->weight         = weight;
+    rel->label          = label;
+
+    link_relationship(hf, rel, log);
+
+    if (log) {
+        fprintf(hf->log_file, "create_rel %lu %lu\n", rel->id, rel->label);
+        fflush(hf->log_file);
+    }
+
+    free(rel);
+
+    hf->n_rels++;
+
+    return rel_id;
 }
 
 node_t*
@@ -612,6 +1469,8 @@ void
 update_node(heap_file* hf, node_t* node_to_write, bool log)
 {
     update_node_internal(hf, node_to_write, true, log);
+    label_index_update(
+          hf->cache, node_ft, node_to_write->id, node_to_write->label, log);
 
     if (log) {
         fprintf(hf->log_file,
@@ -624,6 +1483,49 @@ update_node(heap_file* hf, node_t* node_to_write, bool log)
 
 void
 update_relationship(heap_file* hf, relationship_t* rel_to_write, bool log)
+{
+    if (!hf || !rel_to_write || rel_to_write->id == UNINITIALIZED_LONG
+        || rel_to_write->source_node == UNINITIALIZED_LONG
+        || rel_to_write->target_node == UNINITIALIZED_LONG
+        || rel_to_write->weight == UNINITIALIZED_WEIGHT) {
+        // LCOV_EXCL_START
+        printf("heap file - update relationship: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    relationship_t* stored =
+          read_relationship_internal(hf, rel_to_write->id, true, log);
+
+    // The groups of dense nodes, the adjacency index and the incidence lists
+    // depend on the label and the end points, so the relationship moves to
+    // its new place in the lists. This takes the chain pointers from the
+    // lists, not from the record passed in.
+    if (stored->label != rel_to_write->label
+        || stored->source_node != rel_to_write->source_node
+        || stored->target_node != rel_to_write->target_node) {
+        unlink_relationship(hf, stored, log);
+        link_relationship(hf, rel_to_write, log);
+    } else {
+        update_relationship_internal(hf, rel_to_write, false, log);
+    }
+    free(stored);
+
+    if (log) {
+        fprintf(hf->log_file,
+                "update_rel %lu %lu\n",
+                rel_to_write->id,
+                rel_to_write->label);
+        fflush(hf->log_file);
+    }
+}
+
+void
+write_relationship_record(heap_file*      hf,
+                          relationship_t* rel_to_write,
+                          bool            log)
 {
     update_relationship_internal(hf, rel_to_write, true, log);
 
@@ -649,6 +1551,7 @@ delete_node(heap_file* hf, unsigned long node_id, bool log)
     }
 
     node_t* node = read_node_internal(hf, node_id, true, log);
+    hf->cache->pdb->n_changes++;
 
     if (node->first_relationship != UNINITIALIZED_LONG) {
         relationship_t* rel =
@@ -682,12 +1585,23 @@ delete_node(heap_file* hf, unsigned long node_id, bool log)
         }
     }
 
+    unsigned long entry[NUM_DEGREE_COUNTERS];
+    unsigned long degrees[BOTH + 1];
+    read_degree_entry(hf, node_id, entry, log);
+    entry_to_degrees(entry, degrees);
+
+    for (direction_t d = OUTGOING; d <= BOTH; ++d) {
+        degree_histogram_remove(&hf->degree_hist[d], degrees[d]);
+    }
+
     if (log) {
         fprintf(hf->log_file, "delete_node %lu %lu\n", node_id, node->label);
         fflush(hf->log_file);
     }
     free(node);
 
+    label_index_remove(hf->cache, node_ft, node_id, log);
+
     unsigned long record_page_id = node_id >> CHAR_BIT;
     unsigned char slot_in_page   = node_id & UCHAR_MAX;
 
@@ -714,6 +1628,10 @@ delete_node(heap_file* hf, unsigned long node_id, bool log)
         hf->last_alloc_node_id = node_id;
     }
 
+    if (set_ul_contains(hf->unsorted_nodes, node_id)) {
+        set_ul_remove(hf->unsorted_nodes, node_id);
+    }
+
     hf->n_nodes--;
 }
 
@@ -731,144 +1649,414 @@ delete_relationship(heap_file* hf, unsigned long rel_id, bool log)
 
     relationship_t* rel = read_relationship(hf, rel_id, log);
 
-    if (rel_id != rel->prev_rel_source) {
-        relationship_t* prev_rel_from =
-              read_relationship(hf, rel->prev_rel_source, log);
+    unlink_relationship(hf, rel, log);
+    hf->cache->pdb->n_changes++;
 
-        relationship_t* next_rel_from =
-              rel->next_rel_source == prev_rel_from->id
-                    ? prev_rel_from
-                    : read_relationship(hf, rel->next_rel_source, log);
+    if (log) {
+        fprintf(hf->log_file, "delete_rel %lu %lu\n", rel_id, rel->label);
+        fflush(hf->log_file);
+    }
 
-        relationship_t* prev_rel_to =
-              rel->prev_rel_target == prev_rel_from->id ? prev_rel_from
-              : rel->prev_rel_target == next_rel_from->id
-                    ? next_rel_from
-                    : read_relationship(hf, rel->prev_rel_target, log);
+    free(rel);
 
-        relationship_t* next_rel_to =
-              rel->next_rel_target == prev_rel_from->id   ? prev_rel_from
-              : rel->next_rel_target == next_rel_from->id ? next_rel_from
-              : rel->next_rel_target == prev_rel_to->id
-                    ? prev_rel_to
-                    : read_relationship(hf, rel->next_rel_target, log);
+    unsigned long record_page_id = rel_id >> CHAR_BIT;
+    unsigned char slot_in_page   = rel_id & UCHAR_MAX;
 
-        // Adjust next pointer in source node's previous relation
-        if (prev_rel_from->source_node == rel->source_node) {
-            prev_rel_from->next_rel_source = rel->next_rel_source;
+    size_t absolute_slot = record_page_id * SLOTS_PER_PAGE + slot_in_page;
+
+    size_t         header_id   = absolute_slot / (PAGE_SIZE * CHAR_BIT);
+    size_t         byte_offset = (absolute_slot / CHAR_BIT) % PAGE_SIZE;
+    size_t         bit_offset  = absolute_slot % CHAR_BIT;
+    unsigned char* unused_bits = malloc(sizeof(unsigned char));
+    unused_bits[0]             = 0;
+    page* header_page =
+          pin_page(hf->cache, header_id, header, relationship_ft, log);
+
+    write_bits(hf->cache,
+               header_page,
+               byte_offset,
+               bit_offset,
+               NUM_SLOTS_PER_REL,
+               unused_bits,
+               log);
+
+    unpin_page(hf->cache, header_id, header, relationship_ft, log);
+
+    if (rel_id < hf->last_alloc_rel_id) {
+        hf->last_alloc_rel_id = rel_id;
+    }
+
+    hf->n_rels--;
+}
+
+unsigned long
+node_degree(heap_file*    hf,
+            unsigned long node_id,
+            direction_t   direction,
+            bool          log)
+{
+    if (!hf || node_id == UNINITIALIZED_LONG || direction > BOTH) {
+        // LCOV_EXCL_START
+        printf("heap file - node degree: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    unsigned long entry[NUM_DEGREE_COUNTERS];
+    unsigned long degrees[BOTH + 1];
+    read_degree_entry(hf, node_id, entry, log);
+    entry_to_degrees(entry, degrees);
+
+    if (log) {
+        fprintf(hf->log_file, "read_degree %lu %u\n", node_id, direction);
+        fflush(hf->log_file);
+    }
+
+    return degrees[direction];
+}
+
+void
+swap_node_degrees(heap_file*    hf,
+                  unsigned long fst,
+                  unsigned long snd,
+                  bool          log)
+{
+    if (!hf || fst == UNINITIALIZED_LONG || snd == UNINITIALIZED_LONG) {
+        // LCOV_EXCL_START
+        printf("heap file - swap node degrees: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    unsigned long fst_entry[NUM_DEGREE_COUNTERS];
+    unsigned long snd_entry[NUM_DEGREE_COUNTERS];
+
+    read_degree_entry(hf, fst, fst_entry, log);
+    read_degree_entry(hf, snd, snd_entry, log);
+    write_degree_entry(hf, fst, snd_entry, log);
+    write_degree_entry(hf, snd, fst_entry, log);
+
+    unsigned long fst_group = read_first_group(hf, fst, log);
+    write_first_group(hf, fst, read_first_group(hf, snd, log), log);
+    write_first_group(hf, snd, fst_group, log);
+}
+
+void
+swap_group_relationships(heap_file*    hf,
+                         unsigned long node_id,
+                         unsigned long fst,
+                         unsigned long snd,
+                         bool          log)
+{
+    if (!hf || node_id == UNINITIALIZED_LONG) {
+        // LCOV_EXCL_START
+        printf("heap file - swap group relationships: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    unsigned long         group_id = read_first_group(hf, node_id, log);
+    relationship_group_t* group;
+    bool                  changed;
+
+    while (group_id != NO_GROUP) {
+        group   = read_group(hf, group_id, log);
+        changed = false;
+
+        if (group->first_rel == fst || group->first_rel == snd) {
+            group->first_rel = group->first_rel == fst ? snd : fst;
+            changed          = true;
         }
-        if (prev_rel_from->target_node == rel->source_node) {
-            prev_rel_from->next_rel_target = rel->next_rel_source;
+
+        if (group->last_rel == fst || group->last_rel == snd) {
+            group->last_rel = group->last_rel == fst ? snd : fst;
+            changed         = true;
+        }
+
+        if (changed) {
+            write_group(hf, group, log);
+        }
+
+        group_id = group->next_group;
+        free(group);
+    }
+}
+
+void
+relink_incidence_list(heap_file*           hf,
+                      unsigned long        node_id,
+                      const unsigned long* rel_ids,
+                      size_t               num_rels,
+                      bool                 log)
+{
+    if (!hf || node_id == UNINITIALIZED_LONG || (!rel_ids && num_rels > 0)) {
+        // LCOV_EXCL_START
+        printf("heap file - relink incidence list: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    if (num_rels == 0) {
+        return;
+    }
+
+    grouped_relationship* rels = malloc(num_rels * sizeof(*rels));
+
+    if (!rels) {
+        // LCOV_EXCL_START
+        printf("heap file - relink incidence list: Failed to allocate "
+               "memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    for (size_t i = 0; i < num_rels; ++i) {
+        rels[i].rel       = read_relationship(hf, rel_ids[i], log);
+        rels[i].direction = relationship_group_direction(rels[i].rel, node_id);
+        rels[i].position  = i;
+    }
+
+    unsigned long group_id = read_first_group(hf, node_id, log);
+    bool dense = group_id != NO_GROUP || num_rels > DENSE_NODE_THRESHOLD;
+
+    relationship_group_t* group;
+    while (group_id != NO_GROUP) {
+        group    = read_group(hf, group_id, log);
+        group_id = group->next_group;
+        free_group(hf, group, log);
+        free(group);
+    }
+
+    if (dense) {
+        // Keeps the given order within each run
+        qsort(rels, num_rels, sizeof(*rels), grouped_relationship_cmp);
+
+        // Built back to front so that the list follows the incidence list
+        size_t end   = num_rels;
+        size_t start = 0;
+        while (end > 0) {
+            start = end - 1;
+            while (start > 0
+                   && rels[start - 1].rel->label == rels[end - 1].rel->label
+                   && rels[start - 1].direction == rels[end - 1].direction) {
+                start--;
+            }
+
+            group             = new_relationship_group();
+            group->id         = allocate_group(hf, log);
+            group->label      = rels[start].rel->label;
+            group->direction  = rels[start].direction;
+            group->first_rel  = rels[start].rel->id;
+            group->last_rel   = rels[end - 1].rel->id;
+            group->num_rels   = end - start;
+            group->next_group = group_id;
+            write_group(hf, group, log);
+
+            group_id = group->id;
+            free(group);
+            end = start;
         }
+    }
+
+    write_first_group(hf, node_id, group_id, log);
+
+    for (size_t i = 0; i < num_rels; ++i) {
+        set_chain_pointer(rels[i].rel,
+                          node_id,
+                          rels[(i + num_rels - 1) % num_rels].rel->id,
+                          false);
+        set_chain_pointer(
+              rels[i].rel, node_id, rels[(i + 1) % num_rels].rel->id, true);
+    }
+
+    node_t* node             = read_node(hf, node_id, log);
+    node->first_relationship = rels[0].rel->id;
+
+    // Only the chain pointers change, so the records are written in place
+    for (size_t i = 0; i < num_rels; ++i) {
+        update_relationship_internal(hf, rels[i].rel, false, log);
+        free(rels[i].rel);
+    }
+
+    update_node_internal(hf, node, false, log);
+    free(node);
+    free(rels);
+}
+
+/* The new neighbours of a relationship in the incidence list of a node. */
+typedef struct
+{
+    unsigned long rel_id;
+    unsigned long node_id;
+    unsigned long prev;
+    unsigned long next;
+} chain_update;
+
+static int
+chain_update_cmp(const void* a, const void* b)
+{
+    const chain_update* fst = a;
+    const chain_update* snd = b;
+
+    if (fst->rel_id != snd->rel_id) {
+        return fst->rel_id < snd->rel_id ? -1 : 1;
+    }
+    return (fst->node_id > snd->node_id) - (fst->node_id < snd->node_id);
+}
+
+static int
+chain_update_node_cmp(const void* a, const void* b)
+{
+    const chain_update* fst = a;
+    const chain_update* snd = b;
+
+    return (fst->node_id > snd->node_id) - (fst->node_id < snd->node_id);
+}
+
+void
+relink_incidence_lists(heap_file*           hf,
+                       size_t               n_nodes,
+                       const unsigned long* node_ids,
+                       const unsigned long* offsets,
+                       const unsigned long* rel_ids,
+                       bool                 log)
+{
+    if (!hf || (n_nodes > 0 && (!node_ids || !offsets || !rel_ids))) {
+        // LCOV_EXCL_START
+        printf("heap file - relink incidence lists: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
 
-        // Adjust previous pointer in source node's next relation
-        if (next_rel_from->source_node == rel->source_node) {
-            next_rel_from->prev_rel_source = rel->prev_rel_source;
-        }
-        if (next_rel_from->target_node == rel->source_node) {
-            next_rel_from->prev_rel_target = rel->prev_rel_source;
-        }
+    size_t        n_updates = n_nodes == 0 ? 0 : offsets[n_nodes];
+    chain_update* updates   = calloc(n_updates + 1, sizeof(chain_update));
+    chain_update* firsts    = calloc(n_nodes + 1, sizeof(chain_update));
 
-        // Adjust next pointer in target node's previous relation
-        if (prev_rel_to->source_node == rel->target_node) {
-            prev_rel_to->next_rel_source = rel->next_rel_target;
-        }
-        if (prev_rel_to->target_node == rel->target_node) {
-            prev_rel_to->next_rel_target = rel->next_rel_target;
-        }
+    if (!updates || !firsts) {
+        // LCOV_EXCL_START
+        printf("heap file - relink incidence lists: Failed to allocate "
+               "memory!\n");
+        print_trace();
 
-        // Adjust previous pointer in target node's next relation
-        if (next_rel_to->source_node == rel->target_node) {
-            next_rel_to->prev_rel_source = rel->prev_rel_target;
-        }
-        if (next_rel_to->target_node == rel->target_node) {
-            next_rel_to->prev_rel_target = rel->prev_rel_target;
-        }
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
 
-        // in case one of the previous and next pointers of source and target
-        // are to the same relationship, we must only update and free them once!
-        if (next_rel_from != rel && next_rel_from != prev_rel_from
-            && next_rel_from != next_rel_to && next_rel_from != prev_rel_to) {
-            update_relationship_internal(hf, next_rel_from, false, log);
-            free(next_rel_from);
+    size_t               k        = 0;
+    size_t               n_firsts = 0;
+    size_t               len;
+    const unsigned long* list;
+    for (size_t i = 0; i < n_nodes; ++i) {
+        len  = offsets[i + 1] - offsets[i];
+        list = rel_ids + offsets[i];
+
+        if (len == 0) {
+            continue;
         }
 
-        if (prev_rel_from != rel && prev_rel_from != next_rel_to
-            && prev_rel_from != prev_rel_to) {
-            update_relationship_internal(hf, prev_rel_from, false, log);
-            free(prev_rel_from);
+        if (len > DENSE_NODE_THRESHOLD
+            || read_first_group(hf, node_ids[i], log) != NO_GROUP) {
+            relink_incidence_list(hf, node_ids[i], list, len, log);
+            continue;
         }
 
-        if (next_rel_to != rel && next_rel_to != prev_rel_to) {
-            update_relationship_internal(hf, next_rel_to, false, log);
-            free(next_rel_to);
+        for (size_t j = 0; j < len; ++j) {
+            updates[k].rel_id  = list[j];
+            updates[k].node_id = node_ids[i];
+            updates[k].prev    = list[(j + len - 1) % len];
+            updates[k].next    = list[(j + 1) % len];
+            k++;
         }
-        if (prev_rel_to != rel) {
-            update_relationship_internal(hf, prev_rel_to, false, log);
-            free(prev_rel_to);
+        firsts[n_firsts].node_id = node_ids[i];
+        firsts[n_firsts].next    = list[0];
+        n_firsts++;
+    }
+    n_updates = k;
+
+    qsort(updates, n_updates, sizeof(chain_update), chain_update_cmp);
+    qsort(firsts, n_firsts, sizeof(chain_update), chain_update_node_cmp);
+
+    // Both endpoints of a relationship are updated with a single write
+    unsigned long  page_id = UNINITIALIZED_LONG;
+    page*          p       = NULL;
+    relationship_t rel;
+    for (size_t i = 0; i < n_updates; ++i) {
+        if (i == 0 || updates[i].rel_id != updates[i - 1].rel_id) {
+            if (updates[i].rel_id >> CHAR_BIT != page_id) {
+                if (p) {
+                    unpin_page(
+                          hf->cache, page_id, records, relationship_ft, log);
+                }
+                page_id = updates[i].rel_id >> CHAR_BIT;
+                p       = pin_page(
+                      hf->cache, page_id, records, relationship_ft, log);
+            }
+            rel.id = updates[i].rel_id;
+            relationship_read(&rel, p);
+            hf->num_reads_rels++;
         }
-    }
 
-    node_t* node = read_node_internal(hf, rel->source_node, true, log);
+        set_chain_pointer(&rel, updates[i].node_id, updates[i].prev, false);
+        set_chain_pointer(&rel, updates[i].node_id, updates[i].next, true);
 
-    if (node->first_relationship == rel->id) {
-        if (rel->next_rel_source == rel->id) {
-            node->first_relationship = UNINITIALIZED_LONG;
-        } else {
-            node->first_relationship = rel->next_rel_source;
+        if (i + 1 == n_updates || updates[i + 1].rel_id != rel.id) {
+            relationship_write(&rel, p);
+            hf->num_update_rels++;
         }
+    }
 
-        update_node(hf, node, log);
+    if (p) {
+        unpin_page(hf->cache, page_id, records, relationship_ft, log);
     }
-    free(node);
 
-    node = read_node_internal(hf, rel->target_node, true, log);
-    if (node->first_relationship == rel->id) {
-        if (rel->next_rel_target == rel->id) {
-            node->first_relationship = UNINITIALIZED_LONG;
-        } else {
-            node->first_relationship = rel->next_rel_target;
+    // The first relationships are stored in the nodes, in the order of ids
+    page_id = UNINITIALIZED_LONG;
+    p       = NULL;
+    node_t node;
+    for (size_t i = 0; i < n_firsts; ++i) {
+        if (firsts[i].node_id >> CHAR_BIT != page_id) {
+            if (p) {
+                unpin_page(hf->cache, page_id, records, node_ft, log);
+            }
+            page_id = firsts[i].node_id >> CHAR_BIT;
+            p       = pin_page(hf->cache, page_id, records, node_ft, log);
         }
 
-        update_node(hf, node, log);
-    }
-    free(node);
+        node.id = firsts[i].node_id;
+        node_read(&node, p);
+        node.first_relationship = firsts[i].next;
+        node_write(&node, p);
 
-    if (log) {
-        fprintf(hf->log_file, "delete_rel %lu %lu\n", rel_id, rel->label);
-        fflush(hf->log_file);
+        hf->num_reads_nodes++;
+        hf->num_updates_nodes++;
     }
 
-    free(rel);
-
-    unsigned long record_page_id = rel_id >> CHAR_BIT;
-    unsigned char slot_in_page   = rel_id & UCHAR_MAX;
-
-    size_t absolute_slot = record_page_id * SLOTS_PER_PAGE + slot_in_page;
-
-    size_t         header_id   = absolute_slot / (PAGE_SIZE * CHAR_BIT);
-    size_t         byte_offset = (absolute_slot / CHAR_BIT) % PAGE_SIZE;
-    size_t         bit_offset  = absolute_slot % CHAR_BIT;
-    unsigned char* unused_bits = malloc(sizeof(unsigned char));
-    unused_bits[0]             = 0;
-    page* header_page =
-          pin_page(hf->cache, header_id, header, relationship_ft, log);
-
-    write_bits(hf->cache,
-               header_page,
-               byte_offset,
-               bit_offset,
-               NUM_SLOTS_PER_REL,
-               unused_bits,
-               log);
-
-    unpin_page(hf->cache, header_id, header, relationship_ft, log);
+    if (p) {
+        unpin_page(hf->cache, page_id, records, node_ft, log);
+    }
 
-    if (rel_id < hf->last_alloc_rel_id) {
-        hf->last_alloc_rel_id = rel_id;
+    if (log) {
+        fprintf(hf->log_file,
+                "relink_incidence_lists %lu %lu\n",
+                n_firsts,
+                n_updates);
+        fflush(hf->log_file);
     }
 
-    hf->n_rels--;
+    free(updates);
+    free(firsts);
 }
 
 array_list_node*
@@ -1030,6 +2218,117 @@ next_relationship_id(heap_file*      hf,
     return UNINITIALIZED_LONG;
 }
 
+static inline bool
+has_direction(const relationship_t* rel,
+              unsigned long         node_id,
+              direction_t           direction)
+{
+    return (rel->source_node == node_id && direction != INCOMING)
+           || (rel->target_node == node_id && direction != OUTGOING);
+}
+
+/* Appends the relationships of the incidence list of the node that match the
+ * direction and, if requested, the label. The list is followed from start_id
+ * for at most max_rels relationships or until it returns to start_id. The
+ * page of the current relationship stays pinned as long as the list stays on
+ * it, so that a run of relationships that were placed on the same page, as
+ * by \ref icbl.h, costs a single pin. The chain pointers are trusted, the
+ * slots are not checked. */
+static void
+read_chain(heap_file*               hf,
+           unsigned long            node_id,
+           unsigned long            start_id,
+           size_t                   max_rels,
+           direction_t              direction,
+           bool                     filter_label,
+           unsigned long            label,
+           array_list_relationship* result,
+           bool                     log)
+{
+    unsigned long   rel_id  = start_id;
+    unsigned long   page_id = UNINITIALIZED_LONG;
+    page*           p       = NULL;
+    relationship_t* rel;
+
+    for (size_t i = 0; i < max_rels; ++i) {
+        if (rel_id >> CHAR_BIT != page_id) {
+            if (p) {
+                unpin_page(hf->cache, page_id, records, relationship_ft, log);
+            }
+            page_id = rel_id >> CHAR_BIT;
+            p = pin_page(hf->cache, page_id, records, relationship_ft, log);
+        }
+
+        rel     = new_relationship();
+        rel->id = rel_id;
+        relationship_read(rel, p);
+
+        hf->num_reads_rels++;
+
+        if (hf->access_hook) {
+            hf->access_hook(hf->access_context, false, rel_id);
+        }
+
+        if (log) {
+            fprintf(hf->log_file, "read_rel %lu %lu\n", rel->id, rel->label);
+            fflush(hf->log_file);
+        }
+
+        rel_id = next_in_chain(rel, node_id);
+
+        if ((!filter_label || rel->label == label)
+            && has_direction(rel, node_id, direction)) {
+            array_list_relationship_append(result, rel);
+        } else {
+            free(rel);
+        }
+
+        if (rel_id == start_id) {
+            break;
+        }
+    }
+
+    if (p) {
+        unpin_page(hf->cache, page_id, records, relationship_ft, log);
+    }
+}
+
+/* Appends the relationships of the groups of a dense node that match the
+ * direction and, if requested, the label. Self loops match all directions. */
+static void
+expand_groups(heap_file*               hf,
+              unsigned long            node_id,
+              direction_t              direction,
+              bool                     filter_label,
+              unsigned long            label,
+              array_list_relationship* result,
+              bool                     log)
+{
+    unsigned long         group_id = read_first_group(hf, node_id, log);
+    relationship_group_t* group;
+
+    while (group_id != NO_GROUP) {
+        group = read_group(hf, group_id, log);
+
+        if ((!filter_label || group->label == label)
+            && (direction == BOTH || group->direction == direction
+                || group->direction == BOTH)) {
+            read_chain(hf,
+                       node_id,
+                       group->first_rel,
+                       group->num_rels,
+                       BOTH,
+                       false,
+                       0,
+                       result,
+                       log);
+        }
+
+        group_id = group->next_group;
+        free(group);
+    }
+}
+
 array_list_relationship*
 expand(heap_file* hf, unsigned long node_id, direction_t direction, bool log)
 {
@@ -1052,28 +2351,51 @@ expand(heap_file* hf, unsigned long node_id, direction_t direction, bool log)
         return result;
     }
 
-    relationship_t* rel = read_relationship(hf, rel_id, log);
-    unsigned long   start_id;
+    // Dense nodes only read the groups of the requested direction
+    if (direction != BOTH && read_first_group(hf, node_id, log) != NO_GROUP) {
+        expand_groups(hf, node_id, direction, false, 0, result, log);
+        return result;
+    }
 
-    if ((rel->source_node == node_id && direction != INCOMING)
-        || (rel->target_node == node_id && direction != OUTGOING)) {
-        start_id = rel_id;
-    } else {
-        rel_id   = next_relationship_id(hf, node_id, rel, direction, log);
-        start_id = rel_id;
+    read_chain(hf, node_id, rel_id, SIZE_MAX, direction, false, 0, result, log);
+
+    return result;
+}
+
+array_list_relationship*
+expand_with_label(heap_file*   hf,
+                  unsigned long node_id,
+                  direction_t   direction,
+                  unsigned long label,
+                  bool          log)
+{
+    if (!hf || node_id == UNINITIALIZED_LONG || direction > BOTH) {
+        // LCOV_EXCL_START
+        printf("heap file - expand with label: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
     }
-    free(rel);
 
-    while (rel_id != UNINITIALIZED_LONG) {
-        rel = read_relationship(hf, rel_id, log);
-        array_list_relationship_append(result, rel);
-        rel_id = next_relationship_id(hf, node_id, rel, direction, log);
+    node_t* node = read_node(hf, node_id, log);
 
-        if (rel_id == start_id) {
-            return result;
-        }
+    array_list_relationship* result   = al_rel_create();
+    unsigned long            start_id = node->first_relationship;
+    free(node);
+
+    if (start_id == UNINITIALIZED_LONG) {
+        return result;
+    }
+
+    if (read_first_group(hf, node_id, log) != NO_GROUP) {
+        expand_groups(hf, node_id, direction, true, label, result, log);
+        return result;
     }
 
+    read_chain(
+          hf, node_id, start_id, SIZE_MAX, direction, true, label, result, log);
+
     return result;
 }
 
@@ -1099,50 +2421,24 @@ contains_relationship_from_to(heap_file*    hf,
         return NULL;
     }
 
-    relationship_t* rel;
-    node_t*         source_node = read_node_internal(hf, node_from, false, log);
-    node_t*         target_node = read_node_internal(hf, node_to, false, log);
+    // Probes the adjacency index instead of walking the incidence list
+    unsigned long rel_id = UNINITIALIZED_LONG;
 
-    if (log) {
-        fprintf(hf->log_file,
-                "read_node %lu %lu\n",
-                source_node->id,
-                source_node->label);
-        fprintf(hf->log_file,
-                "read_node %lu %lu\n",
-                target_node->id,
-                target_node->label);
-        fflush(hf->log_file);
+    if (direction != INCOMING) {
+        rel_id = hash_index_find(
+              hf->cache, adjacency_ft, node_from, node_to, log);
     }
 
-    if (source_node->first_relationship == UNINITIALIZED_LONG
-        || target_node->first_relationship == UNINITIALIZED_LONG) {
-        free(source_node);
-        free(target_node);
-        return NULL;
+    if (rel_id == UNINITIALIZED_LONG && direction != OUTGOING) {
+        rel_id = hash_index_find(
+              hf->cache, adjacency_ft, node_to, node_from, log);
     }
 
-    unsigned long next_id  = source_node->first_relationship;
-    unsigned long start_id = next_id;
-
-    free(source_node);
-    free(target_node);
-
-    do {
-        rel = read_relationship(hf, next_id, log);
-        if ((direction != INCOMING && rel->source_node == node_from
-             && rel->target_node == node_to)
-            || (direction != OUTGOING && rel->source_node == node_to
-                && rel->target_node == node_from)) {
-            return rel;
-        }
-
-        next_id = next_relationship_id(hf, node_from, rel, direction, log);
-
-        free(rel);
-    } while (next_id != start_id && next_id != UNINITIALIZED_LONG);
+    if (rel_id == UNINITIALIZED_LONG) {
+        return NULL;
+    }
 
-    return NULL;
+    return read_relationship(hf, rel_id, log);
 }
 
 node_t*
@@ -1157,46 +2453,44 @@ find_node(heap_file* hf, unsigned long label, bool log)
         // LCOV_EXCL_STOP
     }
 
-    node_t*       node;
-    unsigned long cur_id         = 0;
-    unsigned long record_page_id = 0;
-    unsigned char slot_in_page   = 0;
+    unsigned long node_id = label_index_first(hf->cache, node_ft, label, log);
 
-    do {
-        if (check_record_exists(hf, cur_id, true, log)) {
-            node = read_node_internal(hf, cur_id, false, log);
+    if (node_id == UNINITIALIZED_LONG) {
+        // LCOV_EXCL_START
+        printf("heap file - find node: No node with label %lu in database!\n",
+               label);
+        print_trace();
 
-            if (log) {
-                fprintf(hf->log_file,
-                        "read_node %lu %lu\n",
-                        node->id,
-                        node->label);
-            }
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
 
-            if (label == node->label) {
-                return node;
-            }
-            free(node);
-        }
+    return read_node(hf, node_id, log);
+}
 
-        if ((slot_in_page + NUM_SLOTS_PER_NODE) % SLOTS_PER_PAGE
-            < slot_in_page % SLOTS_PER_PAGE) {
-            record_page_id++;
-            slot_in_page = 0;
-        } else {
-            slot_in_page += NUM_SLOTS_PER_NODE;
-        }
+array_list_node*
+find_nodes_by_label(heap_file* hf, unsigned long label, bool log)
+{
+    if (!hf) {
+        // LCOV_EXCL_START
+        printf("heap files - find nodes by label: Invalid Arguments!\n");
+        print_trace();
 
-        cur_id = (record_page_id << CHAR_BIT) | slot_in_page;
-    } while (record_page_id < hf->cache->pdb->records[node_ft]->num_pages);
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
 
-    // LCOV_EXCL_START
-    printf("heap file - find node: No node with label %lu in database!\n",
-           label);
-    print_trace();
+    array_list_ul* ids =
+          label_index_find_all(hf->cache, node_ft, label, log);
+    array_list_node* result = al_node_create();
+
+    for (size_t i = 0; i < array_list_ul_size(ids); ++i) {
+        array_list_node_append(result,
+                               read_node(hf, array_list_ul_get(ids, i), log));
+    }
+    array_list_ul_destroy(ids);
 
-    exit(EXIT_FAILURE);
-    // LCOV_EXCL_STOP
+    return result;
 }
 
 relationship_t*
@@ -1211,47 +2505,21 @@ find_relationships(heap_file* hf, unsigned long label, bool log)
         // LCOV_EXCL_STOP
     }
 
-    relationship_t* rel;
-    unsigned long   cur_id         = 0;
-    unsigned long   record_page_id = 0;
-    unsigned char   slot_in_page   = 0;
-
-    do {
-        if (check_record_exists(hf, cur_id, false, log)) {
-            rel = read_relationship_internal(hf, cur_id, false, log);
-
-            if (log) {
-                fprintf(
-                      hf->log_file, "read_rel %lu %lu\n", rel->id, rel->label);
-                fflush(hf->log_file);
-            }
-
-            if (label == rel->label) {
-                return rel;
-            }
-            free(rel);
-        }
-
-        if ((slot_in_page + NUM_SLOTS_PER_REL) % SLOTS_PER_PAGE
-            < slot_in_page % SLOTS_PER_PAGE) {
-            record_page_id++;
-            slot_in_page = 0;
-        } else {
-            slot_in_page += NUM_SLOTS_PER_REL;
-        }
+    unsigned long rel_id =
+          label_index_first(hf->cache, relationship_ft, label, log);
 
-        cur_id = (record_page_id << CHAR_BIT) | slot_in_page;
-    } while (record_page_id
-             < hf->cache->pdb->records[relationship_ft]->num_pages);
+    if (rel_id == UNINITIALIZED_LONG) {
+        // LCOV_EXCL_START
+        printf("heap file - find relationship: No relationship with label %lu "
+               "in database!\n",
+               label);
+        print_trace();
 
-    // LCOV_EXCL_START
-    printf("heap file - find relationship: No relationship with label %lu in "
-           "database!\n",
-           label);
-    print_trace();
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
 
-    exit(EXIT_FAILURE);
-    // LCOV_EXCL_STOP}
+    return read_relationship(hf, rel_id, log);
 }
 
 void
@@ -0,0 +1,344 @@
+/*!
+ * \file label_index.c
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief See \ref label_index.h
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "access/label_index.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "access/hash_index.h"
+#include "access/node.h"
+#include "access/relationship.h"
+#include "constants.h"
+#include "page.h"
+#include "page_cache.h"
+#include "physical_database.h"
+#include "strace.h"
+
+enum
+{
+    indexed_field,
+    label_field,
+    prev_field,
+    next_field,
+    num_fields
+};
+
+static bool
+valid_record_type(file_type ft)
+{
+    return ft == node_ft || ft == relationship_ft;
+}
+
+static file_type
+chain_file_type(file_type ft)
+{
+    return ft == node_ft ? node_label_ft : relationship_label_ft;
+}
+
+/* Records occupy consecutive slots that never overlap, so dividing the slot
+ * of a record by its number of slots yields a distinct entry per record. */
+static void
+entry_position(file_type     ft,
+               unsigned long id,
+               size_t*       page_no,
+               size_t*       offset)
+{
+    size_t slots_per_record =
+          ft == node_ft ? NUM_SLOTS_PER_NODE : NUM_SLOTS_PER_REL;
+    size_t absolute_slot =
+          (id >> CHAR_BIT) * SLOTS_PER_PAGE + (id & UCHAR_MAX);
+    size_t entry_no = absolute_slot / slots_per_record;
+
+    *page_no = entry_no / LABEL_ENTRIES_PER_PAGE;
+    *offset  = (entry_no % LABEL_ENTRIES_PER_PAGE) * ON_DISK_LABEL_ENTRY_SIZE;
+}
+
+static void
+read_entry(page_cache*    pc,
+           file_type      ft,
+           unsigned long  id,
+           unsigned long* entry,
+           bool           log)
+{
+    file_type chain_ft = chain_file_type(ft);
+    size_t    page_no;
+    size_t    offset;
+    entry_position(ft, id, &page_no, &offset);
+
+    if (page_no >= pc->pdb->records[chain_ft]->num_pages) {
+        for (size_t i = 0; i < num_fields; ++i) {
+            entry[i] = 0;
+        }
+        return;
+    }
+
+    page* entry_page = pin_page(pc, page_no, records, chain_ft, log);
+
+    for (size_t i = 0; i < num_fields; ++i) {
+        entry[i] = read_ulong(entry_page, offset + i * sizeof(unsigned long));
+    }
+
+    unpin_page(pc, page_no, records, chain_ft, log);
+}
+
+static void
+write_entry(page_cache*          pc,
+            file_type            ft,
+            unsigned long        id,
+            const unsigned long* entry,
+            bool                 log)
+{
+    file_type chain_ft = chain_file_type(ft);
+    size_t    page_no;
+    size_t    offset;
+    entry_position(ft, id, &page_no, &offset);
+
+    size_t num_pages = pc->pdb->records[chain_ft]->num_pages;
+    if (page_no >= num_pages) {
+        allocate_pages(pc->pdb, chain_ft, page_no + 1 - num_pages, log);
+    }
+
+    page* entry_page = pin_page(pc, page_no, records, chain_ft, log);
+
+    for (size_t i = 0; i < num_fields; ++i) {
+        write_ulong(entry_page, offset + i * sizeof(unsigned long), entry[i]);
+    }
+
+    unpin_page(pc, page_no, records, chain_ft, log);
+}
+
+static void
+set_link(page_cache*   pc,
+         file_type     ft,
+         unsigned long id,
+         size_t        field,
+         unsigned long value,
+         bool          log)
+{
+    unsigned long entry[num_fields];
+    read_entry(pc, ft, id, entry, log);
+    entry[field] = value;
+    write_entry(pc, ft, id, entry, log);
+}
+
+void
+label_index_insert(page_cache*   pc,
+                   file_type     ft,
+                   unsigned long id,
+                   unsigned long label,
+                   bool          log)
+{
+    if (!pc || !valid_record_type(ft) || id == UNINITIALIZED_LONG) {
+        // LCOV_EXCL_START
+        printf("label index - insert: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    unsigned long entry[num_fields];
+    read_entry(pc, ft, id, entry, log);
+
+    if (entry[indexed_field]) {
+        // LCOV_EXCL_START
+        printf("label index - insert: Record %lu is already indexed!\n", id);
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    unsigned long head = hash_index_find(pc, label_ft, ft, label, log);
+
+    entry[indexed_field] = true;
+    entry[label_field]   = label;
+
+    if (head == UNINITIALIZED_LONG) {
+        entry[prev_field] = id;
+        entry[next_field] = id;
+        write_entry(pc, ft, id, entry, log);
+        hash_index_insert(pc, label_ft, ft, label, id, log);
+        return;
+    }
+
+    unsigned long head_entry[num_fields];
+    read_entry(pc, ft, head, head_entry, log);
+    unsigned long tail = head_entry[prev_field];
+
+    entry[prev_field] = tail;
+    entry[next_field] = head;
+    write_entry(pc, ft, id, entry, log);
+
+    set_link(pc, ft, tail, next_field, id, log);
+    set_link(pc, ft, head, prev_field, id, log);
+}
+
+void
+label_index_remove(page_cache* pc, file_type ft, unsigned long id, bool log)
+{
+    if (!pc || !valid_record_type(ft) || id == UNINITIALIZED_LONG) {
+        // LCOV_EXCL_START
+        printf("label index - remove: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    unsigned long entry[num_fields];
+    read_entry(pc, ft, id, entry, log);
+
+    if (!entry[indexed_field]) {
+        // LCOV_EXCL_START
+        printf("label index - remove: Record %lu is not indexed!\n", id);
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    unsigned long label = entry[label_field];
+
+    if (entry[next_field] == id) {
+        hash_index_remove(pc, label_ft, ft, label, id, log);
+    } else {
+        set_link(pc, ft, entry[prev_field], next_field, entry[next_field], log);
+        set_link(pc, ft, entry[next_field], prev_field, entry[prev_field], log);
+
+        if (hash_index_find(pc, label_ft, ft, label, log) == id) {
+            hash_index_remove(pc, label_ft, ft, label, id, log);
+            hash_index_insert(pc, label_ft, ft, label, entry[next_field], log);
+        }
+    }
+
+    const unsigned long empty[num_fields] = { 0 };
+    write_entry(pc, ft, id, empty, log);
+}
+
+void
+label_index_update(page_cache*   pc,
+                   file_type     ft,
+                   unsigned long id,
+                   unsigned long label,
+                   bool          log)
+{
+    if (!pc || !valid_record_type(ft) || id == UNINITIALIZED_LONG) {
+        // LCOV_EXCL_START
+        printf("label index - update: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    unsigned long entry[num_fields];
+    read_entry(pc, ft, id, entry, log);
+
+    if (entry[indexed_field] && entry[label_field] != label) {
+        label_index_remove(pc, ft, id, log);
+        label_index_insert(pc, ft, id, label, log);
+    }
+}
+
+void
+label_index_swap(page_cache*   pc,
+                 file_type     ft,
+                 unsigned long fst,
+                 unsigned long snd,
+                 bool          log)
+{
+    if (!pc || !valid_record_type(ft) || fst == UNINITIALIZED_LONG
+        || snd == UNINITIALIZED_LONG) {
+        // LCOV_EXCL_START
+        printf("label index - swap: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    if (fst == snd) {
+        return;
+    }
+
+    unsigned long fst_entry[num_fields];
+    unsigned long snd_entry[num_fields];
+    read_entry(pc, ft, fst, fst_entry, log);
+    read_entry(pc, ft, snd, snd_entry, log);
+
+    if (fst_entry[indexed_field]) {
+        label_index_remove(pc, ft, fst, log);
+    }
+    if (snd_entry[indexed_field]) {
+        label_index_remove(pc, ft, snd, log);
+    }
+    if (fst_entry[indexed_field]) {
+        label_index_insert(pc, ft, snd, fst_entry[label_field], log);
+    }
+    if (snd_entry[indexed_field]) {
+        label_index_insert(pc, ft, fst, snd_entry[label_field], log);
+    }
+}
+
+unsigned long
+label_index_first(page_cache*   pc,
+                  file_type     ft,
+                  unsigned long label,
+                  bool          log)
+{
+    if (!pc || !valid_record_type(ft)) {
+        // LCOV_EXCL_START
+        printf("label index - first: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    return hash_index_find(pc, label_ft, ft, label, log);
+}
+
+array_list_ul*
+label_index_find_all(page_cache*   pc,
+                     file_type     ft,
+                     unsigned long label,
+                     bool          log)
+{
+    if (!pc || !valid_record_type(ft)) {
+        // LCOV_EXCL_START
+        printf("label index - find all: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    array_list_ul* result = al_ul_create();
+    unsigned long  head   = hash_index_find(pc, label_ft, ft, label, log);
+
+    if (head == UNINITIALIZED_LONG) {
+        return result;
+    }
+
+    unsigned long entry[num_fields];
+    unsigned long id = head;
+    do {
+        array_list_ul_append(result, id);
+        read_entry(pc, ft, id, entry, log);
+        id = entry[next_field];
+    } while (id != head);
+
+    return result;
+}
@@ -0,0 +1,112 @@
+/*!
+ * \file relationship_group.c
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief See \ref relationship_group.h
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "access/relationship_group.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "constants.h"
+#include "page.h"
+#include "strace.h"
+
+relationship_group_t*
+new_relationship_group(void)
+{
+    relationship_group_t* group = malloc(sizeof(*group));
+
+    if (!group) {
+        // LCOV_EXCL_START
+        printf("relationship group - new: failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    group->id         = NO_GROUP;
+    group->label      = UNINITIALIZED_LONG;
+    group->direction  = BOTH;
+    group->first_rel  = UNINITIALIZED_LONG;
+    group->last_rel   = UNINITIALIZED_LONG;
+    group->num_rels   = 0;
+    group->next_group = NO_GROUP;
+
+    return group;
+}
+
+void
+relationship_group_read(relationship_group_t* group, page* read_from_page)
+{
+    if (!group || !read_from_page || read_from_page->pin_count < 1
+        || group->id / GROUPS_PER_PAGE != read_from_page->page_no) {
+        // LCOV_EXCL_START
+        printf("relationship group - read: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    size_t offset = (group->id % GROUPS_PER_PAGE) * ON_DISK_GROUP_SIZE;
+
+    group->label     = read_ulong(read_from_page, offset);
+    group->direction = (direction_t)read_ulong(
+          read_from_page, offset + sizeof(unsigned long));
+    group->first_rel =
+          read_ulong(read_from_page, offset + 2 * sizeof(unsigned long));
+    group->last_rel =
+          read_ulong(read_from_page, offset + 3 * sizeof(unsigned long));
+    group->num_rels =
+          read_ulong(read_from_page, offset + 4 * sizeof(unsigned long));
+    group->next_group =
+          read_ulong(read_from_page, offset + 5 * sizeof(unsigned long));
+}
+
+void
+relationship_group_write(relationship_group_t* group, page* write_to_page)
+{
+    if (!group || !write_to_page || write_to_page->pin_count < 1
+        || group->id / GROUPS_PER_PAGE != write_to_page->page_no) {
+        // LCOV_EXCL_START
+        printf("relationship group - write: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    size_t offset = (group->id % GROUPS_PER_PAGE) * ON_DISK_GROUP_SIZE;
+
+    write_ulong(write_to_page, offset, group->label);
+    write_ulong(write_to_page,
+                offset + sizeof(unsigned long),
+                (unsigned long)group->direction);
+    write_ulong(
+          write_to_page, offset + 2 * sizeof(unsigned long), group->first_rel);
+    write_ulong(
+          write_to_page, offset + 3 * sizeof(unsigned long), group->last_rel);
+    write_ulong(
+          write_to_page, offset + 4 * sizeof(unsigned long), group->num_rels);
+    write_ulong(
+          write_to_page, offset + 5 * sizeof(unsigned long), group->next_group);
+}
+
+direction_t
+relationship_group_direction(const relationship_t* rel, unsigned long node_id)
+{
+    if (rel->source_node == rel->target_node) {
+        return BOTH;
+    }
+
+    return rel->source_node == node_id ? OUTGOING : INCOMING;
+}
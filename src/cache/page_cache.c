@@ -150,7 +150,8 @@ exit(EXIT_FAILURE);
 page*
 pin_page(page_cache* pc, size_t page_no, file_kind fk, file_type ft, bool log)
 {
-    if (!pc || (fk == catalogue && ft != 0)) {
+    if (!pc || (fk == catalogue && ft != 0)
+        || (fk == header && ft >= NUM_SLOTTED_FILE_TYPES)) {
         // LCOV_EXCL_START
         printf("page cache - pin page: Invalid Arguments!\n");
         print_trace();
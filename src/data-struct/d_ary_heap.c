@@ -0,0 +1,293 @@
+/*!
+ * \file d_ary_heap.c
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief See \ref d_ary_heap.h
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "data-struct/d_ary_heap.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "strace.h"
+
+#define D_ARY_HEAP_INITIAL_CAPACITY (16)
+
+#define NOT_CONTAINED (SIZE_MAX)
+
+d_ary_heap*
+d_ary_heap_create(void)
+{
+    d_ary_heap* heap = malloc(sizeof(d_ary_heap));
+
+    if (!heap) {
+        // LCOV_EXCL_START
+        printf("d-ary heap - create: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    heap->size           = 0;
+    heap->capacity       = D_ARY_HEAP_INITIAL_CAPACITY;
+    heap->index_capacity = 0;
+    heap->positions      = NULL;
+    heap->entries = calloc(heap->capacity, sizeof(d_ary_heap_entry));
+
+    if (!heap->entries) {
+        // LCOV_EXCL_START
+        printf("d-ary heap - create: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    return heap;
+}
+
+void
+d_ary_heap_destroy(d_ary_heap* heap)
+{
+    if (!heap) {
+        // LCOV_EXCL_START
+        printf("d-ary heap - destroy: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    free(heap->entries);
+    free(heap->positions);
+    free(heap);
+}
+
+size_t
+d_ary_heap_size(d_ary_heap* heap)
+{
+    if (!heap) {
+        // LCOV_EXCL_START
+        printf("d-ary heap - size: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    return heap->size;
+}
+
+bool
+d_ary_heap_contains(d_ary_heap* heap, unsigned long value)
+{
+    if (!heap) {
+        // LCOV_EXCL_START
+        printf("d-ary heap - contains: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    return value < heap->index_capacity
+           && heap->positions[value] != NOT_CONTAINED;
+}
+
+static void
+d_ary_heap_grow_index(d_ary_heap* heap, unsigned long value)
+{
+    size_t new_capacity =
+          heap->index_capacity == 0 ? D_ARY_HEAP_INITIAL_CAPACITY
+                                    : heap->index_capacity;
+
+    while (new_capacity <= value) {
+        new_capacity *= 2;
+    }
+
+    size_t* positions = realloc(heap->positions, new_capacity * sizeof(size_t));
+
+    if (!positions) {
+        // LCOV_EXCL_START
+        printf("d-ary heap - grow index: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    for (size_t i = heap->index_capacity; i < new_capacity; ++i) {
+        positions[i] = NOT_CONTAINED;
+    }
+
+    heap->positions      = positions;
+    heap->index_capacity = new_capacity;
+}
+
+static void
+d_ary_heap_sift_up(d_ary_heap* heap, size_t pos)
+{
+    d_ary_heap_entry entry = heap->entries[pos];
+    size_t           parent;
+
+    while (pos > 0) {
+        parent = (pos - 1) / D_ARY_HEAP_ARITY;
+
+        if (heap->entries[parent].key <= entry.key) {
+            break;
+        }
+
+        heap->entries[pos]                        = heap->entries[parent];
+        heap->positions[heap->entries[pos].value] = pos;
+        pos                                       = parent;
+    }
+
+    heap->entries[pos]           = entry;
+    heap->positions[entry.value] = pos;
+}
+
+static void
+d_ary_heap_sift_down(d_ary_heap* heap, size_t pos)
+{
+    d_ary_heap_entry entry = heap->entries[pos];
+    size_t           child;
+    size_t           min_child;
+    size_t           last_child;
+
+    while ((child = pos * D_ARY_HEAP_ARITY + 1) < heap->size) {
+        min_child  = child;
+        last_child = child + D_ARY_HEAP_ARITY < heap->size
+                           ? child + D_ARY_HEAP_ARITY
+                           : heap->size;
+
+        for (size_t i = child + 1; i < last_child; ++i) {
+            if (heap->entries[i].key < heap->entries[min_child].key) {
+                min_child = i;
+            }
+        }
+
+        if (heap->entries[min_child].key >= entry.key) {
+            break;
+        }
+
+        heap->entries[pos]                        = heap->entries[min_child];
+        heap->positions[heap->entries[pos].value] = pos;
+        pos                                       = min_child;
+    }
+
+    heap->entries[pos]           = entry;
+    heap->positions[entry.value] = pos;
+}
+
+void
+d_ary_heap_insert(d_ary_heap* heap, double key, unsigned long value)
+{
+    if (!heap || d_ary_heap_contains(heap, value)) {
+        // LCOV_EXCL_START
+        printf("d-ary heap - insert: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    if (value >= heap->index_capacity) {
+        d_ary_heap_grow_index(heap, value);
+    }
+
+    if (heap->size == heap->capacity) {
+        heap->capacity *= 2;
+        d_ary_heap_entry* entries =
+              realloc(heap->entries, heap->capacity * sizeof(d_ary_heap_entry));
+
+        if (!entries) {
+            // LCOV_EXCL_START
+            printf("d-ary heap - insert: Failed to allocate memory!\n");
+            print_trace();
+
+            exit(EXIT_FAILURE);
+            // LCOV_EXCL_STOP
+        }
+        heap->entries = entries;
+    }
+
+    heap->entries[heap->size].key   = key;
+    heap->entries[heap->size].value = value;
+    heap->size++;
+
+    d_ary_heap_sift_up(heap, heap->size - 1);
+}
+
+void
+d_ary_heap_decrease_key(d_ary_heap* heap, unsigned long value, double key)
+{
+    if (!heap || !d_ary_heap_contains(heap, value)) {
+        // LCOV_EXCL_START
+        printf("d-ary heap - decrease key: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    size_t pos = heap->positions[value];
+
+    if (key >= heap->entries[pos].key) {
+        return;
+    }
+
+    heap->entries[pos].key = key;
+    d_ary_heap_sift_up(heap, pos);
+}
+
+double
+d_ary_heap_min_key(d_ary_heap* heap)
+{
+    if (!heap || heap->size == 0) {
+        // LCOV_EXCL_START
+        printf("d-ary heap - min key: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    return heap->entries[0].key;
+}
+
+unsigned long
+d_ary_heap_extract_min(d_ary_heap* heap, double* key)
+{
+    if (!heap || heap->size == 0) {
+        // LCOV_EXCL_START
+        printf("d-ary heap - extract min: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    d_ary_heap_entry min = heap->entries[0];
+
+    if (key) {
+        *key = min.key;
+    }
+
+    heap->positions[min.value] = NOT_CONTAINED;
+    heap->size--;
+
+    if (heap->size > 0) {
+        heap->entries[0] = heap->entries[heap->size];
+        d_ary_heap_sift_down(heap, 0);
+    }
+
+    return min.value;
+}
@@ -0,0 +1,15 @@
+/*!
+ * \file pairing_heap.c
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief See \ref pairing_heap.h
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "data-struct/pairing_heap.h"
+
+PAIRING_HEAP_IMPL(pairing_heap_ul, unsigned long);
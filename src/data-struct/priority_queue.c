@@ -0,0 +1,340 @@
+/*!
+ * \file priority_queue.c
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief See \ref priority_queue.h
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "data-struct/priority_queue.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "strace.h"
+
+#define PQ_INITIAL_HANDLES (16)
+
+priority_queue*
+priority_queue_create(pq_type type)
+{
+    if (type >= invalid_pq) {
+        // LCOV_EXCL_START
+        printf("priority queue - create: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    priority_queue* pq = calloc(1, sizeof(priority_queue));
+
+    if (!pq) {
+        // LCOV_EXCL_START
+        printf("priority queue - create: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    pq->type = type;
+
+    switch (type) {
+        case fibonacci_pq:
+            pq->heap.fibonacci = fib_heap_ul_create();
+            break;
+        case d_ary_pq:
+            pq->heap.d_ary = d_ary_heap_create();
+            break;
+        case radix_pq:
+            pq->heap.radix = radix_heap_create();
+            break;
+        case pairing_pq:
+            pq->heap.pairing = pairing_heap_ul_create();
+            break;
+        default:
+            // LCOV_EXCL_START
+            break;
+            // LCOV_EXCL_STOP
+    }
+
+    return pq;
+}
+
+void
+priority_queue_destroy(priority_queue* pq)
+{
+    if (!pq) {
+        // LCOV_EXCL_START
+        printf("priority queue - destroy: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    switch (pq->type) {
+        case fibonacci_pq:
+            fib_heap_ul_destroy(pq->heap.fibonacci);
+            break;
+        case d_ary_pq:
+            d_ary_heap_destroy(pq->heap.d_ary);
+            break;
+        case radix_pq:
+            radix_heap_destroy(pq->heap.radix);
+            break;
+        case pairing_pq:
+            pairing_heap_ul_destroy(pq->heap.pairing);
+            break;
+        default:
+            // LCOV_EXCL_START
+            break;
+            // LCOV_EXCL_STOP
+    }
+
+    free(pq->handles);
+    free(pq);
+}
+
+size_t
+priority_queue_size(priority_queue* pq)
+{
+    if (!pq) {
+        // LCOV_EXCL_START
+        printf("priority queue - size: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    switch (pq->type) {
+        case fibonacci_pq:
+            return pq->heap.fibonacci->num_nodes;
+        case d_ary_pq:
+            return d_ary_heap_size(pq->heap.d_ary);
+        case radix_pq:
+            return radix_heap_size(pq->heap.radix);
+        case pairing_pq:
+            return pq->heap.pairing->num_nodes;
+        default:
+            // LCOV_EXCL_START
+            return 0;
+            // LCOV_EXCL_STOP
+    }
+}
+
+bool
+priority_queue_contains(priority_queue* pq, unsigned long value)
+{
+    if (!pq) {
+        // LCOV_EXCL_START
+        printf("priority queue - contains: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    switch (pq->type) {
+        case d_ary_pq:
+            return d_ary_heap_contains(pq->heap.d_ary, value);
+        case radix_pq:
+            return radix_heap_contains(pq->heap.radix, value);
+        default:
+            return value < pq->n_handles && pq->handles[value] != NULL;
+    }
+}
+
+static void
+priority_queue_set_handle(priority_queue* pq, unsigned long value, void* node)
+{
+    if (value >= pq->n_handles) {
+        size_t n_handles = pq->n_handles == 0 ? PQ_INITIAL_HANDLES
+                                              : pq->n_handles;
+        while (n_handles <= value) {
+            n_handles *= 2;
+        }
+
+        void** handles = realloc(pq->handles, n_handles * sizeof(void*));
+
+        if (!handles) {
+            // LCOV_EXCL_START
+            printf("priority queue - set handle: Failed to allocate "
+                   "memory!\n");
+            print_trace();
+
+            exit(EXIT_FAILURE);
+            // LCOV_EXCL_STOP
+        }
+
+        for (size_t i = pq->n_handles; i < n_handles; ++i) {
+            handles[i] = NULL;
+        }
+
+        pq->handles   = handles;
+        pq->n_handles = n_handles;
+    }
+
+    pq->handles[value] = node;
+}
+
+void
+priority_queue_push(priority_queue* pq, double key, unsigned long value)
+{
+    if (!pq) {
+        // LCOV_EXCL_START
+        printf("priority queue - push: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    bool contained = priority_queue_contains(pq, value);
+
+    switch (pq->type) {
+        case fibonacci_pq:
+            if (!contained) {
+                priority_queue_set_handle(
+                      pq,
+                      value,
+                      fib_heap_ul_insert(pq->heap.fibonacci, key, value));
+            } else if (key < ((fib_heap_ul_node*)pq->handles[value])->key) {
+                fib_heap_ul_decrease_key(
+                      pq->heap.fibonacci, pq->handles[value], key);
+            }
+            break;
+        case d_ary_pq:
+            if (!contained) {
+                d_ary_heap_insert(pq->heap.d_ary, key, value);
+            } else {
+                d_ary_heap_decrease_key(pq->heap.d_ary, value, key);
+            }
+            break;
+        case radix_pq:
+            if (!contained) {
+                radix_heap_insert(pq->heap.radix, key, value);
+            } else {
+                radix_heap_decrease_key(pq->heap.radix, value, key);
+            }
+            break;
+        case pairing_pq:
+            if (!contained) {
+                priority_queue_set_handle(
+                      pq,
+                      value,
+                      pairing_heap_ul_insert(pq->heap.pairing, key, value));
+            } else if (key
+                       < ((pairing_heap_ul_node*)pq->handles[value])->key) {
+                pairing_heap_ul_decrease_key(
+                      pq->heap.pairing, pq->handles[value], key);
+            }
+            break;
+        default:
+            // LCOV_EXCL_START
+            break;
+            // LCOV_EXCL_STOP
+    }
+}
+
+double
+priority_queue_min_key(priority_queue* pq)
+{
+    if (!pq || priority_queue_size(pq) == 0) {
+        // LCOV_EXCL_START
+        printf("priority queue - min key: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    switch (pq->type) {
+        case fibonacci_pq:
+            return fib_heap_ul_min(pq->heap.fibonacci)->key;
+        case d_ary_pq:
+            return d_ary_heap_min_key(pq->heap.d_ary);
+        case radix_pq:
+            return radix_heap_min_key(pq->heap.radix);
+        case pairing_pq:
+            return pairing_heap_ul_min(pq->heap.pairing)->key;
+        default:
+            // LCOV_EXCL_START
+            return 0;
+            // LCOV_EXCL_STOP
+    }
+}
+
+unsigned long
+priority_queue_extract_min(priority_queue* pq, double* key)
+{
+    if (!pq || priority_queue_size(pq) == 0) {
+        // LCOV_EXCL_START
+        printf("priority queue - extract min: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    unsigned long value = 0;
+
+    switch (pq->type) {
+        case fibonacci_pq: {
+            fib_heap_ul_node* node = fib_heap_ul_extract_min(pq->heap.fibonacci);
+            value                  = node->value;
+            if (key) {
+                *key = node->key;
+            }
+            pq->handles[value] = NULL;
+            free(node);
+            break;
+        }
+        case d_ary_pq:
+            value = d_ary_heap_extract_min(pq->heap.d_ary, key);
+            break;
+        case radix_pq:
+            value = radix_heap_extract_min(pq->heap.radix, key);
+            break;
+        case pairing_pq: {
+            pairing_heap_ul_node* node =
+                  pairing_heap_ul_extract_min(pq->heap.pairing);
+            value = node->value;
+            if (key) {
+                *key = node->key;
+            }
+            pq->handles[value] = NULL;
+            free(node);
+            break;
+        }
+        default:
+            // LCOV_EXCL_START
+            break;
+            // LCOV_EXCL_STOP
+    }
+
+    return value;
+}
+
+const char*
+priority_queue_type_name(pq_type type)
+{
+    switch (type) {
+        case fibonacci_pq:
+            return "fibonacci";
+        case d_ary_pq:
+            return "4-ary";
+        case radix_pq:
+            return "radix";
+        case pairing_pq:
+            return "pairing";
+        default:
+            return "invalid";
+    }
+}
@@ -0,0 +1,354 @@
+/*!
+ * \file radix_heap.c
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief See \ref radix_heap.h
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "data-struct/radix_heap.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "strace.h"
+
+#define RADIX_HEAP_INITIAL_CAPACITY (16)
+
+#define NOT_CONTAINED (SIZE_MAX)
+
+static unsigned long
+key_to_bits(double key)
+{
+    unsigned long bits;
+    // Map -0.0 to 0.0, as its sign bit would break the ordering.
+    key = key == 0 ? 0 : key;
+    memcpy(&bits, &key, sizeof(bits));
+    return bits;
+}
+
+static double
+bits_to_key(unsigned long bits)
+{
+    double key;
+    memcpy(&key, &bits, sizeof(key));
+    return key;
+}
+
+static size_t
+bucket_index(unsigned long key_bits, unsigned long last_min)
+{
+    unsigned long diff = key_bits ^ last_min;
+
+    return diff == 0 ? 0
+                     : sizeof(unsigned long) * CHAR_BIT - __builtin_clzl(diff);
+}
+
+radix_heap*
+radix_heap_create(void)
+{
+    radix_heap* heap = calloc(1, sizeof(radix_heap));
+
+    if (!heap) {
+        // LCOV_EXCL_START
+        printf("radix heap - create: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    return heap;
+}
+
+void
+radix_heap_destroy(radix_heap* heap)
+{
+    if (!heap) {
+        // LCOV_EXCL_START
+        printf("radix heap - destroy: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    for (size_t i = 0; i < RADIX_HEAP_N_BUCKETS; ++i) {
+        free(heap->buckets[i].entries);
+    }
+
+    free(heap->bucket_of);
+    free(heap->position_of);
+    free(heap);
+}
+
+size_t
+radix_heap_size(radix_heap* heap)
+{
+    if (!heap) {
+        // LCOV_EXCL_START
+        printf("radix heap - size: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    return heap->size;
+}
+
+bool
+radix_heap_contains(radix_heap* heap, unsigned long value)
+{
+    if (!heap) {
+        // LCOV_EXCL_START
+        printf("radix heap - contains: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    return value < heap->index_capacity
+           && heap->bucket_of[value] != NOT_CONTAINED;
+}
+
+static void
+radix_heap_grow_index(radix_heap* heap, unsigned long value)
+{
+    size_t new_capacity = heap->index_capacity == 0
+                                ? RADIX_HEAP_INITIAL_CAPACITY
+                                : heap->index_capacity;
+
+    while (new_capacity <= value) {
+        new_capacity *= 2;
+    }
+
+    size_t* bucket_of = realloc(heap->bucket_of, new_capacity * sizeof(size_t));
+    size_t* position_of =
+          realloc(heap->position_of, new_capacity * sizeof(size_t));
+
+    if (!bucket_of || !position_of) {
+        // LCOV_EXCL_START
+        printf("radix heap - grow index: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    for (size_t i = heap->index_capacity; i < new_capacity; ++i) {
+        bucket_of[i]   = NOT_CONTAINED;
+        position_of[i] = NOT_CONTAINED;
+    }
+
+    heap->bucket_of      = bucket_of;
+    heap->position_of    = position_of;
+    heap->index_capacity = new_capacity;
+}
+
+static void
+radix_heap_bucket_append(radix_heap*   heap,
+                         size_t        bucket_idx,
+                         unsigned long key_bits,
+                         unsigned long value)
+{
+    radix_heap_bucket* bucket = &heap->buckets[bucket_idx];
+
+    if (bucket->size == bucket->capacity) {
+        bucket->capacity = bucket->capacity == 0 ? RADIX_HEAP_INITIAL_CAPACITY
+                                                 : 2 * bucket->capacity;
+        radix_heap_entry* entries = realloc(
+              bucket->entries, bucket->capacity * sizeof(radix_heap_entry));
+
+        if (!entries) {
+            // LCOV_EXCL_START
+            printf("radix heap - append: Failed to allocate memory!\n");
+            print_trace();
+
+            exit(EXIT_FAILURE);
+            // LCOV_EXCL_STOP
+        }
+        bucket->entries = entries;
+    }
+
+    bucket->entries[bucket->size].key_bits = key_bits;
+    bucket->entries[bucket->size].value    = value;
+    heap->bucket_of[value]                 = bucket_idx;
+    heap->position_of[value]               = bucket->size;
+    bucket->size++;
+}
+
+static void
+radix_heap_bucket_remove(radix_heap* heap, unsigned long value)
+{
+    radix_heap_bucket* bucket = &heap->buckets[heap->bucket_of[value]];
+    size_t             pos    = heap->position_of[value];
+
+    bucket->size--;
+    if (pos != bucket->size) {
+        bucket->entries[pos] = bucket->entries[bucket->size];
+        heap->position_of[bucket->entries[pos].value] = pos;
+    }
+
+    heap->bucket_of[value]   = NOT_CONTAINED;
+    heap->position_of[value] = NOT_CONTAINED;
+}
+
+void
+radix_heap_insert(radix_heap* heap, double key, unsigned long value)
+{
+    if (!heap || key < 0 || radix_heap_contains(heap, value)
+        || key_to_bits(key) < heap->last_min) {
+        // LCOV_EXCL_START
+        printf("radix heap - insert: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    if (value >= heap->index_capacity) {
+        radix_heap_grow_index(heap, value);
+    }
+
+    unsigned long key_bits = key_to_bits(key);
+    radix_heap_bucket_append(
+          heap, bucket_index(key_bits, heap->last_min), key_bits, value);
+    heap->size++;
+}
+
+void
+radix_heap_decrease_key(radix_heap* heap, unsigned long value, double key)
+{
+    if (!heap || key < 0 || !radix_heap_contains(heap, value)
+        || key_to_bits(key) < heap->last_min) {
+        // LCOV_EXCL_START
+        printf("radix heap - decrease key: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    unsigned long key_bits = key_to_bits(key);
+    unsigned long old_bits = heap->buckets[heap->bucket_of[value]]
+                                   .entries[heap->position_of[value]]
+                                   .key_bits;
+
+    if (key_bits >= old_bits) {
+        return;
+    }
+
+    radix_heap_bucket_remove(heap, value);
+    radix_heap_bucket_append(
+          heap, bucket_index(key_bits, heap->last_min), key_bits, value);
+}
+
+/* Makes sure that bucket 0 holds the minimum by redistributing the first
+ * non-empty bucket relative to its smallest key. */
+static void
+radix_heap_pull(radix_heap* heap)
+{
+    if (heap->buckets[0].size > 0) {
+        return;
+    }
+
+    size_t i = 1;
+    while (heap->buckets[i].size == 0) {
+        i++;
+    }
+
+    radix_heap_bucket* bucket  = &heap->buckets[i];
+    unsigned long      new_min = bucket->entries[0].key_bits;
+    for (size_t j = 1; j < bucket->size; ++j) {
+        if (bucket->entries[j].key_bits < new_min) {
+            new_min = bucket->entries[j].key_bits;
+        }
+    }
+
+    heap->last_min = new_min;
+
+    // Every element moves to a strictly smaller bucket, so the bucket can be
+    // emptied first and its entries be appended elsewhere afterwards.
+    size_t            n_entries = bucket->size;
+    radix_heap_entry* entries   = bucket->entries;
+    bucket->entries             = NULL;
+    bucket->size                = 0;
+    bucket->capacity            = 0;
+
+    for (size_t j = 0; j < n_entries; ++j) {
+        radix_heap_bucket_append(heap,
+                                 bucket_index(entries[j].key_bits, new_min),
+                                 entries[j].key_bits,
+                                 entries[j].value);
+    }
+
+    free(entries);
+}
+
+double
+radix_heap_min_key(radix_heap* heap)
+{
+    if (!heap || heap->size == 0) {
+        // LCOV_EXCL_START
+        printf("radix heap - min key: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    // Peeking must not advance the last minimum, as that would reject keys
+    // between the last extracted key and the current minimum.
+    size_t i = 0;
+    while (heap->buckets[i].size == 0) {
+        i++;
+    }
+
+    if (i == 0) {
+        return bits_to_key(heap->last_min);
+    }
+
+    unsigned long min = heap->buckets[i].entries[0].key_bits;
+    for (size_t j = 1; j < heap->buckets[i].size; ++j) {
+        if (heap->buckets[i].entries[j].key_bits < min) {
+            min = heap->buckets[i].entries[j].key_bits;
+        }
+    }
+
+    return bits_to_key(min);
+}
+
+unsigned long
+radix_heap_extract_min(radix_heap* heap, double* key)
+{
+    if (!heap || heap->size == 0) {
+        // LCOV_EXCL_START
+        printf("radix heap - extract min: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    radix_heap_pull(heap);
+
+    radix_heap_bucket* bucket = &heap->buckets[0];
+    unsigned long      value  = bucket->entries[bucket->size - 1].value;
+
+    if (key) {
+        *key = bits_to_key(heap->last_min);
+    }
+
+    radix_heap_bucket_remove(heap, value);
+    heap->size--;
+
+    return value;
+}
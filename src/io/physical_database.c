@@ -13,20 +13,113 @@
 #include "physical_database.h"
 
 #include <errno.h>
+#include <fcntl.h>
 #include <limits.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include "constants.h"
 #include "disk_file.h"
 #include "strace.h"
 
+/* The name of each record file is the database name followed by the suffix of
+ * its type. */
+static const char* const record_file_suffixes[invalid_ft] = {
+    "_nodes.db", "_relationships.db", "_degrees.db", "_groups.db",
+    "_adjacency.db", "_labels.db", "_node_labels.db",
+    "_relationship_labels.db", "_btree.db"
+};
+
+/* Files without slots that reference each other are recreated together, e.g.
+ * the degree entries point to the first relationship group of their node and
+ * the label index to the label chains. Each file is mapped to the first file
+ * of its set. */
+static const file_type recreated_with[invalid_ft] = {
+    node_ft,  relationship_ft, degree_ft, degree_ft, adjacency_ft,
+    label_ft, label_ft,        label_ft,  btree_ft
+};
+
+/* The files of generation 0 are named after the database, those of later
+ * generations after the database and the generation, e.g. "db.2_nodes.db".
+ * The catalogue of the current generation is always named "db.info". */
+static char*
+generation_file_name(const char*   db_name,
+                     unsigned long generation,
+                     const char*   suffix)
+{
+    // The longest unsigned long has 20 digits, plus the dot
+    char* file_name =
+          calloc(strlen(db_name) + 21 + strlen(suffix) + 1, sizeof(char));
+
+    if (!file_name) {
+        // LCOV_EXCL_START
+        printf("physical database: failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    if (generation == 0) {
+        sprintf(file_name, "%s%s", db_name, suffix);
+    } else {
+        sprintf(file_name, "%s.%lu%s", db_name, generation, suffix);
+    }
+
+    return file_name;
+}
+
+static unsigned long
+read_catalogue_value(phy_database* db, size_t offset)
+{
+    unsigned char catalogue_page[PAGE_SIZE];
+    unsigned long value;
+
+    read_page(db->catalogue, 0, catalogue_page, false);
+    memcpy(&value, catalogue_page + offset, sizeof(unsigned long));
+
+    return value;
+}
+
+/* Writes the generation, the number of changes and whether the database is
+ * open to the catalogue. */
+static void
+write_catalogue_state(phy_database* db, bool open)
+{
+    unsigned char catalogue_page[PAGE_SIZE];
+    unsigned long open_flag = open;
+
+    read_page(db->catalogue, 0, catalogue_page, false);
+    memcpy(catalogue_page + CATALOGUE_GENERATION_OFFSET,
+           &db->generation,
+           sizeof(unsigned long));
+    memcpy(catalogue_page + CATALOGUE_CHANGES_OFFSET,
+           &db->n_changes,
+           sizeof(unsigned long));
+    memcpy(catalogue_page + CATALOGUE_OPEN_OFFSET,
+           &open_flag,
+           sizeof(unsigned long));
+    write_page(db->catalogue, 0, catalogue_page, false);
+}
+
+/* The number of degree pages that cover the node slots. */
+static size_t
+degree_pages_needed(phy_database* db)
+{
+    size_t n_slots = db->records[node_ft]->num_pages * SLOTS_PER_PAGE;
+
+    return n_slots / DEGREE_ENTRIES_PER_PAGE
+           + (n_slots % DEGREE_ENTRIES_PER_PAGE != 0);
+}
+
 static phy_database*
-phy_database_create_internal(char*       db_name,
-                             bool        open,
-                             const char* log_file_name)
+phy_database_create_internal(const char*   db_name,
+                             unsigned long generation,
+                             bool          open,
+                             const char*   log_file_name)
 {
     if (!db_name || !log_file_name) {
         // LCOV_EXCL_START
@@ -61,33 +154,32 @@ exit(EXIT_FAILURE);
         // LCOV_EXCL_STOP
     }
 
-    char* catalogue_name =
-          calloc(strlen(db_name) + strlen(".info") + 1, sizeof(char));
-
-    strncpy(catalogue_name, db_name, strlen(db_name) + 1);
-
-    strncat(catalogue_name, ".info", strlen(".info"));
+    char* catalogue_name = generation_file_name(db_name, generation, ".info");
 
     if (!open) {
         phy_db->catalogue = disk_file_create(catalogue_name, phy_db->log_file);
         disk_file_grow(phy_db->catalogue, 1, false);
+        phy_db->generation = generation;
+        phy_db->n_changes  = 0;
     } else {
         phy_db->catalogue = disk_file_open(catalogue_name, phy_db->log_file);
+        phy_db->generation =
+              read_catalogue_value(phy_db, CATALOGUE_GENERATION_OFFSET);
+        phy_db->n_changes =
+              read_catalogue_value(phy_db, CATALOGUE_CHANGES_OFFSET);
+
+        if (read_catalogue_value(phy_db, CATALOGUE_OPEN_OFFSET)) {
+            phy_db->n_changes += UNCLOSED_CHANGES;
+        }
     }
+    generation = phy_db->generation;
+    write_catalogue_state(phy_db, true);
 
     /* Create or open header files for the record files */
-    // +1 as strlen does not count \0
     char* nodes_header_name =
-          calloc(strlen(db_name) + strlen("_nodes.idx") + 1, sizeof(char));
-    char* rels_header_name = calloc(
-          strlen(db_name) + strlen("_relationships.idx") + 1, sizeof(char));
-
-    strncpy(nodes_header_name, db_name, strlen(db_name) + 1);
-    strncpy(rels_header_name, db_name, strlen(db_name) + 1);
-
-    strncat(nodes_header_name, "_nodes.idx", strlen("_nodes.idx"));
-    strncat(
-          rels_header_name, "_relationships.idx", strlen("_relationships.idx"));
+          generation_file_name(db_name, generation, "_nodes.idx");
+    char* rels_header_name =
+          generation_file_name(db_name, generation, "_relationships.idx");
 
     if (!open) {
         phy_db->header[node_ft] =
@@ -102,32 +194,37 @@ exit(EXIT_FAILURE);
     }
 
     /* Create or open Record files */
-    // +1 as strlen does not count \0
-    char* nodes_file_name =
-          calloc(strlen(db_name) + strlen("_nodes.db") + 1, sizeof(char));
-    char* rels_file_name = calloc(
-          strlen(db_name) + strlen("_relationships.db") + 1, sizeof(char));
+    char* record_file_names[invalid_ft];
+    for (file_type ft = 0; ft < invalid_ft; ++ft) {
+        record_file_names[ft] = generation_file_name(
+              db_name, generation, record_file_suffixes[ft]);
 
-    strncpy(nodes_file_name, db_name, strlen(db_name) + 1);
-    strncpy(rels_file_name, db_name, strlen(db_name) + 1);
+        if (open && ft >= NUM_SLOTTED_FILE_TYPES
+            && access(record_file_names[ft], F_OK) != 0) {
+            phy_db->recreated[recreated_with[ft]] = true;
+        }
+    }
 
-    strncat(nodes_file_name, "_nodes.db", strlen("_nodes.db"));
-    strncat(rels_file_name, "_relationships.db", strlen("_relationships.db"));
+    for (file_type ft = 0; ft < invalid_ft; ++ft) {
+        phy_db->recreated[ft] = phy_db->recreated[recreated_with[ft]];
 
-    if (!open) {
-        phy_db->records[node_ft] =
-              disk_file_create(nodes_file_name, phy_db->log_file);
-        phy_db->records[relationship_ft] =
-              disk_file_create(rels_file_name, phy_db->log_file);
-    } else {
-        phy_db->records[node_ft] =
-              disk_file_open(nodes_file_name, phy_db->log_file);
-        phy_db->records[relationship_ft] =
-              disk_file_open(rels_file_name, phy_db->log_file);
+        if (!open || phy_db->recreated[ft]) {
+            phy_db->records[ft] =
+                  disk_file_create(record_file_names[ft], phy_db->log_file);
+        } else {
+            phy_db->records[ft] =
+                  disk_file_open(record_file_names[ft], phy_db->log_file);
+        }
+    }
+
+    if (phy_db->recreated[degree_ft]) {
+        disk_file_grow(phy_db->records[degree_ft],
+                       degree_pages_needed(phy_db),
+                       false);
     }
 
     bool valid_header;
-    for (file_type ft = 0; ft < invalid_ft; ++ft) {
+    for (file_type ft = 0; ft < NUM_SLOTTED_FILE_TYPES; ++ft) {
         /* check if record file is empty. */
 
         /* If it is empty, write an empty page to the header file. Alternatively
@@ -152,19 +249,61 @@ exit(EXIT_FAILURE);
         }
     }
 
+    if (!phy_database_validate_degrees(phy_db)) {
+        // LCOV_EXCL_START
+        printf("physical database: failed to open database - Invalid "
+               "degree file!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
     return phy_db;
 }
 
 phy_database*
 phy_database_open(char* db_name, const char* log_file_name)
 {
-    return phy_database_create_internal(db_name, true, log_file_name);
+    return phy_database_create_internal(db_name, 0, true, log_file_name);
 }
 
 phy_database*
 phy_database_create(char* db_name, const char* log_file_name)
 {
-    return phy_database_create_internal(db_name, false, log_file_name);
+    return phy_database_create_internal(db_name, 0, false, log_file_name);
+}
+
+phy_database*
+phy_database_create_next(phy_database* db, const char* log_file_name)
+{
+    if (!db || !log_file_name) {
+        // LCOV_EXCL_START
+        printf("physical database - create next: Invalid arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    size_t len     = strlen(db->catalogue->file_name) - strlen(".info");
+    char*  db_name = calloc(len + 1, sizeof(char));
+
+    if (!db_name) {
+        // LCOV_EXCL_START
+        printf("physical database: failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+    memcpy(db_name, db->catalogue->file_name, len);
+
+    phy_database* next = phy_database_create_internal(
+          db_name, db->generation + 1, false, log_file_name);
+    free(db_name);
+
+    return next;
 }
 
 void
@@ -179,18 +318,23 @@ exit(EXIT_FAILURE);
         // LCOV_EXCL_STOP
     }
 
+    write_catalogue_state(db, false);
+
     char* catalogue_fname = db->catalogue->file_name;
     disk_file_destroy(db->catalogue);
     free(catalogue_fname);
 
     char* header_fname;
+    for (file_type ft = 0; ft < NUM_SLOTTED_FILE_TYPES; ++ft) {
+        header_fname = db->header[ft]->file_name;
+        disk_file_destroy(db->header[ft]);
+        free(header_fname);
+    }
+
     char* record_fname;
     for (file_type ft = 0; ft < invalid_ft; ++ft) {
-        header_fname = db->header[ft]->file_name;
         record_fname = db->records[ft]->file_name;
-        disk_file_destroy(db->header[ft]);
         disk_file_destroy(db->records[ft]);
-        free(header_fname);
         free(record_fname);
     }
 
@@ -223,13 +367,16 @@ exit(EXIT_FAILURE);
     free(catalogue_fname);
 
     char* header_fname;
+    for (file_type ft = 0; ft < NUM_SLOTTED_FILE_TYPES; ++ft) {
+        header_fname = db->header[ft]->file_name;
+        disk_file_delete(db->header[ft]);
+        free(header_fname);
+    }
+
     char* record_fname;
     for (file_type ft = 0; ft < invalid_ft; ++ft) {
-        header_fname = db->header[ft]->file_name;
         record_fname = db->records[ft]->file_name;
-        disk_file_delete(db->header[ft]);
         disk_file_delete(db->records[ft]);
-        free(header_fname);
         free(record_fname);
     }
 
@@ -329,10 +476,28 @@ phy_database_validate_header(phy_database* db, file_type ft)
     return true;
 }
 
+bool
+phy_database_validate_degrees(phy_database* db)
+{
+    size_t n_pages = degree_pages_needed(db);
+
+    if (db->records[degree_ft]->num_pages != n_pages) {
+        printf("physical database - validate degrees: Degree file %s has %zu "
+               "pages, but %zu are needed for the node slots of %s!\n",
+               db->records[degree_ft]->file_name,
+               db->records[degree_ft]->num_pages,
+               n_pages,
+               db->records[node_ft]->file_name);
+        return false;
+    }
+
+    return true;
+}
+
 void
 allocate_pages(phy_database* db, file_type ft, size_t num_pages, bool log)
 {
-    if (!db || (ft != node_ft && ft != relationship_ft)) {
+    if (!db || ft == degree_ft || ft >= invalid_ft) {
         // LCOV_EXCL_START
         printf("physical database - allocate: Invalid arguments!\n");
         print_trace();
@@ -343,6 +508,11 @@ exit(EXIT_FAILURE);
 
     disk_file_grow(db->records[ft], num_pages, log);
 
+    /* Files without slots have no header and no entry in the catalogue. */
+    if (ft >= NUM_SLOTTED_FILE_TYPES) {
+        return;
+    }
+
     /* Compute the number of header bits that will be used due to the groth of
      * the record file. */
     size_t neccessary_bits = num_pages * (PAGE_SIZE / SLOT_SIZE);
@@ -381,6 +551,153 @@ exit(EXIT_FAILURE);
     memcpy(
           catalogue + ft * sizeof(unsigned long), &bits, sizeof(unsigned long));
     write_page(db->catalogue, 0, catalogue, log);
+
+    /* Every node slot has a degree entry. New degree pages are zeroed by
+     * growing the file, so new nodes start without relationships. */
+    if (ft == node_ft) {
+        size_t n_pages = degree_pages_needed(db);
+
+        if (n_pages > db->records[degree_ft]->num_pages) {
+            disk_file_grow(db->records[degree_ft],
+                           n_pages - db->records[degree_ft]->num_pages,
+                           log);
+        }
+    }
+}
+
+static void
+sync_file(disk_file* df)
+{
+    if (fflush(df->file) != 0) {
+        // LCOV_EXCL_START
+        printf("physical database - replace: Failed to flush %s: %s\n",
+               df->file_name,
+               strerror(errno));
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+    disk_file_sync(df);
+}
+
+/* Makes the renames of the files in the directory of \p file_name durable. */
+static void
+sync_directory(const char* file_name)
+{
+    // Without a slash the file is in the working directory, "/" is the root
+    const char* slash    = strrchr(file_name, '/');
+    size_t      len      = !slash || slash == file_name ? 1 : slash - file_name;
+    char*       dir_name = calloc(len + 1, sizeof(char));
+
+    if (!dir_name) {
+        // LCOV_EXCL_START
+        printf("physical database: failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+    memcpy(dir_name, slash ? file_name : ".", len);
+
+    int fd = open(dir_name, O_RDONLY);
+
+    if (fd == -1 || fsync(fd) == -1 || close(fd) == -1) {
+        // LCOV_EXCL_START
+        printf("physical database - replace: Failed to sync directory %s: "
+               "%s\n",
+               dir_name,
+               strerror(errno));
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+    free(dir_name);
+}
+
+/* Removes the old file and takes over the new one with its name. */
+static void
+adopt_file(disk_file** file, disk_file* replacement, FILE* log_file)
+{
+    char* file_name = (*file)->file_name;
+    disk_file_delete(*file);
+    free(file_name);
+
+    disk_file_swap_log_file(replacement, log_file);
+    *file = replacement;
+}
+
+void
+phy_database_replace(phy_database* db, phy_database* replacement)
+{
+    if (!db || !replacement || db == replacement
+        || replacement->generation != db->generation + 1) {
+        // LCOV_EXCL_START
+        printf("physical database - replace: Invalid arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    // The rebuild changed the records
+    replacement->n_changes = db->n_changes + 1;
+    write_catalogue_state(replacement, true);
+
+    sync_file(replacement->catalogue);
+    for (file_type ft = 0; ft < NUM_SLOTTED_FILE_TYPES; ++ft) {
+        sync_file(replacement->header[ft]);
+    }
+    for (file_type ft = 0; ft < invalid_ft; ++ft) {
+        sync_file(replacement->records[ft]);
+    }
+
+    // The catalogue names the generation of the other files, so that this
+    // single rename switches the database to the new files
+    char* catalogue_name = db->catalogue->file_name;
+    if (rename(replacement->catalogue->file_name, catalogue_name) != 0) {
+        // LCOV_EXCL_START
+        printf("physical database - replace: Failed to rename %s to %s: "
+               "%s\n",
+               replacement->catalogue->file_name,
+               catalogue_name,
+               strerror(errno));
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+    sync_directory(catalogue_name);
+
+    disk_file_destroy(db->catalogue);
+    free(replacement->catalogue->file_name);
+    replacement->catalogue->file_name = catalogue_name;
+    disk_file_swap_log_file(replacement->catalogue, db->log_file);
+    db->catalogue = replacement->catalogue;
+
+    for (file_type ft = 0; ft < NUM_SLOTTED_FILE_TYPES; ++ft) {
+        adopt_file(&db->header[ft], replacement->header[ft], db->log_file);
+        db->remaining_header_bits[ft] = replacement->remaining_header_bits[ft];
+    }
+
+    for (file_type ft = 0; ft < invalid_ft; ++ft) {
+        adopt_file(&db->records[ft], replacement->records[ft], db->log_file);
+    }
+    db->generation = replacement->generation;
+    db->n_changes  = replacement->n_changes;
+
+    if (fclose(replacement->log_file) != 0) {
+        // LCOV_EXCL_START
+        printf("physical database - replace: Error closing file: %s",
+               strerror(errno));
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    free(replacement);
 }
 
 void
@@ -419,8 +736,11 @@ exit(EXIT_FAILURE);
 
     disk_file_swap_log_file(pdb->catalogue, pdb->log_file);
 
-    for (size_t i = 0; i < invalid_ft; ++i) {
+    for (size_t i = 0; i < NUM_SLOTTED_FILE_TYPES; ++i) {
         disk_file_swap_log_file(pdb->header[i], pdb->log_file);
+    }
+
+    for (size_t i = 0; i < invalid_ft; ++i) {
         disk_file_swap_log_file(pdb->records[i], pdb->log_file);
     }
 }
@@ -27,6 +27,8 @@
  *
  *  The file_type encodes if the referenced disk file carries node or
  * relationship records or is the respective header.
+ * Node and relationship files are divided into slots, which are addressed by
+ * a header. All other file types only have a records file.
  */
 typedef enum
 {
@@ -34,10 +36,52 @@ typedef enum
     node_ft,
     /*! Indicates that the file is storing or addressing relationships. */
     relationship_ft,
+    /*! Indicates that the file is storing the degree counters of the node
+     * slots, see \ref DEGREE_ENTRY_SIZE. It grows along with the node records
+     * in \ref allocate_pages(). */
+    degree_ft,
+    /*! Indicates that the file is storing the relationship groups of dense
+     * nodes, see \ref relationship_group.h. */
+    group_ft,
+    /*! Indicates that the file is storing the hash index from source and
+     * target to relationship ids, see \ref hash_index.h. */
+    adjacency_ft,
+    /*! Indicates that the file is storing the hash index from record type and
+     * label to the first record with that label, see \ref label_index.h. */
+    label_ft,
+    /*! Indicates that the file is storing the label chain entries of the node
+     * slots, see \ref label_index.h. */
+    node_label_ft,
+    /*! Indicates that the file is storing the label chain entries of the
+     * relationship slots, see \ref label_index.h. */
+    relationship_label_ft,
+    /*! Indicates that the file is storing a B+-tree from unsigned long keys
+     * to values, see \ref btree.h. */
+    btree_ft,
     /*! Is used to iterate, as "NULL" value and to validate parameters. */
     invalid_ft
 } file_type;
 
+/*! The number of file types that have a header, i.e. the file types before
+ * the first type without slots. */
+#define NUM_SLOTTED_FILE_TYPES (relationship_ft + 1)
+
+/*! The offset of the generation of the files in the first catalogue page,
+ * after the number of slots of each slotted record file. */
+#define CATALOGUE_GENERATION_OFFSET                                            \
+    (NUM_SLOTTED_FILE_TYPES * sizeof(unsigned long))
+
+/*! The offset of phy_database::n_changes in the first catalogue page. */
+#define CATALOGUE_CHANGES_OFFSET                                               \
+    (CATALOGUE_GENERATION_OFFSET + sizeof(unsigned long))
+
+/*! The offset of the flag that is set while the database is open. */
+#define CATALOGUE_OPEN_OFFSET (CATALOGUE_CHANGES_OFFSET + sizeof(unsigned long))
+
+/*! Added to phy_database::n_changes when opening a database that was not
+ * closed, as the changes since it was last closed are unknown. */
+#define UNCLOSED_CHANGES (1UL << 32)
+
 /*! \enum file_kind
  *
  *  The file kind encodes if the file holds records or header bitmaps or the
@@ -77,11 +121,12 @@ typedef struct
 {
     /*! The system catalogue of the system, see #file_kind. */
     disk_file* catalogue;
-    /*! One header for each record file, see #file_kind. */
-    disk_file* header[2];
-    /*! One record file for each record type (nodes, relationships), see
+    /*! One header for each slotted record file, see #file_kind. */
+    disk_file* header[NUM_SLOTTED_FILE_TYPES];
+    /*! One record file for each record type (nodes, relationships, degrees,
+     * relationship groups, adjacency index, label index, B+-tree), see
      * #file_kind. */
-    disk_file* records[2];
+    disk_file* records[invalid_ft];
     /*! When allocating a header page, not neccessarily enough record pages are
      * available to be mapped by the header. Thus the remaining_header_bits
      * field stores the amount of bits that are not in use. Imagine allocating a
@@ -89,7 +134,19 @@ typedef struct
      * header page only needs to address 256 slots and thus only 256 of the 4096
      * x 8 bits are in use. For details on header page allocation, see
      * allocate_page().  */
-    size_t remaining_header_bits[2];
+    size_t remaining_header_bits[NUM_SLOTTED_FILE_TYPES];
+    /*! The generation of the files, which \ref phy_database_replace()
+     * increments. It is stored in the catalogue and is part of the names of
+     * all other files, see \ref phy_database_create_next(). */
+    unsigned long generation;
+    /*! Counts the record updates and deletes of the heap file. Together with
+     * the generation it identifies the state of the graph, e.g. for stored
+     * preprocessing results. Written to the catalogue when closing. */
+    unsigned long n_changes;
+    /*! Marks the files without slots that were missing when opening the
+     * database, e.g. as it was written before they existed, and were created
+     * empty. \ref heap_file_create() rebuilds them from the records. */
+    bool recreated[invalid_ft];
     /*! A FILE*, that is used for logging at the file level. This is passed
      * through to the disk_filestructs. */
     FILE* log_file;
@@ -100,8 +157,11 @@ typedef struct
  * Allocates memory for the stuct itself, opens the log file from the path \p
  * log_file, assigns each file the name and an ending: ".info" for the
  * catalogue, ".idx" for the headers and ".db" for records. The header and
- * record file also contain either "nodes" or "relationships" before the suffix.
- * It then creates the disk files and validates the empty header (see
+ * record file also contain either "nodes" or "relationships" before the suffix,
+ * the degree, group and adjacency files are named "degrees.db", "groups.db"
+ * and "adjacency.db", the label index files "labels.db", "node_labels.db" and
+ * "relationship_labels.db" and the B+-tree file "btree.db". It then
+ * creates the disk files and validates the empty header (see
  * phy_database_validate_empty_header()).
  *
  * \param db_name The base name of the database.
@@ -119,8 +179,16 @@ phy_database_create(char* db_name, const char* log_file);
  * from the path \p log_file, assigns each file the name and an ending: ".info"
  * for the catalogue, ".idx" for the headers and ".db" for records. The header
  * and record file also contain either "nodes" or "relationships" before the
- * suffix. It then opens the disk files and validates the  header (see
- * phy_database_validate_header() and phy_database_validate_empty_header()).
+ * suffix, the degree, group and adjacency files are named "degrees.db",
+ * "groups.db" and "adjacency.db", the label index files "labels.db",
+ * "node_labels.db" and "relationship_labels.db" and the B+-tree file
+ * "btree.db", preceded by the generation read from the catalogue if that is
+ * not zero (see \ref phy_database_create_next()). It then opens the disk files
+ * and validates the header (see phy_database_validate_header() and
+ * phy_database_validate_empty_header()) and the degree file (see
+ * phy_database_validate_degrees()). Missing files without slots are created
+ * empty and marked in phy_database::recreated, together with the files that
+ * reference them, and the degree file is grown to cover the node slots.
  *
  * \param db_name The base name of the database.
  * \param log_file The path where the underlying disk files shall log their
@@ -131,6 +199,19 @@ phy_database_create(char* db_name, const char* log_file);
 phy_database*
 phy_database_open(char* db_name, const char* log_file);
 
+/*!
+ * Creates an empty database for the next generation of the files of \p db,
+ * to be swapped in by \ref phy_database_replace(). The files are named after
+ * the database and the generation, e.g. "db.1_nodes.db" and "db.1.info".
+ *
+ * \param db The database that shall be replaced later on.
+ * \param log_file The path where the new files shall log their operations to.
+ * \return A pointer to an initialized phy_database struct with newly created
+ * files on disk.
+ */
+phy_database*
+phy_database_create_next(phy_database* db, const char* log_file);
+
 /*!
  *  Deletes the physical database, especially the underlying files on disk.
  *  Deletes all disk files by calling \ref disk_file_delete() for each, closes
@@ -143,8 +224,9 @@ phy_database_delete(phy_database* db);
 
 /*!
  *  Closes the physical database.
- *  Closes all disk files by calling \ref disk_file_destroy() for each, closes
- * the log file, frees the char* used for the file names.
+ *  Writes phy_database::n_changes to the catalogue, closes all disk files by
+ *  calling \ref disk_file_destroy() for each, closes the log file, frees the
+ *  char* used for the file names.
  *
  *  \param db The physical database to delete.
  */
@@ -183,12 +265,25 @@ phy_database_validate_empty_header(phy_database* db, file_type ft);
 bool
 phy_database_validate_header(phy_database* db, file_type ft);
 
+/*!
+ *  Validates the degree file.
+ *  The degree file must have exactly as many pages as are necessary to store
+ * one degree entry per slot of the node record file.
+ *
+ * \param db The phy_database struct, which holds the degree file.
+ * \return true if the degree file is valid, false if it isn't.
+ */
+bool
+phy_database_validate_degrees(phy_database* db);
+
 /*!
  * This function takes care of allocation new record pages for a specified
  * file_type \p ft, i.e. growing the record file by \p num_pages and if
  * necessary also allocating new header pages. In contrast to \ref
  * disk_file_grow(), this function handles both record files and headers as a
- * dependent entity instead of independently growing them.
+ * dependent entity instead of independently growing them. Growing the node
+ * records also grows the degree file to cover the new slots, which can thus
+ * not be grown on its own. Other files without header are just grown.
  *
  * \param db The phy_database that shall be grown.
  * \param ft The type (node or relationship) of the record and header files to
@@ -199,6 +294,23 @@ phy_database_validate_header(phy_database* db, file_type ft);
 void
 allocate_pages(phy_database* db, file_type ft, size_t num_pages, bool log);
 
+/*!
+ * Replaces the files of \p db by the ones of \p replacement, e.g. after
+ * rebuilding them in a different order. All files of the replacement are
+ * synced, then its catalogue, which holds the generation of the files, is
+ * renamed over the one of \p db and the directory is synced. This single
+ * rename switches from the old files to the new ones, so that the database is
+ * either completely old or completely new on disk. The old files are deleted
+ * afterwards. The new files stay open and log to the log file of \p db. Frees
+ * \p replacement, whose log file is closed but not removed.
+ *
+ * \param db The phy_database whose files shall be replaced.
+ * \param replacement The phy_database holding the new files, created by
+ * \ref phy_database_create_next() for \p db.
+ */
+void
+phy_database_replace(phy_database* db, phy_database* replacement);
+
 /*!
  * Swaps the log file of the physical database and all its contained disk files.
  *
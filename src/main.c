@@ -12,6 +12,7 @@
 #include "access/node.h"
 #include "access/relationship.h"
 #include "data-struct/htable.h"
+#include "order/louvain.h"
 #include "order/random_order.h"
 #include "order/reorder_records.h"
 #include "page_cache.h"
@@ -19,6 +20,7 @@
 #include "query/a-star.h"
 #include "query/alt.h"
 #include "query/bfs.h"
+#include "query/delta_stepping.h"
 #include "query/dfs.h"
 #include "query/dijkstra.h"
 #include "query/random_walk.h"
@@ -84,11 +86,17 @@ main(void)
 
     array_list_node_destroy(nodes);
 
-    // Preprocess the landmarks for alt
-    const unsigned long n_landmarks = 3;
-    dict_ul_d*          landmarks[3];
+    // Preprocess the landmarks for alt unless they are stored already
+    alt_landmarks* landmarks = alt_landmarks_load(hf, db_name);
+    if (!landmarks) {
+        landmarks = alt_preprocess(
+              hf, OUTGOING, NUM_LANDMARKS, alt_avoid, false, NULL);
+        alt_landmarks_save(landmarks, db_name);
+    }
 
-    alt_preprocess(hf, OUTGOING, n_landmarks, landmarks, false, NULL);
+    // The exact distances to the end node serve as heuristic for A*
+    sssp_result* heuristic =
+          delta_stepping(hf, end_id, INCOMING, 0, false, NULL);
 
     // Create and open a log file to log the accesses before reordering the
     // records
@@ -110,16 +118,10 @@ main(void)
     traversal_result* dfs_res = dfs(hf, start_id, OUTGOING, true, log_file);
     sssp_result*      dijkstra_res =
           dijkstra(hf, start_id, OUTGOING, true, log_file);
-    path* alt_res    = alt(hf,
-                        landmarks,
-                        n_landmarks,
-                        start_id,
-                        end_id,
-                        OUTGOING,
-                        true,
-                        log_file);
+    path* alt_res    = alt(hf, landmarks, start_id, end_id, true, log_file);
     path* a_star_res = a_star(hf,
-                              dijkstra_res->distances,
+                              a_star_dict_heuristic,
+                              heuristic->distances,
                               start_id,
                               end_id,
                               OUTGOING,
@@ -132,6 +134,7 @@ main(void)
     path_destroy(alt_res);
     path_destroy(a_star_res);
     sssp_result_destroy(dijkstra_res);
+    sssp_result_destroy(heuristic);
 
     if (fclose(log_file) != 0) {
         printf("Main: error closing file %s: %s\n",
@@ -155,29 +158,9 @@ main(void)
     page_cache_change_n_frames(pc, kib_to_gib);
 
     printf("Main: Reordering the graph on disk.\n");
-    system("python "
-           "/home/someusername/sync/workspace/uni/master/scripts/"
-           "modularity_order.py");
-    FILE* seq_file =
-          fopen("/home/someusername/workspace_local/node_seq.txt", "r");
-    if (!seq_file) {
-        printf("Main: Error opening file %s, %s\n",
-               "node_seq.txt",
-               strerror(errno));
-        exit(EXIT_FAILURE);
-    }
-
-    unsigned long* seq =
-          malloc(get_no_nodes(EMAIL_EU_CORE) * sizeof(unsigned long));
-    node_t* node;
-    for (size_t i = 0; i < get_no_nodes(EMAIL_EU_CORE); ++i) {
-        fscanf(seq_file, "%lu\n", &seq[i]);
-        node   = find_node(hf, seq[i], false);
-        seq[i] = node->id;
-        free(node);
-    }
-    reorder_nodes_by_sequence(hf, seq, true);
-    free(seq);
+    community_result* comms = communities(hf, leiden_method, 1.0, false);
+    reorder_nodes_by_sequence(hf, comms->sequence, true);
+    community_result_destroy(comms);
 
     reorder_relationships_by_nodes(hf, true);
     sort_incidence_list(hf, true);
@@ -189,10 +172,11 @@ main(void)
     free(start_node);
     free(end_node);
 
-    for (size_t i = 0; i < n_landmarks; ++i) {
-        dict_ul_d_destroy(landmarks[i]);
-    }
-    alt_preprocess(hf, OUTGOING, n_landmarks, landmarks, false, NULL);
+    alt_landmarks_destroy(landmarks);
+    landmarks =
+          alt_preprocess(hf, OUTGOING, NUM_LANDMARKS, alt_avoid, false, NULL);
+    alt_landmarks_save(landmarks, db_name);
+    heuristic = delta_stepping(hf, end_id, INCOMING, 0, false, NULL);
 
     // swap the log files to capture the queries after reordering
     log_name_pdb   = "pdb_after.log";
@@ -222,14 +206,15 @@ main(void)
     bfs_res      = bfs(hf, start_id, OUTGOING, true, log_file);
     dfs_res      = dfs(hf, start_id, OUTGOING, true, log_file);
     dijkstra_res = dijkstra(hf, start_id, OUTGOING, true, log_file);
-    alt_res = alt(hf, landmarks, 3, start_id, end_id, OUTGOING, true, log_file);
-    a_star_res = a_star(hf,
-                        dijkstra_res->distances,
-                        start_id,
-                        end_id,
-                        OUTGOING,
-                        true,
-                        log_file);
+    alt_res      = alt(hf, landmarks, start_id, end_id, true, log_file);
+    a_star_res   = a_star(hf,
+                          a_star_dict_heuristic,
+                          heuristic->distances,
+                          start_id,
+                          end_id,
+                          OUTGOING,
+                          true,
+                          log_file);
 
     // free the results, close the log_file
     traversal_result_destroy(bfs_res);
@@ -237,10 +222,9 @@ main(void)
     path_destroy(alt_res);
     path_destroy(a_star_res);
     sssp_result_destroy(dijkstra_res);
+    sssp_result_destroy(heuristic);
 
-    for (size_t i = 0; i < n_landmarks; ++i) {
-        dict_ul_d_destroy(landmarks[i]);
-    }
+    alt_landmarks_destroy(landmarks);
 
     if (fclose(log_file) != 0) {
         printf("Main: error closing file %s: %s\n",
@@ -254,6 +238,7 @@ main(void)
     heap_file_destroy(hf);
     page_cache_destroy(pc);
     phy_database_delete(pdb);
+    alt_landmarks_delete_file(db_name);
 
     return 0;
 }
@@ -0,0 +1,631 @@
+/*!
+ * \file draw.c
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief See \ref draw.h
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "order/draw.h"
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "access/node.h"
+#include "access/relationship.h"
+#include "constants.h"
+#include "data-struct/set.h"
+#include "order/reorder_records.h"
+#include "strace.h"
+
+#define DRAW_MAX_LINE_LENGTH (256)
+#define DRAW_PAIR_BITS       (32)
+
+typedef struct
+{
+    unsigned long key;
+    unsigned long weight;
+} draw_edge;
+
+typedef struct
+{
+    unsigned long  weight;
+    unsigned long* members;
+    size_t         n_members;
+} draw_cluster;
+
+/* The ids of the records before and after the swaps of one call. */
+typedef struct
+{
+    dict_ul_ul* current;
+    dict_ul_ul* origin;
+} draw_moves;
+
+static void*
+draw_calloc(size_t n, size_t size)
+{
+    void* ptr = calloc(n, size);
+
+    if (!ptr) {
+        // LCOV_EXCL_START
+        printf("draw - calloc: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    return ptr;
+}
+
+static unsigned long
+record_slots(file_type ft)
+{
+    return ft == node_ft ? NUM_SLOTS_PER_NODE : NUM_SLOTS_PER_REL;
+}
+
+static unsigned long
+dense_index(unsigned long id, unsigned long n_slots)
+{
+    return ((id >> CHAR_BIT) * SLOTS_PER_PAGE + (id & UCHAR_MAX)) / n_slots;
+}
+
+static unsigned long
+position_id(unsigned long index, unsigned long n_slots)
+{
+    const unsigned long per_page = SLOTS_PER_PAGE / n_slots;
+
+    return (index / per_page) << CHAR_BIT | (index % per_page) * n_slots;
+}
+
+static unsigned long
+pair_key(unsigned long fst, unsigned long snd)
+{
+    return fst < snd ? fst << DRAW_PAIR_BITS | snd
+                     : snd << DRAW_PAIR_BITS | fst;
+}
+
+static void
+add_to(dict_ul_ul* counts, unsigned long key, unsigned long amount)
+{
+    unsigned long count = 0;
+    dict_ul_ul_get(counts, key, &count);
+    dict_ul_ul_insert(counts, key, count + amount);
+}
+
+static void
+draw_hook(void* context, bool node, unsigned long id)
+{
+    draw_reorganizer* reorganizer = context;
+
+    if (reorganizer->migrating) {
+        return;
+    }
+
+    reorganizer->n_accesses++;
+    if (reorganizer->n_accesses % reorganizer->sample_interval == 0) {
+        draw_record_access(reorganizer, node, id);
+    }
+}
+
+draw_reorganizer*
+draw_reorganizer_create(heap_file* hf, size_t window, size_t sample_interval)
+{
+    if (!hf || window < 1 || sample_interval < 1) {
+        // LCOV_EXCL_START
+        printf("draw - create: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    draw_reorganizer* reorganizer = draw_calloc(1, sizeof(draw_reorganizer));
+    reorganizer->hf               = hf;
+    reorganizer->window           = window;
+    reorganizer->sample_interval  = sample_interval;
+
+    for (file_type ft = 0; ft < NUM_SLOTTED_FILE_TYPES; ++ft) {
+        reorganizer->stats[ft].heat      = d_ul_ul_create();
+        reorganizer->stats[ft].co_access = d_ul_ul_create();
+        reorganizer->stats[ft].recent =
+              draw_calloc(window, sizeof(unsigned long));
+    }
+
+    hf->access_hook    = draw_hook;
+    hf->access_context = reorganizer;
+
+    return reorganizer;
+}
+
+void
+draw_reorganizer_destroy(draw_reorganizer* reorganizer)
+{
+    if (!reorganizer) {
+        // LCOV_EXCL_START
+        printf("draw - destroy: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    if (reorganizer->hf->access_context == reorganizer) {
+        reorganizer->hf->access_hook    = NULL;
+        reorganizer->hf->access_context = NULL;
+    }
+
+    for (file_type ft = 0; ft < NUM_SLOTTED_FILE_TYPES; ++ft) {
+        dict_ul_ul_destroy(reorganizer->stats[ft].heat);
+        dict_ul_ul_destroy(reorganizer->stats[ft].co_access);
+        free(reorganizer->stats[ft].recent);
+    }
+
+    free(reorganizer);
+}
+
+void
+draw_record_access(draw_reorganizer* reorganizer,
+                   bool              node,
+                   unsigned long     id)
+{
+    if (!reorganizer || id == UNINITIALIZED_LONG) {
+        // LCOV_EXCL_START
+        printf("draw - record access: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    file_type        ft      = node ? node_ft : relationship_ft;
+    draw_statistics* stats   = &reorganizer->stats[ft];
+    unsigned long    n_slots = record_slots(ft);
+    unsigned long    index   = dense_index(id, n_slots);
+
+    add_to(stats->heat, id, 1);
+
+    // Repeated reads of the same record within the window count once
+    for (size_t i = 0; i < stats->n_recent; ++i) {
+        if (stats->recent[i] == id) {
+            return;
+        }
+    }
+
+    unsigned long other;
+    for (size_t i = 0; i < stats->n_recent; ++i) {
+        other = dense_index(stats->recent[i], n_slots);
+        if (index >> DRAW_PAIR_BITS == 0 && other >> DRAW_PAIR_BITS == 0) {
+            add_to(stats->co_access, pair_key(index, other), 1);
+        }
+    }
+
+    stats->recent[stats->next_recent] = id;
+    stats->next_recent = (stats->next_recent + 1) % reorganizer->window;
+    if (stats->n_recent < reorganizer->window) {
+        stats->n_recent++;
+    }
+}
+
+void
+draw_read_log(draw_reorganizer* reorganizer, const char* log_path)
+{
+    if (!reorganizer || !log_path) {
+        // LCOV_EXCL_START
+        printf("draw - read log: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    FILE* log_file = fopen(log_path, "r");
+
+    if (!log_file) {
+        // LCOV_EXCL_START
+        printf("draw - read log: Failed to open %s!\n", log_path);
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    char          line[DRAW_MAX_LINE_LENGTH];
+    char          name[DRAW_MAX_LINE_LENGTH];
+    char          type[DRAW_MAX_LINE_LENGTH];
+    unsigned long id;
+
+    while (fgets(line, DRAW_MAX_LINE_LENGTH, log_file)) {
+        if (sscanf(line, "%255s %255s %lu", name, type, &id) == 3
+            && (strcmp(type, "N") == 0 || strcmp(type, "R") == 0)) {
+            draw_record_access(reorganizer, type[0] == 'N', id);
+        } else if (sscanf(line, "%255s %lu", name, &id) == 2) {
+            if (strcmp(name, "read_node") == 0
+                || strcmp(name, "Read_Node") == 0) {
+                draw_record_access(reorganizer, true, id);
+            } else if (strcmp(name, "read_rel") == 0) {
+                draw_record_access(reorganizer, false, id);
+            }
+        }
+    }
+
+    fclose(log_file);
+}
+
+static int
+draw_edge_cmp(const void* a, const void* b)
+{
+    const draw_edge* fst = a;
+    const draw_edge* snd = b;
+
+    if (fst->weight != snd->weight) {
+        return fst->weight < snd->weight ? 1 : -1;
+    }
+    return (fst->key > snd->key) - (fst->key < snd->key);
+}
+
+static int
+draw_cluster_cmp(const void* a, const void* b)
+{
+    const draw_cluster* fst = a;
+    const draw_cluster* snd = b;
+
+    if (fst->weight != snd->weight) {
+        return fst->weight < snd->weight ? 1 : -1;
+    }
+    return (fst->members[0] > snd->members[0])
+           - (fst->members[0] < snd->members[0]);
+}
+
+static unsigned long
+find_root(unsigned long* parent, unsigned long x)
+{
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x         = parent[x];
+    }
+    return x;
+}
+
+/* Merges the records along the most frequent co-accesses, as long as the
+ * merged cluster fits into a page. Returns the clusters of at least two
+ * records, heaviest first, with the ids of their members. */
+static draw_cluster*
+cluster(const draw_statistics* stats, file_type ft, size_t* n_clusters)
+{
+    unsigned long n_slots  = record_slots(ft);
+    unsigned long per_page = SLOTS_PER_PAGE / n_slots;
+
+    size_t     n_edges = dict_ul_ul_size(stats->co_access);
+    draw_edge* edges   = draw_calloc(n_edges + 1, sizeof(draw_edge));
+    size_t     k       = 0;
+
+    dict_ul_ul_iterator* it = dict_ul_ul_iterator_create(stats->co_access);
+    unsigned long        key;
+    unsigned long        weight;
+    while (dict_ul_ul_iterator_next(it, &key, &weight) == 0) {
+        if (weight >= DRAW_MIN_CO_ACCESSES) {
+            edges[k].key    = key;
+            edges[k].weight = weight;
+            k++;
+        }
+    }
+    dict_ul_ul_iterator_destroy(it);
+    n_edges = k;
+    qsort(edges, n_edges, sizeof(draw_edge), draw_edge_cmp);
+
+    // Records are numbered in the order in which their first edge appears
+    dict_ul_ul*    local    = d_ul_ul_create();
+    unsigned long* record   = draw_calloc(2 * n_edges + 1, sizeof(long));
+    unsigned long* parent   = draw_calloc(2 * n_edges + 1, sizeof(long));
+    unsigned long* size     = draw_calloc(2 * n_edges + 1, sizeof(long));
+    unsigned long* internal = draw_calloc(2 * n_edges + 1, sizeof(long));
+    size_t         n_local  = 0;
+
+    unsigned long ends[2];
+    unsigned long roots[2];
+    for (size_t i = 0; i < n_edges; ++i) {
+        ends[0] = edges[i].key >> DRAW_PAIR_BITS;
+        ends[1] = edges[i].key & (((unsigned long)1 << DRAW_PAIR_BITS) - 1);
+
+        for (size_t e = 0; e < 2; ++e) {
+            if (dict_ul_ul_get(local, ends[e], &roots[e]) != 0) {
+                roots[e] = n_local;
+                dict_ul_ul_insert(local, ends[e], n_local);
+                record[n_local] = ends[e];
+                parent[n_local] = n_local;
+                size[n_local]   = 1;
+                n_local++;
+            }
+            roots[e] = find_root(parent, roots[e]);
+        }
+
+        if (roots[0] == roots[1]) {
+            internal[roots[0]] += edges[i].weight;
+        } else if (size[roots[0]] + size[roots[1]] <= per_page) {
+            parent[roots[1]] = roots[0];
+            size[roots[0]] += size[roots[1]];
+            internal[roots[0]] += internal[roots[1]] + edges[i].weight;
+        }
+    }
+    dict_ul_ul_destroy(local);
+    free(edges);
+
+    // Collect the members of each cluster at the position of its root
+    unsigned long* slot     = draw_calloc(n_local + 1, sizeof(long));
+    size_t         n_result = 0;
+    for (size_t i = 0; i < n_local; ++i) {
+        if (parent[i] == i && size[i] > 1) {
+            slot[i] = n_result++;
+        }
+    }
+
+    draw_cluster* clusters = draw_calloc(n_result + 1, sizeof(draw_cluster));
+    for (size_t i = 0; i < n_local; ++i) {
+        if (parent[i] == i && size[i] > 1) {
+            clusters[slot[i]].weight  = internal[i];
+            clusters[slot[i]].members = draw_calloc(size[i], sizeof(long));
+        }
+    }
+
+    draw_cluster* c;
+    for (size_t i = 0; i < n_local; ++i) {
+        unsigned long root = find_root(parent, i);
+        if (size[root] > 1) {
+            c                         = &clusters[slot[root]];
+            c->members[c->n_members++] = position_id(record[i], n_slots);
+        }
+    }
+    qsort(clusters, n_result, sizeof(draw_cluster), draw_cluster_cmp);
+
+    free(record);
+    free(parent);
+    free(size);
+    free(internal);
+    free(slot);
+
+    *n_clusters = n_result;
+    return clusters;
+}
+
+static unsigned long
+moved_id(dict_ul_ul* ids, unsigned long id)
+{
+    unsigned long result = id;
+    dict_ul_ul_get(ids, id, &result);
+    return result;
+}
+
+static void
+swap_records(draw_reorganizer* reorganizer,
+             file_type         ft,
+             draw_moves*       moves,
+             unsigned long     fst,
+             unsigned long     snd,
+             bool              log)
+{
+    if (ft == node_ft) {
+        swap_nodes(reorganizer->hf, fst, snd, log);
+    } else {
+        swap_relationships(reorganizer->hf, fst, snd, log);
+    }
+
+    unsigned long fst_origin = moved_id(moves->origin, fst);
+    unsigned long snd_origin = moved_id(moves->origin, snd);
+
+    dict_ul_ul_insert(moves->current, fst_origin, snd);
+    dict_ul_ul_insert(moves->current, snd_origin, fst);
+    dict_ul_ul_insert(moves->origin, snd, fst_origin);
+    dict_ul_ul_insert(moves->origin, fst, snd_origin);
+}
+
+/* The slot of the home page that the member is swapped with: A free one if
+ * there is one, otherwise the one of the least accessed record that is
+ * neither locked nor part of the cluster. */
+static unsigned long
+pick_victim(draw_reorganizer* reorganizer,
+            file_type         ft,
+            draw_moves*       moves,
+            set_ul*           locked,
+            set_ul*           members,
+            unsigned long     home)
+{
+    const draw_statistics* stats   = &reorganizer->stats[ft];
+    unsigned long          n_slots = record_slots(ft);
+    unsigned long          best    = UNINITIALIZED_LONG;
+    unsigned long          coldest = ULONG_MAX;
+    unsigned long          id;
+    unsigned long          heat;
+
+    for (unsigned long s = 0; s < SLOTS_PER_PAGE; s += n_slots) {
+        id = home << CHAR_BIT | s;
+        if (set_ul_contains(locked, id) || set_ul_contains(members, id)) {
+            continue;
+        }
+
+        if (!check_record_exists(reorganizer->hf, id, ft == node_ft, false)) {
+            return id;
+        }
+
+        heat = 0;
+        dict_ul_ul_get(stats->heat, moved_id(moves->origin, id), &heat);
+        if (heat < coldest) {
+            coldest = heat;
+            best    = id;
+        }
+    }
+
+    return best;
+}
+
+/* Moves the members of the cluster to the page that holds most of them. */
+static size_t
+migrate(draw_reorganizer*   reorganizer,
+        file_type           ft,
+        const draw_cluster* c,
+        draw_moves*         moves,
+        set_ul*             locked,
+        size_t              max_swaps,
+        bool                log)
+{
+    unsigned long* ids     = draw_calloc(c->n_members, sizeof(long));
+    set_ul*        members = s_ul_create();
+    dict_ul_ul*    on_page = d_ul_ul_create();
+    unsigned long  home    = UNINITIALIZED_LONG;
+    unsigned long  most    = 0;
+    unsigned long  count;
+
+    for (size_t i = 0; i < c->n_members; ++i) {
+        ids[i] = moved_id(moves->current, c->members[i]);
+        set_ul_insert(members, ids[i]);
+        add_to(on_page, ids[i] >> CHAR_BIT, 1);
+
+        count = dict_ul_ul_get_direct(on_page, ids[i] >> CHAR_BIT);
+        if (count > most || (count == most && ids[i] >> CHAR_BIT < home)) {
+            most = count;
+            home = ids[i] >> CHAR_BIT;
+        }
+    }
+    dict_ul_ul_destroy(on_page);
+
+    size_t        n_swaps = 0;
+    unsigned long victim;
+    for (size_t i = 0; i < c->n_members && n_swaps < max_swaps; ++i) {
+        if (ids[i] >> CHAR_BIT == home) {
+            continue;
+        }
+
+        victim = pick_victim(reorganizer, ft, moves, locked, members, home);
+        if (victim == UNINITIALIZED_LONG) {
+            break;
+        }
+
+        swap_records(reorganizer, ft, moves, ids[i], victim, log);
+        set_ul_remove(members, ids[i]);
+        set_ul_insert(members, victim);
+        ids[i] = victim;
+        n_swaps++;
+    }
+
+    for (size_t i = 0; i < c->n_members; ++i) {
+        set_ul_insert(locked, ids[i]);
+    }
+
+    set_ul_destroy(members);
+    free(ids);
+
+    return n_swaps;
+}
+
+/* Renames the counted records after the swaps and divides all counts. */
+static void
+age(draw_reorganizer* reorganizer,
+    file_type         ft,
+    draw_moves*       moves,
+    unsigned long     decay)
+{
+    draw_statistics* stats   = &reorganizer->stats[ft];
+    unsigned long    n_slots = record_slots(ft);
+    unsigned long    key;
+    unsigned long    value;
+
+    dict_ul_ul*          heat = d_ul_ul_create();
+    dict_ul_ul_iterator* it   = dict_ul_ul_iterator_create(stats->heat);
+    while (dict_ul_ul_iterator_next(it, &key, &value) == 0) {
+        if (value / decay > 0) {
+            dict_ul_ul_insert(
+                  heat, moved_id(moves->current, key), value / decay);
+        }
+    }
+    dict_ul_ul_iterator_destroy(it);
+    dict_ul_ul_destroy(stats->heat);
+    stats->heat = heat;
+
+    unsigned long fst;
+    unsigned long snd;
+    dict_ul_ul*   co_access = d_ul_ul_create();
+    it                      = dict_ul_ul_iterator_create(stats->co_access);
+    while (dict_ul_ul_iterator_next(it, &key, &value) == 0) {
+        if (value / decay == 0) {
+            continue;
+        }
+        fst = position_id(key >> DRAW_PAIR_BITS, n_slots);
+        snd = position_id(key & (((unsigned long)1 << DRAW_PAIR_BITS) - 1),
+                          n_slots);
+        fst = dense_index(moved_id(moves->current, fst), n_slots);
+        snd = dense_index(moved_id(moves->current, snd), n_slots);
+
+        if (fst >> DRAW_PAIR_BITS == 0 && snd >> DRAW_PAIR_BITS == 0) {
+            dict_ul_ul_insert(co_access, pair_key(fst, snd), value / decay);
+        }
+    }
+    dict_ul_ul_iterator_destroy(it);
+    dict_ul_ul_destroy(stats->co_access);
+    stats->co_access = co_access;
+
+    for (size_t i = 0; i < stats->n_recent; ++i) {
+        stats->recent[i] = moved_id(moves->current, stats->recent[i]);
+    }
+}
+
+size_t
+draw_reorganize(draw_reorganizer* reorganizer, size_t max_swaps, bool log)
+{
+    if (!reorganizer) {
+        // LCOV_EXCL_START
+        printf("draw - reorganize: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    reorganizer->migrating = true;
+
+    size_t        n_swaps = 0;
+    size_t        n_clusters;
+    draw_cluster* clusters;
+    for (file_type ft = 0; ft < NUM_SLOTTED_FILE_TYPES; ++ft) {
+        clusters = cluster(&reorganizer->stats[ft], ft, &n_clusters);
+
+        draw_moves moves = { d_ul_ul_create(), d_ul_ul_create() };
+        set_ul*    locked = s_ul_create();
+
+        for (size_t i = 0; i < n_clusters; ++i) {
+            if (n_swaps < max_swaps) {
+                n_swaps += migrate(reorganizer,
+                                   ft,
+                                   &clusters[i],
+                                   &moves,
+                                   locked,
+                                   max_swaps - n_swaps,
+                                   log);
+            }
+            free(clusters[i].members);
+        }
+        free(clusters);
+
+        // Only a completed pass ages the counts, so that the clusters stay
+        // intact across the calls of an incremental migration
+        age(reorganizer, ft, &moves, n_swaps < max_swaps ? 2 : 1);
+
+        set_ul_destroy(locked);
+        dict_ul_ul_destroy(moves.current);
+        dict_ul_ul_destroy(moves.origin);
+    }
+
+    reorganizer->migrating = false;
+
+    if (log) {
+        fprintf(reorganizer->hf->log_file, "draw_reorganize %lu\n", n_swaps);
+    }
+
+    return n_swaps;
+}
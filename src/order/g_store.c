@@ -0,0 +1,860 @@
+/*!
+ * \file g_store.c
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief See \ref g_store.h
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "order/g_store.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "access/node.h"
+#include "access/relationship.h"
+#include "constants.h"
+#include "strace.h"
+
+/* Coarsening stops once a level contracts less than 1 / 20 of its nodes. */
+#define G_STORE_MIN_CONTRACTION (20)
+#define G_STORE_REFINE_PASSES   (8)
+
+/* An undirected graph with node weights, the number of original nodes that
+ * a node stands for. Every edge appears at both endpoints. */
+typedef struct
+{
+    size_t         n;
+    unsigned long* offsets;
+    unsigned long* adj;
+    unsigned long* weights;
+    unsigned long* node_weights;
+} level_graph;
+
+typedef struct
+{
+    unsigned long key;
+    unsigned long value;
+} g_store_pair;
+
+typedef struct
+{
+    unsigned long from;
+    unsigned long to;
+    unsigned long gain;
+    unsigned long node;
+} swap_candidate;
+
+static void*
+g_store_calloc(size_t n, size_t size)
+{
+    void* ptr = calloc(n == 0 ? 1 : n, size);
+
+    if (!ptr) {
+        // LCOV_EXCL_START
+        printf("g-store: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    return ptr;
+}
+
+static level_graph*
+level_graph_create(size_t n, size_t n_adj)
+{
+    level_graph* graph  = g_store_calloc(1, sizeof(level_graph));
+    graph->n            = n;
+    graph->offsets      = g_store_calloc(n + 1, sizeof(unsigned long));
+    graph->adj          = g_store_calloc(n_adj, sizeof(unsigned long));
+    graph->weights      = g_store_calloc(n_adj, sizeof(unsigned long));
+    graph->node_weights = g_store_calloc(n, sizeof(unsigned long));
+
+    return graph;
+}
+
+static void
+level_graph_destroy(level_graph* graph)
+{
+    free(graph->offsets);
+    free(graph->adj);
+    free(graph->weights);
+    free(graph->node_weights);
+    free(graph);
+}
+
+/* Merges the sorted outgoing and incoming edges of node i into distinct
+ * neighbours, dropping self loops. Only counts them if adj is NULL. */
+static size_t
+merge_row(const csr_graph* csr,
+          size_t           i,
+          unsigned long*   adj,
+          unsigned long*   weights)
+{
+    const unsigned long* out_off = csr->offsets[OUTGOING];
+    const unsigned long* in_off  = csr->offsets[INCOMING];
+    const csr_edge*      out     = csr->edges[OUTGOING] + out_off[i];
+    const csr_edge*      in      = csr->edges[INCOMING] + in_off[i];
+    size_t               n_out   = out_off[i + 1] - out_off[i];
+    size_t               n_in    = in_off[i + 1] - in_off[i];
+
+    size_t        a     = 0;
+    size_t        b     = 0;
+    size_t        count = 0;
+    unsigned long last  = UNINITIALIZED_LONG;
+    unsigned long u;
+
+    while (a < n_out || b < n_in) {
+        if (b == n_in || (a < n_out && out[a].neighbour <= in[b].neighbour)) {
+            u = out[a++].neighbour;
+        } else {
+            u = in[b++].neighbour;
+        }
+
+        if (u == i) {
+            continue;
+        }
+
+        if (u != last) {
+            if (adj) {
+                adj[count]     = u;
+                weights[count] = 0;
+            }
+            count++;
+            last = u;
+        }
+
+        if (adj) {
+            weights[count - 1]++;
+        }
+    }
+
+    return count;
+}
+
+static level_graph*
+level_graph_from_csr(const csr_graph* csr)
+{
+    size_t n     = csr->n_nodes;
+    size_t n_adj = 0;
+
+    for (size_t i = 0; i < n; ++i) {
+        n_adj += merge_row(csr, i, NULL, NULL);
+    }
+
+    level_graph* graph = level_graph_create(n, n_adj);
+
+    for (size_t i = 0; i < n; ++i) {
+        graph->offsets[i + 1] =
+              graph->offsets[i]
+              + merge_row(csr,
+                          i,
+                          graph->adj + graph->offsets[i],
+                          graph->weights + graph->offsets[i]);
+        graph->node_weights[i] = 1;
+    }
+
+    return graph;
+}
+
+static unsigned long
+edge_weight(const level_graph* graph, unsigned long v, unsigned long u)
+{
+    for (size_t e = graph->offsets[v]; e < graph->offsets[v + 1]; ++e) {
+        if (graph->adj[e] == u) {
+            return graph->weights[e];
+        }
+    }
+
+    return 0;
+}
+
+/* Contracts a heavy-edge matching whose pairs weigh at most cap. Returns NULL
+ * if too few nodes are matched. Otherwise stores the one or two children of
+ * each coarse node in children, UNINITIALIZED_LONG for a missing second. */
+static level_graph*
+coarsen(const level_graph* graph, unsigned long cap, unsigned long** children)
+{
+    size_t         n     = graph->n;
+    unsigned long* match = g_store_calloc(n, sizeof(unsigned long));
+    unsigned long* map   = g_store_calloc(n, sizeof(unsigned long));
+    size_t         n_coarse = 0;
+    unsigned long  best;
+    unsigned long  best_weight;
+    unsigned long  u;
+
+    for (size_t v = 0; v < n; ++v) {
+        match[v] = UNINITIALIZED_LONG;
+    }
+
+    for (size_t v = 0; v < n; ++v) {
+        if (match[v] != UNINITIALIZED_LONG) {
+            continue;
+        }
+
+        best        = v;
+        best_weight = 0;
+        for (size_t e = graph->offsets[v]; e < graph->offsets[v + 1]; ++e) {
+            u = graph->adj[e];
+
+            if (match[u] != UNINITIALIZED_LONG
+                || graph->node_weights[v] + graph->node_weights[u] > cap) {
+                continue;
+            }
+
+            if (graph->weights[e] > best_weight
+                || (graph->weights[e] == best_weight && u < best)) {
+                best        = u;
+                best_weight = graph->weights[e];
+            }
+        }
+
+        match[v]    = best;
+        match[best] = v;
+        map[v]      = n_coarse;
+        map[best]   = n_coarse;
+        n_coarse++;
+    }
+    free(match);
+
+    if ((n - n_coarse) * G_STORE_MIN_CONTRACTION < n) {
+        free(map);
+        return NULL;
+    }
+
+    *children = g_store_calloc(2 * n_coarse, sizeof(unsigned long));
+    for (size_t c = 0; c < 2 * n_coarse; ++c) {
+        (*children)[c] = UNINITIALIZED_LONG;
+    }
+    for (size_t v = 0; v < n; ++v) {
+        if ((*children)[2 * map[v]] == UNINITIALIZED_LONG) {
+            (*children)[2 * map[v]] = v;
+        } else {
+            (*children)[2 * map[v] + 1] = v;
+        }
+    }
+
+    // The contracted graph has at most as many adjacency entries
+    level_graph*   coarse  = level_graph_create(n_coarse, graph->offsets[n]);
+    unsigned long* scratch = g_store_calloc(n_coarse, sizeof(unsigned long));
+    size_t         n_adj   = 0;
+    size_t         begin;
+    unsigned long  v;
+    unsigned long  q;
+
+    for (size_t c = 0; c < n_coarse; ++c) {
+        begin = n_adj;
+
+        for (size_t i = 2 * c; i < 2 * c + 2; ++i) {
+            v = (*children)[i];
+
+            if (v == UNINITIALIZED_LONG) {
+                continue;
+            }
+
+            coarse->node_weights[c] += graph->node_weights[v];
+            for (size_t e = graph->offsets[v]; e < graph->offsets[v + 1];
+                 ++e) {
+                q = map[graph->adj[e]];
+
+                if (q == c) {
+                    continue;
+                }
+
+                if (scratch[q] == 0) {
+                    coarse->adj[n_adj] = q;
+                    n_adj++;
+                }
+                scratch[q] += graph->weights[e];
+            }
+        }
+
+        for (size_t e = begin; e < n_adj; ++e) {
+            coarse->weights[e]       = scratch[coarse->adj[e]];
+            scratch[coarse->adj[e]] = 0;
+        }
+        coarse->offsets[c + 1] = n_adj;
+    }
+
+    free(scratch);
+    free(map);
+
+    return coarse;
+}
+
+static int
+compare_pairs_desc(const void* fst, const void* snd)
+{
+    const g_store_pair* a = fst;
+    const g_store_pair* b = snd;
+
+    if (a->key != b->key) {
+        return a->key > b->key ? -1 : 1;
+    }
+
+    return (a->value > b->value) - (a->value < b->value);
+}
+
+static int
+compare_pairs_asc(const void* fst, const void* snd)
+{
+    const g_store_pair* a = fst;
+    const g_store_pair* b = snd;
+
+    if (a->key != b->key) {
+        return a->key < b->key ? -1 : 1;
+    }
+
+    return (a->value > b->value) - (a->value < b->value);
+}
+
+/* Breadth-first search that visits the heavier edges of a node first. */
+static unsigned long*
+coarsest_order(const level_graph* graph)
+{
+    size_t         n       = graph->n;
+    unsigned long* seq     = g_store_calloc(n, sizeof(unsigned long));
+    bool*          visited = g_store_calloc(n, sizeof(bool));
+    g_store_pair*  buf =
+          g_store_calloc(graph->offsets[n], sizeof(g_store_pair));
+    size_t         head = 0;
+    size_t         tail = 0;
+    size_t         n_buf;
+    unsigned long  v;
+
+    for (size_t s = 0; s < n; ++s) {
+        if (visited[s]) {
+            continue;
+        }
+        visited[s]  = true;
+        seq[tail++] = s;
+
+        while (head < tail) {
+            v     = seq[head++];
+            n_buf = 0;
+
+            for (size_t e = graph->offsets[v]; e < graph->offsets[v + 1];
+                 ++e) {
+                if (!visited[graph->adj[e]]) {
+                    buf[n_buf].key   = graph->weights[e];
+                    buf[n_buf].value = graph->adj[e];
+                    n_buf++;
+                }
+            }
+            qsort(buf, n_buf, sizeof(g_store_pair), compare_pairs_desc);
+
+            for (size_t i = 0; i < n_buf; ++i) {
+                visited[buf[i].value] = true;
+                seq[tail++]           = buf[i].value;
+            }
+        }
+    }
+
+    free(visited);
+    free(buf);
+
+    return seq;
+}
+
+/* Replaces each coarse node by its children, turning the pair around if the
+ * second child is closer to the previously placed node. */
+static unsigned long*
+uncoarsen(const level_graph*   graph,
+          const unsigned long* coarse_seq,
+          size_t               n_coarse,
+          const unsigned long* children)
+{
+    unsigned long* seq  = g_store_calloc(graph->n, sizeof(unsigned long));
+    unsigned long  last = UNINITIALIZED_LONG;
+    size_t         k    = 0;
+    unsigned long  fst;
+    unsigned long  snd;
+
+    for (size_t i = 0; i < n_coarse; ++i) {
+        fst = children[2 * coarse_seq[i]];
+        snd = children[2 * coarse_seq[i] + 1];
+
+        if (snd != UNINITIALIZED_LONG && last != UNINITIALIZED_LONG
+            && edge_weight(graph, snd, last) > edge_weight(graph, fst, last)) {
+            seq[k++] = snd;
+            seq[k++] = fst;
+        } else {
+            seq[k++] = fst;
+            if (snd != UNINITIALIZED_LONG) {
+                seq[k++] = snd;
+            }
+        }
+        last = seq[k - 1];
+    }
+
+    return seq;
+}
+
+static long
+page_links(const level_graph*   graph,
+           const unsigned long* pos,
+           unsigned long        per_page,
+           unsigned long        v,
+           unsigned long        page)
+{
+    long links = 0;
+
+    for (size_t e = graph->offsets[v]; e < graph->offsets[v + 1]; ++e) {
+        if (pos[graph->adj[e]] / per_page == page) {
+            links += (long)graph->weights[e];
+        }
+    }
+
+    return links;
+}
+
+static int
+compare_candidates(const void* fst, const void* snd)
+{
+    const swap_candidate* a = fst;
+    const swap_candidate* b = snd;
+
+    if (a->from != b->from) {
+        return a->from < b->from ? -1 : 1;
+    }
+    if (a->to != b->to) {
+        return a->to < b->to ? -1 : 1;
+    }
+    if (a->gain != b->gain) {
+        return a->gain > b->gain ? -1 : 1;
+    }
+
+    return (a->node > b->node) - (a->node < b->node);
+}
+
+/* Returns the first candidate moving from page from to page to, or n. */
+static size_t
+find_candidates(const swap_candidate* candidates,
+                size_t                n,
+                unsigned long         from,
+                unsigned long         to)
+{
+    size_t low  = 0;
+    size_t high = n;
+    size_t mid;
+
+    while (low < high) {
+        mid = low + (high - low) / 2;
+
+        if (candidates[mid].from < from
+            || (candidates[mid].from == from && candidates[mid].to < to)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    if (low < n && candidates[low].from == from && candidates[low].to == to) {
+        return low;
+    }
+
+    return n;
+}
+
+/* Swaps nodes that prefer each other's page as long as that reduces the
+ * relationships between pages. */
+static void
+refine(const level_graph* graph, unsigned long* seq, unsigned long per_page)
+{
+    size_t         n       = graph->n;
+    size_t         n_pages = n / per_page + (n % per_page != 0);
+    unsigned long* pos     = g_store_calloc(n, sizeof(unsigned long));
+    unsigned long* links   = g_store_calloc(n_pages, sizeof(unsigned long));
+    unsigned long* touched = g_store_calloc(n_pages, sizeof(unsigned long));
+    swap_candidate* candidates = g_store_calloc(n, sizeof(swap_candidate));
+
+    size_t        n_touched;
+    size_t        n_candidates;
+    size_t        n_swaps;
+    size_t        end;
+    size_t        other;
+    unsigned long own;
+    unsigned long best;
+    unsigned long page;
+    unsigned long v;
+    unsigned long u;
+    unsigned long tmp;
+    long          gain;
+
+    for (size_t i = 0; i < n; ++i) {
+        pos[seq[i]] = i;
+    }
+
+    for (size_t pass = 0; pass < G_STORE_REFINE_PASSES; ++pass) {
+        n_candidates = 0;
+
+        for (v = 0; v < n; ++v) {
+            own       = pos[v] / per_page;
+            n_touched = 0;
+
+            for (size_t e = graph->offsets[v]; e < graph->offsets[v + 1];
+                 ++e) {
+                page = pos[graph->adj[e]] / per_page;
+
+                if (links[page] == 0) {
+                    touched[n_touched++] = page;
+                }
+                links[page] += graph->weights[e];
+            }
+
+            best = own;
+            for (size_t i = 0; i < n_touched; ++i) {
+                page = touched[i];
+
+                if (links[page] > links[best]
+                    || (links[page] == links[best] && best != own
+                        && page < best)) {
+                    best = page;
+                }
+            }
+
+            if (best != own) {
+                candidates[n_candidates].from = own;
+                candidates[n_candidates].to   = best;
+                candidates[n_candidates].gain = links[best] - links[own];
+                candidates[n_candidates].node = v;
+                n_candidates++;
+            }
+
+            for (size_t i = 0; i < n_touched; ++i) {
+                links[touched[i]] = 0;
+            }
+        }
+
+        qsort(candidates,
+              n_candidates,
+              sizeof(swap_candidate),
+              compare_candidates);
+
+        // Pairs the best candidates of both directions between two pages
+        n_swaps = 0;
+        for (size_t i = 0; i < n_candidates; i = end) {
+            for (end = i; end < n_candidates
+                          && candidates[end].from == candidates[i].from
+                          && candidates[end].to == candidates[i].to;
+                 ++end) { }
+
+            if (candidates[i].from > candidates[i].to) {
+                continue;
+            }
+
+            other = find_candidates(candidates,
+                                    n_candidates,
+                                    candidates[i].to,
+                                    candidates[i].from);
+
+            for (size_t k = i; k < end && other < n_candidates
+                               && candidates[other].from == candidates[i].to
+                               && candidates[other].to == candidates[i].from;
+                 ++k, ++other) {
+                v = candidates[k].node;
+                u = candidates[other].node;
+
+                // The gain is recomputed, as earlier swaps change it
+                gain = page_links(graph, pos, per_page, v, candidates[k].to)
+                       - page_links(graph, pos, per_page, v, candidates[k].from)
+                       + page_links(graph, pos, per_page, u, candidates[k].from)
+                       - page_links(graph, pos, per_page, u, candidates[k].to)
+                       - 2 * (long)edge_weight(graph, v, u);
+
+                if (gain <= 0) {
+                    break;
+                }
+
+                seq[pos[v]] = u;
+                seq[pos[u]] = v;
+                tmp         = pos[v];
+                pos[v]      = pos[u];
+                pos[u]      = tmp;
+                n_swaps++;
+            }
+        }
+
+        if (n_swaps == 0) {
+            break;
+        }
+    }
+
+    free(pos);
+    free(links);
+    free(touched);
+    free(candidates);
+}
+
+/* Chains the full pages greedily along the heaviest links between them. The
+ * last page is kept at the end if it is not full, so that the pages stay
+ * aligned. */
+static void
+reorder_pages(const level_graph* graph,
+              unsigned long*     seq,
+              unsigned long      per_page)
+{
+    size_t n       = graph->n;
+    size_t n_pages = n / per_page;
+
+    if (n_pages < 3) {
+        return;
+    }
+
+    unsigned long* pos     = g_store_calloc(n, sizeof(unsigned long));
+    unsigned long* links   = g_store_calloc(n_pages, sizeof(unsigned long));
+    unsigned long* offsets = g_store_calloc(n_pages + 1, sizeof(unsigned long));
+    g_store_pair*  adj =
+          g_store_calloc(graph->offsets[n], sizeof(g_store_pair));
+    size_t         n_adj = 0;
+    size_t         begin;
+    unsigned long  page;
+    unsigned long  v;
+
+    for (size_t i = 0; i < n; ++i) {
+        pos[seq[i]] = i;
+    }
+
+    for (size_t p = 0; p < n_pages; ++p) {
+        begin = n_adj;
+
+        for (size_t i = p * per_page; i < (p + 1) * per_page; ++i) {
+            v = seq[i];
+
+            for (size_t e = graph->offsets[v]; e < graph->offsets[v + 1];
+                 ++e) {
+                page = pos[graph->adj[e]] / per_page;
+
+                if (page == p || page >= n_pages) {
+                    continue;
+                }
+
+                if (links[page] == 0) {
+                    adj[n_adj].value = page;
+                    n_adj++;
+                }
+                links[page] += graph->weights[e];
+            }
+        }
+
+        for (size_t e = begin; e < n_adj; ++e) {
+            adj[e].key          = links[adj[e].value];
+            links[adj[e].value] = 0;
+        }
+        offsets[p + 1] = n_adj;
+    }
+
+    bool*          placed = g_store_calloc(n_pages, sizeof(bool));
+    unsigned long* order  = g_store_calloc(n_pages, sizeof(unsigned long));
+    size_t         next_unplaced = 1;
+    unsigned long  cur           = 0;
+    unsigned long  best;
+    unsigned long  best_links;
+
+    placed[0] = true;
+    for (size_t k = 1; k < n_pages; ++k) {
+        best       = UNINITIALIZED_LONG;
+        best_links = 0;
+
+        for (size_t e = offsets[cur]; e < offsets[cur + 1]; ++e) {
+            if (!placed[adj[e].value]
+                && (adj[e].key > best_links
+                    || (adj[e].key == best_links && adj[e].value < best))) {
+                best       = adj[e].value;
+                best_links = adj[e].key;
+            }
+        }
+
+        if (best == UNINITIALIZED_LONG) {
+            while (placed[next_unplaced]) {
+                next_unplaced++;
+            }
+            best = next_unplaced;
+        }
+
+        placed[best] = true;
+        order[k]     = best;
+        cur          = best;
+    }
+
+    unsigned long* reordered = g_store_calloc(n, sizeof(unsigned long));
+    for (size_t k = 0; k < n_pages; ++k) {
+        memcpy(reordered + k * per_page,
+               seq + order[k] * per_page,
+               per_page * sizeof(unsigned long));
+    }
+    memcpy(seq, reordered, n_pages * per_page * sizeof(unsigned long));
+
+    free(reordered);
+    free(placed);
+    free(order);
+    free(pos);
+    free(links);
+    free(offsets);
+    free(adj);
+}
+
+/* The id of the record at the given position of a densely filled file. */
+static unsigned long
+position_id(size_t position, size_t n_slots)
+{
+    size_t per_page = SLOTS_PER_PAGE / n_slots;
+
+    return (position / per_page) << CHAR_BIT | (position % per_page) * n_slots;
+}
+
+static g_store_layout*
+layout_from_sequence(const csr_graph* csr, const unsigned long* seq)
+{
+    g_store_layout* layout     = g_store_calloc(1, sizeof(g_store_layout));
+    layout->node_order         = d_ul_ul_create();
+    layout->relationship_order = d_ul_ul_create();
+
+    size_t         n   = csr->n_nodes;
+    unsigned long* pos = g_store_calloc(n, sizeof(unsigned long));
+    for (size_t i = 0; i < n; ++i) {
+        pos[seq[i]] = i;
+        dict_ul_ul_insert(layout->node_order,
+                          csr->node_ids[seq[i]],
+                          position_id(i, NUM_SLOTS_PER_NODE));
+    }
+
+    const unsigned long* offsets = csr->offsets[OUTGOING];
+    const csr_edge*      edges   = csr->edges[OUTGOING];
+    g_store_pair*        buf =
+          g_store_calloc(csr->n_rels, sizeof(g_store_pair));
+    size_t               k       = 0;
+    size_t               n_buf;
+
+    for (size_t i = 0; i < n; ++i) {
+        n_buf = 0;
+        for (size_t e = offsets[seq[i]]; e < offsets[seq[i] + 1]; ++e) {
+            buf[n_buf].key   = pos[edges[e].neighbour];
+            buf[n_buf].value = edges[e].rel_id;
+            n_buf++;
+        }
+        qsort(buf, n_buf, sizeof(g_store_pair), compare_pairs_asc);
+
+        for (size_t j = 0; j < n_buf; ++j) {
+            dict_ul_ul_insert(layout->relationship_order,
+                              buf[j].value,
+                              position_id(k++, NUM_SLOTS_PER_REL));
+        }
+    }
+
+    free(buf);
+    free(pos);
+
+    return layout;
+}
+
+g_store_layout*
+g_store_order_csr(const csr_graph* graph)
+{
+    if (!graph) {
+        // LCOV_EXCL_START
+        printf("g-store - order: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    unsigned long per_page = SLOTS_PER_PAGE / NUM_SLOTS_PER_NODE;
+
+    // levels[l + 1] is the contraction of levels[l]
+    level_graph**   levels   = g_store_calloc(1, sizeof(level_graph*));
+    unsigned long** children = NULL;
+    size_t          n_levels = 1;
+    level_graph*    coarse;
+    unsigned long*  coarse_children;
+
+    levels[0] = level_graph_from_csr(graph);
+
+    while (levels[n_levels - 1]->n > 1
+           && (coarse = coarsen(
+                     levels[n_levels - 1], per_page, &coarse_children))) {
+        levels   = realloc(levels, (n_levels + 1) * sizeof(level_graph*));
+        children = realloc(children, n_levels * sizeof(unsigned long*));
+
+        if (!levels || !children) {
+            // LCOV_EXCL_START
+            printf("g-store - order: Failed to allocate memory!\n");
+            print_trace();
+
+            exit(EXIT_FAILURE);
+            // LCOV_EXCL_STOP
+        }
+
+        children[n_levels - 1] = coarse_children;
+        levels[n_levels]       = coarse;
+        n_levels++;
+    }
+
+    unsigned long* seq = coarsest_order(levels[n_levels - 1]);
+    unsigned long* finer;
+
+    for (size_t l = n_levels - 1; l > 0; --l) {
+        finer = uncoarsen(levels[l - 1], seq, levels[l]->n, children[l - 1]);
+        free(seq);
+        free(children[l - 1]);
+        level_graph_destroy(levels[l]);
+        seq = finer;
+    }
+
+    refine(levels[0], seq, per_page);
+    reorder_pages(levels[0], seq, per_page);
+
+    g_store_layout* layout = layout_from_sequence(graph, seq);
+
+    level_graph_destroy(levels[0]);
+    free(levels);
+    free(children);
+    free(seq);
+
+    return layout;
+}
+
+g_store_layout*
+g_store_order(heap_file* hf, bool log)
+{
+    if (!hf) {
+        // LCOV_EXCL_START
+        printf("g-store - order: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    csr_graph*      graph  = csr_graph_create(hf, log);
+    g_store_layout* layout = g_store_order_csr(graph);
+    csr_graph_destroy(graph);
+
+    return layout;
+}
+
+void
+g_store_layout_destroy(g_store_layout* layout)
+{
+    if (!layout) {
+        // LCOV_EXCL_START
+        printf("g-store - layout destroy: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    dict_ul_ul_destroy(layout->node_order);
+    dict_ul_ul_destroy(layout->relationship_order);
+    free(layout);
+}
@@ -0,0 +1,105 @@
+/*!
+ * \file icbl.c
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief See \ref icbl.h
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "order/icbl.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "access/relationship.h"
+#include "constants.h"
+#include "order/reorder_records.h"
+#include "strace.h"
+
+dict_ul_ul*
+icbl_relationship_order_csr(const csr_graph* graph)
+{
+    if (!graph) {
+        // LCOV_EXCL_START
+        printf("icbl - relationship order csr: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    const unsigned long  per_page = SLOTS_PER_PAGE / NUM_SLOTS_PER_REL;
+    const unsigned long* offsets  = graph->offsets[OUTGOING];
+    const csr_edge*      edges    = graph->edges[OUTGOING];
+
+    dict_ul_ul*   order    = d_ul_ul_create();
+    unsigned long position = 0;
+    unsigned long run_length;
+    unsigned long in_page;
+
+    for (size_t i = 0; i < graph->n_nodes; ++i) {
+        run_length = offsets[i + 1] - offsets[i];
+        in_page    = position % per_page;
+
+        // Runs that fit into a page must not cross one, hubs start on a new
+        // page and fill the following ones.
+        if (in_page > 0
+            && (run_length > per_page || in_page + run_length > per_page)) {
+            position += per_page - in_page;
+        }
+
+        for (size_t e = offsets[i]; e < offsets[i + 1]; ++e) {
+            dict_ul_ul_insert(order,
+                              edges[e].rel_id,
+                              (position / per_page) << CHAR_BIT
+                                    | (position % per_page)
+                                            * NUM_SLOTS_PER_REL);
+            position++;
+        }
+    }
+
+    return order;
+}
+
+dict_ul_ul*
+icbl_relationship_order(heap_file* hf, bool log)
+{
+    if (!hf) {
+        // LCOV_EXCL_START
+        printf("icbl - relationship order: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    csr_graph*  graph = csr_graph_create(hf, log);
+    dict_ul_ul* order = icbl_relationship_order_csr(graph);
+    csr_graph_destroy(graph);
+
+    return order;
+}
+
+void
+icbl_layout(heap_file* hf, bool log)
+{
+    if (!hf) {
+        // LCOV_EXCL_START
+        printf("icbl - layout: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    dict_ul_ul* order = icbl_relationship_order(hf, log);
+    reorder_relationships(hf, order, log);
+    dict_ul_ul_destroy(order);
+
+    sort_incidence_list(hf, log);
+}
@@ -0,0 +1,702 @@
+/*!
+ * \file layout_metrics.c
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief See \ref layout_metrics.h
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "order/layout_metrics.h"
+
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "access/relationship.h"
+#include "constants.h"
+#include "data-struct/d_ary_heap.h"
+#include "strace.h"
+
+/* Below this many nodes per thread, the threads cost more than they save. */
+#define LAYOUT_MIN_NODES_PER_THREAD (1024)
+
+/* The pages of the records after the reordering. The incidence list of node v
+ * consists of the relationship pages chain_pages[chain_offsets[v]] to
+ * chain_pages[chain_offsets[v + 1] - 1], in the order of the new ids. */
+typedef struct
+{
+    const csr_graph* graph;
+    unsigned long*   node_position;
+    unsigned long    max_degree;
+    unsigned long    n_node_pages;
+    unsigned long    n_rel_pages;
+    unsigned long*   chain_offsets;
+    unsigned long*   chain_pages;
+    /* The nodes of node page p are page_nodes[page_offsets[p]] to
+     * page_nodes[page_offsets[p + 1] - 1] */
+    unsigned long*   page_offsets;
+    unsigned long*   page_nodes;
+} placement;
+
+typedef struct
+{
+    unsigned long key;
+    unsigned long value;
+} layout_pair;
+
+typedef struct
+{
+    const placement* place;
+    size_t           from;
+    size_t           to;
+    double           linear_arrangement;
+    unsigned long    cross_page_rels;
+    unsigned long    incidence_pages;
+    double           conductance;
+    double           cohesiveness;
+    double           block_locality;
+} metrics_task;
+
+typedef struct
+{
+    const placement* place;
+    layout_traversal traversal;
+    size_t           n_starts;
+    size_t           n_frames;
+    size_t           first_start;
+    size_t           n_task_starts;
+    unsigned long    misses;
+} simulation_task;
+
+/* An LRU cache over the node pages followed by the relationship pages. */
+typedef struct
+{
+    size_t         n_frames;
+    size_t         n_cached;
+    unsigned long  head;
+    unsigned long  tail;
+    unsigned long* prev;
+    unsigned long* next;
+    bool*          cached;
+    unsigned long  misses;
+} lru_cache;
+
+static void*
+layout_calloc(size_t n, size_t size)
+{
+    void* ptr = calloc(n == 0 ? 1 : n, size);
+
+    if (!ptr) {
+        // LCOV_EXCL_START
+        printf("layout metrics: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    return ptr;
+}
+
+static size_t
+thread_count(size_t n)
+{
+    size_t n_threads = n / LAYOUT_MIN_NODES_PER_THREAD;
+
+    if (n_threads > N_THREADS) {
+        return N_THREADS;
+    }
+
+    return n_threads == 0 ? 1 : n_threads;
+}
+
+/* Runs fn on each task, the first one on the calling thread. */
+static void
+run_parallel(void* (*fn)(void*), void* tasks, size_t task_size, size_t n)
+{
+    pthread_t threads[n];
+    for (size_t t = 1; t < n; ++t) {
+        if (pthread_create(&threads[t], NULL, fn, (char*)tasks + t * task_size)
+            != 0) {
+            // LCOV_EXCL_START
+            printf("layout metrics: Failed to create thread!\n");
+            print_trace();
+
+            exit(EXIT_FAILURE);
+            // LCOV_EXCL_STOP
+        }
+    }
+
+    fn(tasks);
+
+    for (size_t t = 1; t < n; ++t) {
+        pthread_join(threads[t], NULL);
+    }
+}
+
+static int
+compare_pairs(const void* a, const void* b)
+{
+    const layout_pair* fst = a;
+    const layout_pair* snd = b;
+
+    if (fst->key != snd->key) {
+        return fst->key < snd->key ? -1 : 1;
+    }
+    return (fst->value > snd->value) - (fst->value < snd->value);
+}
+
+static int
+compare_ul(const void* a, const void* b)
+{
+    unsigned long fst = *(const unsigned long*)a;
+    unsigned long snd = *(const unsigned long*)b;
+
+    return (fst > snd) - (fst < snd);
+}
+
+static unsigned long
+new_id(dict_ul_ul* order, unsigned long id)
+{
+    unsigned long result = id;
+
+    if (order) {
+        dict_ul_ul_get(order, id, &result);
+    }
+    return result;
+}
+
+static unsigned long
+dense_index(unsigned long id, unsigned long n_slots)
+{
+    return ((id >> CHAR_BIT) * SLOTS_PER_PAGE + (id & UCHAR_MAX)) / n_slots;
+}
+
+static placement*
+placement_create(const csr_graph* graph,
+                 dict_ul_ul*      node_order,
+                 dict_ul_ul*      rel_order)
+{
+    placement* place     = layout_calloc(1, sizeof(placement));
+    size_t     n         = graph->n_nodes;
+    place->graph         = graph;
+    place->node_position = layout_calloc(n, sizeof(unsigned long));
+
+    unsigned long id;
+    for (size_t v = 0; v < n; ++v) {
+        id                      = new_id(node_order, graph->node_ids[v]);
+        place->node_position[v] = dense_index(id, NUM_SLOTS_PER_NODE);
+        if ((id >> CHAR_BIT) + 1 > place->n_node_pages) {
+            place->n_node_pages = (id >> CHAR_BIT) + 1;
+        }
+    }
+
+    // Both lists together hold each relationship once per endpoint
+    place->chain_offsets = layout_calloc(n + 1, sizeof(unsigned long));
+    place->chain_pages   = layout_calloc(2 * graph->n_rels, sizeof(long));
+    layout_pair* chain =
+          layout_calloc(2 * graph->n_rels, sizeof(layout_pair));
+
+    size_t k = 0;
+    for (size_t v = 0; v < n; ++v) {
+        place->chain_offsets[v] = k;
+        for (direction_t d = OUTGOING; d <= INCOMING; ++d) {
+            for (size_t e = graph->offsets[d][v];
+                 e < graph->offsets[d][v + 1];
+                 ++e) {
+                id = new_id(rel_order, graph->edges[d][e].rel_id);
+                chain[k].key   = dense_index(id, NUM_SLOTS_PER_REL);
+                chain[k].value = id >> CHAR_BIT;
+                k++;
+                if ((id >> CHAR_BIT) + 1 > place->n_rel_pages) {
+                    place->n_rel_pages = (id >> CHAR_BIT) + 1;
+                }
+            }
+        }
+    }
+    place->chain_offsets[n] = k;
+
+    for (size_t v = 0; v < n; ++v) {
+        if (place->chain_offsets[v + 1] - place->chain_offsets[v]
+            > place->max_degree) {
+            place->max_degree =
+                  place->chain_offsets[v + 1] - place->chain_offsets[v];
+        }
+    }
+
+    for (size_t v = 0; v < n; ++v) {
+        qsort(chain + place->chain_offsets[v],
+              place->chain_offsets[v + 1] - place->chain_offsets[v],
+              sizeof(layout_pair),
+              compare_pairs);
+    }
+    for (size_t i = 0; i < k; ++i) {
+        place->chain_pages[i] = chain[i].value;
+    }
+    free(chain);
+
+    // Counting sort of the nodes by their page
+    const unsigned long per_page = SLOTS_PER_PAGE / NUM_SLOTS_PER_NODE;
+    place->page_offsets =
+          layout_calloc(place->n_node_pages + 1, sizeof(unsigned long));
+    place->page_nodes = layout_calloc(n, sizeof(unsigned long));
+
+    for (size_t v = 0; v < n; ++v) {
+        place->page_offsets[place->node_position[v] / per_page + 1]++;
+    }
+    for (size_t p = 0; p < place->n_node_pages; ++p) {
+        place->page_offsets[p + 1] += place->page_offsets[p];
+    }
+
+    unsigned long* fill =
+          layout_calloc(place->n_node_pages + 1, sizeof(unsigned long));
+    unsigned long page;
+    for (size_t v = 0; v < n; ++v) {
+        page = place->node_position[v] / per_page;
+        place->page_nodes[place->page_offsets[page] + fill[page]++] = v;
+    }
+    free(fill);
+
+    return place;
+}
+
+static void
+placement_destroy(placement* place)
+{
+    free(place->node_position);
+    free(place->chain_offsets);
+    free(place->chain_pages);
+    free(place->page_offsets);
+    free(place->page_nodes);
+    free(place);
+}
+
+static unsigned long
+node_page(const placement* place, unsigned long v)
+{
+    return place->node_position[v] / (SLOTS_PER_PAGE / NUM_SLOTS_PER_NODE);
+}
+
+/* The cost terms of the nodes from to to and of their pages. */
+static void*
+metrics_range(void* arg)
+{
+    metrics_task*    task  = arg;
+    const placement* place = task->place;
+    const csr_graph* graph = place->graph;
+
+    unsigned long neighbour;
+    for (size_t v = task->from; v < task->to; ++v) {
+        for (size_t e = graph->offsets[OUTGOING][v];
+             e < graph->offsets[OUTGOING][v + 1];
+             ++e) {
+            neighbour = graph->edges[OUTGOING][e].neighbour;
+            task->linear_arrangement +=
+                  place->node_position[v] > place->node_position[neighbour]
+                        ? place->node_position[v]
+                                - place->node_position[neighbour]
+                        : place->node_position[neighbour]
+                                - place->node_position[v];
+            task->cross_page_rels +=
+                  node_page(place, v) != node_page(place, neighbour);
+        }
+
+        // Runs on the same page are read with one pin
+        for (size_t i = place->chain_offsets[v];
+             i < place->chain_offsets[v + 1];
+             ++i) {
+            task->incidence_pages +=
+                  i == place->chain_offsets[v]
+                  || place->chain_pages[i] != place->chain_pages[i - 1];
+        }
+    }
+
+    // Pages are assigned to the task that holds their first node
+    unsigned long* pairs = layout_calloc(place->max_degree, sizeof(long));
+    unsigned long  page;
+    unsigned long  begin;
+    unsigned long  end;
+    unsigned long  cut;
+    unsigned long  inside;
+    unsigned long  adjacent;
+    unsigned long  n_pairs;
+    double         conductance;
+    double         cohesiveness;
+    unsigned long  v;
+
+    for (page = 0; page < place->n_node_pages; ++page) {
+        begin = place->page_offsets[page];
+        end   = place->page_offsets[page + 1];
+        if (begin == end || place->page_nodes[begin] < task->from
+            || place->page_nodes[begin] >= task->to) {
+            continue;
+        }
+
+        cut      = 0;
+        inside   = 0;
+        adjacent = 0;
+        for (size_t i = begin; i < end; ++i) {
+            v       = place->page_nodes[i];
+            n_pairs = 0;
+            for (direction_t d = OUTGOING; d <= INCOMING; ++d) {
+                for (size_t e = graph->offsets[d][v];
+                     e < graph->offsets[d][v + 1];
+                     ++e) {
+                    neighbour = graph->edges[d][e].neighbour;
+                    if (node_page(place, neighbour) != page) {
+                        cut++;
+                        continue;
+                    }
+                    inside++;
+                    if (neighbour > v) {
+                        pairs[n_pairs++] = neighbour;
+                    }
+                }
+            }
+
+            qsort(pairs, n_pairs, sizeof(unsigned long), compare_ul);
+            for (size_t j = 0; j < n_pairs; ++j) {
+                adjacent += j == 0 || pairs[j] != pairs[j - 1];
+            }
+        }
+
+        // Relationships inside the page were seen from both endpoints
+        inside /= 2;
+        conductance =
+              cut + inside == 0 ? 0.0 : (double)cut / (double)(cut + inside);
+        cohesiveness =
+              end - begin < 2
+                    ? 0.0
+                    : (double)adjacent
+                            / ((double)(end - begin) * (end - begin - 1) / 2);
+
+        task->conductance += conductance;
+        task->cohesiveness += cohesiveness;
+        task->block_locality += sqrt(conductance * (1 - cohesiveness));
+    }
+    free(pairs);
+
+    return NULL;
+}
+
+static void
+check_arguments(const csr_graph* graph, const char* fn)
+{
+    if (!graph) {
+        // LCOV_EXCL_START
+        printf("layout metrics - %s: Invalid Arguments!\n", fn);
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+}
+
+layout_metrics*
+layout_metrics_compute(const csr_graph* graph,
+                       dict_ul_ul*      node_order,
+                       dict_ul_ul*      rel_order)
+{
+    check_arguments(graph, "compute");
+
+    placement* place     = placement_create(graph, node_order, rel_order);
+    size_t     n         = graph->n_nodes;
+    size_t     n_threads = thread_count(n);
+
+    metrics_task tasks[n_threads];
+    for (size_t t = 0; t < n_threads; ++t) {
+        tasks[t]       = (metrics_task){ 0 };
+        tasks[t].place = place;
+        tasks[t].from  = n * t / n_threads;
+        tasks[t].to    = n * (t + 1) / n_threads;
+    }
+    run_parallel(metrics_range, tasks, sizeof(metrics_task), n_threads);
+
+    layout_metrics* result = layout_calloc(1, sizeof(layout_metrics));
+    result->n_node_pages   = place->n_node_pages;
+    result->n_rel_pages    = place->n_rel_pages;
+
+    unsigned long n_used_pages = 0;
+    for (size_t p = 0; p < place->n_node_pages; ++p) {
+        n_used_pages += place->page_offsets[p + 1] > place->page_offsets[p];
+    }
+
+    for (size_t t = 0; t < n_threads; ++t) {
+        result->linear_arrangement += tasks[t].linear_arrangement;
+        result->cross_page_rels += tasks[t].cross_page_rels;
+        result->incidence_pages += tasks[t].incidence_pages;
+        result->conductance += tasks[t].conductance;
+        result->cohesiveness += tasks[t].cohesiveness;
+        result->block_locality += tasks[t].block_locality;
+    }
+
+    if (n_used_pages > 0) {
+        result->conductance /= (double)n_used_pages;
+        result->cohesiveness /= (double)n_used_pages;
+        result->block_locality /= (double)n_used_pages;
+    }
+
+    placement_destroy(place);
+
+    return result;
+}
+
+static lru_cache*
+lru_create(size_t n_pages, size_t n_frames)
+{
+    lru_cache* cache = layout_calloc(1, sizeof(lru_cache));
+    cache->n_frames  = n_frames;
+    cache->head      = UNINITIALIZED_LONG;
+    cache->tail      = UNINITIALIZED_LONG;
+    cache->prev      = layout_calloc(n_pages, sizeof(unsigned long));
+    cache->next      = layout_calloc(n_pages, sizeof(unsigned long));
+    cache->cached    = layout_calloc(n_pages, sizeof(bool));
+
+    return cache;
+}
+
+static void
+lru_destroy(lru_cache* cache)
+{
+    free(cache->prev);
+    free(cache->next);
+    free(cache->cached);
+    free(cache);
+}
+
+static void
+lru_unlink(lru_cache* cache, unsigned long page)
+{
+    if (cache->prev[page] != UNINITIALIZED_LONG) {
+        cache->next[cache->prev[page]] = cache->next[page];
+    } else {
+        cache->head = cache->next[page];
+    }
+
+    if (cache->next[page] != UNINITIALIZED_LONG) {
+        cache->prev[cache->next[page]] = cache->prev[page];
+    } else {
+        cache->tail = cache->prev[page];
+    }
+}
+
+static void
+lru_access(lru_cache* cache, unsigned long page)
+{
+    if (cache->cached[page]) {
+        lru_unlink(cache, page);
+    } else {
+        cache->misses++;
+
+        if (cache->n_cached == cache->n_frames) {
+            cache->cached[cache->tail] = false;
+            lru_unlink(cache, cache->tail);
+        } else {
+            cache->n_cached++;
+        }
+        cache->cached[page] = true;
+    }
+
+    cache->prev[page] = UNINITIALIZED_LONG;
+    cache->next[page] = cache->head;
+    if (cache->head != UNINITIALIZED_LONG) {
+        cache->prev[cache->head] = page;
+    }
+    cache->head = page;
+    if (cache->tail == UNINITIALIZED_LONG) {
+        cache->tail = page;
+    }
+}
+
+/* Reads the node and walks its incidence list, as expand does. */
+static void
+simulate_expand(const placement* place, lru_cache* cache, unsigned long v)
+{
+    lru_access(cache, node_page(place, v));
+
+    for (size_t i = place->chain_offsets[v]; i < place->chain_offsets[v + 1];
+         ++i) {
+        if (i == place->chain_offsets[v]
+            || place->chain_pages[i] != place->chain_pages[i - 1]) {
+            lru_access(cache, place->n_node_pages + place->chain_pages[i]);
+        }
+    }
+}
+
+static void
+simulate_bfs(const placement* place,
+             lru_cache*       cache,
+             unsigned long    start,
+             bool*            visited,
+             unsigned long*   queue)
+{
+    const csr_graph* graph = place->graph;
+    size_t           head  = 0;
+    size_t           tail  = 0;
+    unsigned long    v;
+    unsigned long    neighbour;
+
+    visited[start] = true;
+    queue[tail++]  = start;
+
+    while (head < tail) {
+        v = queue[head++];
+        simulate_expand(place, cache, v);
+
+        for (size_t e = graph->offsets[OUTGOING][v];
+             e < graph->offsets[OUTGOING][v + 1];
+             ++e) {
+            neighbour = graph->edges[OUTGOING][e].neighbour;
+            if (!visited[neighbour]) {
+                visited[neighbour] = true;
+                queue[tail++]      = neighbour;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < tail; ++i) {
+        visited[queue[i]] = false;
+    }
+}
+
+static void
+simulate_dijkstra(const placement* place,
+                  lru_cache*       cache,
+                  unsigned long    start,
+                  bool*            visited,
+                  double*          dist)
+{
+    const csr_graph* graph = place->graph;
+    d_ary_heap*      heap  = d_ary_heap_create();
+    unsigned long    v;
+    unsigned long    neighbour;
+    double           key;
+
+    for (size_t i = 0; i < graph->n_nodes; ++i) {
+        dist[i]    = INFINITY;
+        visited[i] = false;
+    }
+
+    dist[start] = 0;
+    d_ary_heap_insert(heap, 0, start);
+
+    while (d_ary_heap_size(heap) > 0) {
+        v          = d_ary_heap_extract_min(heap, &key);
+        visited[v] = true;
+        simulate_expand(place, cache, v);
+
+        for (size_t e = graph->offsets[OUTGOING][v];
+             e < graph->offsets[OUTGOING][v + 1];
+             ++e) {
+            neighbour = graph->edges[OUTGOING][e].neighbour;
+            key       = dist[v] + graph->edges[OUTGOING][e].weight;
+            if (visited[neighbour] || key >= dist[neighbour]) {
+                continue;
+            }
+
+            if (d_ary_heap_contains(heap, neighbour)) {
+                d_ary_heap_decrease_key(heap, neighbour, key);
+            } else {
+                d_ary_heap_insert(heap, key, neighbour);
+            }
+            dist[neighbour] = key;
+        }
+    }
+
+    for (size_t i = 0; i < graph->n_nodes; ++i) {
+        visited[i] = false;
+    }
+    d_ary_heap_destroy(heap);
+}
+
+static void*
+simulate_range(void* arg)
+{
+    simulation_task* task    = arg;
+    const placement* place   = task->place;
+    size_t           n       = place->graph->n_nodes;
+    size_t           n_pages = place->n_node_pages + place->n_rel_pages;
+
+    bool*          visited = layout_calloc(n, sizeof(bool));
+    unsigned long* queue   = layout_calloc(n, sizeof(unsigned long));
+    double*        dist    = layout_calloc(n, sizeof(double));
+    lru_cache*     cache;
+    unsigned long  start;
+
+    for (size_t s = task->first_start;
+         s < task->first_start + task->n_task_starts;
+         ++s) {
+        start = n * s / task->n_starts;
+        cache = lru_create(n_pages, task->n_frames);
+
+        if (task->traversal == LAYOUT_BFS) {
+            simulate_bfs(place, cache, start, visited, queue);
+        } else {
+            simulate_dijkstra(place, cache, start, visited, dist);
+        }
+
+        task->misses += cache->misses;
+        lru_destroy(cache);
+    }
+
+    free(visited);
+    free(queue);
+    free(dist);
+
+    return NULL;
+}
+
+double
+layout_simulate_misses(const csr_graph* graph,
+                       dict_ul_ul*      node_order,
+                       dict_ul_ul*      rel_order,
+                       layout_traversal traversal,
+                       size_t           n_starts,
+                       size_t           n_frames)
+{
+    check_arguments(graph, "simulate misses");
+
+    if (n_starts == 0 || n_frames == 0 || traversal > LAYOUT_DIJKSTRA) {
+        // LCOV_EXCL_START
+        printf("layout metrics - simulate misses: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    if (graph->n_nodes == 0) {
+        return 0;
+    }
+
+    placement* place     = placement_create(graph, node_order, rel_order);
+    size_t     n_threads = n_starts < N_THREADS ? n_starts : N_THREADS;
+
+    simulation_task tasks[n_threads];
+    for (size_t t = 0; t < n_threads; ++t) {
+        tasks[t].place         = place;
+        tasks[t].traversal     = traversal;
+        tasks[t].n_starts      = n_starts;
+        tasks[t].n_frames      = n_frames;
+        tasks[t].first_start   = n_starts * t / n_threads;
+        tasks[t].n_task_starts = n_starts * (t + 1) / n_threads
+                                 - tasks[t].first_start;
+        tasks[t].misses        = 0;
+    }
+    run_parallel(simulate_range, tasks, sizeof(simulation_task), n_threads);
+
+    unsigned long misses = 0;
+    for (size_t t = 0; t < n_threads; ++t) {
+        misses += tasks[t].misses;
+    }
+    placement_destroy(place);
+
+    return (double)misses / (double)n_starts;
+}
@@ -0,0 +1,967 @@
+/*!
+ * \file locality_order.c
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief See \ref locality_order.h
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "order/locality_order.h"
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "access/csr_graph.h"
+#include "access/node.h"
+#include "access/relationship.h"
+#include "constants.h"
+#include "data-struct/array_list.h"
+#include "strace.h"
+
+/* George and Liu's search for a pseudo-peripheral node usually converges
+ * after two or three searches. */
+#define RCM_MAX_PERIPHERAL_SEARCHES (8)
+/* Below this many nodes per thread, the threads cost more than they save. */
+#define RABBIT_MIN_NODES_PER_THREAD (1024)
+
+typedef struct
+{
+    unsigned long key;
+    unsigned long value;
+} order_pair;
+
+/* The buckets of nodes with the same key of the unit heap used by Gorder, as
+ * keys only ever change by one. */
+typedef struct
+{
+    unsigned long* key;
+    unsigned long* prev;
+    unsigned long* next;
+    bool*          removed;
+    unsigned long* head;
+    size_t         n_keys;
+    size_t         max_key;
+} unit_heap;
+
+/* The relationships of a merged node, to the nodes that were the roots of
+ * their merge trees when they were last compacted. */
+typedef struct
+{
+    unsigned long* neighbours;
+    double*        weights;
+    size_t         size;
+    size_t         capacity;
+} rabbit_edges;
+
+typedef struct
+{
+    size_t                  n;
+    double                  total;
+    rabbit_edges*           edges;
+    _Atomic unsigned long*  dest;
+    _Atomic double*         strength;
+    pthread_mutex_t*        locks;
+    unsigned long*          first_child;
+    unsigned long*          last_child;
+    unsigned long*          sibling;
+    const unsigned long*    order;
+    atomic_size_t           next;
+} rabbit_state;
+
+typedef struct
+{
+    rabbit_state*  state;
+    double*        scratch;
+    unsigned long* touched;
+    array_list_ul* retry;
+} rabbit_task;
+
+static void*
+order_calloc(size_t n, size_t size)
+{
+    void* ptr = calloc(n == 0 ? 1 : n, size);
+
+    if (!ptr) {
+        // LCOV_EXCL_START
+        printf("locality order: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    return ptr;
+}
+
+static void*
+order_realloc(void* ptr, size_t n, size_t size)
+{
+    ptr = realloc(ptr, (n == 0 ? 1 : n) * size);
+
+    if (!ptr) {
+        // LCOV_EXCL_START
+        printf("locality order: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    return ptr;
+}
+
+static int
+compare_pairs(const void* fst, const void* snd)
+{
+    const order_pair* a = fst;
+    const order_pair* b = snd;
+
+    if (a->key != b->key) {
+        return a->key < b->key ? -1 : 1;
+    }
+
+    return (a->value > b->value) - (a->value < b->value);
+}
+
+static unsigned long
+degree(const csr_graph* graph, unsigned long v)
+{
+    return graph->offsets[OUTGOING][v + 1] - graph->offsets[OUTGOING][v]
+           + graph->offsets[INCOMING][v + 1] - graph->offsets[INCOMING][v];
+}
+
+/* The id of the record at the given position of a densely filled file. */
+static unsigned long
+position_id(size_t position, size_t n_slots)
+{
+    size_t per_page = SLOTS_PER_PAGE / n_slots;
+
+    return (position / per_page) << CHAR_BIT | (position % per_page) * n_slots;
+}
+
+static dict_ul_ul*
+order_from_sequence(const csr_graph* graph, const unsigned long* seq)
+{
+    dict_ul_ul* order = d_ul_ul_create();
+
+    for (size_t i = 0; i < graph->n_nodes; ++i) {
+        dict_ul_ul_insert(order,
+                          graph->node_ids[seq[i]],
+                          position_id(i, NUM_SLOTS_PER_NODE));
+    }
+
+    return order;
+}
+
+static unsigned long*
+bfs_sequence(const csr_graph* graph)
+{
+    size_t         n       = graph->n_nodes;
+    unsigned long* seq     = order_calloc(n, sizeof(unsigned long));
+    bool*          visited = order_calloc(n, sizeof(bool));
+    size_t         head    = 0;
+    size_t         tail    = 0;
+    unsigned long  v;
+    unsigned long  u;
+
+    for (size_t s = 0; s < n; ++s) {
+        if (visited[s]) {
+            continue;
+        }
+        visited[s]  = true;
+        seq[tail++] = s;
+
+        while (head < tail) {
+            v = seq[head++];
+
+            for (direction_t d = OUTGOING; d <= INCOMING; ++d) {
+                for (size_t e = graph->offsets[d][v];
+                     e < graph->offsets[d][v + 1];
+                     ++e) {
+                    u = graph->edges[d][e].neighbour;
+
+                    if (!visited[u]) {
+                        visited[u]  = true;
+                        seq[tail++] = u;
+                    }
+                }
+            }
+        }
+    }
+    free(visited);
+
+    return seq;
+}
+
+/* Searches breadth-first from start among the nodes not yet visited. Returns
+ * the depth of the search and stores the node with the lowest degree on the
+ * last level in far. */
+static size_t
+rcm_eccentricity(const csr_graph* graph,
+                 unsigned long    start,
+                 const bool*      visited,
+                 unsigned long*   mark,
+                 unsigned long    stamp,
+                 unsigned long*   queue,
+                 unsigned long*   far)
+{
+    size_t        begin        = 0;
+    size_t        end          = 1;
+    size_t        tail         = 1;
+    size_t        eccentricity = 0;
+    unsigned long u;
+
+    queue[0]    = start;
+    mark[start] = stamp;
+
+    for (;;) {
+        for (size_t i = begin; i < end; ++i) {
+            for (direction_t d = OUTGOING; d <= INCOMING; ++d) {
+                for (size_t e = graph->offsets[d][queue[i]];
+                     e < graph->offsets[d][queue[i] + 1];
+                     ++e) {
+                    u = graph->edges[d][e].neighbour;
+
+                    if (!visited[u] && mark[u] != stamp) {
+                        mark[u]       = stamp;
+                        queue[tail++] = u;
+                    }
+                }
+            }
+        }
+
+        if (tail == end) {
+            break;
+        }
+        eccentricity++;
+        begin = end;
+        end   = tail;
+    }
+
+    *far = queue[begin];
+    for (size_t i = begin + 1; i < end; ++i) {
+        if (degree(graph, queue[i]) < degree(graph, *far)) {
+            *far = queue[i];
+        }
+    }
+
+    return eccentricity;
+}
+
+static unsigned long*
+rcm_sequence(const csr_graph* graph)
+{
+    size_t         n       = graph->n_nodes;
+    unsigned long* seq     = order_calloc(n, sizeof(unsigned long));
+    bool*          visited = order_calloc(n, sizeof(bool));
+    unsigned long* mark    = order_calloc(n, sizeof(unsigned long));
+    unsigned long* queue   = order_calloc(n, sizeof(unsigned long));
+    order_pair*    by_degree = order_calloc(n, sizeof(order_pair));
+    order_pair*    buf       = order_calloc(n, sizeof(order_pair));
+
+    for (size_t v = 0; v < n; ++v) {
+        by_degree[v].key   = degree(graph, v);
+        by_degree[v].value = v;
+    }
+    qsort(by_degree, n, sizeof(order_pair), compare_pairs);
+
+    unsigned long stamp = 0;
+    size_t        head  = 0;
+    size_t        tail  = 0;
+    size_t        eccentricity;
+    size_t        next_eccentricity;
+    size_t        n_buf;
+    unsigned long start;
+    unsigned long far;
+    unsigned long next_far;
+    unsigned long v;
+    unsigned long u;
+
+    for (size_t s = 0; s < n; ++s) {
+        start = by_degree[s].value;
+
+        if (visited[start]) {
+            continue;
+        }
+
+        // Moves the start away until the search does not get deeper
+        eccentricity = rcm_eccentricity(
+              graph, start, visited, mark, ++stamp, queue, &far);
+        for (size_t i = 0; i < RCM_MAX_PERIPHERAL_SEARCHES; ++i) {
+            next_eccentricity = rcm_eccentricity(
+                  graph, far, visited, mark, ++stamp, queue, &next_far);
+
+            if (next_eccentricity <= eccentricity) {
+                break;
+            }
+            start        = far;
+            far          = next_far;
+            eccentricity = next_eccentricity;
+        }
+
+        visited[start] = true;
+        seq[tail++]    = start;
+
+        while (head < tail) {
+            v     = seq[head++];
+            n_buf = 0;
+
+            for (direction_t d = OUTGOING; d <= INCOMING; ++d) {
+                for (size_t e = graph->offsets[d][v];
+                     e < graph->offsets[d][v + 1];
+                     ++e) {
+                    u = graph->edges[d][e].neighbour;
+
+                    if (!visited[u]) {
+                        visited[u]       = true;
+                        buf[n_buf].key   = degree(graph, u);
+                        buf[n_buf].value = u;
+                        n_buf++;
+                    }
+                }
+            }
+            qsort(buf, n_buf, sizeof(order_pair), compare_pairs);
+
+            for (size_t i = 0; i < n_buf; ++i) {
+                seq[tail++] = buf[i].value;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < n / 2; ++i) {
+        v              = seq[i];
+        seq[i]         = seq[n - 1 - i];
+        seq[n - 1 - i] = v;
+    }
+
+    free(visited);
+    free(mark);
+    free(queue);
+    free(by_degree);
+    free(buf);
+
+    return seq;
+}
+
+static unsigned long*
+degree_sequence(const csr_graph* graph)
+{
+    size_t         n      = graph->n_nodes;
+    unsigned long* seq    = order_calloc(n, sizeof(unsigned long));
+    order_pair*    hubs   = order_calloc(n, sizeof(order_pair));
+    size_t         n_hubs = 0;
+    size_t         k;
+
+    // Above average degree without dividing: degree * n > 2 * n_rels
+    for (size_t v = 0; v < n; ++v) {
+        if (degree(graph, v) * n > 2 * graph->n_rels) {
+            hubs[n_hubs].key   = ULONG_MAX - degree(graph, v);
+            hubs[n_hubs].value = v;
+            n_hubs++;
+        }
+    }
+    qsort(hubs, n_hubs, sizeof(order_pair), compare_pairs);
+
+    for (k = 0; k < n_hubs; ++k) {
+        seq[k] = hubs[k].value;
+    }
+    for (size_t v = 0; v < n; ++v) {
+        if (degree(graph, v) * n <= 2 * graph->n_rels) {
+            seq[k++] = v;
+        }
+    }
+    free(hubs);
+
+    return seq;
+}
+
+static void
+unit_heap_unlink(unit_heap* heap, unsigned long v)
+{
+    if (heap->prev[v] != UNINITIALIZED_LONG) {
+        heap->next[heap->prev[v]] = heap->next[v];
+    } else {
+        heap->head[heap->key[v]] = heap->next[v];
+    }
+
+    if (heap->next[v] != UNINITIALIZED_LONG) {
+        heap->prev[heap->next[v]] = heap->prev[v];
+    }
+}
+
+static void
+unit_heap_link(unit_heap* heap, unsigned long v)
+{
+    if (heap->key[v] >= heap->n_keys) {
+        heap->head = order_realloc(
+              heap->head, 2 * heap->n_keys, sizeof(unsigned long));
+
+        for (size_t k = heap->n_keys; k < 2 * heap->n_keys; ++k) {
+            heap->head[k] = UNINITIALIZED_LONG;
+        }
+        heap->n_keys *= 2;
+    }
+
+    heap->prev[v] = UNINITIALIZED_LONG;
+    heap->next[v] = heap->head[heap->key[v]];
+    if (heap->next[v] != UNINITIALIZED_LONG) {
+        heap->prev[heap->next[v]] = v;
+    }
+    heap->head[heap->key[v]] = v;
+
+    if (heap->key[v] > heap->max_key) {
+        heap->max_key = heap->key[v];
+    }
+}
+
+static void
+unit_heap_adjust(unit_heap* heap, unsigned long v, bool increment)
+{
+    if (heap->removed[v]) {
+        return;
+    }
+
+    unit_heap_unlink(heap, v);
+    heap->key[v] = increment ? heap->key[v] + 1 : heap->key[v] - 1;
+    unit_heap_link(heap, v);
+}
+
+static void
+unit_heap_remove(unit_heap* heap, unsigned long v)
+{
+    unit_heap_unlink(heap, v);
+    heap->removed[v] = true;
+}
+
+static unsigned long
+unit_heap_pop(unit_heap* heap)
+{
+    while (heap->head[heap->max_key] == UNINITIALIZED_LONG
+           && heap->max_key > 0) {
+        heap->max_key--;
+    }
+
+    unsigned long v = heap->head[heap->max_key];
+    unit_heap_remove(heap, v);
+
+    return v;
+}
+
+/* Adds or removes the scores of the node u entering or leaving the window. */
+static void
+gorder_update(const csr_graph* graph,
+              unit_heap*       heap,
+              unsigned long    u,
+              unsigned long    hub_limit,
+              bool             increment)
+{
+    const unsigned long* out_off = graph->offsets[OUTGOING];
+    unsigned long        p;
+    unsigned long        x;
+
+    for (direction_t d = OUTGOING; d <= INCOMING; ++d) {
+        for (size_t e = graph->offsets[d][u]; e < graph->offsets[d][u + 1];
+             ++e) {
+            x = graph->edges[d][e].neighbour;
+
+            if (x != u) {
+                unit_heap_adjust(heap, x, increment);
+            }
+        }
+    }
+
+    // Nodes with a common in-neighbour
+    for (size_t e = graph->offsets[INCOMING][u];
+         e < graph->offsets[INCOMING][u + 1];
+         ++e) {
+        p = graph->edges[INCOMING][e].neighbour;
+
+        if (out_off[p + 1] - out_off[p] > hub_limit) {
+            continue;
+        }
+
+        for (size_t f = out_off[p]; f < out_off[p + 1]; ++f) {
+            x = graph->edges[OUTGOING][f].neighbour;
+
+            if (x != u) {
+                unit_heap_adjust(heap, x, increment);
+            }
+        }
+    }
+}
+
+static unsigned long*
+gorder_sequence(const csr_graph* graph, size_t window)
+{
+    size_t         n   = graph->n_nodes;
+    unsigned long* seq = order_calloc(n, sizeof(unsigned long));
+
+    if (n == 0) {
+        return seq;
+    }
+
+    unit_heap heap;
+    heap.key     = order_calloc(n, sizeof(unsigned long));
+    heap.prev    = order_calloc(n, sizeof(unsigned long));
+    heap.next    = order_calloc(n, sizeof(unsigned long));
+    heap.removed = order_calloc(n, sizeof(bool));
+    heap.n_keys  = 1;
+    heap.max_key = 0;
+    heap.head    = order_calloc(1, sizeof(unsigned long));
+    heap.head[0] = UNINITIALIZED_LONG;
+
+    for (size_t v = n; v > 0; --v) {
+        unit_heap_link(&heap, v - 1);
+    }
+
+    unsigned long hub_limit = 1;
+    while ((hub_limit + 1) * (hub_limit + 1) <= n) {
+        hub_limit++;
+    }
+
+    // Starts with the node with the most in-neighbours
+    unsigned long start = 0;
+    for (size_t v = 1; v < n; ++v) {
+        if (csr_graph_degree(graph, v, INCOMING)
+            > csr_graph_degree(graph, start, INCOMING)) {
+            start = v;
+        }
+    }
+
+    seq[0] = start;
+    unit_heap_remove(&heap, start);
+    gorder_update(graph, &heap, start, hub_limit, true);
+
+    for (size_t i = 1; i < n; ++i) {
+        seq[i] = unit_heap_pop(&heap);
+        gorder_update(graph, &heap, seq[i], hub_limit, true);
+
+        if (i >= window) {
+            gorder_update(graph, &heap, seq[i - window], hub_limit, false);
+        }
+    }
+
+    free(heap.key);
+    free(heap.prev);
+    free(heap.next);
+    free(heap.removed);
+    free(heap.head);
+
+    return seq;
+}
+
+static unsigned long
+rabbit_find(rabbit_state* state, unsigned long v)
+{
+    unsigned long d;
+
+    while ((d = atomic_load_explicit(&state->dest[v], memory_order_acquire))
+           != v) {
+        v = d;
+    }
+
+    return v;
+}
+
+/* Merges v into its best neighbour. Returns false if that neighbour is busy
+ * or was merged itself, so that v has to be tried again. */
+static bool
+rabbit_merge(rabbit_state*  state,
+             unsigned long  v,
+             double*        scratch,
+             unsigned long* touched)
+{
+    pthread_mutex_lock(&state->locks[v]);
+
+    rabbit_edges* edges     = &state->edges[v];
+    size_t        n_touched = 0;
+    unsigned long r;
+
+    for (size_t i = 0; i < edges->size; ++i) {
+        r = rabbit_find(state, edges->neighbours[i]);
+
+        if (r == v) {
+            continue;
+        }
+
+        if (scratch[r] < 0) {
+            scratch[r]           = 0;
+            touched[n_touched++] = r;
+        }
+        scratch[r] += edges->weights[i];
+    }
+
+    // Compacts the edges and picks the largest gain, scaled by total^2 / 2
+    double        strength  = atomic_load(&state->strength[v]);
+    unsigned long best      = UNINITIALIZED_LONG;
+    double        best_gain = 0;
+    double        gain;
+
+    edges->size = n_touched;
+    for (size_t i = 0; i < n_touched; ++i) {
+        r                     = touched[i];
+        edges->neighbours[i]  = r;
+        edges->weights[i]     = scratch[r];
+        scratch[r]            = -1;
+
+        gain = edges->weights[i] * state->total
+               - strength * atomic_load(&state->strength[r]);
+
+        if (gain > best_gain
+            || (gain == best_gain && best != UNINITIALIZED_LONG && r < best)) {
+            best      = r;
+            best_gain = gain;
+        }
+    }
+
+    if (best == UNINITIALIZED_LONG) {
+        pthread_mutex_unlock(&state->locks[v]);
+        return true;
+    }
+
+    if (pthread_mutex_trylock(&state->locks[best]) != 0) {
+        pthread_mutex_unlock(&state->locks[v]);
+        return false;
+    }
+
+    if (atomic_load(&state->dest[best]) != best) {
+        pthread_mutex_unlock(&state->locks[best]);
+        pthread_mutex_unlock(&state->locks[v]);
+        return false;
+    }
+
+    rabbit_edges* target = &state->edges[best];
+    if (target->size + edges->size > target->capacity) {
+        target->capacity   = target->size + edges->size;
+        target->neighbours = order_realloc(
+              target->neighbours, target->capacity, sizeof(unsigned long));
+        target->weights =
+              order_realloc(target->weights, target->capacity, sizeof(double));
+    }
+    memcpy(target->neighbours + target->size,
+           edges->neighbours,
+           edges->size * sizeof(unsigned long));
+    memcpy(target->weights + target->size,
+           edges->weights,
+           edges->size * sizeof(double));
+    target->size += edges->size;
+
+    free(edges->neighbours);
+    free(edges->weights);
+    edges->neighbours = NULL;
+    edges->weights    = NULL;
+    edges->size       = 0;
+    edges->capacity   = 0;
+
+    atomic_store(&state->strength[best],
+                 atomic_load(&state->strength[best]) + strength);
+
+    if (state->last_child[best] == UNINITIALIZED_LONG) {
+        state->first_child[best] = v;
+    } else {
+        state->sibling[state->last_child[best]] = v;
+    }
+    state->last_child[best] = v;
+
+    atomic_store_explicit(&state->dest[v], best, memory_order_release);
+
+    pthread_mutex_unlock(&state->locks[best]);
+    pthread_mutex_unlock(&state->locks[v]);
+
+    return true;
+}
+
+static void*
+rabbit_aggregate(void* arg)
+{
+    rabbit_task*  task  = arg;
+    rabbit_state* state = task->state;
+    size_t        i;
+
+    while ((i = atomic_fetch_add(&state->next, 1)) < state->n) {
+        if (!rabbit_merge(
+                  state, state->order[i], task->scratch, task->touched)) {
+            array_list_ul_append(task->retry, state->order[i]);
+        }
+    }
+
+    return NULL;
+}
+
+static unsigned long*
+rabbit_sequence(const csr_graph* graph)
+{
+    size_t n = graph->n_nodes;
+
+    rabbit_state state;
+    state.n           = n;
+    state.total       = 0;
+    state.edges       = order_calloc(n, sizeof(rabbit_edges));
+    state.dest        = order_calloc(n, sizeof(_Atomic unsigned long));
+    state.strength    = order_calloc(n, sizeof(_Atomic double));
+    state.locks       = order_calloc(n, sizeof(pthread_mutex_t));
+    state.first_child = order_calloc(n, sizeof(unsigned long));
+    state.last_child  = order_calloc(n, sizeof(unsigned long));
+    state.sibling     = order_calloc(n, sizeof(unsigned long));
+    atomic_init(&state.next, 0);
+
+    order_pair*    by_degree = order_calloc(n, sizeof(order_pair));
+    unsigned long* order     = order_calloc(n, sizeof(unsigned long));
+    rabbit_edges*  edges;
+    unsigned long  u;
+
+    // Every relationship starts with weight one, self loops are dropped
+    for (size_t v = 0; v < n; ++v) {
+        edges             = &state.edges[v];
+        edges->capacity   = degree(graph, v);
+        edges->neighbours =
+              order_calloc(edges->capacity, sizeof(unsigned long));
+        edges->weights    = order_calloc(edges->capacity, sizeof(double));
+
+        for (direction_t d = OUTGOING; d <= INCOMING; ++d) {
+            for (size_t e = graph->offsets[d][v]; e < graph->offsets[d][v + 1];
+                 ++e) {
+                u = graph->edges[d][e].neighbour;
+
+                if (u != v) {
+                    edges->neighbours[edges->size] = u;
+                    edges->weights[edges->size]    = 1;
+                    edges->size++;
+                }
+            }
+        }
+
+        atomic_init(&state.dest[v], v);
+        atomic_init(&state.strength[v], (double)edges->size);
+        pthread_mutex_init(&state.locks[v], NULL);
+        state.total += (double)edges->size;
+        state.first_child[v] = UNINITIALIZED_LONG;
+        state.last_child[v]  = UNINITIALIZED_LONG;
+        state.sibling[v]     = UNINITIALIZED_LONG;
+
+        by_degree[v].key   = degree(graph, v);
+        by_degree[v].value = v;
+    }
+
+    qsort(by_degree, n, sizeof(order_pair), compare_pairs);
+    for (size_t i = 0; i < n; ++i) {
+        order[i] = by_degree[i].value;
+    }
+    free(by_degree);
+    state.order = order;
+
+    size_t n_threads = n / RABBIT_MIN_NODES_PER_THREAD;
+    if (n_threads > N_THREADS) {
+        n_threads = N_THREADS;
+    } else if (n_threads == 0) {
+        n_threads = 1;
+    }
+
+    rabbit_task tasks[n_threads];
+    for (size_t t = 0; t < n_threads; ++t) {
+        tasks[t].state   = &state;
+        tasks[t].scratch = order_calloc(n, sizeof(double));
+        tasks[t].touched = order_calloc(n, sizeof(unsigned long));
+        tasks[t].retry   = al_ul_create();
+
+        for (size_t v = 0; v < n; ++v) {
+            tasks[t].scratch[v] = -1;
+        }
+    }
+
+    pthread_t threads[n_threads];
+    for (size_t t = 1; t < n_threads; ++t) {
+        if (pthread_create(&threads[t], NULL, rabbit_aggregate, &tasks[t])
+            != 0) {
+            // LCOV_EXCL_START
+            printf("locality order - rabbit order: Failed to create "
+                   "thread!\n");
+            print_trace();
+
+            exit(EXIT_FAILURE);
+            // LCOV_EXCL_STOP
+        }
+    }
+
+    rabbit_aggregate(&tasks[0]);
+
+    for (size_t t = 1; t < n_threads; ++t) {
+        pthread_join(threads[t], NULL);
+    }
+
+    // Alone, a node never finds its neighbour busy
+    for (size_t t = 0; t < n_threads; ++t) {
+        for (size_t i = 0; i < array_list_ul_size(tasks[t].retry); ++i) {
+            rabbit_merge(&state,
+                         array_list_ul_get(tasks[t].retry, i),
+                         tasks[0].scratch,
+                         tasks[0].touched);
+        }
+    }
+
+    // Depth-first over the merge trees, children in the order of merging
+    unsigned long* seq   = order_calloc(n, sizeof(unsigned long));
+    unsigned long* stack = order_calloc(n, sizeof(unsigned long));
+    size_t         k     = 0;
+    size_t         top   = 0;
+    unsigned long  v;
+
+    for (size_t root = 0; root < n; ++root) {
+        if (atomic_load(&state.dest[root]) != root) {
+            continue;
+        }
+
+        stack[top++] = root;
+        while (top > 0) {
+            v        = stack[--top];
+            seq[k++] = v;
+
+            if (v != root && state.sibling[v] != UNINITIALIZED_LONG) {
+                stack[top++] = state.sibling[v];
+            }
+            if (state.first_child[v] != UNINITIALIZED_LONG) {
+                stack[top++] = state.first_child[v];
+            }
+        }
+    }
+
+    for (size_t t = 0; t < n_threads; ++t) {
+        free(tasks[t].scratch);
+        free(tasks[t].touched);
+        array_list_ul_destroy(tasks[t].retry);
+    }
+    for (size_t i = 0; i < n; ++i) {
+        free(state.edges[i].neighbours);
+        free(state.edges[i].weights);
+        pthread_mutex_destroy(&state.locks[i]);
+    }
+    free(state.edges);
+    free(state.dest);
+    free(state.strength);
+    free(state.locks);
+    free(state.first_child);
+    free(state.last_child);
+    free(state.sibling);
+    free(order);
+    free(stack);
+
+    return seq;
+}
+
+dict_ul_ul*
+bfs_node_order(heap_file* hf, bool log)
+{
+    if (!hf) {
+        // LCOV_EXCL_START
+        printf("locality order - bfs node order: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    csr_graph*     graph = csr_graph_create(hf, log);
+    unsigned long* seq   = bfs_sequence(graph);
+    dict_ul_ul*    order = order_from_sequence(graph, seq);
+
+    free(seq);
+    csr_graph_destroy(graph);
+
+    return order;
+}
+
+dict_ul_ul*
+rcm_node_order(heap_file* hf, bool log)
+{
+    if (!hf) {
+        // LCOV_EXCL_START
+        printf("locality order - rcm node order: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    csr_graph*     graph = csr_graph_create(hf, log);
+    unsigned long* seq   = rcm_sequence(graph);
+    dict_ul_ul*    order = order_from_sequence(graph, seq);
+
+    free(seq);
+    csr_graph_destroy(graph);
+
+    return order;
+}
+
+dict_ul_ul*
+degree_node_order(heap_file* hf, bool log)
+{
+    if (!hf) {
+        // LCOV_EXCL_START
+        printf("locality order - degree node order: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    csr_graph*     graph = csr_graph_create(hf, log);
+    unsigned long* seq   = degree_sequence(graph);
+    dict_ul_ul*    order = order_from_sequence(graph, seq);
+
+    free(seq);
+    csr_graph_destroy(graph);
+
+    return order;
+}
+
+dict_ul_ul*
+gorder_node_order(heap_file* hf, size_t window, bool log)
+{
+    if (!hf || window == 0) {
+        // LCOV_EXCL_START
+        printf("locality order - gorder node order: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    csr_graph*     graph = csr_graph_create(hf, log);
+    unsigned long* seq   = gorder_sequence(graph, window);
+    dict_ul_ul*    order = order_from_sequence(graph, seq);
+
+    free(seq);
+    csr_graph_destroy(graph);
+
+    return order;
+}
+
+dict_ul_ul*
+rabbit_node_order(heap_file* hf, bool log)
+{
+    if (!hf) {
+        // LCOV_EXCL_START
+        printf("locality order - rabbit node order: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    csr_graph*     graph = csr_graph_create(hf, log);
+    unsigned long* seq   = rabbit_sequence(graph);
+    dict_ul_ul*    order = order_from_sequence(graph, seq);
+
+    free(seq);
+    csr_graph_destroy(graph);
+
+    return order;
+}
@@ -0,0 +1,1012 @@
+/*!
+ * \file louvain.c
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief See \ref louvain.h
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "order/louvain.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "access/csr_graph.h"
+#include "access/relationship.h"
+#include "constants.h"
+#include "strace.h"
+
+/* Number of consecutive nodes whose moves are chosen on the same state. */
+#define LOUVAIN_BLOCK_SIZE (256)
+/* Below this many nodes per thread, the threads cost more than they save. */
+#define LOUVAIN_MIN_NODES_PER_THREAD (64)
+/* Bounds the sweeps over all nodes per level. Usually the gain in modularity
+ * drops below the minimum after a few sweeps. */
+#define LOUVAIN_MAX_SWEEPS (64)
+#define LOUVAIN_MIN_GAIN   (1e-7)
+
+/* The undirected graph of one level. Every edge appears in the adjacency of
+ * both endpoints, self loops are kept apart and count twice in the degree. */
+typedef struct
+{
+    size_t         n;
+    unsigned long* offsets;
+    unsigned long* adj;
+    double*        weights;
+    double*        self;
+    double*        degree;
+    double         total;
+} level_graph;
+
+typedef struct
+{
+    const level_graph*   graph;
+    const unsigned long* comm;
+    size_t               begin;
+    size_t               end;
+    double               internal;
+} modularity_task;
+
+typedef struct
+{
+    const level_graph* graph;
+    double             resolution;
+    unsigned long*     comm;
+    double*            tot;
+    unsigned long*     size;
+    unsigned long*     target;
+    size_t             n_threads;
+    size_t             n_moves;
+    pthread_barrier_t  barrier;
+} move_state;
+
+typedef struct
+{
+    move_state*    state;
+    size_t         tid;
+    /* Weight to each community, negative for communities not adjacent to the
+     * current node */
+    double*        scratch;
+    unsigned long* touched;
+} move_task;
+
+typedef struct
+{
+    const level_graph*   graph;
+    double               resolution;
+    const unsigned long* comm;
+    const double*        tot;
+    const unsigned long* members;
+    const unsigned long* member_offsets;
+    unsigned long*       refined;
+    double*              ref_tot;
+    double*              ref_ext;
+    unsigned long*       ref_size;
+    size_t               begin;
+    size_t               end;
+    double*              scratch;
+    unsigned long*       touched;
+} refine_task;
+
+static void*
+louvain_calloc(size_t n, size_t size)
+{
+    void* ptr = calloc(n == 0 ? 1 : n, size);
+
+    if (!ptr) {
+        // LCOV_EXCL_START
+        printf("louvain: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    return ptr;
+}
+
+static size_t
+thread_count(size_t n)
+{
+    size_t n_threads = n / LOUVAIN_MIN_NODES_PER_THREAD;
+
+    if (n_threads > N_THREADS) {
+        return N_THREADS;
+    }
+
+    return n_threads == 0 ? 1 : n_threads;
+}
+
+/* Runs fn on each task, the first one on the calling thread. */
+static void
+run_parallel(void* (*fn)(void*), void* tasks, size_t task_size, size_t n)
+{
+    pthread_t threads[n];
+    for (size_t t = 1; t < n; ++t) {
+        if (pthread_create(&threads[t], NULL, fn, (char*)tasks + t * task_size)
+            != 0) {
+            // LCOV_EXCL_START
+            printf("louvain: Failed to create thread!\n");
+            print_trace();
+
+            exit(EXIT_FAILURE);
+            // LCOV_EXCL_STOP
+        }
+    }
+
+    fn(tasks);
+
+    for (size_t t = 1; t < n; ++t) {
+        pthread_join(threads[t], NULL);
+    }
+}
+
+static level_graph*
+level_graph_create(size_t n, size_t n_adj)
+{
+    level_graph* graph = louvain_calloc(1, sizeof(level_graph));
+    graph->n           = n;
+    graph->offsets     = louvain_calloc(n + 1, sizeof(unsigned long));
+    graph->adj         = louvain_calloc(n_adj, sizeof(unsigned long));
+    graph->weights     = louvain_calloc(n_adj, sizeof(double));
+    graph->self        = louvain_calloc(n, sizeof(double));
+    graph->degree      = louvain_calloc(n, sizeof(double));
+    graph->total       = 0;
+
+    return graph;
+}
+
+static void
+level_graph_destroy(level_graph* graph)
+{
+    free(graph->offsets);
+    free(graph->adj);
+    free(graph->weights);
+    free(graph->self);
+    free(graph->degree);
+    free(graph);
+}
+
+/* Merges the sorted outgoing and incoming edges of node i into distinct
+ * neighbours. Only counts them if adj is NULL. */
+static size_t
+merge_row(const csr_graph* csr,
+          size_t           i,
+          unsigned long*   adj,
+          double*          weights,
+          double*          self)
+{
+    const unsigned long* out_off = csr->offsets[OUTGOING];
+    const unsigned long* in_off  = csr->offsets[INCOMING];
+    const csr_edge*      out     = csr->edges[OUTGOING] + out_off[i];
+    const csr_edge*      in      = csr->edges[INCOMING] + in_off[i];
+    size_t               n_out   = out_off[i + 1] - out_off[i];
+    size_t               n_in    = in_off[i + 1] - in_off[i];
+
+    size_t        a     = 0;
+    size_t        b     = 0;
+    size_t        count = 0;
+    unsigned long last  = UNINITIALIZED_LONG;
+    unsigned long u;
+
+    *self = 0;
+    while (a < n_out || b < n_in) {
+        if (b == n_in || (a < n_out && out[a].neighbour <= in[b].neighbour)) {
+            u = out[a++].neighbour;
+
+            if (u == i) {
+                *self += 1;
+                continue;
+            }
+        } else {
+            u = in[b++].neighbour;
+
+            // Self loops are in both lists and counted above
+            if (u == i) {
+                continue;
+            }
+        }
+
+        if (u != last) {
+            if (adj) {
+                adj[count]     = u;
+                weights[count] = 0;
+            }
+            count++;
+            last = u;
+        }
+
+        if (adj) {
+            weights[count - 1] += 1;
+        }
+    }
+
+    return count;
+}
+
+static level_graph*
+level_graph_from_csr(const csr_graph* csr)
+{
+    size_t n     = csr->n_nodes;
+    size_t n_adj = 0;
+    double self;
+
+    for (size_t i = 0; i < n; ++i) {
+        n_adj += merge_row(csr, i, NULL, NULL, &self);
+    }
+
+    level_graph* graph = level_graph_create(n, n_adj);
+
+    for (size_t i = 0; i < n; ++i) {
+        graph->offsets[i + 1] =
+              graph->offsets[i]
+              + merge_row(csr,
+                          i,
+                          graph->adj + graph->offsets[i],
+                          graph->weights + graph->offsets[i],
+                          &graph->self[i]);
+
+        graph->degree[i] = 2 * graph->self[i];
+        for (size_t e = graph->offsets[i]; e < graph->offsets[i + 1]; ++e) {
+            graph->degree[i] += graph->weights[e];
+        }
+        graph->total += graph->degree[i];
+    }
+
+    return graph;
+}
+
+/* Groups the nodes by their label in [0, n_labels), keeping their order. */
+static void
+group_by_label(const unsigned long* labels,
+               size_t               n,
+               size_t               n_labels,
+               unsigned long*       members,
+               unsigned long*       offsets)
+{
+    memset(offsets, 0, (n_labels + 1) * sizeof(unsigned long));
+
+    for (size_t v = 0; v < n; ++v) {
+        offsets[labels[v] + 1]++;
+    }
+    for (size_t l = 0; l < n_labels; ++l) {
+        offsets[l + 1] += offsets[l];
+    }
+
+    unsigned long* next = louvain_calloc(n_labels, sizeof(unsigned long));
+    memcpy(next, offsets, n_labels * sizeof(unsigned long));
+    for (size_t v = 0; v < n; ++v) {
+        members[next[labels[v]]++] = v;
+    }
+    free(next);
+}
+
+/* Renumbers labels in [0, n) densely in the order of their first node.
+ * Returns the number of distinct labels. */
+static size_t
+renumber(unsigned long* labels, size_t n)
+{
+    unsigned long* map      = louvain_calloc(n, sizeof(unsigned long));
+    size_t         n_labels = 0;
+
+    for (size_t v = 0; v < n; ++v) {
+        map[v] = UNINITIALIZED_LONG;
+    }
+
+    for (size_t v = 0; v < n; ++v) {
+        if (map[labels[v]] == UNINITIALIZED_LONG) {
+            map[labels[v]] = n_labels++;
+        }
+        labels[v] = map[labels[v]];
+    }
+    free(map);
+
+    return n_labels;
+}
+
+static void*
+internal_weight_range(void* arg)
+{
+    modularity_task*   task  = arg;
+    const level_graph* graph = task->graph;
+
+    task->internal = 0;
+    for (size_t v = task->begin; v < task->end; ++v) {
+        task->internal += 2 * graph->self[v];
+
+        for (size_t e = graph->offsets[v]; e < graph->offsets[v + 1]; ++e) {
+            if (task->comm[graph->adj[e]] == task->comm[v]) {
+                task->internal += graph->weights[e];
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/* The communities are labelled with values below the number of nodes. */
+static double
+modularity(const level_graph*   graph,
+           const unsigned long* comm,
+           const double*        tot,
+           double               resolution)
+{
+    if (graph->total == 0) {
+        return 0;
+    }
+
+    size_t          n_threads = thread_count(graph->n);
+    modularity_task tasks[n_threads];
+    for (size_t t = 0; t < n_threads; ++t) {
+        tasks[t].graph = graph;
+        tasks[t].comm  = comm;
+        tasks[t].begin = graph->n * t / n_threads;
+        tasks[t].end   = graph->n * (t + 1) / n_threads;
+    }
+
+    run_parallel(
+          internal_weight_range, tasks, sizeof(modularity_task), n_threads);
+
+    double internal = 0;
+    for (size_t t = 0; t < n_threads; ++t) {
+        internal += tasks[t].internal;
+    }
+
+    double squares = 0;
+    for (size_t c = 0; c < graph->n; ++c) {
+        squares += tot[c] * tot[c];
+    }
+
+    return (internal - resolution * squares / graph->total) / graph->total;
+}
+
+static unsigned long
+best_community(const move_state* state,
+               unsigned long     v,
+               double*           scratch,
+               unsigned long*    touched)
+{
+    const level_graph* graph = state->graph;
+    unsigned long      own   = state->comm[v];
+    double             k     = graph->degree[v];
+    size_t             n_touched = 1;
+    unsigned long      c;
+
+    scratch[own] = 0;
+    touched[0]   = own;
+
+    for (size_t e = graph->offsets[v]; e < graph->offsets[v + 1]; ++e) {
+        c = state->comm[graph->adj[e]];
+
+        if (scratch[c] < 0) {
+            scratch[c]           = 0;
+            touched[n_touched++] = c;
+        }
+        scratch[c] += graph->weights[e];
+    }
+
+    double        scale = state->resolution * k / graph->total;
+    unsigned long best  = own;
+    double        best_gain = scratch[own] - scale * (state->tot[own] - k);
+    double        gain;
+
+    for (size_t i = 1; i < n_touched; ++i) {
+        c    = touched[i];
+        gain = scratch[c] - scale * state->tot[c];
+
+        if (gain > best_gain
+            || (gain == best_gain && best != own && c < best)) {
+            best      = c;
+            best_gain = gain;
+        }
+    }
+
+    for (size_t i = 0; i < n_touched; ++i) {
+        scratch[touched[i]] = -1;
+    }
+
+    // Two single nodes joining each other's community would swap them
+    if (state->size[own] == 1 && state->size[best] == 1 && best > own) {
+        return own;
+    }
+
+    return best;
+}
+
+static void*
+move_blocks(void* arg)
+{
+    move_task*  task  = arg;
+    move_state* state = task->state;
+    size_t      n     = state->graph->n;
+    size_t      len;
+    size_t      end;
+    double      k;
+
+    for (size_t block = 0; block < n; block += LOUVAIN_BLOCK_SIZE) {
+        len = n - block < LOUVAIN_BLOCK_SIZE ? n - block : LOUVAIN_BLOCK_SIZE;
+        end = block + len * (task->tid + 1) / state->n_threads;
+
+        for (size_t v = block + len * task->tid / state->n_threads; v < end;
+             ++v) {
+            state->target[v] =
+                  best_community(state, v, task->scratch, task->touched);
+        }
+
+        pthread_barrier_wait(&state->barrier);
+
+        if (task->tid == 0) {
+            for (size_t v = block; v < block + len; ++v) {
+                if (state->target[v] != state->comm[v]) {
+                    k = state->graph->degree[v];
+                    state->tot[state->comm[v]] -= k;
+                    state->size[state->comm[v]]--;
+                    state->tot[state->target[v]] += k;
+                    state->size[state->target[v]]++;
+                    state->comm[v] = state->target[v];
+                    state->n_moves++;
+                }
+            }
+        }
+
+        pthread_barrier_wait(&state->barrier);
+    }
+
+    return NULL;
+}
+
+/* Moves nodes between the communities until the modularity stops improving.
+ * A sweep that decreases the modularity is undone. */
+static void
+move_nodes(const level_graph* graph,
+           unsigned long*     comm,
+           double*            tot,
+           unsigned long*     size,
+           double             resolution)
+{
+    size_t n = graph->n;
+
+    move_state state;
+    state.graph      = graph;
+    state.resolution = resolution;
+    state.comm       = comm;
+    state.tot        = tot;
+    state.size       = size;
+    state.target     = louvain_calloc(n, sizeof(unsigned long));
+    state.n_threads  = thread_count(n);
+    pthread_barrier_init(&state.barrier, NULL, state.n_threads);
+
+    move_task tasks[state.n_threads];
+    for (size_t t = 0; t < state.n_threads; ++t) {
+        tasks[t].state   = &state;
+        tasks[t].tid     = t;
+        tasks[t].scratch = louvain_calloc(n, sizeof(double));
+        tasks[t].touched = louvain_calloc(n, sizeof(unsigned long));
+
+        for (size_t c = 0; c < n; ++c) {
+            tasks[t].scratch[c] = -1;
+        }
+    }
+
+    unsigned long* prev_comm = louvain_calloc(n, sizeof(unsigned long));
+    double*        prev_tot  = louvain_calloc(n, sizeof(double));
+    unsigned long* prev_size = louvain_calloc(n, sizeof(unsigned long));
+
+    double q = modularity(graph, comm, tot, resolution);
+    double q_new;
+    for (size_t sweep = 0; sweep < LOUVAIN_MAX_SWEEPS; ++sweep) {
+        memcpy(prev_comm, comm, n * sizeof(unsigned long));
+        memcpy(prev_tot, tot, n * sizeof(double));
+        memcpy(prev_size, size, n * sizeof(unsigned long));
+
+        state.n_moves = 0;
+        run_parallel(move_blocks, tasks, sizeof(move_task), state.n_threads);
+
+        if (state.n_moves == 0) {
+            break;
+        }
+
+        q_new = modularity(graph, comm, tot, resolution);
+
+        if (q_new < q) {
+            memcpy(comm, prev_comm, n * sizeof(unsigned long));
+            memcpy(tot, prev_tot, n * sizeof(double));
+            memcpy(size, prev_size, n * sizeof(unsigned long));
+            break;
+        }
+
+        if (q_new - q < LOUVAIN_MIN_GAIN) {
+            break;
+        }
+        q = q_new;
+    }
+
+    free(prev_comm);
+    free(prev_tot);
+    free(prev_size);
+    for (size_t t = 0; t < state.n_threads; ++t) {
+        free(tasks[t].scratch);
+        free(tasks[t].touched);
+    }
+    pthread_barrier_destroy(&state.barrier);
+    free(state.target);
+}
+
+static void*
+refine_range(void* arg)
+{
+    refine_task*       task  = arg;
+    const level_graph* graph = task->graph;
+    const double       scale = task->resolution / graph->total;
+
+    unsigned long v;
+    unsigned long u;
+    unsigned long r;
+    unsigned long best;
+    size_t        n_touched;
+    double        k;
+    double        k_in;
+    double        gain;
+    double        best_gain;
+    double        tot_c;
+
+    for (size_t c = task->begin; c < task->end; ++c) {
+        tot_c = task->tot[c];
+
+        // Each node starts alone, connected to the rest of the community
+        for (size_t i = task->member_offsets[c];
+             i < task->member_offsets[c + 1];
+             ++i) {
+            v                 = task->members[i];
+            task->ref_ext[v] = 0;
+
+            for (size_t e = graph->offsets[v]; e < graph->offsets[v + 1];
+                 ++e) {
+                if (task->comm[graph->adj[e]] == c) {
+                    task->ref_ext[v] += graph->weights[e];
+                }
+            }
+        }
+
+        for (size_t i = task->member_offsets[c];
+             i < task->member_offsets[c + 1];
+             ++i) {
+            v = task->members[i];
+
+            if (task->refined[v] != v || task->ref_size[v] != 1) {
+                continue;
+            }
+
+            k         = graph->degree[v];
+            k_in      = 0;
+            n_touched = 0;
+            for (size_t e = graph->offsets[v]; e < graph->offsets[v + 1];
+                 ++e) {
+                u = graph->adj[e];
+
+                if (task->comm[u] != c) {
+                    continue;
+                }
+
+                k_in += graph->weights[e];
+                r = task->refined[u];
+
+                if (task->scratch[r] < 0) {
+                    task->scratch[r]            = 0;
+                    task->touched[n_touched++] = r;
+                }
+                task->scratch[r] += graph->weights[e];
+            }
+
+            best      = UNINITIALIZED_LONG;
+            best_gain = 0;
+
+            // Only well-connected nodes join well-connected subcommunities
+            if (k_in >= scale * k * (tot_c - k)) {
+                for (size_t j = 0; j < n_touched; ++j) {
+                    r = task->touched[j];
+
+                    if (task->ref_ext[r]
+                        < scale * task->ref_tot[r]
+                                * (tot_c - task->ref_tot[r])) {
+                        continue;
+                    }
+
+                    gain = task->scratch[r] - scale * k * task->ref_tot[r];
+
+                    if (gain > best_gain
+                        || (gain == best_gain && best != UNINITIALIZED_LONG
+                            && r < best)) {
+                        best      = r;
+                        best_gain = gain;
+                    }
+                }
+            }
+
+            if (best != UNINITIALIZED_LONG) {
+                task->refined[v] = best;
+                task->ref_size[v]--;
+                task->ref_size[best]++;
+                task->ref_tot[best] += k;
+                task->ref_ext[best] += k_in - 2 * task->scratch[best];
+            }
+
+            for (size_t j = 0; j < n_touched; ++j) {
+                task->scratch[task->touched[j]] = -1;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/* Splits each of the n_comms communities into subcommunities. Returns the
+ * subcommunity of each node, labelled by one of its nodes. */
+static unsigned long*
+refine(const level_graph*   graph,
+       const unsigned long* comm,
+       size_t               n_comms,
+       double               resolution)
+{
+    size_t n = graph->n;
+
+    unsigned long* members = louvain_calloc(n, sizeof(unsigned long));
+    unsigned long* offsets = louvain_calloc(n_comms + 1, sizeof(unsigned long));
+    group_by_label(comm, n, n_comms, members, offsets);
+
+    double*        tot      = louvain_calloc(n_comms, sizeof(double));
+    unsigned long* refined  = louvain_calloc(n, sizeof(unsigned long));
+    double*        ref_tot  = louvain_calloc(n, sizeof(double));
+    double*        ref_ext  = louvain_calloc(n, sizeof(double));
+    unsigned long* ref_size = louvain_calloc(n, sizeof(unsigned long));
+
+    for (size_t v = 0; v < n; ++v) {
+        tot[comm[v]] += graph->degree[v];
+        refined[v]  = v;
+        ref_tot[v]  = graph->degree[v];
+        ref_size[v] = 1;
+    }
+
+    // Balances the tasks by the number of nodes in their communities
+    size_t      n_threads = thread_count(n);
+    refine_task tasks[n_threads];
+    size_t      c = 0;
+    for (size_t t = 0; t < n_threads; ++t) {
+        tasks[t].graph          = graph;
+        tasks[t].resolution     = resolution;
+        tasks[t].comm           = comm;
+        tasks[t].tot            = tot;
+        tasks[t].members        = members;
+        tasks[t].member_offsets = offsets;
+        tasks[t].refined        = refined;
+        tasks[t].ref_tot        = ref_tot;
+        tasks[t].ref_ext        = ref_ext;
+        tasks[t].ref_size       = ref_size;
+        tasks[t].begin          = c;
+
+        while (c < n_comms && offsets[c] < n * (t + 1) / n_threads) {
+            c++;
+        }
+        tasks[t].end     = t + 1 == n_threads ? n_comms : c;
+        tasks[t].scratch = louvain_calloc(n, sizeof(double));
+        tasks[t].touched = louvain_calloc(n, sizeof(unsigned long));
+
+        for (size_t r = 0; r < n; ++r) {
+            tasks[t].scratch[r] = -1;
+        }
+    }
+
+    run_parallel(refine_range, tasks, sizeof(refine_task), n_threads);
+
+    for (size_t t = 0; t < n_threads; ++t) {
+        free(tasks[t].scratch);
+        free(tasks[t].touched);
+    }
+    free(members);
+    free(offsets);
+    free(tot);
+    free(ref_tot);
+    free(ref_ext);
+    free(ref_size);
+
+    return refined;
+}
+
+/* Contracts the nodes with the same label in [0, n_parts) to one node. */
+static level_graph*
+aggregate(const level_graph* graph, const unsigned long* part, size_t n_parts)
+{
+    size_t n = graph->n;
+
+    unsigned long* members = louvain_calloc(n, sizeof(unsigned long));
+    unsigned long* offsets = louvain_calloc(n_parts + 1, sizeof(unsigned long));
+    group_by_label(part, n, n_parts, members, offsets);
+
+    // The contracted graph has at most as many adjacency entries
+    level_graph* coarse  = level_graph_create(n_parts, graph->offsets[n]);
+    double*      scratch = louvain_calloc(n_parts, sizeof(double));
+    size_t       n_adj   = 0;
+    unsigned long v;
+    unsigned long q;
+
+    for (size_t p = 0; p < n_parts; ++p) {
+        scratch[p] = -1;
+    }
+
+    for (size_t p = 0; p < n_parts; ++p) {
+        size_t begin = n_adj;
+
+        for (size_t i = offsets[p]; i < offsets[p + 1]; ++i) {
+            v = members[i];
+            coarse->self[p] += graph->self[v];
+            coarse->degree[p] += graph->degree[v];
+
+            for (size_t e = graph->offsets[v]; e < graph->offsets[v + 1];
+                 ++e) {
+                q = part[graph->adj[e]];
+
+                // Internal edges are seen from both endpoints
+                if (q == p) {
+                    coarse->self[p] += graph->weights[e] / 2;
+                    continue;
+                }
+
+                if (scratch[q] < 0) {
+                    scratch[q]         = 0;
+                    coarse->adj[n_adj] = q;
+                    n_adj++;
+                }
+                scratch[q] += graph->weights[e];
+            }
+        }
+
+        for (size_t e = begin; e < n_adj; ++e) {
+            coarse->weights[e]       = scratch[coarse->adj[e]];
+            scratch[coarse->adj[e]] = -1;
+        }
+        coarse->offsets[p + 1] = n_adj;
+    }
+    coarse->total = graph->total;
+
+    free(scratch);
+    free(members);
+    free(offsets);
+
+    return coarse;
+}
+
+/* Sorts the nodes in order stably by their key in [0, n_keys). */
+static void
+sort_by_key(unsigned long*       order,
+            size_t               n,
+            const unsigned long* key,
+            size_t               n_keys)
+{
+    unsigned long* count  = louvain_calloc(n_keys + 1, sizeof(unsigned long));
+    unsigned long* sorted = louvain_calloc(n, sizeof(unsigned long));
+
+    for (size_t i = 0; i < n; ++i) {
+        count[key[order[i]] + 1]++;
+    }
+    for (size_t k = 0; k < n_keys; ++k) {
+        count[k + 1] += count[k];
+    }
+    for (size_t i = 0; i < n; ++i) {
+        sorted[count[key[order[i]]]++] = order[i];
+    }
+
+    memcpy(order, sorted, n * sizeof(unsigned long));
+    free(count);
+    free(sorted);
+}
+
+static void
+init_communities(const level_graph* graph,
+                 unsigned long*     comm,
+                 double*            tot,
+                 unsigned long*     size)
+{
+    memset(tot, 0, graph->n * sizeof(double));
+    memset(size, 0, graph->n * sizeof(unsigned long));
+
+    for (size_t v = 0; v < graph->n; ++v) {
+        tot[comm[v]] += graph->degree[v];
+        size[comm[v]]++;
+    }
+}
+
+community_result*
+communities_csr(const csr_graph* graph,
+                community_method method,
+                double           resolution)
+{
+    if (!graph || method >= invalid_community_method || !(resolution > 0)) {
+        // LCOV_EXCL_START
+        printf("louvain - communities: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    size_t            n      = graph->n_nodes;
+    community_result* result = louvain_calloc(1, sizeof(community_result));
+    result->n_nodes          = n;
+    result->community        = louvain_calloc(n, sizeof(unsigned long));
+    result->sequence         = louvain_calloc(n, sizeof(unsigned long));
+
+    level_graph* base  = level_graph_from_csr(graph);
+    level_graph* level = base;
+
+    unsigned long* comm = louvain_calloc(n, sizeof(unsigned long));
+    double*        tot  = louvain_calloc(n, sizeof(double));
+    unsigned long* size = louvain_calloc(n, sizeof(unsigned long));
+
+    for (size_t v = 0; v < n; ++v) {
+        comm[v] = v;
+    }
+    init_communities(level, comm, tot, size);
+
+    // The labels of the nodes of each level in the next one
+    unsigned long** maps     = NULL;
+    size_t*         n_labels = NULL;
+    size_t          n_levels = 0;
+    size_t          n_comms;
+    size_t          n_parts;
+    unsigned long*  part;
+    level_graph*    coarse;
+
+    for (;;) {
+        move_nodes(level, comm, tot, size, resolution);
+        n_comms = renumber(comm, level->n);
+
+        if (n_comms == level->n) {
+            break;
+        }
+
+        if (method == leiden_method) {
+            part    = refine(level, comm, n_comms, resolution);
+            n_parts = renumber(part, level->n);
+
+            if (n_parts == level->n) {
+                free(part);
+                break;
+            }
+        } else {
+            part    = louvain_calloc(level->n, sizeof(unsigned long));
+            n_parts = n_comms;
+            memcpy(part, comm, level->n * sizeof(unsigned long));
+        }
+
+        coarse = aggregate(level, part, n_parts);
+
+        // Leiden starts the coarse level from the unrefined communities
+        for (size_t v = 0; v < level->n; ++v) {
+            comm[part[v]] = method == leiden_method ? comm[v] : part[v];
+        }
+        init_communities(coarse, comm, tot, size);
+
+        maps     = realloc(maps, (n_levels + 1) * sizeof(unsigned long*));
+        n_labels = realloc(n_labels, (n_levels + 1) * sizeof(size_t));
+
+        if (!maps || !n_labels) {
+            // LCOV_EXCL_START
+            printf("louvain - communities: Failed to allocate memory!\n");
+            print_trace();
+
+            exit(EXIT_FAILURE);
+            // LCOV_EXCL_STOP
+        }
+
+        maps[n_levels]     = part;
+        n_labels[n_levels] = n_parts;
+        n_levels++;
+
+        if (level != base) {
+            level_graph_destroy(level);
+        }
+        level = coarse;
+    }
+
+    // Orders by the labels of the levels from the finest to the coarsest
+    unsigned long* cur   = louvain_calloc(n, sizeof(unsigned long));
+    unsigned long* order = louvain_calloc(n, sizeof(unsigned long));
+    for (size_t v = 0; v < n; ++v) {
+        cur[v]   = v;
+        order[v] = v;
+    }
+
+    for (size_t l = 0; l < n_levels; ++l) {
+        for (size_t v = 0; v < n; ++v) {
+            cur[v] = maps[l][cur[v]];
+        }
+        sort_by_key(order, n, cur, n_labels[l]);
+        free(maps[l]);
+    }
+
+    for (size_t v = 0; v < n; ++v) {
+        cur[v] = comm[cur[v]];
+    }
+    sort_by_key(order, n, cur, n_comms);
+
+    // Numbers the communities in the order of the sequence
+    unsigned long* number = louvain_calloc(n, sizeof(unsigned long));
+    for (size_t c = 0; c < n; ++c) {
+        number[c] = UNINITIALIZED_LONG;
+    }
+
+    result->n_communities = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (number[cur[order[i]]] == UNINITIALIZED_LONG) {
+            number[cur[order[i]]] = result->n_communities++;
+        }
+        result->community[order[i]] = number[cur[order[i]]];
+        result->sequence[i]         = graph->node_ids[order[i]];
+    }
+
+    memset(tot, 0, n * sizeof(double));
+    for (size_t v = 0; v < n; ++v) {
+        tot[result->community[v]] += base->degree[v];
+    }
+    result->modularity = modularity(base, result->community, tot, resolution);
+
+    if (level != base) {
+        level_graph_destroy(level);
+    }
+    level_graph_destroy(base);
+    free(maps);
+    free(n_labels);
+    free(number);
+    free(cur);
+    free(order);
+    free(comm);
+    free(tot);
+    free(size);
+
+    return result;
+}
+
+community_result*
+communities(heap_file*       hf,
+            community_method method,
+            double           resolution,
+            bool             log)
+{
+    if (!hf) {
+        // LCOV_EXCL_START
+        printf("louvain - communities: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    csr_graph*        graph  = csr_graph_create(hf, log);
+    community_result* result = communities_csr(graph, method, resolution);
+    csr_graph_destroy(graph);
+
+    return result;
+}
+
+void
+community_result_destroy(community_result* result)
+{
+    if (!result) {
+        // LCOV_EXCL_START
+        printf("louvain - community result destroy: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    free(result->community);
+    free(result->sequence);
+    free(result);
+}
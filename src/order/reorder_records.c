@@ -12,21 +12,26 @@
  */
 #include "order/reorder_records.h"
 
-#include <assert.h>
 #include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "access/csr_graph.h"
+#include "access/hash_index.h"
 #include "access/header_page.h"
 #include "access/heap_file.h"
+#include "access/label_index.h"
 #include "access/node.h"
 #include "access/relationship.h"
+#include "access/relationship_group.h"
 #include "constants.h"
 #include "data-struct/array_list.h"
 #include "data-struct/cbs.h"
 #include "data-struct/htable.h"
 #include "data-struct/set.h"
 #include "disk_file.h"
+#include "page.h"
 #include "page_cache.h"
 #include "physical_database.h"
 #include "strace.h"
@@ -77,24 +82,36 @@ swap_nodes(heap_file* hf, unsigned long fst, unsigned long snd, bool log)
         }
 
         array_list_relationship_destroy(rels_snd);
+    }
 
-        for (size_t i = 0; i < array_list_relationship_size(rels); ++i) {
-            rel = array_list_relationship_get(rels, i);
-
-            if (rel->source_node == fst) {
-                rel->source_node = snd;
-            } else if (rel->source_node == snd) {
-                rel->source_node = fst;
-            }
-
-            if (rel->target_node == fst) {
-                rel->target_node = snd;
-            } else if (rel->target_node == snd) {
-                rel->target_node = fst;
-            }
+    for (size_t i = 0; i < array_list_relationship_size(rels); ++i) {
+        rel = array_list_relationship_get(rels, i);
+        hash_index_remove(hf->cache,
+                          adjacency_ft,
+                          rel->source_node,
+                          rel->target_node,
+                          rel->id,
+                          log);
+
+        if (rel->source_node == fst) {
+            rel->source_node = snd;
+        } else if (rel->source_node == snd) {
+            rel->source_node = fst;
+        }
 
-            update_relationship(hf, rel, log);
+        if (rel->target_node == fst) {
+            rel->target_node = snd;
+        } else if (rel->target_node == snd) {
+            rel->target_node = fst;
         }
+
+        write_relationship_record(hf, rel, log);
+        hash_index_insert(hf->cache,
+                          adjacency_ft,
+                          rel->source_node,
+                          rel->target_node,
+                          rel->id,
+                          log);
     }
 
     array_list_relationship_destroy(rels);
@@ -169,6 +186,8 @@ swap_nodes(heap_file* hf, unsigned long fst, unsigned long snd, bool log)
         unpin_page(hf->cache, header_id, header, node_ft, log);
     }
 
+    label_index_swap(hf->cache, node_ft, fst, snd, log);
+
     if (fst_exists) {
         fst_node->id = snd;
         update_node(hf, fst_node, log);
@@ -180,6 +199,15 @@ swap_nodes(heap_file* hf, unsigned long fst, unsigned long snd, bool log)
         update_node(hf, snd_node, log);
         free(snd_node);
     }
+
+    swap_node_degrees(hf, fst, snd, log);
+
+    bool fst_unsorted = set_ul_contains(hf->unsorted_nodes, fst);
+    bool snd_unsorted = set_ul_contains(hf->unsorted_nodes, snd);
+    if (fst_unsorted != snd_unsorted) {
+        set_ul_remove(hf->unsorted_nodes, fst_unsorted ? fst : snd);
+        set_ul_insert(hf->unsorted_nodes, fst_unsorted ? snd : fst);
+    }
 }
 
 void
@@ -300,7 +328,7 @@ swap_relationships(heap_file*    hf,
             rel->next_rel_target = fst;
         }
 
-        update_relationship(hf, rel, log);
+        write_relationship_record(hf, rel, log);
         free(rel);
     }
     array_list_ul_destroy(rels_to_update);
@@ -316,6 +344,8 @@ swap_relationships(heap_file*    hf,
         }
 
         update_node(hf, node, log);
+        swap_group_relationships(hf, node->id, fst, snd, log);
+        set_ul_insert(hf->unsorted_nodes, node->id);
         free(node);
     }
     array_list_ul_destroy(nodes_to_update);
@@ -328,6 +358,39 @@ swap_relationships(heap_file*    hf,
 
     if (fst_exists) {
         fst_rel = read_relationship(hf, fst, log);
+        hash_index_remove(hf->cache,
+                          adjacency_ft,
+                          fst_rel->source_node,
+                          fst_rel->target_node,
+                          fst,
+                          log);
+    }
+
+    if (snd_exists) {
+        hash_index_remove(hf->cache,
+                          adjacency_ft,
+                          snd_rel->source_node,
+                          snd_rel->target_node,
+                          snd,
+                          log);
+    }
+
+    if (fst_exists) {
+        hash_index_insert(hf->cache,
+                          adjacency_ft,
+                          fst_rel->source_node,
+                          fst_rel->target_node,
+                          snd,
+                          log);
+    }
+
+    if (snd_exists) {
+        hash_index_insert(hf->cache,
+                          adjacency_ft,
+                          snd_rel->source_node,
+                          snd_rel->target_node,
+                          fst,
+                          log);
     }
 
     if (log) {
@@ -385,15 +448,17 @@ swap_relationships(heap_file*    hf,
         unpin_page(hf->cache, header_id, header, relationship_ft, log);
     }
 
+    label_index_swap(hf->cache, relationship_ft, fst, snd, log);
+
     if (fst_exists) {
         fst_rel->id = snd;
-        update_relationship(hf, fst_rel, log);
+        write_relationship_record(hf, fst_rel, log);
         free(fst_rel);
     }
 
     if (snd_exists) {
         snd_rel->id = fst;
-        update_relationship(hf, snd_rel, log);
+        write_relationship_record(hf, snd_rel, log);
         free(snd_rel);
     }
 }
@@ -435,179 +500,1243 @@ swap_record_pages(heap_file* hf, size_t fst, size_t snd, file_type ft, bool log)
     }
 }
 
-void
-reorder_nodes(heap_file* hf, dict_ul_ul* new_ids, bool log)
+/* The rebuild below reads the old files of the database sequentially in
+ * batches and distributes their entries to the new files, which are written
+ * one chunk of pages at a time. Both buffers together take as many pages as
+ * the cache has frames. If a remapped file does not fit into the write buffer,
+ * its entries are first appended to one bucket per chunk of the new file in a
+ * run file, which is then read back one bucket at a time. Records are
+ * addressed by their dense index, i.e. the number of the record counting all
+ * slots of the file. */
+typedef struct
 {
-    if (!hf || !new_ids) {
+    phy_database*  old_pdb;
+    phy_database*  new_pdb;
+    /* The new dense index of each record of the old files, UNINITIALIZED_LONG
+     * for free slots. */
+    unsigned long* new_index[NUM_SLOTTED_FILE_TYPES];
+    size_t         n_old_records[NUM_SLOTTED_FILE_TYPES];
+    size_t         n_new_records[NUM_SLOTTED_FILE_TYPES];
+    /* The header bitmaps of the new record files */
+    unsigned char* new_header[NUM_SLOTTED_FILE_TYPES];
+    unsigned char* buffer;
+    size_t         n_in_pages;
+    size_t         n_out_pages;
+    page**         in_pages;
+    page**         out_pages;
+    /* Holds a single entry read back from the run file */
+    page*          scratch;
+    FILE*          runs;
+    /* The nodes with relationships, by new id, if relationships moved and
+     * thus their incidence lists are no longer sorted by id. NULL otherwise. */
+    set_ul*        unsorted;
+} rebuild;
+
+/* Moves the entry with the given number in the page \p from to the one in the
+ * page \p to. */
+typedef void (*move_entry)(const rebuild* rb,
+                           page*          from,
+                           size_t         from_entry,
+                           page*          to,
+                           size_t         to_entry);
+
+static void*
+rebuild_calloc(size_t n, size_t size)
+{
+    void* ptr = calloc(n, size);
+
+    if (!ptr) {
         // LCOV_EXCL_START
-        printf("reorder_records - reorder nodes: Invalid Arguments!\n");
+        printf("reorder records - rebuild: Failed to allocate memory!\n");
         print_trace();
 
         exit(EXIT_FAILURE);
         // LCOV_EXCL_STOP
     }
 
-    // construct inverse mapping to avoid seeking for values num nodes times
-    dict_ul_ul_iterator* it              = dict_ul_ul_iterator_create(new_ids);
-    dict_ul_ul*          inverse_new_ids = d_ul_ul_create();
-    unsigned long        old_id;
-    unsigned long        new_id;
+    return ptr;
+}
 
-    while (dict_ul_ul_iterator_next(it, &old_id, &new_id) == 0) {
-        dict_ul_ul_insert(inverse_new_ids, new_id, old_id); // fut => cur
-    }
-    dict_ul_ul_iterator_destroy(it);
+static unsigned long
+record_slots(file_type ft)
+{
+    return ft == node_ft ? NUM_SLOTS_PER_NODE : NUM_SLOTS_PER_REL;
+}
 
-    unsigned short cur_slot = 0;
-    unsigned long  cur_page = 0;
-    unsigned long  temp_new;
+static unsigned long
+dense_index(unsigned long id, unsigned long n_slots)
+{
+    return ((id >> CHAR_BIT) * SLOTS_PER_PAGE + (id & UCHAR_MAX)) / n_slots;
+}
 
-    for (size_t i = 0; i < hf->n_nodes; ++i) {
-        new_id = cur_page << CHAR_BIT | cur_slot;
+static unsigned long
+position_id(unsigned long index, unsigned long n_slots)
+{
+    const unsigned long per_page = SLOTS_PER_PAGE / n_slots;
 
-        if (dict_ul_ul_get(inverse_new_ids, new_id, &old_id) == 0) {
-            swap_nodes(hf, old_id, new_id, log);
+    return (index / per_page) << CHAR_BIT | (index % per_page) * n_slots;
+}
 
-            // remove the element that was just swapped
-            dict_ul_ul_remove(new_ids, old_id);
-            dict_ul_ul_remove(inverse_new_ids, new_id);
+/* Header bits are stored from the most significant bit of each byte on. */
+static bool
+slot_used(const unsigned char* bits, size_t slot)
+{
+    return bits[slot / CHAR_BIT] & (1U << (CHAR_BIT - 1 - slot % CHAR_BIT));
+}
 
-            if (old_id != new_id) {
-                // update the dict such that the node that was previously at
-                // position new id is now at old id
-                temp_new = dict_ul_ul_get_direct(new_ids, new_id);
+static void
+use_slots(unsigned char* bits, size_t fst_slot, size_t n_slots)
+{
+    for (size_t s = fst_slot; s < fst_slot + n_slots; ++s) {
+        bits[s / CHAR_BIT] |= 1U << (CHAR_BIT - 1 - s % CHAR_BIT);
+    }
+}
+
+static unsigned long
+new_id(const rebuild* rb, file_type ft, unsigned long id)
+{
+    if (id == UNINITIALIZED_LONG) {
+        return id;
+    }
+
+    unsigned long n_slots = record_slots(ft);
 
-                // remove the old entries for the node that was swapped with
-                dict_ul_ul_remove(new_ids, new_id);
-                dict_ul_ul_remove(inverse_new_ids, temp_new);
+    return position_id(rb->new_index[ft][dense_index(id, n_slots)], n_slots);
+}
+
+static bool
+valid_record_id(unsigned long id, unsigned long n_slots)
+{
+    return id != UNINITIALIZED_LONG && (id & UCHAR_MAX) % n_slots == 0;
+}
 
-                dict_ul_ul_insert(new_ids, old_id, temp_new);
-                dict_ul_ul_insert(inverse_new_ids, temp_new, old_id);
+/* Reads the old header and assigns each record its new dense index: The one
+ * given by \p new_ids, or if it has none the first position that no other
+ * record is moved to. Without \p new_ids, the records keep their ids. */
+static void
+assign_new_indexes(rebuild* rb, file_type ft, dict_ul_ul* new_ids)
+{
+    disk_file*    header_file = rb->old_pdb->header[ft];
+    unsigned long n_slots     = record_slots(ft);
+    size_t        n_old =
+          rb->old_pdb->records[ft]->num_pages * SLOTS_PER_PAGE / n_slots;
+
+    unsigned char* bits =
+          rebuild_calloc(header_file->num_pages * PAGE_SIZE, sizeof(char));
+    read_pages(header_file, 0, header_file->num_pages - 1, bits, false);
+
+    unsigned long* index   = rebuild_calloc(n_old, sizeof(unsigned long));
+    size_t         n_used  = 0;
+    size_t         n_new   = 0;
+    bool           invalid = false;
+
+    for (size_t i = 0; i < n_old; ++i) {
+        index[i] = UNINITIALIZED_LONG;
+        n_used += slot_used(bits, i * n_slots);
+    }
+
+    if (!new_ids) {
+        for (size_t i = 0; i < n_old; ++i) {
+            if (slot_used(bits, i * n_slots)) {
+                index[i] = i;
+                n_new    = i + 1;
+            }
+        }
+    } else {
+        dict_ul_ul_iterator* it = dict_ul_ul_iterator_create(new_ids);
+        unsigned long        old_id;
+        unsigned long        to_id;
+        unsigned long        i;
+
+        while (dict_ul_ul_iterator_next(it, &old_id, &to_id) == 0) {
+            i = dense_index(old_id, n_slots);
+            if (!valid_record_id(old_id, n_slots)
+                || !valid_record_id(to_id, n_slots) || i >= n_old
+                || !slot_used(bits, i * n_slots)) {
+                invalid = true;
+                break;
             }
+            index[i] = dense_index(to_id, n_slots);
+            n_new    = index[i] + 1 > n_new ? index[i] + 1 : n_new;
         }
+        dict_ul_ul_iterator_destroy(it);
 
-        if (dict_ul_ul_size(new_ids) == 0) {
-            break;
+        size_t n_positions = n_new > n_used ? n_new : n_used;
+        bool*  taken       = rebuild_calloc(n_positions, sizeof(bool));
+
+        for (size_t i = 0; i < n_old && !invalid; ++i) {
+            if (index[i] != UNINITIALIZED_LONG) {
+                invalid         = taken[index[i]];
+                taken[index[i]] = true;
+            }
         }
 
-        if (cur_slot + NUM_SLOTS_PER_NODE >= UCHAR_MAX) {
-            cur_page++;
-            cur_slot = 0;
-        } else {
-            cur_slot += NUM_SLOTS_PER_NODE;
+        size_t free_position = 0;
+        for (size_t i = 0; i < n_old && !invalid; ++i) {
+            if (slot_used(bits, i * n_slots)
+                && index[i] == UNINITIALIZED_LONG) {
+                while (taken[free_position]) {
+                    free_position++;
+                }
+                index[i]             = free_position;
+                taken[free_position] = true;
+                n_new = free_position + 1 > n_new ? free_position + 1 : n_new;
+            }
         }
+        free(taken);
     }
+    free(bits);
 
-    dict_ul_ul_destroy(inverse_new_ids);
-}
-
-void
-reorder_nodes_by_sequence(heap_file*           hf,
-                          const unsigned long* sequence,
-                          bool                 log)
-{
-    if (!hf || !sequence) {
+    if (invalid) {
         // LCOV_EXCL_START
-        printf("reorder_records - reorder nodes by sequence: Invalid "
-               "Arguments!\n");
+        printf("reorder records - rebuild: Invalid Arguments!\n");
         print_trace();
 
         exit(EXIT_FAILURE);
         // LCOV_EXCL_STOP
     }
 
-    const size_t n_pages =
-          hf->n_nodes * NUM_SLOTS_PER_NODE / (PAGE_SIZE * CHAR_BIT)
-          + (hf->n_rels * NUM_SLOTS_PER_NODE % (PAGE_SIZE * CHAR_BIT) != 0);
+    rb->new_index[ft]     = index;
+    rb->n_old_records[ft] = n_old;
+    rb->n_new_records[ft] = n_new;
+}
 
-    dict_ul_ul*   new_ids  = d_ul_ul_create();
-    phy_database* temp_pdb = phy_database_create("reord_temp", "temp_log");
+static void
+move_node(const rebuild* rb,
+          page*          from,
+          size_t         from_entry,
+          page*          to,
+          size_t         to_entry)
+{
+    node_t node;
+    node.id = from->page_no << CHAR_BIT | from_entry * NUM_SLOTS_PER_NODE;
+    node_read(&node, from);
 
-    page_cache* temp_pc = page_cache_create(temp_pdb, n_pages, "temp_log");
-    heap_file*  temp_hf = heap_file_create(temp_pc, "temp_log");
+    node.first_relationship =
+          new_id(rb, relationship_ft, node.first_relationship);
+    node.id = to->page_no << CHAR_BIT | to_entry * NUM_SLOTS_PER_NODE;
+    node_write(&node, to);
 
-    for (size_t i = 0; i < hf->n_nodes; ++i) {
-        next_free_slots(temp_hf, true, false);
-        dict_ul_ul_insert(new_ids, sequence[i], temp_hf->last_alloc_node_id);
+    if (rb->unsorted && node.first_relationship != UNINITIALIZED_LONG) {
+        set_ul_insert(rb->unsorted, node.id);
     }
+}
 
-    heap_file_destroy(temp_hf);
-    page_cache_destroy(temp_pc);
-    phy_database_delete(temp_pdb);
+static void
+move_relationship(const rebuild* rb,
+                  page*          from,
+                  size_t         from_entry,
+                  page*          to,
+                  size_t         to_entry)
+{
+    relationship_t rel;
+    rel.id = from->page_no << CHAR_BIT | from_entry * NUM_SLOTS_PER_REL;
+    relationship_read(&rel, from);
+
+    rel.source_node     = new_id(rb, node_ft, rel.source_node);
+    rel.target_node     = new_id(rb, node_ft, rel.target_node);
+    rel.prev_rel_source = new_id(rb, relationship_ft, rel.prev_rel_source);
+    rel.next_rel_source = new_id(rb, relationship_ft, rel.next_rel_source);
+    rel.prev_rel_target = new_id(rb, relationship_ft, rel.prev_rel_target);
+    rel.next_rel_target = new_id(rb, relationship_ft, rel.next_rel_target);
+    rel.id = to->page_no << CHAR_BIT | to_entry * NUM_SLOTS_PER_REL;
+    relationship_write(&rel, to);
+}
 
-    reorder_nodes(hf, new_ids, log);
-    dict_ul_ul_destroy(new_ids);
+/* The group ids stay the same, so the degree entries are moved as they are */
+static void
+move_degree_entry(const rebuild* rb,
+                  page*          from,
+                  size_t         from_entry,
+                  page*          to,
+                  size_t         to_entry)
+{
+    (void)rb;
+    memcpy(to->data + to_entry * DEGREE_ENTRY_SIZE,
+           from->data + from_entry * DEGREE_ENTRY_SIZE,
+           DEGREE_ENTRY_SIZE);
 }
 
-void
-reorder_relationships(heap_file* hf, dict_ul_ul* new_ids, bool log)
+static void
+move_group(const rebuild* rb,
+           page*          from,
+           size_t         from_entry,
+           page*          to,
+           size_t         to_entry)
 {
-    if (!hf || !new_ids) {
+    relationship_group_t group;
+    group.id = from->page_no * GROUPS_PER_PAGE + from_entry;
+
+    // The first entry holds the free list, free groups have no relationships
+    if (group.id == 0) {
+        memcpy(to->data, from->data, ON_DISK_GROUP_SIZE);
+        return;
+    }
+
+    relationship_group_read(&group, from);
+
+    if (group.num_rels > 0) {
+        group.first_rel = new_id(rb, relationship_ft, group.first_rel);
+        group.last_rel  = new_id(rb, relationship_ft, group.last_rel);
+    }
+
+    group.id = to->page_no * GROUPS_PER_PAGE + to_entry;
+    relationship_group_write(&group, to);
+}
+
+static void
+move_page(const rebuild* rb,
+          page*          from,
+          size_t         from_entry,
+          page*          to,
+          size_t         to_entry)
+{
+    (void)rb;
+    (void)from_entry;
+    (void)to_entry;
+    memcpy(to->data, from->data, PAGE_SIZE);
+}
+
+/* A label chain entry holds whether the record is indexed, its label and the
+ * previous and next record of the chain, see \ref label_index.h. The chains
+ * keep their order. */
+static void
+move_label_entry(const rebuild* rb,
+                 file_type      ft,
+                 page*          from,
+                 size_t         from_entry,
+                 page*          to,
+                 size_t         to_entry)
+{
+    enum
+    {
+        indexed_field,
+        label_field,
+        prev_field,
+        next_field,
+        num_fields
+    };
+
+    unsigned long entry[num_fields];
+    for (size_t i = 0; i < num_fields; ++i) {
+        entry[i] = read_ulong(from,
+                              from_entry * ON_DISK_LABEL_ENTRY_SIZE
+                                    + i * sizeof(unsigned long));
+    }
+
+    if (entry[indexed_field]) {
+        entry[prev_field] = new_id(rb, ft, entry[prev_field]);
+        entry[next_field] = new_id(rb, ft, entry[next_field]);
+    }
+
+    for (size_t i = 0; i < num_fields; ++i) {
+        write_ulong(to,
+                    to_entry * ON_DISK_LABEL_ENTRY_SIZE
+                          + i * sizeof(unsigned long),
+                    entry[i]);
+    }
+}
+
+static void
+move_node_label_entry(const rebuild* rb,
+                      page*          from,
+                      size_t         from_entry,
+                      page*          to,
+                      size_t         to_entry)
+{
+    move_label_entry(rb, node_ft, from, from_entry, to, to_entry);
+}
+
+static void
+move_rel_label_entry(const rebuild* rb,
+                     page*          from,
+                     size_t         from_entry,
+                     page*          to,
+                     size_t         to_entry)
+{
+    move_label_entry(rb, relationship_ft, from, from_entry, to, to_entry);
+}
+
+/* The label heads are keyed by record type and label, which stay the same, so
+ * the entries keep their slots and only their values move. */
+static void
+move_label_head(const rebuild* rb,
+                page*          from,
+                size_t         from_entry,
+                page*          to,
+                size_t         to_entry)
+{
+    enum
+    {
+        type_field,
+        label_field,
+        value_field,
+        num_fields
+    };
+
+    unsigned long entry[num_fields];
+    for (size_t i = 0; i < num_fields; ++i) {
+        entry[i] = read_ulong(from,
+                              from_entry * ON_DISK_HASH_ENTRY_SIZE
+                                    + i * sizeof(unsigned long));
+    }
+
+    // The first entry holds the capacity and size, empty ones a zero value
+    bool meta = from->page_no == 0 && from_entry == 0;
+    if (!meta && entry[value_field] != 0) {
+        entry[value_field] = new_id(rb,
+                                    (file_type)entry[type_field],
+                                    entry[value_field] - 1)
+                             + 1;
+    }
+
+    for (size_t i = 0; i < num_fields; ++i) {
+        write_ulong(to,
+                    to_entry * ON_DISK_HASH_ENTRY_SIZE
+                          + i * sizeof(unsigned long),
+                    entry[i]);
+    }
+}
+
+static void
+begin_chunk(const rebuild* rb, size_t lo, size_t hi)
+{
+    memset(rb->buffer + rb->n_in_pages * PAGE_SIZE, 0, (hi - lo) * PAGE_SIZE);
+
+    for (size_t p = lo; p < hi; ++p) {
+        rb->out_pages[p - lo]->page_no = p;
+    }
+}
+
+static void
+end_chunk(const rebuild* rb, file_type ft, size_t lo, size_t hi)
+{
+    // The degree file has already grown along with the node records
+    if (ft != degree_ft) {
+        allocate_pages(rb->new_pdb, ft, hi - lo, false);
+    }
+    write_pages(rb->new_pdb->records[ft],
+                lo,
+                hi - 1,
+                rb->buffer + rb->n_in_pages * PAGE_SIZE,
+                false);
+}
+
+static unsigned long
+target_index(const unsigned long* new_index, size_t n_indexed, size_t entry)
+{
+    if (!new_index) {
+        return entry;
+    }
+
+    return entry < n_indexed ? new_index[entry] : UNINITIALIZED_LONG;
+}
+
+/* Moves the entries of the old pages \p fst_page to \p lst_page - 1 that land
+ * in the chunk of new pages \p lo to \p hi - 1. */
+static void
+move_from_pages(const rebuild*       rb,
+                file_type            ft,
+                size_t               entries_per_page,
+                const unsigned long* new_index,
+                size_t               n_indexed,
+                size_t               fst_page,
+                size_t               lst_page,
+                size_t               lo,
+                size_t               hi,
+                move_entry           move)
+{
+    unsigned long target;
+    size_t        target_page;
+
+    for (size_t fst = fst_page; fst < lst_page; fst += rb->n_in_pages) {
+        size_t lst = fst + rb->n_in_pages < lst_page ? fst + rb->n_in_pages
+                                                     : lst_page;
+        read_pages(rb->old_pdb->records[ft], fst, lst - 1, rb->buffer, false);
+
+        for (size_t p = fst; p < lst; ++p) {
+            rb->in_pages[p - fst]->page_no = p;
+        }
+
+        for (size_t e = fst * entries_per_page; e < lst * entries_per_page;
+             ++e) {
+            target = target_index(new_index, n_indexed, e);
+            if (target == UNINITIALIZED_LONG) {
+                continue;
+            }
+
+            target_page = target / entries_per_page;
+            if (target_page < lo || target_page >= hi) {
+                continue;
+            }
+
+            move(rb,
+                 rb->in_pages[e / entries_per_page - fst],
+                 e % entries_per_page,
+                 rb->out_pages[target_page - lo],
+                 target % entries_per_page);
+        }
+    }
+}
+
+static void
+write_run(FILE* runs, size_t offset, const unsigned char* data, size_t size)
+{
+    if (fseek(runs, (long)offset, SEEK_SET) != 0
+        || fwrite(data, 1, size, runs) != size) {
         // LCOV_EXCL_START
-        printf("reorder_records - reorder relationships: Invalid Arguments!\n");
+        printf("reorder records - rebuild: Failed to write the run file!\n");
         print_trace();
 
         exit(EXIT_FAILURE);
         // LCOV_EXCL_STOP
     }
+}
 
-    // construct inverse mapping to avoid seeking for values num nodes times
-    dict_ul_ul_iterator* it              = dict_ul_ul_iterator_create(new_ids);
-    dict_ul_ul*          inverse_new_ids = d_ul_ul_create();
-    unsigned long        old_id;
-    unsigned long        new_id;
+static void
+read_run(FILE* runs, size_t offset, unsigned char* data, size_t size)
+{
+    if (fseek(runs, (long)offset, SEEK_SET) != 0
+        || fread(data, 1, size, runs) != size) {
+        // LCOV_EXCL_START
+        printf("reorder records - rebuild: Failed to read the run file!\n");
+        print_trace();
 
-    while (dict_ul_ul_iterator_next(it, &old_id, &new_id) == 0) {
-        dict_ul_ul_insert(inverse_new_ids, new_id, old_id); // fut => cur
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
     }
-    dict_ul_ul_iterator_destroy(it);
+}
 
-    unsigned short cur_slot = 0;
-    unsigned long  cur_page = 0;
-    unsigned long  temp_new;
+/* Buckets of fixed size entries in the run file. The caller counts the
+ * entries of bucket b in offsets[b + 1] before \ref runs_start, so that each
+ * bucket gets its own region of the file. */
+typedef struct
+{
+    size_t         n_buckets;
+    size_t         entry_size;
+    size_t*        offsets;
+    size_t*        filled;
+    size_t*        in_slice;
+    size_t         per_slice;
+    unsigned char* slices;
+} bucket_runs;
+
+static void
+runs_create(bucket_runs* runs, size_t n_buckets, size_t entry_size)
+{
+    runs->n_buckets  = n_buckets;
+    runs->entry_size = entry_size;
+    runs->offsets    = rebuild_calloc(n_buckets + 1, sizeof(size_t));
+}
 
-    for (size_t i = 0; i < hf->n_rels; ++i) {
-        new_id = cur_page << CHAR_BIT | cur_slot;
+/* Each bucket collects its entries in a slice of the write buffer, or in one
+ * entry if the buffer has too little room for all buckets. The slices are
+ * then still small compared to the index of new ids. */
+static void
+runs_start(const rebuild* rb, bucket_runs* runs)
+{
+    unsigned char* out_data  = rb->buffer + rb->n_in_pages * PAGE_SIZE;
+    size_t         out_bytes = rb->n_out_pages * PAGE_SIZE;
+
+    for (size_t b = 1; b <= runs->n_buckets; ++b) {
+        runs->offsets[b] += runs->offsets[b - 1];
+    }
+
+    runs->filled    = rebuild_calloc(runs->n_buckets, sizeof(size_t));
+    runs->in_slice  = rebuild_calloc(runs->n_buckets, sizeof(size_t));
+    runs->per_slice = out_bytes / runs->n_buckets / runs->entry_size;
+    runs->per_slice = runs->per_slice == 0 ? 1 : runs->per_slice;
+    runs->slices =
+          runs->per_slice * runs->n_buckets * runs->entry_size <= out_bytes
+                ? out_data
+                : rebuild_calloc(runs->n_buckets * runs->per_slice,
+                                 runs->entry_size);
+}
+
+static void
+flush_slice(const rebuild* rb, bucket_runs* runs, size_t b)
+{
+    write_run(rb->runs,
+              (runs->offsets[b] + runs->filled[b]) * runs->entry_size,
+              runs->slices + b * runs->per_slice * runs->entry_size,
+              runs->in_slice[b] * runs->entry_size);
+    runs->filled[b] += runs->in_slice[b];
+    runs->in_slice[b] = 0;
+}
+
+/* Returns the place of the next entry of bucket \p b, which is written out
+ * by the next call for the bucket or by \ref runs_finish. */
+static unsigned char*
+runs_append(const rebuild* rb, bucket_runs* runs, size_t b)
+{
+    if (runs->in_slice[b] == runs->per_slice) {
+        flush_slice(rb, runs, b);
+    }
+
+    return runs->slices
+           + (b * runs->per_slice + runs->in_slice[b]++) * runs->entry_size;
+}
+
+static void
+runs_finish(const rebuild* rb, bucket_runs* runs)
+{
+    for (size_t b = 0; b < runs->n_buckets; ++b) {
+        if (runs->in_slice[b] > 0) {
+            flush_slice(rb, runs, b);
+        }
+    }
+
+    if (runs->slices != rb->buffer + rb->n_in_pages * PAGE_SIZE) {
+        free(runs->slices);
+    }
+    free(runs->in_slice);
+    free(runs->filled);
+}
+
+/* Writes the file of type \p ft of the new database with \p n_new_pages pages.
+ * The entry with number i of the old file is moved to the entry with number
+ * new_index[i], or to the same number if \p new_index is NULL. Entries of
+ * \p entry_size bytes lie one after the other in the pages. */
+static void
+distribute(const rebuild*       rb,
+           file_type            ft,
+           size_t               entries_per_page,
+           size_t               entry_size,
+           const unsigned long* new_index,
+           size_t               n_indexed,
+           size_t               n_new_pages,
+           move_entry           move)
+{
+    size_t n_old_pages = rb->old_pdb->records[ft]->num_pages;
+
+    // Each chunk of the new file only receives the old pages of the same
+    // numbers if the entries keep them. A file that fits into the write
+    // buffer is a single chunk. Both take one pass over the old file.
+    if (!new_index || n_new_pages <= rb->n_out_pages) {
+        for (size_t lo = 0; lo < n_new_pages; lo += rb->n_out_pages) {
+            size_t hi = lo + rb->n_out_pages < n_new_pages
+                              ? lo + rb->n_out_pages
+                              : n_new_pages;
+            begin_chunk(rb, lo, hi);
+            move_from_pages(rb,
+                            ft,
+                            entries_per_page,
+                            new_index,
+                            n_indexed,
+                            new_index ? 0 : lo,
+                            new_index || n_old_pages < hi ? n_old_pages : hi,
+                            lo,
+                            hi,
+                            move);
+            end_chunk(rb, ft, lo, hi);
+        }
+        return;
+    }
+
+    // A run entry is the old entry number followed by the entry itself
+    const size_t entries_per_bucket = rb->n_out_pages * entries_per_page;
+    const size_t n_entries          = n_old_pages * entries_per_page;
+    unsigned long target;
+
+    bucket_runs runs;
+    runs_create(&runs,
+                n_new_pages / rb->n_out_pages
+                      + (n_new_pages % rb->n_out_pages != 0),
+                sizeof(unsigned long) + entry_size);
+
+    for (size_t e = 0; e < n_entries; ++e) {
+        target = target_index(new_index, n_indexed, e);
+        if (target != UNINITIALIZED_LONG) {
+            runs.offsets[target / entries_per_bucket + 1]++;
+        }
+    }
+    runs_start(rb, &runs);
+
+    unsigned char* run_entry;
+    for (size_t fst = 0; fst < n_old_pages; fst += rb->n_in_pages) {
+        size_t lst = fst + rb->n_in_pages < n_old_pages ? fst + rb->n_in_pages
+                                                        : n_old_pages;
+        read_pages(rb->old_pdb->records[ft], fst, lst - 1, rb->buffer, false);
+
+        for (size_t e = fst * entries_per_page; e < lst * entries_per_page;
+             ++e) {
+            target = target_index(new_index, n_indexed, e);
+            if (target == UNINITIALIZED_LONG) {
+                continue;
+            }
+
+            run_entry = runs_append(rb, &runs, target / entries_per_bucket);
+            memcpy(run_entry, &e, sizeof(unsigned long));
+            memcpy(run_entry + sizeof(unsigned long),
+                   rb->buffer + (e / entries_per_page - fst) * PAGE_SIZE
+                         + (e % entries_per_page) * entry_size,
+                   entry_size);
+        }
+    }
+    runs_finish(rb, &runs);
+
+    // Reads each bucket back into the read buffer and moves its entries
+    const size_t  per_read = rb->n_in_pages * PAGE_SIZE / runs.entry_size;
+    unsigned long from;
+
+    for (size_t b = 0; b < runs.n_buckets; ++b) {
+        size_t lo = b * rb->n_out_pages;
+        size_t hi = lo + rb->n_out_pages < n_new_pages ? lo + rb->n_out_pages
+                                                       : n_new_pages;
+        begin_chunk(rb, lo, hi);
+
+        for (size_t fst = runs.offsets[b]; fst < runs.offsets[b + 1];
+             fst += per_read) {
+            size_t n = fst + per_read < runs.offsets[b + 1]
+                             ? per_read
+                             : runs.offsets[b + 1] - fst;
+            read_run(rb->runs,
+                     fst * runs.entry_size,
+                     rb->buffer,
+                     n * runs.entry_size);
+
+            for (size_t i = 0; i < n; ++i) {
+                run_entry = rb->buffer + i * runs.entry_size;
+                memcpy(&from, run_entry, sizeof(unsigned long));
+                target = new_index[from];
+
+                rb->scratch->page_no = from / entries_per_page;
+                memcpy(rb->scratch->data
+                             + (from % entries_per_page) * entry_size,
+                       run_entry + sizeof(unsigned long),
+                       entry_size);
+
+                move(rb,
+                     rb->scratch,
+                     from % entries_per_page,
+                     rb->out_pages[target / entries_per_page - lo],
+                     target % entries_per_page);
+            }
+        }
+
+        end_chunk(rb, ft, lo, hi);
+    }
+    free(runs.offsets);
+}
+
+static size_t
+pages_for(size_t n_entries, size_t entries_per_page)
+{
+    return n_entries / entries_per_page + (n_entries % entries_per_page != 0);
+}
+
+/* Sets the header bits of the moved records and writes the new header, which
+ * has been grown with the record file. */
+static void
+write_header(rebuild* rb, file_type ft)
+{
+    disk_file*    header_file = rb->new_pdb->header[ft];
+    unsigned long n_slots     = record_slots(ft);
+
+    unsigned char* bits =
+          rebuild_calloc(header_file->num_pages * PAGE_SIZE, sizeof(char));
+
+    for (size_t i = 0; i < rb->n_old_records[ft]; ++i) {
+        if (rb->new_index[ft][i] != UNINITIALIZED_LONG) {
+            use_slots(bits, rb->new_index[ft][i] * n_slots, n_slots);
+        }
+    }
+
+    write_pages(header_file, 0, header_file->num_pages - 1, bits, false);
+    rb->new_header[ft] = bits;
+}
+
+/* Creates an empty database for the next generation of the files of the heap
+ * file, with a log named after the catalogue of the latter. */
+static phy_database*
+create_rebuild_database(phy_database* pdb, char** log_name)
+{
+    const char* suffix = "_rebuild.log";
+    size_t      len = strlen(pdb->catalogue->file_name) - strlen(".info");
+
+    *log_name = rebuild_calloc(len + strlen(suffix) + 1, sizeof(char));
+    memcpy(*log_name, pdb->catalogue->file_name, len);
+    strcat(*log_name, suffix);
+
+    return phy_database_create_next(pdb, *log_name);
+}
+
+/* An entry of the adjacency index with the slot its probe sequence starts at,
+ * see \ref hash_index_home_slot. */
+typedef struct
+{
+    unsigned long home;
+    unsigned long entry[3];
+} hash_run_entry;
+
+static int
+hash_run_entry_cmp(const void* a, const void* b)
+{
+    const hash_run_entry* fst = a;
+    const hash_run_entry* snd = b;
+
+    return (fst->home > snd->home) - (fst->home < snd->home);
+}
+
+/* Reads the entry with number \p e from the read buffer, which holds the old
+ * pages from \p fst_page on, and maps its ids to the new ones. Returns false
+ * for the meta entry and empty entries. */
+static bool
+remap_adjacency_entry(const rebuild*  rb,
+                      size_t          fst_page,
+                      size_t          e,
+                      unsigned long   capacity,
+                      hash_run_entry* remapped)
+{
+    page*  from   = rb->in_pages[e / HASH_ENTRIES_PER_PAGE - fst_page];
+    size_t offset = (e % HASH_ENTRIES_PER_PAGE) * ON_DISK_HASH_ENTRY_SIZE;
 
-        if (dict_ul_ul_get(inverse_new_ids, new_id, &old_id) == 0) {
-            swap_relationships(hf, old_id, new_id, log);
+    for (size_t i = 0; i < 3; ++i) {
+        remapped->entry[i] =
+              read_ulong(from, offset + i * sizeof(unsigned long));
+    }
 
-            // remove the element that was just swapped
-            dict_ul_ul_remove(new_ids, old_id);
-            dict_ul_ul_remove(inverse_new_ids, new_id);
+    if (e == 0 || remapped->entry[2] == 0) {
+        return false;
+    }
 
-            if (old_id != new_id) {
-                // update the dict such that the node that was previously at
-                // position new id is now at old id
-                temp_new = dict_ul_ul_get_direct(new_ids, new_id);
+    remapped->entry[0] = new_id(rb, node_ft, remapped->entry[0]);
+    remapped->entry[1] = new_id(rb, node_ft, remapped->entry[1]);
+    remapped->entry[2] =
+          new_id(rb, relationship_ft, remapped->entry[2] - 1) + 1;
+    remapped->home     = hash_index_home_slot(
+          remapped->entry[0], remapped->entry[1], capacity);
 
-                // remove the old entries for the node that was swapped with
-                dict_ul_ul_remove(new_ids, new_id);
-                dict_ul_ul_remove(inverse_new_ids, temp_new);
+    return true;
+}
 
-                dict_ul_ul_insert(new_ids, old_id, temp_new);
-                dict_ul_ul_insert(inverse_new_ids, temp_new, old_id);
-                // printf("inner if sz nid %lu, sz inid %lu\n",
-                //        dict_ul_ul_size(new_ids),
-                //        dict_ul_ul_size(inverse_new_ids));
+static void
+write_hash_entry(page* to, size_t entry_no, const unsigned long* entry)
+{
+    for (size_t i = 0; i < 3; ++i) {
+        write_ulong(to,
+                    (entry_no % HASH_ENTRIES_PER_PAGE) * ON_DISK_HASH_ENTRY_SIZE
+                          + i * sizeof(unsigned long),
+                    entry[i]);
+    }
+}
 
-                assert(dict_ul_ul_size(new_ids)
-                       == dict_ul_ul_size(inverse_new_ids));
+/* The adjacency index holds as many entries as before, so it keeps its
+ * capacity. Its entries are remapped and distributed by the chunk of the new
+ * file that holds their home slot. Each bucket is then sorted by home slot and
+ * placed in order, which puts every entry into the first empty slot from its
+ * home slot on. Entries that run past the end of a chunk move on to the next
+ * one, the few that run past the end of the table wrap around to its start. */
+static void
+rebuild_adjacency(const rebuild* rb)
+{
+    disk_file* from    = rb->old_pdb->records[adjacency_ft];
+    disk_file* to      = rb->new_pdb->records[adjacency_ft];
+    size_t     n_pages = from->num_pages;
+
+    if (n_pages == 0) {
+        return;
+    }
+
+    read_pages(from, 0, 0, rb->buffer, false);
+    const unsigned long capacity = read_ulong(rb->in_pages[0], 0);
+    const unsigned long count =
+          read_ulong(rb->in_pages[0], sizeof(unsigned long));
+    const size_t entries_per_bucket = rb->n_out_pages * HASH_ENTRIES_PER_PAGE;
+
+    bucket_runs runs;
+    runs_create(&runs,
+                n_pages / rb->n_out_pages + (n_pages % rb->n_out_pages != 0),
+                sizeof(hash_run_entry));
+
+    hash_run_entry remapped;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (size_t fst = 0; fst < n_pages; fst += rb->n_in_pages) {
+            size_t lst = fst + rb->n_in_pages < n_pages ? fst + rb->n_in_pages
+                                                        : n_pages;
+            read_pages(from, fst, lst - 1, rb->buffer, false);
+
+            for (size_t e = fst * HASH_ENTRIES_PER_PAGE;
+                 e < lst * HASH_ENTRIES_PER_PAGE;
+                 ++e) {
+                if (!remap_adjacency_entry(rb, fst, e, capacity, &remapped)) {
+                    continue;
+                }
+
+                // Table slot k is entry k + 1 of the file
+                if (pass == 0) {
+                    runs.offsets[(remapped.home + 1) / entries_per_bucket
+                                 + 1]++;
+                } else {
+                    memcpy(runs_append(rb,
+                                       &runs,
+                                       (remapped.home + 1)
+                                             / entries_per_bucket),
+                           &remapped,
+                           sizeof(hash_run_entry));
+                }
             }
         }
 
-        if (dict_ul_ul_size(new_ids) == 0) {
-            break;
+        if (pass == 0) {
+            runs_start(rb, &runs);
+        }
+    }
+    runs_finish(rb, &runs);
+
+    hash_run_entry* pending   = NULL;
+    size_t          n_carried = 0;
+    unsigned long   next_free = 0;
+    unsigned long   slot;
+    size_t          i;
+
+    for (size_t b = 0; b < runs.n_buckets; ++b) {
+        size_t lo = b * rb->n_out_pages;
+        size_t hi = lo + rb->n_out_pages < n_pages ? lo + rb->n_out_pages
+                                                   : n_pages;
+        size_t n_bucket = runs.offsets[b + 1] - runs.offsets[b];
+        size_t n        = n_carried + n_bucket;
+
+        pending = realloc(pending, (n + 1) * sizeof(hash_run_entry));
+        if (!pending) {
+            // LCOV_EXCL_START
+            printf("reorder records - rebuild: Failed to allocate memory!\n");
+            print_trace();
+
+            exit(EXIT_FAILURE);
+            // LCOV_EXCL_STOP
+        }
+
+        if (n_bucket > 0) {
+            read_run(rb->runs,
+                     runs.offsets[b] * sizeof(hash_run_entry),
+                     (unsigned char*)(pending + n_carried),
+                     n_bucket * sizeof(hash_run_entry));
+        }
+        qsort(pending + n_carried,
+              n_bucket,
+              sizeof(hash_run_entry),
+              hash_run_entry_cmp);
+
+        begin_chunk(rb, lo, hi);
+        if (b == 0) {
+            write_ulong(rb->out_pages[0], 0, capacity);
+            write_ulong(rb->out_pages[0], sizeof(unsigned long), count);
         }
 
-        if (cur_slot + NUM_SLOTS_PER_REL >= UCHAR_MAX) {
-            cur_page++;
-            cur_slot = 0;
+        for (i = 0; i < n; ++i) {
+            slot = pending[i].home > next_free ? pending[i].home : next_free;
+            if (slot + 1 >= hi * HASH_ENTRIES_PER_PAGE) {
+                break;
+            }
+
+            write_hash_entry(rb->out_pages[(slot + 1) / HASH_ENTRIES_PER_PAGE
+                                           - lo],
+                             slot + 1,
+                             pending[i].entry);
+            next_free = slot + 1;
+        }
+        end_chunk(rb, adjacency_ft, lo, hi);
+
+        memmove(pending, pending + i, (n - i) * sizeof(hash_run_entry));
+        n_carried = n - i;
+    }
+    free(runs.offsets);
+
+    // Places the wrapped entries into the first empty slots of the table
+    unsigned char* out_data = rb->buffer + rb->n_in_pages * PAGE_SIZE;
+    i                       = 0;
+    slot                    = 0;
+    for (size_t lo = 0; i < n_carried && lo < n_pages; lo += rb->n_out_pages) {
+        size_t hi = lo + rb->n_out_pages < n_pages ? lo + rb->n_out_pages
+                                                   : n_pages;
+        read_pages(to, lo, hi - 1, out_data, false);
+
+        for (; i < n_carried && slot + 1 < hi * HASH_ENTRIES_PER_PAGE; ++slot) {
+            page* p = rb->out_pages[(slot + 1) / HASH_ENTRIES_PER_PAGE - lo];
+            if (read_ulong(p,
+                           ((slot + 1) % HASH_ENTRIES_PER_PAGE)
+                                       * ON_DISK_HASH_ENTRY_SIZE
+                                 + 2 * sizeof(unsigned long))
+                == 0) {
+                write_hash_entry(p, slot + 1, pending[i++].entry);
+            }
+        }
+        write_pages(to, lo, hi - 1, out_data, false);
+    }
+    free(pending);
+}
+
+/* Writes the label chains and the label and adjacency indexes of the new
+ * database from the old ones, with the ids mapped to the new ones. */
+static void
+rebuild_indexes(const rebuild* rb)
+{
+    distribute(rb,
+               node_label_ft,
+               LABEL_ENTRIES_PER_PAGE,
+               ON_DISK_LABEL_ENTRY_SIZE,
+               rb->new_index[node_ft],
+               rb->n_old_records[node_ft],
+               pages_for(rb->n_new_records[node_ft], LABEL_ENTRIES_PER_PAGE),
+               move_node_label_entry);
+    distribute(rb,
+               relationship_label_ft,
+               LABEL_ENTRIES_PER_PAGE,
+               ON_DISK_LABEL_ENTRY_SIZE,
+               rb->new_index[relationship_ft],
+               rb->n_old_records[relationship_ft],
+               pages_for(rb->n_new_records[relationship_ft],
+                         LABEL_ENTRIES_PER_PAGE),
+               move_rel_label_entry);
+    distribute(rb,
+               label_ft,
+               HASH_ENTRIES_PER_PAGE,
+               ON_DISK_HASH_ENTRY_SIZE,
+               NULL,
+               0,
+               rb->old_pdb->records[label_ft]->num_pages,
+               move_label_head);
+    rebuild_adjacency(rb);
+}
+
+/* Maps the nodes that were unsorted before to their new ids and adds them to
+ * the ones that the rebuild left unsorted. */
+static void
+remap_unsorted_nodes(const rebuild* rb, heap_file* hf)
+{
+    set_ul*       unsorted = rb->unsorted ? rb->unsorted : s_ul_create();
+    unsigned long id;
+
+    set_ul_iterator* it = set_ul_iterator_create(hf->unsorted_nodes);
+    while (set_ul_iterator_next(it, &id) == 0) {
+        id = rb->new_index[node_ft][dense_index(id, NUM_SLOTS_PER_NODE)];
+        set_ul_insert(unsorted, position_id(id, NUM_SLOTS_PER_NODE));
+    }
+    set_ul_iterator_destroy(it);
+    set_ul_destroy(hf->unsorted_nodes);
+    hf->unsorted_nodes = unsorted;
+}
+
+void
+rebuild_records(heap_file* hf,
+                dict_ul_ul* new_node_ids,
+                dict_ul_ul* new_rel_ids,
+                bool        log)
+{
+    if (!hf) {
+        // LCOV_EXCL_START
+        printf("reorder records - rebuild records: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    page_cache* pc = hf->cache;
+
+    // Writes back and drops all cached pages of the old files
+    page_cache_change_n_frames(pc, pc->n_frames);
+
+    rebuild rb;
+    rb.old_pdb = pc->pdb;
+    assign_new_indexes(&rb, node_ft, new_node_ids);
+    assign_new_indexes(&rb, relationship_ft, new_rel_ids);
+
+    char* log_name;
+    rb.new_pdb = create_rebuild_database(pc->pdb, &log_name);
+
+    size_t n_pages = pc->n_frames > 1 ? pc->n_frames : 2;
+    rb.n_in_pages  = n_pages / 2;
+    rb.n_out_pages = n_pages - rb.n_in_pages;
+    rb.buffer      = rebuild_calloc(n_pages, PAGE_SIZE);
+    rb.in_pages    = rebuild_calloc(rb.n_in_pages, sizeof(page*));
+    rb.out_pages   = rebuild_calloc(rb.n_out_pages, sizeof(page*));
+
+    char* run_name = rebuild_calloc(strlen(log_name) + 1, sizeof(char));
+    strcpy(run_name, log_name);
+    strcpy(run_name + strlen(run_name) - strlen(".log"), ".run");
+    rb.runs = fopen(run_name, "w+b");
+
+    if (!rb.runs) {
+        // LCOV_EXCL_START
+        printf("reorder records - rebuild: Failed to create the run file!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    rb.scratch            = page_create(rebuild_calloc(1, PAGE_SIZE));
+    rb.scratch->pin_count = 1;
+    rb.unsorted           = new_rel_ids ? s_ul_create() : NULL;
+
+    // The wrapped pages count as pinned for the record functions
+    for (size_t i = 0; i < n_pages; ++i) {
+        page* p      = page_create(rb.buffer + i * PAGE_SIZE);
+        p->pin_count = 1;
+        if (i < rb.n_in_pages) {
+            rb.in_pages[i] = p;
         } else {
-            cur_slot += NUM_SLOTS_PER_REL;
+            rb.out_pages[i - rb.n_in_pages] = p;
         }
     }
-    dict_ul_ul_destroy(inverse_new_ids);
+
+    const size_t nodes_per_page = SLOTS_PER_PAGE / NUM_SLOTS_PER_NODE;
+    const size_t rels_per_page  = SLOTS_PER_PAGE / NUM_SLOTS_PER_REL;
+
+    distribute(&rb,
+               node_ft,
+               nodes_per_page,
+               NUM_SLOTS_PER_NODE * SLOT_SIZE,
+               rb.new_index[node_ft],
+               rb.n_old_records[node_ft],
+               pages_for(rb.n_new_records[node_ft], nodes_per_page),
+               move_node);
+    distribute(&rb,
+               relationship_ft,
+               rels_per_page,
+               NUM_SLOTS_PER_REL * SLOT_SIZE,
+               rb.new_index[relationship_ft],
+               rb.n_old_records[relationship_ft],
+               pages_for(rb.n_new_records[relationship_ft], rels_per_page),
+               move_relationship);
+
+    // A node takes a single slot, so its dense index is its degree entry
+    distribute(&rb,
+               degree_ft,
+               DEGREE_ENTRIES_PER_PAGE,
+               DEGREE_ENTRY_SIZE,
+               rb.new_index[node_ft],
+               rb.n_old_records[node_ft],
+               rb.new_pdb->records[degree_ft]->num_pages,
+               move_degree_entry);
+    distribute(&rb,
+               group_ft,
+               GROUPS_PER_PAGE,
+               ON_DISK_GROUP_SIZE,
+               NULL,
+               0,
+               rb.old_pdb->records[group_ft]->num_pages,
+               move_group);
+    distribute(&rb,
+               btree_ft,
+               1,
+               PAGE_SIZE,
+               NULL,
+               0,
+               rb.old_pdb->records[btree_ft]->num_pages,
+               move_page);
+
+    write_header(&rb, node_ft);
+    write_header(&rb, relationship_ft);
+    rebuild_indexes(&rb);
+
+    fclose(rb.runs);
+    remove(run_name);
+    free(run_name);
+
+    phy_database_replace(pc->pdb, rb.new_pdb);
+    remove(log_name);
+    free(log_name);
+
+    remap_unsorted_nodes(&rb, hf);
+
+    hf->last_alloc_node_id =
+          rb.n_new_records[node_ft] == 0
+                ? 0
+                : position_id(rb.n_new_records[node_ft] - 1,
+                              NUM_SLOTS_PER_NODE);
+    hf->last_alloc_rel_id =
+          rb.n_new_records[relationship_ft] == 0
+                ? 0
+                : position_id(rb.n_new_records[relationship_ft] - 1,
+                              NUM_SLOTS_PER_REL);
+
+    if (log) {
+        fprintf(hf->log_file,
+                "rebuild_records %lu %lu\n",
+                rb.n_new_records[node_ft],
+                rb.n_new_records[relationship_ft]);
+    }
+
+    for (size_t i = 0; i < n_pages; ++i) {
+        page* p = i < rb.n_in_pages ? rb.in_pages[i]
+                                    : rb.out_pages[i - rb.n_in_pages];
+        p->pin_count = 0;
+        p->dirty     = false;
+        page_destroy(p);
+    }
+    free(rb.in_pages);
+    free(rb.out_pages);
+    free(rb.buffer);
+
+    unsigned char* scratch_data = rb.scratch->data;
+    rb.scratch->pin_count       = 0;
+    rb.scratch->dirty           = false;
+    page_destroy(rb.scratch);
+    free(scratch_data);
+
+    for (file_type ft = 0; ft < NUM_SLOTTED_FILE_TYPES; ++ft) {
+        free(rb.new_index[ft]);
+        free(rb.new_header[ft]);
+    }
+}
+
+void
+reorder_nodes(heap_file* hf, dict_ul_ul* new_ids, bool log)
+{
+    if (!hf || !new_ids) {
+        // LCOV_EXCL_START
+        printf("reorder_records - reorder nodes: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    rebuild_records(hf, new_ids, NULL, log);
+}
+
+void
+reorder_nodes_by_sequence(heap_file*           hf,
+                          const unsigned long* sequence,
+                          bool                 log)
+{
+    if (!hf || !sequence) {
+        // LCOV_EXCL_START
+        printf("reorder_records - reorder nodes by sequence: Invalid "
+               "Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    dict_ul_ul* new_ids = d_ul_ul_create();
+
+    for (size_t i = 0; i < hf->n_nodes; ++i) {
+        dict_ul_ul_insert(
+              new_ids, sequence[i], position_id(i, NUM_SLOTS_PER_NODE));
+    }
+
+    reorder_nodes(hf, new_ids, log);
+    dict_ul_ul_destroy(new_ids);
+}
+
+void
+reorder_relationships(heap_file* hf, dict_ul_ul* new_ids, bool log)
+{
+    if (!hf || !new_ids) {
+        // LCOV_EXCL_START
+        printf("reorder_records - reorder relationships: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    rebuild_records(hf, NULL, new_ids, log);
 }
 
 void
@@ -658,30 +1787,50 @@ reorder_relationships_by_sequence(heap_file*           hf,
         // LCOV_EXCL_STOP
     }
 
-    const size_t n_pages =
-          hf->n_rels * NUM_SLOTS_PER_REL / (PAGE_SIZE * CHAR_BIT)
-          + (hf->n_rels * NUM_SLOTS_PER_REL % (PAGE_SIZE * CHAR_BIT) != 0);
-
-    dict_ul_ul*   new_ids  = d_ul_ul_create();
-    phy_database* temp_pdb = phy_database_create("reord_temp", "temp_log");
-    disk_file_grow(temp_pdb->header[relationship_ft], n_pages, false);
-
-    page_cache* temp_pc = page_cache_create(temp_pdb, n_pages, "temp_log");
-    heap_file*  temp_hf = heap_file_create(temp_pc, "temp_log");
+    dict_ul_ul* new_ids = d_ul_ul_create();
 
     for (size_t i = 0; i < hf->n_rels; ++i) {
-        next_free_slots(temp_hf, false, false);
-        dict_ul_ul_insert(new_ids, sequence[i], temp_hf->last_alloc_rel_id);
+        dict_ul_ul_insert(
+              new_ids, sequence[i], position_id(i, NUM_SLOTS_PER_REL));
     }
 
-    heap_file_destroy(temp_hf);
-    page_cache_destroy(temp_pc);
-    phy_database_delete(temp_pdb);
-
     reorder_relationships(hf, new_ids, log);
     dict_ul_ul_destroy(new_ids);
 }
 
+/* Sorts the incidence lists of the nodes by id and links them in a batch. */
+static void
+relink_sorted(heap_file*           hf,
+              size_t               n_nodes,
+              const unsigned long* node_ids,
+              unsigned long*       offsets,
+              unsigned long*       rel_ids,
+              bool                 log)
+{
+    size_t k = 0;
+    size_t start;
+    for (size_t i = 0; i < n_nodes; ++i) {
+        start = offsets[i];
+        qsort(rel_ids + start,
+              offsets[i + 1] - start,
+              sizeof(unsigned long),
+              ul_cmp);
+
+        // Self loops are in both the outgoing and the incoming list
+        offsets[i] = k;
+        for (size_t j = start; j < offsets[i + 1]; ++j) {
+            if (j == start || rel_ids[j] != rel_ids[j - 1]) {
+                rel_ids[k++] = rel_ids[j];
+            }
+        }
+    }
+    if (n_nodes > 0) {
+        offsets[n_nodes] = k;
+    }
+
+    relink_incidence_lists(hf, n_nodes, node_ids, offsets, rel_ids, log);
+}
+
 void
 sort_incidence_list(heap_file* hf, bool log)
 {
@@ -695,90 +1844,115 @@ sort_incidence_list(heap_file* hf, bool log)
         // LCOV_EXCL_STOP
     }
 
-    array_list_node*         nodes = get_nodes(hf, log);
-    unsigned long            node_id;
-    array_list_relationship* rels;
-    set_ul*                  rel_ids;
-    unsigned long*           sorted_rel_ids;
-    relationship_t*          rel;
-    size_t                   rels_size;
+    csr_graph*     graph   = csr_graph_create(hf, log);
+    size_t         n       = graph->n_nodes;
+    unsigned long* offsets = calloc(n + 1, sizeof(unsigned long));
+    unsigned long* rel_ids = calloc(2 * graph->n_rels + 1, sizeof(long));
 
-    // For each node get the incident edges.
-    for (size_t i = 0; i < hf->n_nodes; ++i) {
-        node_id   = array_list_node_get(nodes, i)->id;
-        rels      = expand(hf, node_id, BOTH, log);
-        rels_size = array_list_relationship_size(rels);
+    if (!offsets || !rel_ids) {
+        // LCOV_EXCL_START
+        printf("reorganize records - sort_incidence_list: Failed to "
+               "allocate memory!\n");
+        print_trace();
 
-        if (rels_size < 3) {
-            array_list_relationship_destroy(rels);
-            continue;
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    size_t k = 0;
+    for (size_t i = 0; i < n; ++i) {
+        offsets[i] = k;
+        for (direction_t d = OUTGOING; d <= INCOMING; ++d) {
+            for (size_t e = graph->offsets[d][i];
+                 e < graph->offsets[d][i + 1];
+                 ++e) {
+                rel_ids[k++] = graph->edges[d][e].rel_id;
+            }
         }
+    }
+    offsets[n] = k;
 
-        // Sort the incident edges by id
-        rel_ids = s_ul_create();
+    relink_sorted(hf, n, graph->node_ids, offsets, rel_ids, log);
 
-        for (size_t j = 0; j < rels_size; ++j) {
-            rel = array_list_relationship_get(rels, j);
-            set_ul_insert(rel_ids, rel->id);
-        }
+    set_ul_destroy(hf->unsorted_nodes);
+    hf->unsorted_nodes = s_ul_create();
 
-        sorted_rel_ids = calloc(set_ul_size(rel_ids), sizeof(unsigned long));
-        set_ul_iterator* it   = set_ul_iterator_create(rel_ids);
-        size_t           i    = 0;
-        unsigned long    elem = UNINITIALIZED_LONG;
-        while (set_ul_iterator_next(it, &elem) == 0) {
-            sorted_rel_ids[i] = elem;
-            ++i;
-        }
-        set_ul_iterator_destroy(it);
+    free(offsets);
+    free(rel_ids);
+    csr_graph_destroy(graph);
+}
 
-        qsort(sorted_rel_ids,
-              set_ul_size(rel_ids),
-              sizeof(unsigned long),
-              ul_cmp);
+void
+sort_incidence_list_incremental(heap_file* hf, bool log)
+{
+    if (!hf) {
+        // LCOV_EXCL_START
+        printf("reorganize records - sort_incidence_list_incremental: "
+               "Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
 
-        // relink the incidence list pointers.
-        rel = read_relationship(hf, sorted_rel_ids[0], log);
+    size_t         n        = set_ul_size(hf->unsorted_nodes);
+    unsigned long* node_ids = calloc(n + 1, sizeof(unsigned long));
+    unsigned long* offsets  = calloc(n + 1, sizeof(unsigned long));
+    array_list_ul* rel_ids  = al_ul_create();
 
-        if (rel->source_node == node_id) {
-            rel->prev_rel_source = sorted_rel_ids[rels_size - 1];
-            rel->next_rel_source = sorted_rel_ids[1];
-        } else {
-            rel->prev_rel_target = sorted_rel_ids[rels_size - 1];
-            rel->next_rel_target = sorted_rel_ids[1];
-        }
-        update_relationship(hf, rel, log);
-        free(rel);
+    if (!node_ids || !offsets) {
+        // LCOV_EXCL_START
+        printf("reorganize records - sort_incidence_list_incremental: "
+               "Failed to allocate memory!\n");
+        print_trace();
 
-        for (size_t j = 1; j < rels_size - 1; ++j) {
-            rel = read_relationship(hf, sorted_rel_ids[j], log);
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
 
-            if (rel->source_node == node_id) {
-                rel->prev_rel_source = sorted_rel_ids[j - 1];
-                rel->next_rel_source = sorted_rel_ids[j + 1];
-            } else {
-                rel->prev_rel_target = sorted_rel_ids[j - 1];
-                rel->next_rel_target = sorted_rel_ids[j + 1];
-            }
-            update_relationship(hf, rel, log);
-            free(rel);
+    size_t           i  = 0;
+    set_ul_iterator* it = set_ul_iterator_create(hf->unsorted_nodes);
+    while (set_ul_iterator_next(it, &node_ids[i]) == 0) {
+        i++;
+    }
+    set_ul_iterator_destroy(it);
+    qsort(node_ids, n, sizeof(unsigned long), ul_cmp);
+
+    array_list_relationship* rels;
+    for (i = 0; i < n; ++i) {
+        offsets[i] = array_list_ul_size(rel_ids);
+        rels       = expand(hf, node_ids[i], BOTH, log);
+        for (size_t j = 0; j < array_list_relationship_size(rels); ++j) {
+            array_list_ul_append(rel_ids,
+                                 array_list_relationship_get(rels, j)->id);
         }
+        array_list_relationship_destroy(rels);
+    }
+    offsets[n] = array_list_ul_size(rel_ids);
 
-        rel = read_relationship(hf, sorted_rel_ids[rels_size - 1], log);
+    unsigned long* ids = calloc(offsets[n] + 1, sizeof(unsigned long));
 
-        if (rel->source_node == node_id) {
-            rel->prev_rel_source = sorted_rel_ids[rels_size - 2];
-            rel->next_rel_source = sorted_rel_ids[0];
-        } else {
-            rel->prev_rel_target = sorted_rel_ids[rels_size - 2];
-            rel->next_rel_target = sorted_rel_ids[0];
-        }
-        update_relationship(hf, rel, log);
-        free(rel);
+    if (!ids) {
+        // LCOV_EXCL_START
+        printf("reorganize records - sort_incidence_list_incremental: "
+               "Failed to allocate memory!\n");
+        print_trace();
 
-        array_list_relationship_destroy(rels);
-        set_ul_destroy(rel_ids);
-        free(sorted_rel_ids);
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
     }
-    array_list_node_destroy(nodes);
+
+    for (i = 0; i < offsets[n]; ++i) {
+        ids[i] = array_list_ul_get(rel_ids, i);
+    }
+    array_list_ul_destroy(rel_ids);
+
+    relink_sorted(hf, n, node_ids, offsets, ids, log);
+
+    set_ul_destroy(hf->unsorted_nodes);
+    hf->unsorted_nodes = s_ul_create();
+
+    free(node_ids);
+    free(offsets);
+    free(ids);
 }
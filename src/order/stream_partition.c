@@ -0,0 +1,392 @@
+/*!
+ * \file stream_partition.c
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief See \ref stream_partition.h
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "order/stream_partition.h"
+
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "access/node.h"
+#include "access/relationship.h"
+#include "constants.h"
+#include "strace.h"
+
+#define FENNEL_GAMMA (1.5)
+#define NO_BUCKET    (ULONG_MAX)
+
+typedef struct
+{
+    stream_partitioner partitioner;
+    size_t             n_partitions;
+    unsigned long      capacity;
+    double             alpha;
+    /* Indexed by node id */
+    unsigned int*      partition;
+    size_t             n_ids;
+    unsigned long*     sizes;
+    /* The partitions in buckets by size, so that the smallest one is found
+     * in constant time, as sizes only ever change by one */
+    unsigned long*     head;
+    unsigned long*     next;
+    unsigned long*     prev;
+    unsigned long      least;
+    /* The run of relationships of the current source */
+    unsigned long*     targets;
+    size_t             n_targets;
+    size_t             targets_capacity;
+    unsigned long*     n_neighbours;
+    unsigned int*      touched;
+    size_t             n_touched;
+} stream_state;
+
+static void*
+stream_calloc(size_t n, size_t size)
+{
+    void* ptr = calloc(n == 0 ? 1 : n, size);
+
+    if (!ptr) {
+        // LCOV_EXCL_START
+        printf("stream partition: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    return ptr;
+}
+
+static void
+bucket_insert(stream_state* st, unsigned long p)
+{
+    unsigned long size = st->sizes[p];
+
+    st->prev[p] = NO_BUCKET;
+    st->next[p] = st->head[size];
+    if (st->head[size] != NO_BUCKET) {
+        st->prev[st->head[size]] = p;
+    }
+    st->head[size] = p;
+
+    if (size < st->least) {
+        st->least = size;
+    }
+}
+
+static void
+bucket_remove(stream_state* st, unsigned long p)
+{
+    if (st->prev[p] == NO_BUCKET) {
+        st->head[st->sizes[p]] = st->next[p];
+    } else {
+        st->next[st->prev[p]] = st->next[p];
+    }
+
+    if (st->next[p] != NO_BUCKET) {
+        st->prev[st->next[p]] = st->prev[p];
+    }
+}
+
+static void
+add_node(stream_state* st, unsigned long node_id, unsigned long p)
+{
+    bucket_remove(st, p);
+    st->sizes[p]++;
+    bucket_insert(st, p);
+    st->partition[node_id] = p;
+
+    while (st->head[st->least] == NO_BUCKET) {
+        st->least++;
+    }
+}
+
+static void
+remove_node(stream_state* st, unsigned long node_id)
+{
+    unsigned long p = st->partition[node_id];
+
+    bucket_remove(st, p);
+    st->sizes[p]--;
+    bucket_insert(st, p);
+    st->partition[node_id] = STREAM_NO_PARTITION;
+}
+
+static double
+score(const stream_state* st, unsigned long n_neighbours, unsigned long size)
+{
+    if (st->partitioner == LDG_PARTITIONER) {
+        return (double)n_neighbours
+               * (1.0 - (double)size / (double)st->capacity);
+    }
+
+    return (double)n_neighbours
+           - st->alpha * FENNEL_GAMMA * pow((double)size, FENNEL_GAMMA - 1);
+}
+
+/* Moves the source of the current run to the partition with the best score.
+ * Partitions without targets score best if they are the smallest, so only
+ * the partitions of the targets and the smallest one are candidates. */
+static void
+place(stream_state* st, unsigned long source, bool first_pass)
+{
+    unsigned long p;
+
+    if (st->partition[source] != STREAM_NO_PARTITION) {
+        remove_node(st, source);
+    }
+
+    for (size_t i = 0; i < st->n_targets; ++i) {
+        p = st->partition[st->targets[i]];
+        if (p != STREAM_NO_PARTITION && st->n_neighbours[p]++ == 0) {
+            st->touched[st->n_touched++] = p;
+        }
+    }
+
+    unsigned long best       = st->head[st->least];
+    double        best_score = score(st, 0, st->least);
+    double        s;
+
+    for (size_t i = 0; i < st->n_touched; ++i) {
+        p = st->touched[i];
+
+        if (st->sizes[p] < st->capacity) {
+            s = score(st, st->n_neighbours[p], st->sizes[p]);
+
+            if (s > best_score
+                || (s == best_score && st->sizes[p] < st->sizes[best])) {
+                best       = p;
+                best_score = s;
+            }
+        }
+        st->n_neighbours[p] = 0;
+    }
+    st->n_touched = 0;
+
+    add_node(st, source, best);
+
+    // Targets that have no outgoing relationships would not be placed at all
+    if (first_pass) {
+        for (size_t i = 0; i < st->n_targets && st->sizes[best] < st->capacity;
+             ++i) {
+            if (st->partition[st->targets[i]] == STREAM_NO_PARTITION) {
+                add_node(st, st->targets[i], best);
+            }
+        }
+    }
+
+    st->n_targets = 0;
+}
+
+static void
+append_target(stream_state* st, unsigned long target)
+{
+    if (st->n_targets == st->targets_capacity) {
+        st->targets_capacity *= 2;
+        st->targets = realloc(st->targets,
+                              st->targets_capacity * sizeof(unsigned long));
+
+        if (!st->targets) {
+            // LCOV_EXCL_START
+            printf("stream partition: Failed to allocate memory!\n");
+            print_trace();
+
+            exit(EXIT_FAILURE);
+            // LCOV_EXCL_STOP
+        }
+    }
+
+    st->targets[st->n_targets++] = target;
+}
+
+/* Reads the relationships in the order of the record file. */
+static void
+stream_pass(heap_file* hf, stream_state* st, bool first_pass, bool log)
+{
+    unsigned long   source         = UNINITIALIZED_LONG;
+    unsigned long   cur_id         = 0;
+    unsigned long   record_page_id = 0;
+    unsigned char   slot_in_page   = 0;
+    relationship_t* rel;
+
+    while (record_page_id
+           < hf->cache->pdb->records[relationship_ft]->num_pages) {
+        if (check_record_exists(hf, cur_id, false, log)) {
+            rel = read_relationship(hf, cur_id, log);
+
+            if (rel->source_node != source) {
+                if (source != UNINITIALIZED_LONG) {
+                    place(st, source, first_pass);
+                }
+                source = rel->source_node;
+            }
+
+            if (rel->target_node != source) {
+                append_target(st, rel->target_node);
+            }
+            free(rel);
+        }
+
+        if ((slot_in_page + NUM_SLOTS_PER_REL) % SLOTS_PER_PAGE
+            < slot_in_page % SLOTS_PER_PAGE) {
+            record_page_id++;
+            slot_in_page = 0;
+        } else {
+            slot_in_page += NUM_SLOTS_PER_REL;
+        }
+
+        cur_id = (record_page_id << CHAR_BIT) | slot_in_page;
+    }
+
+    if (source != UNINITIALIZED_LONG) {
+        place(st, source, first_pass);
+    }
+}
+
+unsigned int*
+stream_partition(heap_file*         hf,
+                 size_t             n_partitions,
+                 stream_partitioner partitioner,
+                 size_t             n_restreams,
+                 bool               log)
+{
+    if (!hf
+        || (partitioner != LDG_PARTITIONER
+            && partitioner != FENNEL_PARTITIONER)) {
+        // LCOV_EXCL_START
+        printf("stream partition - stream partition: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    const unsigned long n              = hf->n_nodes;
+    const unsigned long nodes_per_page = SLOTS_PER_PAGE / NUM_SLOTS_PER_NODE;
+
+    if (n_partitions == 0) {
+        n_partitions = (n + nodes_per_page - 1) / nodes_per_page;
+    }
+    n_partitions = n_partitions == 0 ? 1 : n_partitions;
+
+    stream_state st;
+    st.partitioner  = partitioner;
+    st.n_partitions = n_partitions;
+    st.capacity     = n == 0 ? 1 : (n + n_partitions - 1) / n_partitions;
+    st.alpha        = n == 0 ? 0
+                             : sqrt((double)n_partitions) * (double)hf->n_rels
+                            / pow((double)n, FENNEL_GAMMA);
+    st.n_ids = hf->cache->pdb->records[node_ft]->num_pages * SLOTS_PER_PAGE;
+    st.partition    = stream_calloc(st.n_ids, sizeof(unsigned int));
+    st.sizes        = stream_calloc(n_partitions, sizeof(unsigned long));
+    st.head         = stream_calloc(st.capacity + 1, sizeof(unsigned long));
+    st.next         = stream_calloc(n_partitions, sizeof(unsigned long));
+    st.prev         = stream_calloc(n_partitions, sizeof(unsigned long));
+    st.least        = st.capacity;
+    st.n_targets    = 0;
+    st.n_touched    = 0;
+    st.n_neighbours = stream_calloc(n_partitions, sizeof(unsigned long));
+    st.touched      = stream_calloc(n_partitions, sizeof(unsigned int));
+
+    st.targets_capacity = SLOTS_PER_PAGE;
+    st.targets = stream_calloc(st.targets_capacity, sizeof(unsigned long));
+
+    for (size_t i = 0; i < st.n_ids; ++i) {
+        st.partition[i] = STREAM_NO_PARTITION;
+    }
+
+    for (size_t s = 0; s <= st.capacity; ++s) {
+        st.head[s] = NO_BUCKET;
+    }
+
+    // Inserted back to front, so that the partitions fill up in order
+    for (size_t p = n_partitions; p > 0; --p) {
+        bucket_insert(&st, p - 1);
+    }
+
+    for (size_t pass = 0; pass <= n_restreams; ++pass) {
+        stream_pass(hf, &st, pass == 0, log);
+    }
+
+    for (size_t i = 0; i < st.n_ids; ++i) {
+        if (st.partition[i] == STREAM_NO_PARTITION
+            && check_record_exists(hf, i, true, log)) {
+            add_node(&st, i, st.head[st.least]);
+        }
+    }
+
+    free(st.sizes);
+    free(st.head);
+    free(st.next);
+    free(st.prev);
+    free(st.targets);
+    free(st.n_neighbours);
+    free(st.touched);
+
+    return st.partition;
+}
+
+unsigned long*
+stream_partition_order(heap_file*         hf,
+                       size_t             n_partitions,
+                       stream_partitioner partitioner,
+                       size_t             n_restreams,
+                       bool               log)
+{
+    if (!hf) {
+        // LCOV_EXCL_START
+        printf("stream partition - stream partition order: Invalid "
+               "Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    unsigned int* partition =
+          stream_partition(hf, n_partitions, partitioner, n_restreams, log);
+    size_t n_ids = hf->cache->pdb->records[node_ft]->num_pages * SLOTS_PER_PAGE;
+
+    unsigned int max_partition = 0;
+    for (size_t i = 0; i < n_ids; ++i) {
+        if (partition[i] != STREAM_NO_PARTITION
+            && partition[i] > max_partition) {
+            max_partition = partition[i];
+        }
+    }
+
+    // Counting sort, which keeps the ids in order within each partition
+    unsigned long* offsets =
+          stream_calloc((size_t)max_partition + 2, sizeof(unsigned long));
+    for (size_t i = 0; i < n_ids; ++i) {
+        if (partition[i] != STREAM_NO_PARTITION) {
+            offsets[partition[i] + 1]++;
+        }
+    }
+
+    for (size_t p = 1; p <= (size_t)max_partition + 1; ++p) {
+        offsets[p] += offsets[p - 1];
+    }
+
+    unsigned long* sequence = stream_calloc(hf->n_nodes, sizeof(unsigned long));
+    for (size_t i = 0; i < n_ids; ++i) {
+        if (partition[i] != STREAM_NO_PARTITION) {
+            sequence[offsets[partition[i]]++] = i;
+        }
+    }
+
+    free(offsets);
+    free(partition);
+
+    return sequence;
+}
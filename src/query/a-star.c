@@ -20,58 +20,112 @@
 #include "access/relationship.h"
 #include "constants.h"
 #include "data-struct/array_list.h"
-#include "data-struct/fibonacci_heap.h"
 #include "data-struct/htable.h"
+#include "data-struct/priority_queue.h"
 #include "query/result_types.h"
 #include "strace.h"
 
+double
+a_star_dict_heuristic(unsigned long from_node_id,
+                      unsigned long to_node_id,
+                      void*         data)
+{
+    (void)to_node_id;
+    dict_ul_d* estimates = data;
+
+    if (!estimates || !dict_ul_d_contains(estimates, from_node_id)) {
+        return 0;
+    }
+
+    double estimate = dict_ul_d_get_direct(estimates, from_node_id);
+
+    return estimate == DBL_MAX ? 0 : estimate;
+}
+
 path*
 a_star(heap_file*    hf,
-       dict_ul_d*    heuristic,
+       heuristic_fn  heuristic,
+       void*         heuristic_data,
        unsigned long source_node_id,
        unsigned long target_node_id,
        direction_t   direction,
        bool          log,
        FILE*         log_file)
 {
-    if (!hf
-        || source_node_id == UNINITIALIZED_LONG
+    // The keys are distances plus bounds on the remaining distance, which are
+    // not monotone for inconsistent heuristics.
+    return a_star_pq(hf,
+                     heuristic,
+                     heuristic_data,
+                     source_node_id,
+                     target_node_id,
+                     direction,
+                     d_ary_pq,
+                     log,
+                     log_file);
+}
+
+path*
+a_star_pq(heap_file*    hf,
+          heuristic_fn  heuristic,
+          void*         heuristic_data,
+          unsigned long source_node_id,
+          unsigned long target_node_id,
+          direction_t   direction,
+          pq_type       queue_type,
+          bool          log,
+          FILE*         log_file)
+{
+    if (!hf || source_node_id == UNINITIALIZED_LONG
+        || target_node_id == UNINITIALIZED_LONG || queue_type >= invalid_pq) {
         // LCOV_EXCL_START
-        || target_node_id == UNINITIALIZED_LONG) {
         printf("a-star: Invalid Arguments!\n");
         print_trace();
+
         exit(EXIT_FAILURE);
         // LCOV_EXCL_STOP
     }
 
+    if (source_node_id == target_node_id) {
+        return create_path(source_node_id, target_node_id, 0, al_ul_create());
+    }
+
     dict_ul_ul* parents  = d_ul_ul_create();
     dict_ul_d*  distance = d_ul_d_create();
 
-    fib_heap_ul* prio_queue = fib_heap_ul_create();
+    priority_queue* prio_queue = priority_queue_create(queue_type);
 
     array_list_relationship* current_rels;
     relationship_t*          current_rel;
+    unsigned long            node_id;
     unsigned long            temp;
     double                   new_dist;
-    fib_heap_ul_node*        fh_node = NULL;
-    fib_heap_ul_insert(prio_queue, DBL_MAX, source_node_id);
+    double                   new_key;
+    double                   min_key = 0;
+    priority_queue_push(prio_queue,
+                        heuristic ? heuristic(source_node_id,
+                                              target_node_id,
+                                              heuristic_data)
+                                  : 0,
+                        source_node_id);
     dict_ul_d_insert(distance, source_node_id, 0);
 
-    while (prio_queue->num_nodes > 0) {
-        fh_node = fib_heap_ul_extract_min(prio_queue);
+    while (priority_queue_size(prio_queue) > 0) {
+        node_id = priority_queue_extract_min(prio_queue, &min_key);
 
-        if (fh_node->value == target_node_id) {
+        if (node_id == target_node_id) {
+            priority_queue_destroy(prio_queue);
             dict_ul_d_destroy(distance);
-            free(fh_node);
-            fib_heap_ul_destroy(prio_queue);
+
+            // Takes ownership of the parents
             return construct_path(
-                  hf, source_node_id, target_node_id, parents, log_file);
+                  hf, source_node_id, target_node_id, parents, log);
         }
 
-        current_rels = expand(hf, fh_node->value, direction, log);
+        current_rels = expand(hf, node_id, direction, log);
 
         if (log) {
-            fprintf(log_file, "%s %lu\n", "a-star N", fh_node->value);
+            fprintf(log_file, "%s %lu\n", "a-star N", node_id);
             fflush(log_file);
         }
 
@@ -83,28 +137,35 @@ a_star(heap_file*    hf,
                 fprintf(log_file, "%s %lu\n", "a-star R", current_rel->id);
                 fflush(log_file);
             }
-            temp = fh_node->value == current_rel->source_node
+            temp = node_id == current_rel->source_node
                          ? current_rel->target_node
                          : current_rel->source_node;
 
-            new_dist = dict_ul_d_get_direct(distance, fh_node->value)
-                       + current_rel->weight
-                       + dict_ul_d_get_direct(heuristic, fh_node->value);
+            new_dist = dict_ul_d_get_direct(distance, node_id)
+                       + current_rel->weight;
             if (!dict_ul_d_contains(distance, temp)
                 || dict_ul_d_get_direct(distance, temp) > new_dist) {
                 dict_ul_d_insert(distance, temp, new_dist);
                 dict_ul_ul_insert(parents, temp, current_rel->id);
-                fib_heap_ul_insert(prio_queue, new_dist, temp);
+                new_key = new_dist
+                          + (heuristic ? heuristic(
+                                   temp, target_node_id, heuristic_data)
+                                       : 0);
+
+                // A consistent heuristic only undercuts the last key by
+                // rounding, which the radix heap would reject
+                if (queue_type == radix_pq && new_key < min_key) {
+                    new_key = min_key;
+                }
+                priority_queue_push(prio_queue, new_key, temp);
             }
         }
-        free(fh_node);
         array_list_relationship_destroy(current_rels);
     }
-    // LCOV_EXCL_START
-    fib_heap_ul_destroy(prio_queue);
+
+    priority_queue_destroy(prio_queue);
     dict_ul_ul_destroy(parents);
     dict_ul_d_destroy(distance);
 
     return create_path(source_node_id, target_node_id, DBL_MAX, al_ul_create());
-    // LCOV_EXCL_STOP
 }
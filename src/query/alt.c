@@ -13,19 +13,27 @@
 #include "query/alt.h"
 
 #include <errno.h>
+#include <float.h>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "access/csr_graph.h"
 #include "access/heap_file.h"
 #include "access/node.h"
+#include "constants.h"
 #include "data-struct/htable.h"
 #include "query/a-star.h"
+#include "query/bidirectional.h"
 #include "query/degree.h"
-#include "query/dijkstra.h"
+#include "query/delta_stepping.h"
 #include "query/result_types.h"
 #include "strace.h"
 
+/* "ALTLMRKS" */
+#define ALT_FILE_MAGIC (0x414c544c4d524b32UL)
+
 unsigned long
 alt_chose_avg_deg_rand_landmark(heap_file*  hf,
                                 direction_t direction,
@@ -65,96 +73,913 @@ alt_chose_avg_deg_rand_landmark(heap_file*  hf,
     return landmark_id;
 }
 
-void
-alt_preprocess(heap_file*    hf,
-               direction_t   d,
-               unsigned long num_landmarks,
-               dict_ul_d**   landmark_dists,
-               bool          log,
-               FILE*         log_file)
+/* A shortest path tree on the dense indices of a snapshot, used to place
+ * landmarks by the avoid and the planar strategy. */
+typedef struct
+{
+    double*        dist;
+    unsigned long* parent;
+    unsigned long* child_offsets;
+    unsigned long* children;
+    unsigned long* preorder;
+    unsigned long  n_reached;
+} landmark_tree;
+
+static unsigned long
+edge_endpoint(const csr_graph* graph, unsigned long node_idx, unsigned long rel)
+{
+    for (size_t d = 0; d < 2; ++d) {
+        for (size_t i = graph->offsets[d][node_idx];
+             i < graph->offsets[d][node_idx + 1];
+             ++i) {
+            if (graph->edges[d][i].rel_id == rel) {
+                return graph->edges[d][i].neighbour;
+            }
+        }
+    }
+
+    // LCOV_EXCL_START
+    printf("ALT - edge endpoint: Relationship not incident to node!\n");
+    print_trace();
+
+    exit(EXIT_FAILURE);
+    // LCOV_EXCL_STOP
+}
+
+static landmark_tree*
+landmark_tree_create(const csr_graph* graph,
+                     unsigned long    root_idx,
+                     direction_t      direction)
 {
-    if (!hf || !landmark_dists) {
+    unsigned long  n    = graph->n_nodes;
+    landmark_tree* tree = malloc(sizeof(landmark_tree));
+
+    if (!tree) {
         // LCOV_EXCL_START
-        printf("ALT - preprocess: Invalid arguments!\n");
+        printf("ALT - landmark tree: Failed to allocate memory!\n");
         print_trace();
 
         exit(EXIT_FAILURE);
         // LCOV_EXCL_STOP
     }
 
-    unsigned long landmarks[num_landmarks];
-    sssp_result*  result;
+    tree->dist          = malloc(n * sizeof(double));
+    tree->parent        = malloc(n * sizeof(unsigned long));
+    tree->child_offsets = calloc(n + 1, sizeof(unsigned long));
+    tree->children      = malloc(n * sizeof(unsigned long));
+    tree->preorder      = malloc(n * sizeof(unsigned long));
+    tree->n_reached     = 0;
 
-    for (size_t i = 0; i < num_landmarks; ++i) {
-        landmarks[i] = alt_chose_avg_deg_rand_landmark(hf, d, log, log_file);
-        result       = dijkstra(hf, landmarks[i], d, log, log_file);
+    if (!tree->dist || !tree->parent || !tree->child_offsets || !tree->children
+        || !tree->preorder) {
+        // LCOV_EXCL_START
+        printf("ALT - landmark tree: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    // The predecessor edges of delta-stepping form a tree, even if there are
+    // edges of weight zero.
+    sssp_result* result =
+          delta_stepping_csr(graph, graph->node_ids[root_idx], direction, 0);
 
-        // Assign the distances gathered by using dijkstras and discard the rest
-        // of the sssp result (pred edges and the struct itself.
-        landmark_dists[i] = result->distances;
-        dict_ul_ul_destroy(result->pred_edges);
-        free(result);
+    for (unsigned long i = 0; i < n; ++i) {
+        tree->dist[i] =
+              dict_ul_d_get_direct(result->distances, graph->node_ids[i]);
+        tree->parent[i] = UNINITIALIZED_LONG;
+
+        if (i != root_idx && tree->dist[i] != DBL_MAX) {
+            tree->parent[i] = edge_endpoint(
+                  graph,
+                  i,
+                  dict_ul_ul_get_direct(result->pred_edges,
+                                        graph->node_ids[i]));
+            tree->child_offsets[tree->parent[i] + 1]++;
+        }
+    }
+    sssp_result_destroy(result);
+
+    for (unsigned long i = 0; i < n; ++i) {
+        tree->child_offsets[i + 1] += tree->child_offsets[i];
+    }
+
+    // Use the preorder array as fill pointers before it is computed
+    memcpy(tree->preorder, tree->child_offsets, n * sizeof(unsigned long));
+    for (unsigned long i = 0; i < n; ++i) {
+        if (tree->parent[i] != UNINITIALIZED_LONG) {
+            tree->children[tree->preorder[tree->parent[i]]++] = i;
+        }
+    }
+
+    // Depth first order with the children in ascending order
+    unsigned long* stack    = malloc(n * sizeof(unsigned long));
+    size_t         stack_sz = 0;
+    unsigned long  current;
+
+    if (!stack) {
+        // LCOV_EXCL_START
+        printf("ALT - landmark tree: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
     }
+
+    stack[stack_sz++] = root_idx;
+    while (stack_sz > 0) {
+        current                           = stack[--stack_sz];
+        tree->preorder[tree->n_reached++] = current;
+
+        for (size_t i = tree->child_offsets[current + 1];
+             i > tree->child_offsets[current];
+             --i) {
+            stack[stack_sz++] = tree->children[i - 1];
+        }
+    }
+    free(stack);
+
+    return tree;
 }
 
-path*
-alt(heap_file*    hf,
-    dict_ul_d**   landmark_dists,
-    unsigned long num_landmarks,
-    unsigned long source_node_id,
-    unsigned long target_node_id,
-    direction_t   direction,
-    bool          log,
-    FILE*         log_file)
+static void
+landmark_tree_destroy(landmark_tree* tree)
 {
-    if (!hf || !landmark_dists) {
+    free(tree->dist);
+    free(tree->parent);
+    free(tree->child_offsets);
+    free(tree->children);
+    free(tree->preorder);
+    free(tree);
+}
+
+static const float*
+landmark_row(const alt_landmarks* landmarks, unsigned long node_idx)
+{
+    return landmarks->dists
+           + node_idx * landmarks->num_sides * landmarks->num_landmarks;
+}
+
+static double
+landmark_bound(const alt_landmarks* landmarks,
+               unsigned long        num_used,
+               unsigned long        from_idx,
+               unsigned long        to_idx)
+{
+    const float* from_row = landmark_row(landmarks, from_idx);
+    const float* to_row   = landmark_row(landmarks, to_idx);
+
+    double bound = 0;
+    double from_dist;
+    double to_dist;
+    double temp_dist;
+
+    for (size_t side = 0; side < landmarks->num_sides; ++side) {
+        for (size_t i = 0; i < num_used; ++i) {
+            from_dist = from_row[side * landmarks->num_landmarks + i];
+            to_dist   = to_row[side * landmarks->num_landmarks + i];
+
+            if (isinf(from_dist) || isinf(to_dist)) {
+                continue;
+            }
+
+            // d(l, to) <= d(l, from) + d(from, to) and
+            // d(from, l) <= d(from, to) + d(to, l)
+            temp_dist = side == 0 ? to_dist - from_dist : from_dist - to_dist;
+
+            if (landmarks->direction == BOTH) {
+                temp_dist = fabs(temp_dist);
+            }
+
+            // Both distances may be rounded up or down by half an ulp
+            if (!landmarks->exact) {
+                temp_dist -= FLT_EPSILON * (from_dist + to_dist);
+            }
+
+            bound = temp_dist > bound ? temp_dist : bound;
+        }
+    }
+
+    return bound;
+}
+
+static unsigned long
+random_avg_degree_landmark(const csr_graph* graph, direction_t direction)
+{
+    double avg_degree = (double)graph->n_rels / (double)graph->n_nodes;
+    if (direction == BOTH) {
+        avg_degree *= 2;
+    }
+
+    unsigned long landmark_idx;
+    do {
+        landmark_idx = (unsigned long)rand() % graph->n_nodes;
+    } while ((double)csr_graph_degree(graph, landmark_idx, direction)
+             < avg_degree);
+
+    return landmark_idx;
+}
+
+static unsigned long
+farthest_landmark(const alt_landmarks* landmarks, unsigned long num_used)
+{
+    if (num_used == 0) {
+        return (unsigned long)rand() % landmarks->n_nodes;
+    }
+
+    unsigned long landmark_idx = UNINITIALIZED_LONG;
+    double        max_dist     = 0;
+    double        min_dist;
+    double        dist;
+    const float*  row;
+
+    for (unsigned long v = 0; v < landmarks->n_nodes; ++v) {
+        row      = landmark_row(landmarks, v);
+        min_dist = INFINITY;
+
+        for (size_t i = 0; i < num_used; ++i) {
+            dist = row[i];
+            if (landmarks->num_sides == 2) {
+                dist += row[landmarks->num_landmarks + i];
+            }
+            min_dist = dist < min_dist ? dist : min_dist;
+        }
+
+        if (min_dist > max_dist) {
+            max_dist     = min_dist;
+            landmark_idx = v;
+        }
+    }
+
+    // All nodes coincide with the landmarks chosen so far
+    return landmark_idx == UNINITIALIZED_LONG
+                 ? (unsigned long)rand() % landmarks->n_nodes
+                 : landmark_idx;
+}
+
+static unsigned long
+avoid_landmark(const csr_graph*     graph,
+               const alt_landmarks* landmarks,
+               unsigned long        num_used)
+{
+    unsigned long  n        = graph->n_nodes;
+    unsigned long  root_idx = (unsigned long)rand() % n;
+    landmark_tree* tree =
+          landmark_tree_create(graph, root_idx, landmarks->direction);
+
+    double* size    = malloc(n * sizeof(double));
+    bool*   covered = calloc(n, sizeof(bool));
+
+    if (!size || !covered) {
         // LCOV_EXCL_START
-        printf("ALT: Invalid arguments!\n");
+        printf("ALT - avoid: Failed to allocate memory!\n");
         print_trace();
 
         exit(EXIT_FAILURE);
         // LCOV_EXCL_STOP
     }
 
-    dict_ul_d*       heuristic = d_ul_d_create();
-    array_list_node* nodes     = get_nodes(hf, log);
+    for (size_t i = 0; i < num_used; ++i) {
+        covered[csr_graph_index(graph, landmarks->landmark_ids[i])] = true;
+    }
+
+    // The size of a subtree is the sum of the gaps between the distance from
+    // the root and its lower bound, or zero if it contains a landmark.
+    unsigned long v;
+    unsigned long landmark_idx = root_idx;
+    for (size_t i = tree->n_reached; i > 0; --i) {
+        v       = tree->preorder[i - 1];
+        size[v] = tree->dist[v]
+                  - landmark_bound(landmarks, num_used, root_idx, v);
 
-    double temp_dist;
-    for (size_t i = 0; i < num_landmarks; ++i) {
-        for (size_t j = 0; j < array_list_node_size(nodes); ++j) {
-
-            temp_dist = fabs(
-                  dict_ul_d_get_direct(landmark_dists[i],
-                                       array_list_node_get(nodes, j)->id)
-                  - dict_ul_d_get_direct(landmark_dists[i], target_node_id));
-
-            if (log) {
-                fprintf(log_file,
-                        "alt N %lu\n",
-                        array_list_node_get(nodes, j)->id);
-                fflush(log_file);
+        for (size_t j = tree->child_offsets[v]; j < tree->child_offsets[v + 1];
+             ++j) {
+            covered[v] = covered[v] || covered[tree->children[j]];
+            size[v] += size[tree->children[j]];
+        }
+
+        if (covered[v]) {
+            size[v] = 0;
+        } else if (size[v] > size[landmark_idx]) {
+            landmark_idx = v;
+        }
+    }
+
+    if (size[landmark_idx] <= 0) {
+        landmark_idx = (unsigned long)rand() % n;
+    } else {
+        // Descend along the heaviest child down to a leaf
+        unsigned long child;
+        while (tree->child_offsets[landmark_idx]
+               < tree->child_offsets[landmark_idx + 1]) {
+            child = tree->children[tree->child_offsets[landmark_idx]];
+            for (size_t j = tree->child_offsets[landmark_idx] + 1;
+                 j < tree->child_offsets[landmark_idx + 1];
+                 ++j) {
+                if (size[tree->children[j]] > size[child]) {
+                    child = tree->children[j];
+                }
             }
+            landmark_idx = child;
+        }
+    }
+
+    free(size);
+    free(covered);
+    landmark_tree_destroy(tree);
+
+    return landmark_idx;
+}
+
+static void
+planar_landmarks(const csr_graph* graph,
+                 direction_t      direction,
+                 unsigned long    num_landmarks,
+                 unsigned long*   landmark_idxs)
+{
+    unsigned long center_idx = 0;
+    for (unsigned long v = 1; v < graph->n_nodes; ++v) {
+        if (csr_graph_degree(graph, v, BOTH)
+            > csr_graph_degree(graph, center_idx, BOTH)) {
+            center_idx = v;
+        }
+    }
+
+    landmark_tree* tree = landmark_tree_create(graph, center_idx, direction);
+
+    // The root comes first in the order and is not part of any sector
+    unsigned long n_sector_nodes = tree->n_reached - 1;
+    unsigned long begin;
+    unsigned long end;
+    unsigned long v;
 
-            if (!dict_ul_d_contains(heuristic,
-                                    array_list_node_get(nodes, j)->id)
-                || temp_dist < dict_ul_d_get_direct(
-                         heuristic, array_list_node_get(nodes, j)->id)) {
-                dict_ul_d_insert(
-                      heuristic, array_list_node_get(nodes, j)->id, temp_dist);
+    for (size_t i = 0; i < num_landmarks; ++i) {
+        begin            = 1 + i * n_sector_nodes / num_landmarks;
+        end              = 1 + (i + 1) * n_sector_nodes / num_landmarks;
+        landmark_idxs[i] = begin < end ? tree->preorder[begin]
+                                       : (unsigned long)rand() % graph->n_nodes;
+
+        for (size_t j = begin + 1; j < end; ++j) {
+            v = tree->preorder[j];
+            if (tree->dist[v] > tree->dist[landmark_idxs[i]]) {
+                landmark_idxs[i] = v;
             }
         }
     }
 
-    array_list_node_destroy(nodes);
+    landmark_tree_destroy(tree);
+}
+
+static void
+store_distances(alt_landmarks*   landmarks,
+                const csr_graph* graph,
+                unsigned long    landmark,
+                size_t           side,
+                direction_t      direction)
+{
+    sssp_result* result = delta_stepping_csr(
+          graph, landmarks->landmark_ids[landmark], direction, 0);
+
+    size_t stride = landmarks->num_sides * landmarks->num_landmarks;
+    float* column =
+          landmarks->dists + side * landmarks->num_landmarks + landmark;
+    double dist;
+
+    for (unsigned long v = 0; v < graph->n_nodes; ++v) {
+        dist = dict_ul_d_get_direct(result->distances, graph->node_ids[v]);
+        column[v * stride] = dist == DBL_MAX ? INFINITY : (float)dist;
+
+        if (dist != DBL_MAX && (double)column[v * stride] != dist) {
+            landmarks->exact = false;
+        }
+    }
+
+    sssp_result_destroy(result);
+}
+
+static alt_landmarks*
+alt_landmarks_create(direction_t   d,
+                     unsigned long num_landmarks,
+                     unsigned long n_nodes,
+                     unsigned long n_rels)
+{
+    alt_landmarks* landmarks = malloc(sizeof(alt_landmarks));
+
+    if (!landmarks) {
+        // LCOV_EXCL_START
+        printf("ALT - create landmarks: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    landmarks->direction     = d;
+    landmarks->num_landmarks = n_nodes > 0 ? num_landmarks : 0;
+    landmarks->n_nodes       = n_nodes;
+    landmarks->n_rels        = n_rels;
+    landmarks->generation    = UNINITIALIZED_LONG;
+    landmarks->n_changes     = UNINITIALIZED_LONG;
+    landmarks->num_sides     = d == BOTH ? 1 : 2;
+    landmarks->exact         = true;
+    landmarks->index_of      = NULL;
+    landmarks->index_bound   = 0;
+    landmarks->landmark_ids =
+          malloc(landmarks->num_landmarks * sizeof(unsigned long));
+    landmarks->node_ids = malloc(n_nodes * sizeof(unsigned long));
+    landmarks->dists    = malloc(n_nodes * landmarks->num_sides
+                              * landmarks->num_landmarks * sizeof(float));
+
+    if ((landmarks->num_landmarks > 0
+         && (!landmarks->landmark_ids || !landmarks->dists))
+        || (n_nodes > 0 && !landmarks->node_ids)) {
+        // LCOV_EXCL_START
+        printf("ALT - create landmarks: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    return landmarks;
+}
 
-    path* result = a_star(hf,
-                          heuristic,
-                          source_node_id,
-                          target_node_id,
-                          direction,
-                          log,
-                          log_file);
+static void
+build_index(alt_landmarks* landmarks)
+{
+    for (unsigned long i = 0; i < landmarks->n_nodes; ++i) {
+        if (landmarks->node_ids[i] / NUM_SLOTS_PER_NODE
+            >= landmarks->index_bound) {
+            landmarks->index_bound =
+                  landmarks->node_ids[i] / NUM_SLOTS_PER_NODE + 1;
+        }
+    }
+
+    landmarks->index_of =
+          malloc(landmarks->index_bound * sizeof(unsigned long));
+
+    if (landmarks->index_bound > 0 && !landmarks->index_of) {
+        // LCOV_EXCL_START
+        printf("ALT - build index: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    for (unsigned long i = 0; i < landmarks->index_bound; ++i) {
+        landmarks->index_of[i] = UNINITIALIZED_LONG;
+    }
+
+    for (unsigned long i = 0; i < landmarks->n_nodes; ++i) {
+        landmarks->index_of[landmarks->node_ids[i] / NUM_SLOTS_PER_NODE] = i;
+    }
+}
+
+alt_landmarks*
+alt_preprocess_csr(const csr_graph*      graph,
+                   direction_t           d,
+                   unsigned long         num_landmarks,
+                   alt_landmark_strategy strategy)
+{
+    if (!graph || d > BOTH || strategy > alt_planar) {
+        // LCOV_EXCL_START
+        printf("ALT - preprocess: Invalid arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    alt_landmarks* landmarks =
+          alt_landmarks_create(d, num_landmarks, graph->n_nodes, graph->n_rels);
+    memcpy(landmarks->node_ids,
+           graph->node_ids,
+           graph->n_nodes * sizeof(unsigned long));
+    build_index(landmarks);
+
+    unsigned long* planned = NULL;
+    if (strategy == alt_planar && landmarks->num_landmarks > 0) {
+        planned = malloc(landmarks->num_landmarks * sizeof(unsigned long));
+
+        if (!planned) {
+            // LCOV_EXCL_START
+            printf("ALT - preprocess: Failed to allocate memory!\n");
+            print_trace();
+
+            exit(EXIT_FAILURE);
+            // LCOV_EXCL_STOP
+        }
+
+        planar_landmarks(graph, d, landmarks->num_landmarks, planned);
+    }
+
+    unsigned long landmark_idx;
+    for (size_t i = 0; i < landmarks->num_landmarks; ++i) {
+        switch (strategy) {
+            case alt_random_avg_degree:
+                landmark_idx = random_avg_degree_landmark(graph, d);
+                break;
+            case alt_farthest:
+                landmark_idx = farthest_landmark(landmarks, i);
+                break;
+            case alt_avoid:
+                landmark_idx = avoid_landmark(graph, landmarks, i);
+                break;
+            default:
+                landmark_idx = planned[i];
+                break;
+        }
+
+        landmarks->landmark_ids[i] = graph->node_ids[landmark_idx];
+        store_distances(landmarks, graph, i, 0, d);
+
+        if (d != BOTH) {
+            store_distances(landmarks, graph, i, 1, reverse_direction(d));
+        }
+    }
+
+    free(planned);
+
+    return landmarks;
+}
+
+alt_landmarks*
+alt_preprocess(heap_file*            hf,
+               direction_t           d,
+               unsigned long         num_landmarks,
+               alt_landmark_strategy strategy,
+               bool                  log,
+               FILE*                 log_file)
+{
+    if (!hf || d > BOTH || strategy > alt_planar) {
+        // LCOV_EXCL_START
+        printf("ALT - preprocess: Invalid arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    // Read the graph once and compute the distances of all landmarks on the
+    // snapshot in parallel.
+    csr_graph*     graph = csr_graph_create(hf, log);
+    alt_landmarks* landmarks =
+          alt_preprocess_csr(graph, d, num_landmarks, strategy);
+    csr_graph_destroy(graph);
+
+    landmarks->generation = hf->cache->pdb->generation;
+    landmarks->n_changes  = hf->cache->pdb->n_changes;
+
+    if (log) {
+        for (size_t i = 0; i < landmarks->num_landmarks; ++i) {
+            fprintf(log_file,
+                    "alt_preprocess N %lu\n",
+                    landmarks->landmark_ids[i]);
+        }
+        fflush(log_file);
+    }
+
+    return landmarks;
+}
+
+void
+alt_landmarks_destroy(alt_landmarks* landmarks)
+{
+    if (!landmarks) {
+        // LCOV_EXCL_START
+        printf("ALT - destroy landmarks: Invalid arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    free(landmarks->landmark_ids);
+    free(landmarks->node_ids);
+    free(landmarks->index_of);
+    free(landmarks->dists);
+    free(landmarks);
+}
+
+static char*
+landmarks_file_name(const char* db_name)
+{
+    const char*  suffix    = "_landmarks.alt";
+    const size_t name_len  = strlen(db_name);
+    const size_t total_len = name_len + strlen(suffix) + 1;
+
+    char* file_name = calloc(total_len, sizeof(char));
+
+    if (!file_name) {
+        // LCOV_EXCL_START
+        printf("ALT - landmarks file name: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    strncpy(file_name, db_name, name_len + 1);
+    strncat(file_name, suffix, total_len - name_len - 1);
+
+    return file_name;
+}
+
+void
+alt_landmarks_save(const alt_landmarks* landmarks, const char* db_name)
+{
+    if (!landmarks || !db_name) {
+        // LCOV_EXCL_START
+        printf("ALT - save landmarks: Invalid arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    char* file_name = landmarks_file_name(db_name);
+    FILE* file      = fopen(file_name, "wb");
+
+    if (!file) {
+        // LCOV_EXCL_START
+        printf("ALT - save landmarks: Failed to open %s: %s\n",
+               file_name,
+               strerror(errno));
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    const unsigned long header[] = { ALT_FILE_MAGIC,
+                                     landmarks->direction,
+                                     landmarks->num_landmarks,
+                                     landmarks->n_nodes,
+                                     landmarks->n_rels,
+                                     landmarks->generation,
+                                     landmarks->n_changes,
+                                     landmarks->exact };
+    const size_t n_dists =
+          landmarks->n_nodes * landmarks->num_sides * landmarks->num_landmarks;
+    const size_t n_header = sizeof(header) / sizeof(header[0]);
+
+    if (fwrite(header, sizeof(unsigned long), n_header, file) != n_header
+        || fwrite(landmarks->landmark_ids,
+                  sizeof(unsigned long),
+                  landmarks->num_landmarks,
+                  file)
+                 != landmarks->num_landmarks
+        || fwrite(landmarks->node_ids,
+                  sizeof(unsigned long),
+                  landmarks->n_nodes,
+                  file)
+                 != landmarks->n_nodes
+        || fwrite(landmarks->dists, sizeof(float), n_dists, file) != n_dists
+        || fclose(file) != 0) {
+        // LCOV_EXCL_START
+        printf("ALT - save landmarks: Failed to write %s: %s\n",
+               file_name,
+               strerror(errno));
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    free(file_name);
+}
+
+alt_landmarks*
+alt_landmarks_load(heap_file* hf, const char* db_name)
+{
+    if (!hf || !db_name) {
+        // LCOV_EXCL_START
+        printf("ALT - load landmarks: Invalid arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    char* file_name = landmarks_file_name(db_name);
+    FILE* file      = fopen(file_name, "rb");
+
+    if (!file) {
+        free(file_name);
+        return NULL;
+    }
+
+    unsigned long header[8];
+    const size_t  n_header = sizeof(header) / sizeof(header[0]);
+
+    // Files of other versions are ignored like missing ones
+    if (fread(header, sizeof(unsigned long), 1, file) != 1
+        || header[0] != ALT_FILE_MAGIC) {
+        fclose(file);
+        free(file_name);
+        return NULL;
+    }
+
+    if (fread(header + 1, sizeof(unsigned long), n_header - 1, file)
+              != n_header - 1
+        || header[1] > BOTH) {
+        // LCOV_EXCL_START
+        printf("ALT - load landmarks: %s is corrupted!\n", file_name);
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    const phy_database* pdb = hf->cache->pdb;
+    if (header[3] != hf->n_nodes || header[4] != hf->n_rels
+        || header[5] != pdb->generation || header[6] != pdb->n_changes) {
+        fclose(file);
+        free(file_name);
+        return NULL;
+    }
+
+    alt_landmarks* landmarks =
+          alt_landmarks_create(header[1], header[2], header[3], header[4]);
+    landmarks->generation = header[5];
+    landmarks->n_changes  = header[6];
+    landmarks->exact      = header[7];
+
+    const size_t n_dists =
+          landmarks->n_nodes * landmarks->num_sides * landmarks->num_landmarks;
+
+    if (landmarks->num_landmarks != header[2]
+        || fread(landmarks->landmark_ids,
+                 sizeof(unsigned long),
+                 landmarks->num_landmarks,
+                 file)
+                 != landmarks->num_landmarks
+        || fread(landmarks->node_ids,
+                 sizeof(unsigned long),
+                 landmarks->n_nodes,
+                 file)
+                 != landmarks->n_nodes
+        || fread(landmarks->dists, sizeof(float), n_dists, file) != n_dists) {
+        // LCOV_EXCL_START
+        printf("ALT - load landmarks: %s is corrupted!\n", file_name);
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    fclose(file);
+    free(file_name);
+    build_index(landmarks);
+
+    return landmarks;
+}
+
+void
+alt_landmarks_delete_file(const char* db_name)
+{
+    if (!db_name) {
+        // LCOV_EXCL_START
+        printf("ALT - delete landmarks file: Invalid arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    char* file_name = landmarks_file_name(db_name);
+
+    if (remove(file_name) != 0 && errno != ENOENT) {
+        // LCOV_EXCL_START
+        printf("ALT - delete landmarks file: Failed to remove %s: %s\n",
+               file_name,
+               strerror(errno));
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    free(file_name);
+}
+
+static unsigned long
+landmark_index(const alt_landmarks* landmarks, unsigned long node_id)
+{
+    if (node_id == UNINITIALIZED_LONG
+        || node_id / NUM_SLOTS_PER_NODE >= landmarks->index_bound) {
+        return UNINITIALIZED_LONG;
+    }
+
+    return landmarks->index_of[node_id / NUM_SLOTS_PER_NODE];
+}
+
+double
+alt_heuristic(unsigned long from_node_id, unsigned long to_node_id, void* data)
+{
+    alt_landmarks* landmarks = data;
+
+    unsigned long from_idx = landmark_index(landmarks, from_node_id);
+    unsigned long to_idx   = landmark_index(landmarks, to_node_id);
+
+    if (from_idx == UNINITIALIZED_LONG || to_idx == UNINITIALIZED_LONG) {
+        return 0;
+    }
+
+    return landmark_bound(
+          landmarks, landmarks->num_landmarks, from_idx, to_idx);
+}
+
+path*
+alt(heap_file*     hf,
+    alt_landmarks* landmarks,
+    unsigned long  source_node_id,
+    unsigned long  target_node_id,
+    bool           log,
+    FILE*          log_file)
+{
+    return alt_pq(hf,
+                  landmarks,
+                  source_node_id,
+                  target_node_id,
+                  d_ary_pq,
+                  log,
+                  log_file);
+}
+
+path*
+alt_pq(heap_file*     hf,
+       alt_landmarks* landmarks,
+       unsigned long  source_node_id,
+       unsigned long  target_node_id,
+       pq_type        queue_type,
+       bool           log,
+       FILE*          log_file)
+{
+    if (!hf || !landmarks) {
+        // LCOV_EXCL_START
+        printf("ALT: Invalid arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    return a_star_pq(hf,
+                     alt_heuristic,
+                     landmarks,
+                     source_node_id,
+                     target_node_id,
+                     landmarks->direction,
+                     queue_type,
+                     log,
+                     log_file);
+}
+
+path*
+alt_bidirectional(heap_file*     hf,
+                  alt_landmarks* landmarks,
+                  unsigned long  source_node_id,
+                  unsigned long  target_node_id,
+                  bool           log,
+                  FILE*          log_file)
+{
+    return alt_bidirectional_pq(hf,
+                                landmarks,
+                                source_node_id,
+                                target_node_id,
+                                d_ary_pq,
+                                log,
+                                log_file);
+}
+
+path*
+alt_bidirectional_pq(heap_file*     hf,
+                     alt_landmarks* landmarks,
+                     unsigned long  source_node_id,
+                     unsigned long  target_node_id,
+                     pq_type        queue_type,
+                     bool           log,
+                     FILE*          log_file)
+{
+    if (!hf || !landmarks) {
+        // LCOV_EXCL_START
+        printf("ALT - bidirectional: Invalid arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
 
-    dict_ul_d_destroy(heuristic);
-    return result;
+    return bidirectional_a_star_pq(hf,
+                                   alt_heuristic,
+                                   landmarks,
+                                   source_node_id,
+                                   target_node_id,
+                                   landmarks->direction,
+                                   queue_type,
+                                   log,
+                                   log_file);
 }
@@ -94,3 +94,155 @@ bfs(heap_file*    hf,
 
     return create_traversal_result(source_node_id, bfs, parents);
 }
+
+bfs_cursor*
+bfs_cursor_create(heap_file*            hf,
+                  unsigned long         source_node_id,
+                  direction_t           direction,
+                  unsigned long         max_depth,
+                  traversal_edge_filter edge_filter,
+                  traversal_node_filter node_filter,
+                  void*                 filter_data,
+                  bool                  log,
+                  FILE*                 log_file)
+{
+    if (!hf || source_node_id == UNINITIALIZED_LONG || direction > BOTH) {
+        // LCOV_EXCL_START
+        printf("bfs cursor - create: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    bfs_cursor* cursor = malloc(sizeof(bfs_cursor));
+
+    if (!cursor) {
+        // LCOV_EXCL_START
+        printf("bfs cursor - create: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    cursor->hf          = hf;
+    cursor->direction   = direction;
+    cursor->max_depth   = max_depth;
+    cursor->edge_filter = edge_filter;
+    cursor->node_filter = node_filter;
+    cursor->filter_data = filter_data;
+    cursor->queue       = q_ul_create();
+    cursor->depths      = d_ul_ul_create();
+    cursor->parents     = d_ul_ul_create();
+    cursor->pending     = UNINITIALIZED_LONG;
+    cursor->log         = log;
+    cursor->log_file    = log_file;
+
+    queue_ul_push(cursor->queue, source_node_id);
+    dict_ul_ul_insert(cursor->depths, source_node_id, 0);
+    dict_ul_ul_insert(cursor->parents, source_node_id, UNINITIALIZED_LONG);
+
+    return cursor;
+}
+
+void
+bfs_cursor_destroy(bfs_cursor* cursor)
+{
+    if (!cursor) {
+        // LCOV_EXCL_START
+        printf("bfs cursor - destroy: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    queue_ul_destroy(cursor->queue);
+    dict_ul_ul_destroy(cursor->depths);
+    dict_ul_ul_destroy(cursor->parents);
+    free(cursor);
+}
+
+static void
+bfs_cursor_expand(bfs_cursor* cursor, unsigned long node_id)
+{
+    unsigned long depth = dict_ul_ul_get_direct(cursor->depths, node_id);
+
+    if (depth >= cursor->max_depth) {
+        return;
+    }
+
+    array_list_relationship* current_rels =
+          expand(cursor->hf, node_id, cursor->direction, cursor->log);
+    relationship_t* current_rel;
+    unsigned long   temp;
+
+    if (cursor->log) {
+        fprintf(cursor->log_file, "bfs_cursor %s %lu\n", "N", node_id);
+        fflush(cursor->log_file);
+    }
+
+    for (size_t i = 0; i < array_list_relationship_size(current_rels); ++i) {
+        current_rel = array_list_relationship_get(current_rels, i);
+
+        if (cursor->log) {
+            fprintf(cursor->log_file,
+                    "bfs_cursor %s %lu\n",
+                    "R",
+                    current_rel->id);
+            fflush(cursor->log_file);
+        }
+
+        temp = node_id == current_rel->source_node ? current_rel->target_node
+                                                   : current_rel->source_node;
+
+        if (!dict_ul_ul_contains(cursor->depths, temp)
+            && (!cursor->edge_filter
+                || cursor->edge_filter(
+                      current_rel, node_id, cursor->filter_data))) {
+            dict_ul_ul_insert(cursor->depths, temp, depth + 1);
+            dict_ul_ul_insert(cursor->parents, temp, current_rel->id);
+            queue_ul_push(cursor->queue, temp);
+        }
+    }
+
+    array_list_relationship_destroy(current_rels);
+}
+
+bool
+bfs_cursor_next(bfs_cursor* cursor, traversal_step* step)
+{
+    if (!cursor || !step) {
+        // LCOV_EXCL_START
+        printf("bfs cursor - next: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    while (true) {
+        if (cursor->pending != UNINITIALIZED_LONG) {
+            bfs_cursor_expand(cursor, cursor->pending);
+            cursor->pending = UNINITIALIZED_LONG;
+        }
+
+        if (queue_ul_size(cursor->queue) == 0) {
+            return false;
+        }
+
+        cursor->pending = queue_ul_pop(cursor->queue);
+
+        step->node_id  = cursor->pending;
+        step->depth    = dict_ul_ul_get_direct(cursor->depths, cursor->pending);
+        step->distance = (double)step->depth;
+        step->parent_edge =
+              dict_ul_ul_get_direct(cursor->parents, cursor->pending);
+
+        if (!cursor->node_filter
+            || cursor->node_filter(step, cursor->filter_data)) {
+            return true;
+        }
+    }
+}
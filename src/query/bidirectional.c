@@ -0,0 +1,353 @@
+/*!
+ * \file bidirectional.c
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief See \ref bidirectional.h
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "query/bidirectional.h"
+
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "access/relationship.h"
+#include "constants.h"
+#include "data-struct/array_list.h"
+#include "data-struct/htable.h"
+#include "data-struct/priority_queue.h"
+#include "data-struct/set.h"
+#include "query/result_types.h"
+#include "strace.h"
+
+#define FORWARD  (0)
+#define BACKWARD (1)
+
+direction_t
+reverse_direction(direction_t direction)
+{
+    switch (direction) {
+        case OUTGOING:
+            return INCOMING;
+        case INCOMING:
+            return OUTGOING;
+        default:
+            return direction;
+    }
+}
+
+/* The forward potential is p_f(v) = (h(v, t) - h(s, v)) / 2 and the
+ * backward potential is p_r(v) = -p_f(v). As p_f + p_r is constant, the usual
+ * stopping criterion of bidirectional Dijkstra stays valid on the reduced
+ * costs. */
+static double
+potential(heuristic_fn  heuristic,
+          void*         heuristic_data,
+          unsigned long source_node_id,
+          unsigned long target_node_id,
+          unsigned long node_id,
+          int           side)
+{
+    if (!heuristic) {
+        return 0;
+    }
+
+    double p_f = (heuristic(node_id, target_node_id, heuristic_data)
+                  - heuristic(source_node_id, node_id, heuristic_data))
+                 / 2;
+
+    return side == FORWARD ? p_f : -p_f;
+}
+
+static void
+append_half_path(heap_file*     hf,
+                 array_list_ul* edges,
+                 dict_ul_ul*    parents,
+                 unsigned long  meeting_node_id,
+                 unsigned long  end_node_id,
+                 bool           reverse,
+                 bool           log)
+{
+    array_list_ul*  half    = al_ul_create();
+    unsigned long   node_id = meeting_node_id;
+    relationship_t* rel;
+
+    while (node_id != end_node_id) {
+        unsigned long rel_id = dict_ul_ul_get_direct(parents, node_id);
+        array_list_ul_append(half, rel_id);
+
+        rel     = read_relationship(hf, rel_id, log);
+        node_id = rel->target_node == node_id ? rel->source_node
+                                              : rel->target_node;
+        free(rel);
+    }
+
+    size_t n = array_list_ul_size(half);
+    for (size_t i = 0; i < n; ++i) {
+        array_list_ul_append(
+              edges, array_list_ul_get(half, reverse ? n - 1 - i : i));
+    }
+
+    array_list_ul_destroy(half);
+}
+
+static path*
+bidirectional_search(heap_file*    hf,
+                     heuristic_fn  heuristic,
+                     void*         heuristic_data,
+                     unsigned long source_node_id,
+                     unsigned long target_node_id,
+                     direction_t   direction,
+                     pq_type       queue_type,
+                     const char*   name,
+                     bool          log,
+                     FILE*         log_file)
+{
+    if (source_node_id == target_node_id) {
+        return create_path(source_node_id, target_node_id, 0, al_ul_create());
+    }
+
+    dict_ul_d*  distance[2] = { d_ul_d_create(), d_ul_d_create() };
+    dict_ul_ul* parents[2]  = { d_ul_ul_create(), d_ul_ul_create() };
+    set_ul*     settled[2]  = { s_ul_create(), s_ul_create() };
+    direction_t dirs[2]     = { direction, reverse_direction(direction) };
+
+    priority_queue* queue[2] = { priority_queue_create(queue_type),
+                                 priority_queue_create(queue_type) };
+
+    dict_ul_d_insert(distance[FORWARD], source_node_id, 0);
+    priority_queue_push(queue[FORWARD],
+                        potential(heuristic,
+                                  heuristic_data,
+                                  source_node_id,
+                                  target_node_id,
+                                  source_node_id,
+                                  FORWARD),
+                        source_node_id);
+    dict_ul_d_insert(distance[BACKWARD], target_node_id, 0);
+    priority_queue_push(queue[BACKWARD],
+                        potential(heuristic,
+                                  heuristic_data,
+                                  source_node_id,
+                                  target_node_id,
+                                  target_node_id,
+                                  BACKWARD),
+                        target_node_id);
+
+    double        best_dist    = DBL_MAX;
+    unsigned long meeting_node = UNINITIALIZED_LONG;
+
+    array_list_relationship* current_rels;
+    relationship_t*          current_rel;
+    unsigned long            node_id;
+    unsigned long            temp;
+    double                   new_dist;
+    int                      side;
+    double                   min_key[2];
+
+    while (priority_queue_size(queue[FORWARD]) > 0
+           && priority_queue_size(queue[BACKWARD]) > 0) {
+        min_key[FORWARD]  = priority_queue_min_key(queue[FORWARD]);
+        min_key[BACKWARD] = priority_queue_min_key(queue[BACKWARD]);
+
+        if (min_key[FORWARD] + min_key[BACKWARD] >= best_dist) {
+            break;
+        }
+
+        side    = min_key[FORWARD] <= min_key[BACKWARD] ? FORWARD : BACKWARD;
+        node_id = priority_queue_extract_min(queue[side], NULL);
+        set_ul_insert(settled[side], node_id);
+
+        current_rels = expand(hf, node_id, dirs[side], log);
+
+        if (log) {
+            fprintf(log_file, "%s %s %lu\n", name, "N", node_id);
+            fflush(log_file);
+        }
+
+        for (size_t i = 0; i < array_list_relationship_size(current_rels);
+             ++i) {
+            current_rel = array_list_relationship_get(current_rels, i);
+
+            if (log) {
+                fprintf(log_file, "%s %s %lu\n", name, "R", current_rel->id);
+                fflush(log_file);
+            }
+
+            temp = node_id == current_rel->source_node
+                         ? current_rel->target_node
+                         : current_rel->source_node;
+
+            new_dist = dict_ul_d_get_direct(distance[side], node_id)
+                       + current_rel->weight;
+
+            if (!set_ul_contains(settled[side], temp)
+                && (!dict_ul_d_contains(distance[side], temp)
+                    || dict_ul_d_get_direct(distance[side], temp)
+                             > new_dist)) {
+                dict_ul_d_insert(distance[side], temp, new_dist);
+                dict_ul_ul_insert(parents[side], temp, current_rel->id);
+                priority_queue_push(queue[side],
+                                    new_dist
+                                          + potential(heuristic,
+                                                      heuristic_data,
+                                                      source_node_id,
+                                                      target_node_id,
+                                                      temp,
+                                                      side),
+                                    temp);
+            }
+
+            if (dict_ul_d_contains(distance[1 - side], temp)
+                && dict_ul_d_get_direct(distance[side], temp)
+                                 + dict_ul_d_get_direct(distance[1 - side],
+                                                        temp)
+                         < best_dist) {
+                best_dist = dict_ul_d_get_direct(distance[side], temp)
+                            + dict_ul_d_get_direct(distance[1 - side], temp);
+                meeting_node = temp;
+            }
+        }
+
+        array_list_relationship_destroy(current_rels);
+    }
+
+    array_list_ul* edges = al_ul_create();
+
+    if (meeting_node != UNINITIALIZED_LONG) {
+        append_half_path(hf,
+                         edges,
+                         parents[FORWARD],
+                         meeting_node,
+                         source_node_id,
+                         true,
+                         log);
+        append_half_path(hf,
+                         edges,
+                         parents[BACKWARD],
+                         meeting_node,
+                         target_node_id,
+                         false,
+                         log);
+    }
+
+    for (int i = 0; i < 2; ++i) {
+        dict_ul_d_destroy(distance[i]);
+        dict_ul_ul_destroy(parents[i]);
+        set_ul_destroy(settled[i]);
+        priority_queue_destroy(queue[i]);
+    }
+
+    return create_path(source_node_id, target_node_id, best_dist, edges);
+}
+
+path*
+dijkstra_p2p(heap_file*    hf,
+             unsigned long source_node_id,
+             unsigned long target_node_id,
+             direction_t   direction,
+             bool          log,
+             FILE*         log_file)
+{
+    return dijkstra_p2p_pq(hf,
+                           source_node_id,
+                           target_node_id,
+                           direction,
+                           d_ary_pq,
+                           log,
+                           log_file);
+}
+
+path*
+dijkstra_p2p_pq(heap_file*    hf,
+                unsigned long source_node_id,
+                unsigned long target_node_id,
+                direction_t   direction,
+                pq_type       queue_type,
+                bool          log,
+                FILE*         log_file)
+{
+    if (!hf || source_node_id == UNINITIALIZED_LONG
+        || target_node_id == UNINITIALIZED_LONG || queue_type >= invalid_pq) {
+        // LCOV_EXCL_START
+        printf("dijkstra p2p: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    return bidirectional_search(hf,
+                                NULL,
+                                NULL,
+                                source_node_id,
+                                target_node_id,
+                                direction,
+                                queue_type,
+                                "dijkstra_p2p",
+                                log,
+                                log_file);
+}
+
+path*
+bidirectional_a_star(heap_file*    hf,
+                     heuristic_fn  heuristic,
+                     void*         heuristic_data,
+                     unsigned long source_node_id,
+                     unsigned long target_node_id,
+                     direction_t   direction,
+                     bool          log,
+                     FILE*         log_file)
+{
+    return bidirectional_a_star_pq(hf,
+                                   heuristic,
+                                   heuristic_data,
+                                   source_node_id,
+                                   target_node_id,
+                                   direction,
+                                   d_ary_pq,
+                                   log,
+                                   log_file);
+}
+
+path*
+bidirectional_a_star_pq(heap_file*    hf,
+                        heuristic_fn  heuristic,
+                        void*         heuristic_data,
+                        unsigned long source_node_id,
+                        unsigned long target_node_id,
+                        direction_t   direction,
+                        pq_type       queue_type,
+                        bool          log,
+                        FILE*         log_file)
+{
+    // Keys are shifted by the potentials and may be negative, which rules out
+    // the monotone radix heap.
+    if (!hf || !heuristic
+        || source_node_id == UNINITIALIZED_LONG
+        || target_node_id == UNINITIALIZED_LONG || queue_type >= invalid_pq
+        || queue_type == radix_pq) {
+        // LCOV_EXCL_START
+        printf("bidirectional a-star: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    return bidirectional_search(hf,
+                                heuristic,
+                                heuristic_data,
+                                source_node_id,
+                                target_node_id,
+                                direction,
+                                queue_type,
+                                "bidirectional_a_star",
+                                log,
+                                log_file);
+}
@@ -0,0 +1,796 @@
+/*!
+ * \file contraction_hierarchies.c
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief See \ref contraction_hierarchies.h
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "query/contraction_hierarchies.h"
+
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "constants.h"
+#include "data-struct/array_list.h"
+#include "data-struct/d_ary_heap.h"
+#include "query/result_types.h"
+#include "strace.h"
+
+#define FORWARD  (0)
+#define BACKWARD (1)
+
+#define CH_ARC_LIST_INITIAL_CAPACITY (4)
+
+typedef struct
+{
+    ch_arc* arcs;
+    size_t  size;
+    size_t  capacity;
+} ch_arc_list;
+
+/* The remaining graph during the contraction. The head of an arc in the in
+ * list is the tail of the edge, so both lists name the other endpoint. */
+typedef struct
+{
+    unsigned long  n_nodes;
+    ch_arc_list*   out;
+    ch_arc_list*   in;
+    bool*          contracted;
+    unsigned long* n_contracted_neighbours;
+    ch_shortcut*   shortcuts;
+    unsigned long  n_shortcuts;
+    unsigned long  shortcuts_capacity;
+    /* witness search buffers */
+    double*        dist;
+    array_list_ul* touched;
+    d_ary_heap*    queue;
+} ch_builder;
+
+static void
+ch_arc_list_append(ch_arc_list*  list,
+                   unsigned long head,
+                   double        weight,
+                   unsigned long edge)
+{
+    if (list->size == list->capacity) {
+        list->capacity = list->capacity == 0 ? CH_ARC_LIST_INITIAL_CAPACITY
+                                             : 2 * list->capacity;
+        ch_arc* arcs   = realloc(list->arcs, list->capacity * sizeof(ch_arc));
+
+        if (!arcs) {
+            // LCOV_EXCL_START
+            printf("contraction hierarchies - append arc: Failed to allocate "
+                   "memory!\n");
+            print_trace();
+
+            exit(EXIT_FAILURE);
+            // LCOV_EXCL_STOP
+        }
+        list->arcs = arcs;
+    }
+
+    list->arcs[list->size].head   = head;
+    list->arcs[list->size].weight = weight;
+    list->arcs[list->size].edge   = edge;
+    list->size++;
+}
+
+static ch_arc*
+ch_arc_list_find(ch_arc_list* list, unsigned long head)
+{
+    for (size_t i = 0; i < list->size; ++i) {
+        if (list->arcs[i].head == head) {
+            return &list->arcs[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* Adds the cheaper of parallel edges between the same endpoints only. The
+ * rows of the snapshot are sorted by neighbour, so parallel edges are
+ * adjacent. With direction BOTH the outgoing and incoming rows are merged. */
+static void
+ch_builder_add_row(ch_builder*      builder,
+                   const csr_graph* graph,
+                   unsigned long    node,
+                   direction_t      direction)
+{
+    const csr_edge* rows[2];
+    size_t          len[2];
+    size_t          pos[2] = { 0, 0 };
+
+    for (direction_t d = OUTGOING; d <= INCOMING; ++d) {
+        bool used = direction == BOTH || direction == d;
+        rows[d]   = graph->edges[d] + graph->offsets[d][node];
+        len[d]    = used ? graph->offsets[d][node + 1] - graph->offsets[d][node]
+                         : 0;
+    }
+
+    const csr_edge* best;
+    int             side;
+    while (pos[OUTGOING] < len[OUTGOING] || pos[INCOMING] < len[INCOMING]) {
+        side = pos[INCOMING] >= len[INCOMING]
+                     || (pos[OUTGOING] < len[OUTGOING]
+                         && rows[OUTGOING][pos[OUTGOING]].neighbour
+                                  <= rows[INCOMING][pos[INCOMING]].neighbour)
+                     ? OUTGOING
+                     : INCOMING;
+        best = &rows[side][pos[side]++];
+
+        for (int d = OUTGOING; d <= INCOMING; ++d) {
+            while (pos[d] < len[d]
+                   && rows[d][pos[d]].neighbour == best->neighbour) {
+                if (rows[d][pos[d]].weight < best->weight) {
+                    best = &rows[d][pos[d]];
+                }
+                pos[d]++;
+            }
+        }
+
+        if (best->neighbour == node) {
+            continue;
+        }
+
+        ch_arc_list_append(
+              &builder->out[node], best->neighbour, best->weight, best->rel_id);
+        ch_arc_list_append(
+              &builder->in[best->neighbour], node, best->weight, best->rel_id);
+    }
+}
+
+static ch_builder*
+ch_builder_create(const csr_graph* graph, direction_t direction)
+{
+    ch_builder* builder = malloc(sizeof(ch_builder));
+
+    if (!builder) {
+        // LCOV_EXCL_START
+        printf("contraction hierarchies - create builder: Failed to allocate "
+               "memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    builder->n_nodes    = graph->n_nodes;
+    builder->out        = calloc(graph->n_nodes, sizeof(ch_arc_list));
+    builder->in         = calloc(graph->n_nodes, sizeof(ch_arc_list));
+    builder->contracted = calloc(graph->n_nodes, sizeof(bool));
+    builder->n_contracted_neighbours =
+          calloc(graph->n_nodes, sizeof(unsigned long));
+    builder->n_shortcuts        = 0;
+    builder->shortcuts_capacity = graph->n_nodes + 1;
+    builder->shortcuts =
+          malloc(builder->shortcuts_capacity * sizeof(ch_shortcut));
+    builder->dist    = malloc(graph->n_nodes * sizeof(double));
+    builder->touched = al_ul_create();
+    builder->queue   = d_ary_heap_create();
+
+    if ((graph->n_nodes > 0
+         && (!builder->out || !builder->in || !builder->contracted
+             || !builder->n_contracted_neighbours || !builder->dist))
+        || !builder->shortcuts) {
+        // LCOV_EXCL_START
+        printf("contraction hierarchies - create builder: Failed to allocate "
+               "memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    for (size_t i = 0; i < graph->n_nodes; ++i) {
+        builder->dist[i] = DBL_MAX;
+    }
+
+    for (size_t i = 0; i < graph->n_nodes; ++i) {
+        ch_builder_add_row(builder, graph, i, direction);
+    }
+
+    return builder;
+}
+
+static void
+ch_builder_destroy(ch_builder* builder)
+{
+    for (size_t i = 0; i < builder->n_nodes; ++i) {
+        free(builder->out[i].arcs);
+        free(builder->in[i].arcs);
+    }
+
+    free(builder->out);
+    free(builder->in);
+    free(builder->contracted);
+    free(builder->n_contracted_neighbours);
+    free(builder->dist);
+    array_list_ul_destroy(builder->touched);
+    d_ary_heap_destroy(builder->queue);
+    free(builder);
+}
+
+/* Runs Dijkstra's algorithm from source on the remaining graph without the
+ * excluded node. The distances stay in builder->dist until the next search. */
+static void
+ch_witness_search(ch_builder*   builder,
+                  unsigned long source,
+                  unsigned long excluded,
+                  double        max_dist)
+{
+    for (size_t i = 0; i < array_list_ul_size(builder->touched); ++i) {
+        builder->dist[array_list_ul_get(builder->touched, i)] = DBL_MAX;
+    }
+    array_list_ul_destroy(builder->touched);
+    builder->touched = al_ul_create();
+
+    builder->dist[source] = 0;
+    array_list_ul_append(builder->touched, source);
+    d_ary_heap_insert(builder->queue, 0, source);
+
+    size_t        n_settled = 0;
+    unsigned long node;
+    double        node_dist;
+    ch_arc*       arc;
+    while (d_ary_heap_size(builder->queue) > 0) {
+        node = d_ary_heap_extract_min(builder->queue, &node_dist);
+
+        if (node_dist > max_dist || ++n_settled > CH_WITNESS_SETTLE_LIMIT) {
+            break;
+        }
+
+        for (size_t i = 0; i < builder->out[node].size; ++i) {
+            arc = &builder->out[node].arcs[i];
+
+            if (arc->head == excluded || builder->contracted[arc->head]
+                || node_dist + arc->weight >= builder->dist[arc->head]) {
+                continue;
+            }
+
+            if (builder->dist[arc->head] == DBL_MAX) {
+                array_list_ul_append(builder->touched, arc->head);
+                d_ary_heap_insert(
+                      builder->queue, node_dist + arc->weight, arc->head);
+            } else {
+                d_ary_heap_decrease_key(
+                      builder->queue, arc->head, node_dist + arc->weight);
+            }
+            builder->dist[arc->head] = node_dist + arc->weight;
+        }
+    }
+
+    while (d_ary_heap_size(builder->queue) > 0) {
+        d_ary_heap_extract_min(builder->queue, NULL);
+    }
+}
+
+static void
+ch_add_shortcut(ch_builder*   builder,
+                unsigned long from,
+                unsigned long to,
+                double        weight,
+                unsigned long first,
+                unsigned long second)
+{
+    ch_arc* out_arc = ch_arc_list_find(&builder->out[from], to);
+
+    if (out_arc && out_arc->weight <= weight) {
+        return;
+    }
+
+    if (builder->n_shortcuts == builder->shortcuts_capacity) {
+        builder->shortcuts_capacity *= 2;
+        ch_shortcut* shortcuts =
+              realloc(builder->shortcuts,
+                      builder->shortcuts_capacity * sizeof(ch_shortcut));
+
+        if (!shortcuts) {
+            // LCOV_EXCL_START
+            printf("contraction hierarchies - add shortcut: Failed to "
+                   "allocate memory!\n");
+            print_trace();
+
+            exit(EXIT_FAILURE);
+            // LCOV_EXCL_STOP
+        }
+        builder->shortcuts = shortcuts;
+    }
+
+    builder->shortcuts[builder->n_shortcuts].first  = first;
+    builder->shortcuts[builder->n_shortcuts].second = second;
+    unsigned long edge = CH_SHORTCUT_BIT | builder->n_shortcuts++;
+
+    if (out_arc) {
+        // Parallel edges are never added, so the edge is unique in both lists
+        ch_arc* in_arc  = ch_arc_list_find(&builder->in[to], from);
+        out_arc->weight = weight;
+        out_arc->edge   = edge;
+        in_arc->weight  = weight;
+        in_arc->edge    = edge;
+    } else {
+        ch_arc_list_append(&builder->out[from], to, weight, edge);
+        ch_arc_list_append(&builder->in[to], from, weight, edge);
+    }
+}
+
+/* Returns the number of shortcuts that contracting the node requires and
+ * inserts them unless simulate is set. */
+static unsigned long
+ch_contract(ch_builder* builder, unsigned long node, bool simulate)
+{
+    ch_arc_list*  in          = &builder->in[node];
+    ch_arc_list*  out         = &builder->out[node];
+    unsigned long n_shortcuts = 0;
+
+    double  max_out;
+    ch_arc* in_arc;
+    ch_arc* out_arc;
+    for (size_t i = 0; i < in->size; ++i) {
+        in_arc = &in->arcs[i];
+
+        if (builder->contracted[in_arc->head]) {
+            continue;
+        }
+
+        max_out = -1;
+        for (size_t j = 0; j < out->size; ++j) {
+            if (!builder->contracted[out->arcs[j].head]
+                && out->arcs[j].head != in_arc->head
+                && out->arcs[j].weight > max_out) {
+                max_out = out->arcs[j].weight;
+            }
+        }
+
+        if (max_out < 0) {
+            continue;
+        }
+
+        ch_witness_search(
+              builder, in_arc->head, node, in_arc->weight + max_out);
+
+        for (size_t j = 0; j < out->size; ++j) {
+            out_arc = &out->arcs[j];
+
+            if (builder->contracted[out_arc->head]
+                || out_arc->head == in_arc->head
+                || builder->dist[out_arc->head]
+                         <= in_arc->weight + out_arc->weight) {
+                continue;
+            }
+
+            n_shortcuts++;
+            if (!simulate) {
+                ch_add_shortcut(builder,
+                                in_arc->head,
+                                out_arc->head,
+                                in_arc->weight + out_arc->weight,
+                                in_arc->edge,
+                                out_arc->edge);
+            }
+        }
+    }
+
+    return n_shortcuts;
+}
+
+static double
+ch_priority(ch_builder* builder, unsigned long node)
+{
+    unsigned long n_edges = 0;
+
+    for (size_t i = 0; i < builder->in[node].size; ++i) {
+        n_edges += !builder->contracted[builder->in[node].arcs[i].head];
+    }
+
+    for (size_t i = 0; i < builder->out[node].size; ++i) {
+        n_edges += !builder->contracted[builder->out[node].arcs[i].head];
+    }
+
+    return (double)ch_contract(builder, node, true) - (double)n_edges
+           + (double)builder->n_contracted_neighbours[node];
+}
+
+static void
+ch_build_upward_graphs(contraction_hierarchy* ch, ch_builder* builder)
+{
+    for (size_t side = FORWARD; side <= BACKWARD; ++side) {
+        ch->up_offsets[side] = calloc(ch->n_nodes + 1, sizeof(unsigned long));
+
+        if (!ch->up_offsets[side]) {
+            // LCOV_EXCL_START
+            printf("contraction hierarchies - upward graph: Failed to "
+                   "allocate memory!\n");
+            print_trace();
+
+            exit(EXIT_FAILURE);
+            // LCOV_EXCL_STOP
+        }
+    }
+
+    unsigned long head;
+    for (size_t i = 0; i < ch->n_nodes; ++i) {
+        for (size_t j = 0; j < builder->out[i].size; ++j) {
+            head = builder->out[i].arcs[j].head;
+
+            if (ch->rank[i] < ch->rank[head]) {
+                ch->up_offsets[FORWARD][i + 1]++;
+            } else {
+                ch->up_offsets[BACKWARD][head + 1]++;
+            }
+        }
+    }
+
+    for (size_t side = FORWARD; side <= BACKWARD; ++side) {
+        for (size_t i = 0; i < ch->n_nodes; ++i) {
+            ch->up_offsets[side][i + 1] += ch->up_offsets[side][i];
+        }
+
+        ch->up_arcs[side] =
+              malloc((ch->up_offsets[side][ch->n_nodes] + 1) * sizeof(ch_arc));
+
+        if (!ch->up_arcs[side]) {
+            // LCOV_EXCL_START
+            printf("contraction hierarchies - upward graph: Failed to "
+                   "allocate memory!\n");
+            print_trace();
+
+            exit(EXIT_FAILURE);
+            // LCOV_EXCL_STOP
+        }
+    }
+
+    // Use the offsets of the successors as insert positions and restore them
+    // afterwards by shifting.
+    ch_arc* arc;
+    ch_arc* up_arc;
+    for (size_t i = 0; i < ch->n_nodes; ++i) {
+        for (size_t j = 0; j < builder->out[i].size; ++j) {
+            arc = &builder->out[i].arcs[j];
+
+            if (ch->rank[i] < ch->rank[arc->head]) {
+                up_arc  = &ch->up_arcs[FORWARD][ch->up_offsets[FORWARD][i]++];
+                *up_arc = *arc;
+            } else {
+                up_arc =
+                      &ch->up_arcs[BACKWARD]
+                                  [ch->up_offsets[BACKWARD][arc->head]++];
+                up_arc->head   = i;
+                up_arc->weight = arc->weight;
+                up_arc->edge   = arc->edge;
+            }
+        }
+    }
+
+    for (size_t side = FORWARD; side <= BACKWARD; ++side) {
+        memmove(ch->up_offsets[side] + 1,
+                ch->up_offsets[side],
+                ch->n_nodes * sizeof(unsigned long));
+        ch->up_offsets[side][0] = 0;
+    }
+}
+
+contraction_hierarchy*
+ch_preprocess_csr(const csr_graph* graph, direction_t direction)
+{
+    if (!graph || direction > BOTH) {
+        // LCOV_EXCL_START
+        printf("contraction hierarchies - preprocess: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    contraction_hierarchy* ch = malloc(sizeof(contraction_hierarchy));
+
+    if (!ch) {
+        // LCOV_EXCL_START
+        printf("contraction hierarchies - preprocess: Failed to allocate "
+               "memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    ch->direction   = direction;
+    ch->n_nodes     = graph->n_nodes;
+    ch->index_bound = graph->index_bound;
+    ch->node_ids    = malloc(graph->n_nodes * sizeof(unsigned long));
+    ch->index_of    = malloc(graph->index_bound * sizeof(unsigned long));
+    ch->rank        = malloc(graph->n_nodes * sizeof(unsigned long));
+
+    for (size_t side = FORWARD; side <= BACKWARD; ++side) {
+        ch->query_dist[side]   = malloc(graph->n_nodes * sizeof(double));
+        ch->query_parent[side] = malloc(graph->n_nodes * sizeof(unsigned long));
+        ch->query_edge[side]   = malloc(graph->n_nodes * sizeof(unsigned long));
+        ch->query_queue[side]  = d_ary_heap_create();
+
+        if (graph->n_nodes > 0
+            && (!ch->query_dist[side] || !ch->query_parent[side]
+                || !ch->query_edge[side])) {
+            // LCOV_EXCL_START
+            printf("contraction hierarchies - preprocess: Failed to allocate "
+                   "memory!\n");
+            print_trace();
+
+            exit(EXIT_FAILURE);
+            // LCOV_EXCL_STOP
+        }
+
+        for (size_t i = 0; i < graph->n_nodes; ++i) {
+            ch->query_dist[side][i] = DBL_MAX;
+        }
+    }
+
+    if ((graph->n_nodes > 0 && (!ch->node_ids || !ch->rank))
+        || (graph->index_bound > 0 && !ch->index_of)) {
+        // LCOV_EXCL_START
+        printf("contraction hierarchies - preprocess: Failed to allocate "
+               "memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    memcpy(ch->node_ids,
+           graph->node_ids,
+           graph->n_nodes * sizeof(unsigned long));
+    memcpy(ch->index_of,
+           graph->index_of,
+           graph->index_bound * sizeof(unsigned long));
+
+    // Contracting with INCOMING is contracting the reversed graph, which the
+    // builder reads from the incoming rows.
+    ch_builder* builder = ch_builder_create(graph, direction);
+    d_ary_heap* order   = d_ary_heap_create();
+
+    for (size_t i = 0; i < graph->n_nodes; ++i) {
+        d_ary_heap_insert(order, ch_priority(builder, i), i);
+    }
+
+    unsigned long next_rank = 0;
+    unsigned long node;
+    double        priority;
+    while (d_ary_heap_size(order) > 0) {
+        node     = d_ary_heap_extract_min(order, NULL);
+        priority = ch_priority(builder, node);
+
+        // Lazy update: Contracting the neighbours may have changed the
+        // priority. Postpone the node if it is not the minimum anymore.
+        if (d_ary_heap_size(order) > 0
+            && priority > d_ary_heap_min_key(order)) {
+            d_ary_heap_insert(order, priority, node);
+            continue;
+        }
+
+        ch_contract(builder, node, false);
+        builder->contracted[node] = true;
+        ch->rank[node]            = next_rank++;
+
+        for (size_t i = 0; i < builder->in[node].size; ++i) {
+            builder->n_contracted_neighbours[builder->in[node].arcs[i].head]++;
+        }
+
+        for (size_t i = 0; i < builder->out[node].size; ++i) {
+            builder->n_contracted_neighbours[builder->out[node].arcs[i].head]++;
+        }
+    }
+
+    d_ary_heap_destroy(order);
+
+    ch_build_upward_graphs(ch, builder);
+
+    ch->shortcuts   = builder->shortcuts;
+    ch->n_shortcuts = builder->n_shortcuts;
+    ch_builder_destroy(builder);
+
+    return ch;
+}
+
+contraction_hierarchy*
+ch_preprocess(heap_file* hf, direction_t direction, bool log)
+{
+    if (!hf || direction > BOTH) {
+        // LCOV_EXCL_START
+        printf("contraction hierarchies - preprocess: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    csr_graph*             graph = csr_graph_create(hf, log);
+    contraction_hierarchy* ch    = ch_preprocess_csr(graph, direction);
+    csr_graph_destroy(graph);
+
+    return ch;
+}
+
+void
+ch_destroy(contraction_hierarchy* ch)
+{
+    if (!ch) {
+        // LCOV_EXCL_START
+        printf("contraction hierarchies - destroy: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    for (size_t side = FORWARD; side <= BACKWARD; ++side) {
+        free(ch->up_offsets[side]);
+        free(ch->up_arcs[side]);
+        free(ch->query_dist[side]);
+        free(ch->query_parent[side]);
+        free(ch->query_edge[side]);
+        d_ary_heap_destroy(ch->query_queue[side]);
+    }
+
+    free(ch->node_ids);
+    free(ch->index_of);
+    free(ch->rank);
+    free(ch->shortcuts);
+    free(ch);
+}
+
+static void
+ch_unpack(contraction_hierarchy* ch, unsigned long edge, array_list_ul* edges)
+{
+    if (edge & CH_SHORTCUT_BIT) {
+        ch_shortcut* shortcut = &ch->shortcuts[edge & ~CH_SHORTCUT_BIT];
+        ch_unpack(ch, shortcut->first, edges);
+        ch_unpack(ch, shortcut->second, edges);
+    } else {
+        array_list_ul_append(edges, edge);
+    }
+}
+
+static unsigned long
+ch_index(contraction_hierarchy* ch, unsigned long node_id)
+{
+    if (node_id == UNINITIALIZED_LONG
+        || node_id / NUM_SLOTS_PER_NODE >= ch->index_bound) {
+        return UNINITIALIZED_LONG;
+    }
+
+    return ch->index_of[node_id / NUM_SLOTS_PER_NODE];
+}
+
+path*
+ch_query(contraction_hierarchy* ch,
+         unsigned long          source_node_id,
+         unsigned long          target_node_id,
+         bool                   log,
+         FILE*                  log_file)
+{
+    unsigned long ends[2] = { ch ? ch_index(ch, source_node_id)
+                                 : UNINITIALIZED_LONG,
+                              ch ? ch_index(ch, target_node_id)
+                                 : UNINITIALIZED_LONG };
+
+    if (!ch || ends[FORWARD] == UNINITIALIZED_LONG
+        || ends[BACKWARD] == UNINITIALIZED_LONG) {
+        // LCOV_EXCL_START
+        printf("contraction hierarchies - query: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    if (source_node_id == target_node_id) {
+        return create_path(source_node_id, target_node_id, 0, al_ul_create());
+    }
+
+    array_list_ul* touched[2] = { al_ul_create(), al_ul_create() };
+    bool           done[2]    = { false, false };
+    double         best_dist  = DBL_MAX;
+    unsigned long  meeting    = UNINITIALIZED_LONG;
+
+    for (size_t side = FORWARD; side <= BACKWARD; ++side) {
+        ch->query_dist[side][ends[side]] = 0;
+        array_list_ul_append(touched[side], ends[side]);
+        d_ary_heap_insert(ch->query_queue[side], 0, ends[side]);
+    }
+
+    unsigned long node;
+    double        node_dist;
+    double        new_dist;
+    ch_arc*       arc;
+    while (!done[FORWARD] || !done[BACKWARD]) {
+        for (size_t side = FORWARD; side <= BACKWARD; ++side) {
+            if (done[side]) {
+                continue;
+            }
+
+            // Nodes settled later are at least as far away as the best path
+            if (d_ary_heap_size(ch->query_queue[side]) == 0
+                || d_ary_heap_min_key(ch->query_queue[side]) >= best_dist) {
+                done[side] = true;
+                continue;
+            }
+
+            node = d_ary_heap_extract_min(ch->query_queue[side], &node_dist);
+
+            if (log) {
+                fprintf(log_file, "ch_query %s %lu\n", "N", ch->node_ids[node]);
+                fflush(log_file);
+            }
+
+            if (ch->query_dist[1 - side][node] != DBL_MAX
+                && node_dist + ch->query_dist[1 - side][node] < best_dist) {
+                best_dist = node_dist + ch->query_dist[1 - side][node];
+                meeting   = node;
+            }
+
+            for (size_t i = ch->up_offsets[side][node];
+                 i < ch->up_offsets[side][node + 1];
+                 ++i) {
+                arc      = &ch->up_arcs[side][i];
+                new_dist = node_dist + arc->weight;
+
+                if (new_dist >= ch->query_dist[side][arc->head]) {
+                    continue;
+                }
+
+                if (ch->query_dist[side][arc->head] == DBL_MAX) {
+                    array_list_ul_append(touched[side], arc->head);
+                    d_ary_heap_insert(
+                          ch->query_queue[side], new_dist, arc->head);
+                } else {
+                    d_ary_heap_decrease_key(
+                          ch->query_queue[side], arc->head, new_dist);
+                }
+
+                ch->query_dist[side][arc->head]   = new_dist;
+                ch->query_parent[side][arc->head] = node;
+                ch->query_edge[side][arc->head]   = arc->edge;
+            }
+        }
+    }
+
+    array_list_ul* edges = al_ul_create();
+
+    if (meeting != UNINITIALIZED_LONG) {
+        array_list_ul* up_edges = al_ul_create();
+
+        for (node = meeting; node != ends[FORWARD];
+             node = ch->query_parent[FORWARD][node]) {
+            array_list_ul_append(up_edges, ch->query_edge[FORWARD][node]);
+        }
+
+        for (size_t i = array_list_ul_size(up_edges); i > 0; --i) {
+            ch_unpack(ch, array_list_ul_get(up_edges, i - 1), edges);
+        }
+        array_list_ul_destroy(up_edges);
+
+        for (node = meeting; node != ends[BACKWARD];
+             node = ch->query_parent[BACKWARD][node]) {
+            ch_unpack(ch, ch->query_edge[BACKWARD][node], edges);
+        }
+    }
+
+    for (size_t side = FORWARD; side <= BACKWARD; ++side) {
+        while (d_ary_heap_size(ch->query_queue[side]) > 0) {
+            d_ary_heap_extract_min(ch->query_queue[side], NULL);
+        }
+
+        for (size_t i = 0; i < array_list_ul_size(touched[side]); ++i) {
+            ch->query_dist[side][array_list_ul_get(touched[side], i)] =
+                  DBL_MAX;
+        }
+        array_list_ul_destroy(touched[side]);
+    }
+
+    return create_path(source_node_id, target_node_id, best_dist, edges);
+}
@@ -12,7 +12,6 @@
  */
 #include "query/degree.h"
 
-#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -44,25 +43,7 @@ get_degree(heap_file*    hf,
         }
     }
 
-    array_list_relationship* rels   = expand(hf, node_id, direction, log);
-    size_t                   degree = array_list_relationship_size(rels);
-
-    if (log) {
-        if (log_file) {
-            for (size_t i = 0; i < array_list_relationship_size(rels); ++i) {
-
-                fprintf(log_file,
-                        "get_degree %s %lu\n",
-                        "R ",
-                        array_list_relationship_get(rels, i)->id);
-                fflush(log_file);
-            }
-        }
-    }
-
-    array_list_relationship_destroy(rels);
-
-    return degree;
+    return node_degree(hf, node_id, direction, log);
 }
 
 float
@@ -77,44 +58,22 @@ get_avg_degree(heap_file* hf, direction_t direction, bool log, FILE* log_file)
         // LCOV_EXCL_STOP
     }
 
-    array_list_node* nodes        = get_nodes(hf, log);
-    size_t           num_nodes    = array_list_node_size(nodes);
-    size_t           total_degree = 0;
-
-    array_list_relationship* rels;
-
-    for (size_t i = 0; i < num_nodes; ++i) {
-        rels = expand(hf, array_list_node_get(nodes, i)->id, direction, log);
-        total_degree += array_list_relationship_size(rels);
+    // The aggregates are cached and read no records, there is nothing to log
+    (void)log;
+    (void)log_file;
 
-        if (log) {
-            if (log_file) {
-                fprintf(log_file, "get_avg_degree %s %lu\n", "N ", i);
-                fflush(log_file);
+    // Each relationship adds one to the out and one to the in degree, a self
+    // loop only adds one to the degree in both directions.
+    size_t total_degree = direction == BOTH ? 2 * hf->n_rels - hf->n_self_loops
+                                            : hf->n_rels;
 
-                for (size_t i = 0; i < array_list_relationship_size(rels);
-                     ++i) {
-                    fprintf(log_file,
-                            "get_avg_degree %s %lu\n",
-                            "R ",
-                            array_list_relationship_get(rels, i)->id);
-
-                    fflush(log_file);
-                }
-            }
-        }
-        array_list_relationship_destroy(rels);
-    }
-
-    array_list_node_destroy(nodes);
-
-    return ((float)total_degree) / ((float)num_nodes);
+    return ((float)total_degree) / ((float)hf->n_nodes);
 }
 
 size_t
 get_min_degree(heap_file* hf, direction_t direction, bool log, FILE* log_file)
 {
-    if (!hf) {
+    if (!hf || direction > BOTH) {
         // LCOV_EXCL_START
         printf("degree - get min degree: Invalid Arguments!\n");
         print_trace();
@@ -123,28 +82,16 @@ get_min_degree(heap_file* hf, direction_t direction, bool log, FILE* log_file)
         // LCOV_EXCL_STOP
     }
 
-    array_list_node* nodes      = get_nodes(hf, log);
-    size_t           num_nodes  = array_list_node_size(nodes);
-    size_t           min_degree = SIZE_MAX;
-    size_t           degree;
+    (void)log;
+    (void)log_file;
 
-    for (size_t i = 0; i < num_nodes; ++i) {
-        degree = get_degree(
-              hf, array_list_node_get(nodes, i)->id, direction, log, log_file);
-
-        if (degree < min_degree) {
-            min_degree = degree;
-        }
-    }
-    array_list_node_destroy(nodes);
-
-    return min_degree;
+    return hf->degree_hist[direction].min;
 }
 
 size_t
 get_max_degree(heap_file* hf, direction_t direction, bool log, FILE* log_file)
 {
-    if (!hf) {
+    if (!hf || direction > BOTH) {
         // LCOV_EXCL_START
         printf("degree - get max degree: Invalid Arguments!\n");
         print_trace();
@@ -153,21 +100,40 @@ get_max_degree(heap_file* hf, direction_t direction, bool log, FILE* log_file)
         // LCOV_EXCL_STOP
     }
 
-    array_list_node* nodes      = get_nodes(hf, log);
-    size_t           num_nodes  = array_list_node_size(nodes);
-    size_t           max_degree = 0;
-    size_t           degree;
+    (void)log;
+    (void)log_file;
 
-    for (size_t i = 0; i < num_nodes; ++i) {
-        degree = get_degree(
-              hf, array_list_node_get(nodes, i)->id, direction, log, log_file);
+    return hf->degree_hist[direction].max;
+}
 
-        if (degree > max_degree) {
-            max_degree = degree;
-        }
+array_list_ul*
+get_degree_histogram(heap_file*  hf,
+                     direction_t direction,
+                     bool        log,
+                     FILE*       log_file)
+{
+    if (!hf || direction > BOTH) {
+        // LCOV_EXCL_START
+        printf("degree - get degree histogram: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    (void)log;
+    (void)log_file;
+
+    array_list_ul*          result = al_ul_create();
+    const degree_histogram* hist   = &hf->degree_hist[direction];
+
+    if (hf->n_nodes == 0) {
+        return result;
     }
 
-    array_list_node_destroy(nodes);
+    for (unsigned long i = 0; i <= hist->max; ++i) {
+        array_list_ul_append(result, hist->counts[i]);
+    }
 
-    return max_degree;
+    return result;
 }
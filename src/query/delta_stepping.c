@@ -0,0 +1,441 @@
+/*!
+ * \file delta_stepping.c
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief See \ref delta_stepping.h
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "query/delta_stepping.h"
+
+#include <float.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "constants.h"
+#include "data-struct/array_list.h"
+#include "data-struct/htable.h"
+#include "query/result_types.h"
+#include "strace.h"
+
+/* Phases with fewer nodes per thread are relaxed on the calling thread, as
+ * spawning threads would cost more than the relaxation itself. */
+#define DELTA_STEPPING_MIN_NODES_PER_THREAD (256)
+
+typedef struct
+{
+    const csr_graph* graph;
+    direction_t      direction;
+    double           delta;
+    bool             light;
+    _Atomic double*  dist;
+    array_list_ul*   frontier;
+    size_t           begin;
+    size_t           end;
+    array_list_ul*   updated;
+} delta_stepping_task;
+
+static bool
+relax(_Atomic double* dist, unsigned long node_idx, double new_dist)
+{
+    double old_dist =
+          atomic_load_explicit(&dist[node_idx], memory_order_relaxed);
+
+    while (new_dist < old_dist) {
+        if (atomic_compare_exchange_weak_explicit(&dist[node_idx],
+                                                  &old_dist,
+                                                  new_dist,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void*
+relax_range(void* arg)
+{
+    delta_stepping_task* task  = arg;
+    const csr_graph*     graph = task->graph;
+
+    unsigned long   node_idx;
+    double          node_dist;
+    const csr_edge* edge;
+    for (size_t i = task->begin; i < task->end; ++i) {
+        node_idx  = array_list_ul_get(task->frontier, i);
+        node_dist = atomic_load_explicit(&task->dist[node_idx],
+                                         memory_order_relaxed);
+
+        for (direction_t d = OUTGOING; d <= INCOMING; ++d) {
+            if (task->direction != BOTH && task->direction != d) {
+                continue;
+            }
+
+            for (size_t j = graph->offsets[d][node_idx];
+                 j < graph->offsets[d][node_idx + 1];
+                 ++j) {
+                edge = &graph->edges[d][j];
+
+                if ((edge->weight <= task->delta) != task->light) {
+                    continue;
+                }
+
+                if (relax(task->dist,
+                          edge->neighbour,
+                          node_dist + edge->weight)) {
+                    array_list_ul_append(task->updated, edge->neighbour);
+                }
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/* Relaxes the light or heavy edges of all nodes in the frontier and collects
+ * the nodes whose distance decreased in one list per thread. */
+static void
+relax_frontier(delta_stepping_task* tasks,
+               array_list_ul*       frontier,
+               bool                 light)
+{
+    size_t n_nodes   = array_list_ul_size(frontier);
+    size_t n_threads = n_nodes / DELTA_STEPPING_MIN_NODES_PER_THREAD;
+
+    if (n_threads > N_THREADS) {
+        n_threads = N_THREADS;
+    } else if (n_threads == 0) {
+        n_threads = 1;
+    }
+
+    for (size_t t = 0; t < N_THREADS; ++t) {
+        tasks[t].light    = light;
+        tasks[t].frontier = frontier;
+        tasks[t].begin    = t < n_threads ? n_nodes * t / n_threads : 0;
+        tasks[t].end      = t < n_threads ? n_nodes * (t + 1) / n_threads : 0;
+    }
+
+    pthread_t threads[n_threads];
+    for (size_t t = 1; t < n_threads; ++t) {
+        if (pthread_create(&threads[t], NULL, relax_range, &tasks[t]) != 0) {
+            // LCOV_EXCL_START
+            printf("delta stepping - relax: Failed to create thread!\n");
+            print_trace();
+
+            exit(EXIT_FAILURE);
+            // LCOV_EXCL_STOP
+        }
+    }
+
+    relax_range(&tasks[0]);
+
+    for (size_t t = 1; t < n_threads; ++t) {
+        pthread_join(threads[t], NULL);
+    }
+}
+
+/* Moves the updated nodes of every thread into the bucket of their new
+ * distance. Nodes may end up in a bucket several times or in a bucket they
+ * already left, which is filtered when the bucket is processed. */
+static size_t
+distribute(delta_stepping_task* tasks,
+           array_list_ul**      buckets,
+           size_t               n_buckets,
+           double               delta)
+{
+    size_t        n_inserted = 0;
+    unsigned long node_idx;
+    size_t        bucket;
+    for (size_t t = 0; t < N_THREADS; ++t) {
+        if (array_list_ul_size(tasks[t].updated) == 0) {
+            continue;
+        }
+
+        for (size_t i = 0; i < array_list_ul_size(tasks[t].updated); ++i) {
+            node_idx = array_list_ul_get(tasks[t].updated, i);
+            bucket   = (size_t)(atomic_load_explicit(&tasks[t].dist[node_idx],
+                                                   memory_order_relaxed)
+                              / delta);
+            array_list_ul_append(buckets[bucket % n_buckets], node_idx);
+            n_inserted++;
+        }
+        array_list_ul_destroy(tasks[t].updated);
+        tasks[t].updated = al_ul_create();
+    }
+
+    return n_inserted;
+}
+
+/* All distances are final, so every reached node has an edge (u, v) with
+ * dist[u] + w = dist[v]. A BFS over these tight edges from the source yields a
+ * shortest path tree, also when zero weights would allow cyclic choices. */
+static dict_ul_ul*
+build_pred_edges(const csr_graph* graph,
+                 const double*    dist,
+                 unsigned long    source_idx,
+                 direction_t      direction)
+{
+    dict_ul_ul* pred_edges = d_ul_ul_create();
+    bool*       visited    = calloc(graph->n_nodes, sizeof(bool));
+    size_t*     queue      = malloc(graph->n_nodes * sizeof(size_t));
+
+    if (!visited || !queue) {
+        // LCOV_EXCL_START
+        printf("delta stepping - preds: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    size_t head = 0;
+    size_t tail = 0;
+
+    queue[tail++]       = source_idx;
+    visited[source_idx] = true;
+
+    unsigned long   node_idx;
+    const csr_edge* edge;
+    while (head < tail) {
+        node_idx = queue[head++];
+
+        for (direction_t d = OUTGOING; d <= INCOMING; ++d) {
+            if (direction != BOTH && direction != d) {
+                continue;
+            }
+
+            for (size_t j = graph->offsets[d][node_idx];
+                 j < graph->offsets[d][node_idx + 1];
+                 ++j) {
+                edge = &graph->edges[d][j];
+
+                if (!visited[edge->neighbour]
+                    && dist[node_idx] + edge->weight
+                             == dist[edge->neighbour]) {
+                    visited[edge->neighbour] = true;
+                    queue[tail++]            = edge->neighbour;
+                    dict_ul_ul_insert(pred_edges,
+                                      graph->node_ids[edge->neighbour],
+                                      edge->rel_id);
+                }
+            }
+        }
+    }
+
+    free(visited);
+    free(queue);
+
+    return pred_edges;
+}
+
+static double
+max_weight(const csr_graph* graph)
+{
+    double max = 0;
+    for (size_t i = 0; i < graph->n_rels; ++i) {
+        if (graph->edges[OUTGOING][i].weight > max) {
+            max = graph->edges[OUTGOING][i].weight;
+        }
+    }
+
+    return max;
+}
+
+sssp_result*
+delta_stepping_csr(const csr_graph* graph,
+                   unsigned long    source_node_id,
+                   direction_t      direction,
+                   double           delta)
+{
+    unsigned long source_idx =
+          graph ? csr_graph_index(graph, source_node_id) : UNINITIALIZED_LONG;
+
+    if (!graph || source_idx == UNINITIALIZED_LONG || direction > BOTH) {
+        // LCOV_EXCL_START
+        printf("delta stepping: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    double max_w = max_weight(graph);
+
+    if (delta <= 0) {
+        delta = max_w > 0
+                      ? max_w * (double)graph->n_nodes / (double)graph->n_rels
+                      : 1;
+    }
+
+    // All tentative distances lie in [i * delta, (i + 1) * delta + max_w]
+    // while bucket i is processed, so a cyclic array of buckets suffices.
+    size_t n_buckets = (size_t)(max_w / delta) + 2;
+
+    array_list_ul**      buckets = malloc(n_buckets * sizeof(array_list_ul*));
+    delta_stepping_task* tasks   = malloc(N_THREADS * sizeof(*tasks));
+
+    _Atomic double* dist       = malloc(graph->n_nodes * sizeof(*dist));
+    double*         relaxed_at = malloc(graph->n_nodes * sizeof(double));
+    size_t*         removed_in = malloc(graph->n_nodes * sizeof(size_t));
+
+    if (!buckets || !tasks
+        || (graph->n_nodes > 0 && (!dist || !relaxed_at || !removed_in))) {
+        // LCOV_EXCL_START
+        printf("delta stepping: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    for (size_t i = 0; i < n_buckets; ++i) {
+        buckets[i] = al_ul_create();
+    }
+
+    for (size_t i = 0; i < graph->n_nodes; ++i) {
+        atomic_init(&dist[i], DBL_MAX);
+        relaxed_at[i] = -1;
+        removed_in[i] = SIZE_MAX;
+    }
+
+    for (size_t t = 0; t < N_THREADS; ++t) {
+        tasks[t].graph     = graph;
+        tasks[t].direction = direction;
+        tasks[t].delta     = delta;
+        tasks[t].dist      = dist;
+        tasks[t].updated   = al_ul_create();
+    }
+
+    atomic_store(&dist[source_idx], 0);
+    array_list_ul_append(buckets[0], source_idx);
+    size_t n_pending = 1;
+
+    array_list_ul* current;
+    array_list_ul* frontier;
+    array_list_ul* removed;
+    unsigned long  node_idx;
+    double         node_dist;
+    for (size_t bucket = 0; n_pending > 0; ++bucket) {
+        removed = al_ul_create();
+
+        while (array_list_ul_size(buckets[bucket % n_buckets]) > 0) {
+            current                     = buckets[bucket % n_buckets];
+            buckets[bucket % n_buckets] = al_ul_create();
+            n_pending -= array_list_ul_size(current);
+
+            // Drop stale entries and duplicates: A node is relaxed only if it
+            // still belongs to this bucket and its distance changed since it
+            // was relaxed the last time.
+            frontier = al_ul_create();
+            for (size_t i = 0; i < array_list_ul_size(current); ++i) {
+                node_idx  = array_list_ul_get(current, i);
+                node_dist = atomic_load_explicit(&dist[node_idx],
+                                                 memory_order_relaxed);
+
+                if ((size_t)(node_dist / delta) != bucket
+                    || relaxed_at[node_idx] == node_dist) {
+                    continue;
+                }
+
+                relaxed_at[node_idx] = node_dist;
+                array_list_ul_append(frontier, node_idx);
+
+                if (removed_in[node_idx] != bucket) {
+                    removed_in[node_idx] = bucket;
+                    array_list_ul_append(removed, node_idx);
+                }
+            }
+            array_list_ul_destroy(current);
+
+            relax_frontier(tasks, frontier, true);
+            n_pending += distribute(tasks, buckets, n_buckets, delta);
+            array_list_ul_destroy(frontier);
+        }
+
+        relax_frontier(tasks, removed, false);
+        n_pending += distribute(tasks, buckets, n_buckets, delta);
+        array_list_ul_destroy(removed);
+    }
+
+    for (size_t t = 0; t < N_THREADS; ++t) {
+        array_list_ul_destroy(tasks[t].updated);
+    }
+
+    for (size_t i = 0; i < n_buckets; ++i) {
+        array_list_ul_destroy(buckets[i]);
+    }
+
+    // The atomics are not needed anymore, reuse the buffer for plain doubles.
+    double*    final_dist = relaxed_at;
+    dict_ul_d* distances  = d_ul_d_create();
+    for (size_t i = 0; i < graph->n_nodes; ++i) {
+        final_dist[i] = atomic_load(&dist[i]);
+        dict_ul_d_insert(distances, graph->node_ids[i], final_dist[i]);
+    }
+
+    dict_ul_ul* pred_edges =
+          build_pred_edges(graph, final_dist, source_idx, direction);
+
+    free(tasks);
+    free(removed_in);
+    free(relaxed_at);
+    free(dist);
+    free(buckets);
+
+    return create_sssp_result(source_node_id, distances, pred_edges);
+}
+
+sssp_result*
+delta_stepping(heap_file*    hf,
+               unsigned long source_node_id,
+               direction_t   direction,
+               double        delta,
+               bool          log,
+               FILE*         log_file)
+{
+    if (!hf || source_node_id == UNINITIALIZED_LONG) {
+        // LCOV_EXCL_START
+        printf("delta stepping: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    csr_graph* graph = csr_graph_create(hf, log);
+
+    if (log) {
+        for (size_t i = 0; i < graph->n_nodes; ++i) {
+            fprintf(log_file,
+                    "delta_stepping %s %lu\n",
+                    "N",
+                    graph->node_ids[i]);
+
+            for (size_t j = graph->offsets[OUTGOING][i];
+                 j < graph->offsets[OUTGOING][i + 1];
+                 ++j) {
+                fprintf(log_file,
+                        "delta_stepping %s %lu\n",
+                        "R",
+                        graph->edges[OUTGOING][j].rel_id);
+            }
+        }
+        fflush(log_file);
+    }
+
+    sssp_result* result =
+          delta_stepping_csr(graph, source_node_id, direction, delta);
+
+    csr_graph_destroy(graph);
+
+    return result;
+}
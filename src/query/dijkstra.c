@@ -20,8 +20,8 @@
 #include "access/node.h"
 #include "access/relationship.h"
 #include "constants.h"
-#include "data-struct/fibonacci_heap.h"
 #include "data-struct/htable.h"
+#include "data-struct/priority_queue.h"
 #include "query/result_types.h"
 #include "strace.h"
 
@@ -32,7 +32,20 @@ dijkstra(heap_file*    hf,
          bool          log,
          FILE*         log_file)
 {
-    if (!hf || source_node_id == UNINITIALIZED_LONG) {
+    return dijkstra_pq(
+          hf, source_node_id, direction, fibonacci_pq, log, log_file);
+}
+
+sssp_result*
+dijkstra_pq(heap_file*    hf,
+            unsigned long source_node_id,
+            direction_t   direction,
+            pq_type       queue_type,
+            bool          log,
+            FILE*         log_file)
+{
+    if (!hf || source_node_id == UNINITIALIZED_LONG
+        || queue_type >= invalid_pq) {
         // LCOV_EXCL_START
         printf("dijkstra: Invalid Arguemnts!\n");
         print_trace();
@@ -50,23 +63,23 @@ dijkstra(heap_file*    hf,
     }
     array_list_node_destroy(nodes);
 
-    fib_heap_ul* prio_queue = fib_heap_ul_create();
+    priority_queue* prio_queue = priority_queue_create(queue_type);
 
     array_list_relationship* current_rels;
     relationship_t*          current_rel;
+    unsigned long            node_id;
     unsigned long            temp;
     double                   new_dist;
-    fib_heap_ul_node*        fh_node = NULL;
-    fib_heap_ul_insert(prio_queue, DBL_MAX, source_node_id);
+    priority_queue_push(prio_queue, 0, source_node_id);
 
     dict_ul_d_insert(distance, source_node_id, 0);
 
-    while (prio_queue->num_nodes > 0) {
-        fh_node      = fib_heap_ul_extract_min(prio_queue);
-        current_rels = expand(hf, fh_node->value, direction, log);
+    while (priority_queue_size(prio_queue) > 0) {
+        node_id      = priority_queue_extract_min(prio_queue, NULL);
+        current_rels = expand(hf, node_id, direction, log);
 
         if (log) {
-            fprintf(log_file, "dijkstra %s %lu\n", "N", fh_node->value);
+            fprintf(log_file, "dijkstra %s %lu\n", "N", node_id);
             fflush(log_file);
         }
 
@@ -79,22 +92,181 @@ dijkstra(heap_file*    hf,
                 fflush(log_file);
             }
 
-            temp = fh_node->value == current_rel->source_node
+            temp = node_id == current_rel->source_node
                          ? current_rel->target_node
                          : current_rel->source_node;
 
-            new_dist = dict_ul_d_get_direct(distance, fh_node->value)
+            new_dist = dict_ul_d_get_direct(distance, node_id)
                        + current_rel->weight;
             if (dict_ul_d_get_direct(distance, temp) > new_dist) {
                 dict_ul_d_insert(distance, temp, new_dist);
                 dict_ul_ul_insert(parents, temp, current_rel->id);
-                fib_heap_ul_insert(prio_queue, new_dist, temp);
+                priority_queue_push(prio_queue, new_dist, temp);
             }
         }
-        free(fh_node);
         array_list_relationship_destroy(current_rels);
     }
-    fib_heap_ul_destroy(prio_queue);
+    priority_queue_destroy(prio_queue);
 
     return create_sssp_result(source_node_id, distance, parents);
 }
+
+dijkstra_cursor*
+dijkstra_cursor_create(heap_file*            hf,
+                       unsigned long         source_node_id,
+                       direction_t           direction,
+                       double                max_distance,
+                       traversal_edge_filter edge_filter,
+                       traversal_node_filter node_filter,
+                       void*                 filter_data,
+                       bool                  log,
+                       FILE*                 log_file)
+{
+    if (!hf || source_node_id == UNINITIALIZED_LONG || direction > BOTH) {
+        // LCOV_EXCL_START
+        printf("dijkstra cursor - create: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    dijkstra_cursor* cursor = malloc(sizeof(dijkstra_cursor));
+
+    if (!cursor) {
+        // LCOV_EXCL_START
+        printf("dijkstra cursor - create: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    cursor->hf           = hf;
+    cursor->direction    = direction;
+    cursor->max_distance = max_distance;
+    cursor->edge_filter  = edge_filter;
+    cursor->node_filter  = node_filter;
+    cursor->filter_data  = filter_data;
+    cursor->queue        = priority_queue_create(d_ary_pq);
+    cursor->distances    = d_ul_d_create();
+    cursor->depths       = d_ul_ul_create();
+    cursor->parents      = d_ul_ul_create();
+    cursor->pending      = UNINITIALIZED_LONG;
+    cursor->log          = log;
+    cursor->log_file     = log_file;
+
+    priority_queue_push(cursor->queue, 0, source_node_id);
+    dict_ul_d_insert(cursor->distances, source_node_id, 0);
+    dict_ul_ul_insert(cursor->depths, source_node_id, 0);
+    dict_ul_ul_insert(cursor->parents, source_node_id, UNINITIALIZED_LONG);
+
+    return cursor;
+}
+
+void
+dijkstra_cursor_destroy(dijkstra_cursor* cursor)
+{
+    if (!cursor) {
+        // LCOV_EXCL_START
+        printf("dijkstra cursor - destroy: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    priority_queue_destroy(cursor->queue);
+    dict_ul_d_destroy(cursor->distances);
+    dict_ul_ul_destroy(cursor->depths);
+    dict_ul_ul_destroy(cursor->parents);
+    free(cursor);
+}
+
+static void
+dijkstra_cursor_expand(dijkstra_cursor* cursor, unsigned long node_id)
+{
+    array_list_relationship* current_rels =
+          expand(cursor->hf, node_id, cursor->direction, cursor->log);
+    relationship_t* current_rel;
+    unsigned long   temp;
+    double          new_dist;
+    double          dist = dict_ul_d_get_direct(cursor->distances, node_id);
+
+    if (cursor->log) {
+        fprintf(cursor->log_file, "dijkstra_cursor %s %lu\n", "N", node_id);
+        fflush(cursor->log_file);
+    }
+
+    for (size_t i = 0; i < array_list_relationship_size(current_rels); ++i) {
+        current_rel = array_list_relationship_get(current_rels, i);
+
+        if (cursor->log) {
+            fprintf(cursor->log_file,
+                    "dijkstra_cursor %s %lu\n",
+                    "R",
+                    current_rel->id);
+            fflush(cursor->log_file);
+        }
+
+        temp = node_id == current_rel->source_node ? current_rel->target_node
+                                                   : current_rel->source_node;
+        new_dist = dist + current_rel->weight;
+
+        // Settled nodes are never improved as the weights are non-negative
+        if (new_dist > cursor->max_distance
+            || (dict_ul_d_contains(cursor->distances, temp)
+                && dict_ul_d_get_direct(cursor->distances, temp) <= new_dist)
+            || (cursor->edge_filter
+                && !cursor->edge_filter(
+                      current_rel, node_id, cursor->filter_data))) {
+            continue;
+        }
+
+        dict_ul_d_insert(cursor->distances, temp, new_dist);
+        dict_ul_ul_insert(cursor->depths,
+                          temp,
+                          dict_ul_ul_get_direct(cursor->depths, node_id) + 1);
+        dict_ul_ul_insert(cursor->parents, temp, current_rel->id);
+        priority_queue_push(cursor->queue, new_dist, temp);
+    }
+
+    array_list_relationship_destroy(current_rels);
+}
+
+bool
+dijkstra_cursor_next(dijkstra_cursor* cursor, traversal_step* step)
+{
+    if (!cursor || !step) {
+        // LCOV_EXCL_START
+        printf("dijkstra cursor - next: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    while (true) {
+        if (cursor->pending != UNINITIALIZED_LONG) {
+            dijkstra_cursor_expand(cursor, cursor->pending);
+            cursor->pending = UNINITIALIZED_LONG;
+        }
+
+        if (priority_queue_size(cursor->queue) == 0) {
+            return false;
+        }
+
+        cursor->pending =
+              priority_queue_extract_min(cursor->queue, &step->distance);
+
+        step->node_id = cursor->pending;
+        step->depth   = dict_ul_ul_get_direct(cursor->depths, cursor->pending);
+        step->parent_edge =
+              dict_ul_ul_get_direct(cursor->parents, cursor->pending);
+
+        if (!cursor->node_filter
+            || cursor->node_filter(step, cursor->filter_data)) {
+            return true;
+        }
+    }
+}
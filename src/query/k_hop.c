@@ -0,0 +1,230 @@
+/*!
+ * \file k_hop.c
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief See \ref k_hop.h
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "query/k_hop.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "access/node.h"
+#include "access/relationship.h"
+#include "constants.h"
+#include "data-struct/array_list.h"
+#include "data-struct/cbs.h"
+#include "strace.h"
+
+#define K_HOP_WORD_BITS (sizeof(unsigned long) * CHAR_BIT)
+
+static bool
+k_hop_mark(unsigned long* visited, unsigned long node_id)
+{
+    size_t        idx  = node_id / NUM_SLOTS_PER_NODE;
+    unsigned long mask = 1UL << (idx % K_HOP_WORD_BITS);
+
+    if (visited[idx / K_HOP_WORD_BITS] & mask) {
+        return false;
+    }
+
+    visited[idx / K_HOP_WORD_BITS] |= mask;
+    return true;
+}
+
+static array_list_ul*
+k_hop_level(const unsigned long* nodes, size_t n_nodes)
+{
+    array_list_ul* level = al_ul_create();
+
+    for (size_t i = 0; i < n_nodes; ++i) {
+        array_list_ul_append(level, nodes[i]);
+    }
+
+    return level;
+}
+
+k_hop_result*
+k_hop(heap_file*           hf,
+      const unsigned long* source_node_ids,
+      size_t               num_sources,
+      unsigned long        k,
+      direction_t          direction,
+      unsigned long        rel_label_filter,
+      unsigned long        node_label_filter,
+      bool                 log,
+      FILE*                log_file)
+{
+    if (!hf || (!source_node_ids && num_sources > 0) || direction > BOTH) {
+        // LCOV_EXCL_START
+        printf("k hop: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    for (size_t i = 0; i < num_sources; ++i) {
+        if (!check_record_exists(hf, source_node_ids[i], true, log)) {
+            // LCOV_EXCL_START
+            printf("k hop: Source node %lu does not exist!\n",
+                   source_node_ids[i]);
+            print_trace();
+
+            exit(EXIT_FAILURE);
+            // LCOV_EXCL_STOP
+        }
+    }
+
+    size_t n_slots = hf->cache->pdb->records[node_ft]->num_pages
+                     * SLOTS_PER_PAGE / NUM_SLOTS_PER_NODE;
+
+    k_hop_result*  result = malloc(sizeof(k_hop_result));
+    unsigned long* visited =
+          calloc(n_slots / K_HOP_WORD_BITS + 1, sizeof(unsigned long));
+    unsigned long* frontier = malloc((n_slots + 1) * sizeof(unsigned long));
+    unsigned long* next     = malloc((n_slots + 1) * sizeof(unsigned long));
+
+    if (!result || !visited || !frontier || !next) {
+        // LCOV_EXCL_START
+        printf("k hop: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    // No node is first reached after more hops than there are nodes
+    if (k > hf->n_nodes) {
+        k = hf->n_nodes;
+    }
+
+    result->k    = k;
+    result->hops = malloc((k + 1) * sizeof(array_list_ul*));
+
+    if (!result->hops) {
+        // LCOV_EXCL_START
+        printf("k hop: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    size_t n_frontier = 0;
+    for (size_t i = 0; i < num_sources; ++i) {
+        if (k_hop_mark(visited, source_node_ids[i])) {
+            frontier[n_frontier++] = source_node_ids[i];
+        }
+    }
+    qsort(frontier, n_frontier, sizeof(unsigned long), ul_cmp);
+    result->hops[0] = k_hop_level(frontier, n_frontier);
+
+    array_list_relationship* current_rels;
+    relationship_t*          current_rel;
+    node_t*                  node;
+    unsigned long            other_id;
+    unsigned long*           temp;
+    size_t                   n_next;
+    size_t                   n_kept;
+
+    for (unsigned long hop = 1; hop <= k; ++hop) {
+        n_next = 0;
+
+        for (size_t i = 0; i < n_frontier; ++i) {
+            // Dense nodes only read the relationships with the label
+            if (rel_label_filter == K_HOP_ANY_LABEL) {
+                current_rels = expand(hf, frontier[i], direction, log);
+            } else {
+                current_rels = expand_with_label(
+                      hf, frontier[i], direction, rel_label_filter, log);
+            }
+
+            if (log) {
+                fprintf(log_file, "k_hop %s %lu\n", "N", frontier[i]);
+                fflush(log_file);
+            }
+
+            for (size_t j = 0; j < array_list_relationship_size(current_rels);
+                 ++j) {
+                current_rel = array_list_relationship_get(current_rels, j);
+
+                if (log) {
+                    fprintf(log_file, "k_hop %s %lu\n", "R", current_rel->id);
+                    fflush(log_file);
+                }
+
+                if (rel_label_filter != K_HOP_ANY_LABEL
+                    && current_rel->label != rel_label_filter) {
+                    continue;
+                }
+
+                other_id = frontier[i] == current_rel->source_node
+                                 ? current_rel->target_node
+                                 : current_rel->source_node;
+
+                if (k_hop_mark(visited, other_id)) {
+                    next[n_next++] = other_id;
+                }
+            }
+
+            array_list_relationship_destroy(current_rels);
+        }
+
+        qsort(next, n_next, sizeof(unsigned long), ul_cmp);
+
+        // Candidates with another label stay marked, so they are read once
+        if (node_label_filter != K_HOP_ANY_LABEL) {
+            n_kept = 0;
+            for (size_t i = 0; i < n_next; ++i) {
+                node = read_node(hf, next[i], log);
+
+                if (node->label == node_label_filter) {
+                    next[n_kept++] = next[i];
+                }
+                free(node);
+            }
+            n_next = n_kept;
+        }
+
+        result->hops[hop] = k_hop_level(next, n_next);
+
+        temp       = frontier;
+        frontier   = next;
+        next       = temp;
+        n_frontier = n_next;
+    }
+
+    free(visited);
+    free(frontier);
+    free(next);
+
+    return result;
+}
+
+void
+k_hop_result_destroy(k_hop_result* result)
+{
+    if (!result) {
+        // LCOV_EXCL_START
+        printf("k hop - destroy result: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    for (size_t i = 0; i <= result->k; ++i) {
+        array_list_ul_destroy(result->hops[i]);
+    }
+
+    free(result->hops);
+    free(result);
+}
@@ -0,0 +1,246 @@
+/*!
+ * \file ms_bfs.c
+ * \version 1.0
+ * \date Sep 15, 2021
+ * \author Fabian Klopfer <fabian.klopfer@ieee.org>
+ * \brief See \ref ms_bfs.h
+ *
+ * \copyright Copyright (c) 2021- University of Konstanz.
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "query/ms_bfs.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "access/node.h"
+#include "access/relationship.h"
+#include "constants.h"
+#include "data-struct/array_list.h"
+#include "data-struct/htable.h"
+#include "query/result_types.h"
+#include "strace.h"
+
+static void
+ms_bfs_batch(heap_file*           hf,
+             const unsigned long* source_node_ids,
+             size_t               num_sources,
+             direction_t          direction,
+             traversal_result**   results,
+             bool                 log,
+             FILE*                log_file)
+{
+    /* Node ids are slot numbers, so dividing by the number of slots per node
+     * yields a dense index that can address the per vertex bitsets. */
+    size_t n_slots = hf->cache->pdb->records[node_ft]->num_pages
+                     * SLOTS_PER_PAGE / NUM_SLOTS_PER_NODE;
+
+    unsigned long* seen  = calloc(n_slots * MS_BFS_WORDS, sizeof(*seen));
+    unsigned long* visit = calloc(n_slots * MS_BFS_WORDS, sizeof(*visit));
+    unsigned long* next  = calloc(n_slots * MS_BFS_WORDS, sizeof(*next));
+
+    if (!seen || !visit || !next) {
+        // LCOV_EXCL_START
+        printf("ms bfs - batch: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    array_list_ul* frontier      = al_ul_create();
+    array_list_ul* next_frontier = al_ul_create();
+    unsigned long* temp_bits     = NULL;
+
+    size_t        idx;
+    size_t        lane;
+    unsigned long word;
+    for (size_t i = 0; i < num_sources; ++i) {
+        idx  = source_node_ids[i] / NUM_SLOTS_PER_NODE;
+        word = i / MS_BFS_WORD_BITS;
+
+        bool fresh = true;
+        for (size_t w = 0; w < MS_BFS_WORDS; ++w) {
+            fresh &= visit[idx * MS_BFS_WORDS + w] == 0;
+        }
+
+        if (fresh) {
+            array_list_ul_append(frontier, idx);
+        }
+
+        seen[idx * MS_BFS_WORDS + word] |= 1UL << (i % MS_BFS_WORD_BITS);
+        visit[idx * MS_BFS_WORDS + word] |= 1UL << (i % MS_BFS_WORD_BITS);
+
+        dict_ul_ul_insert(results[i]->traversal_numbers, source_node_ids[i], 0);
+    }
+
+    array_list_relationship* current_rels = NULL;
+    relationship_t*          current_rel  = NULL;
+    unsigned long            node_id;
+    unsigned long            other_id;
+    size_t                   other;
+    unsigned long            diff[MS_BFS_WORDS];
+    unsigned long            any;
+    unsigned long            level = 0;
+
+    while (array_list_ul_size(frontier) > 0) {
+        level++;
+
+        for (size_t i = 0; i < array_list_ul_size(frontier); ++i) {
+            idx          = array_list_ul_get(frontier, i);
+            node_id      = idx * NUM_SLOTS_PER_NODE;
+            current_rels = expand(hf, node_id, direction, log);
+
+            if (log) {
+                fprintf(log_file, "ms_bfs %s %lu\n", "N", node_id);
+                fflush(log_file);
+            }
+
+            for (size_t j = 0; j < array_list_relationship_size(current_rels);
+                 ++j) {
+                current_rel = array_list_relationship_get(current_rels, j);
+
+                if (log) {
+                    fprintf(log_file, "ms_bfs %s %lu\n", "R", current_rel->id);
+                    fflush(log_file);
+                }
+
+                other_id = node_id == current_rel->source_node
+                                 ? current_rel->target_node
+                                 : current_rel->source_node;
+                other    = other_id / NUM_SLOTS_PER_NODE;
+
+                any = 0;
+                for (size_t w = 0; w < MS_BFS_WORDS; ++w) {
+                    diff[w] = visit[idx * MS_BFS_WORDS + w]
+                              & ~seen[other * MS_BFS_WORDS + w];
+                    any |= diff[w];
+                }
+
+                if (any == 0) {
+                    continue;
+                }
+
+                any = 0;
+                for (size_t w = 0; w < MS_BFS_WORDS; ++w) {
+                    any |= next[other * MS_BFS_WORDS + w];
+                    next[other * MS_BFS_WORDS + w] |= diff[w];
+                    seen[other * MS_BFS_WORDS + w] |= diff[w];
+                }
+
+                if (any == 0) {
+                    array_list_ul_append(next_frontier, other);
+                }
+
+                for (size_t w = 0; w < MS_BFS_WORDS; ++w) {
+                    while (diff[w] != 0) {
+                        lane = w * MS_BFS_WORD_BITS + __builtin_ctzl(diff[w]);
+                        diff[w] &= diff[w] - 1;
+
+                        dict_ul_ul_insert(
+                              results[lane]->traversal_numbers, other_id, level);
+                        dict_ul_ul_insert(
+                              results[lane]->parents, other_id, current_rel->id);
+                    }
+                }
+            }
+
+            array_list_relationship_destroy(current_rels);
+        }
+
+        for (size_t i = 0; i < array_list_ul_size(frontier); ++i) {
+            idx = array_list_ul_get(frontier, i);
+            memset(visit + idx * MS_BFS_WORDS,
+                   0,
+                   MS_BFS_WORDS * sizeof(unsigned long));
+        }
+
+        temp_bits = visit;
+        visit     = next;
+        next      = temp_bits;
+
+        array_list_ul_destroy(frontier);
+        frontier      = next_frontier;
+        next_frontier = al_ul_create();
+    }
+
+    array_list_ul_destroy(frontier);
+    array_list_ul_destroy(next_frontier);
+    free(seen);
+    free(visit);
+    free(next);
+}
+
+traversal_result**
+ms_bfs(heap_file*           hf,
+       const unsigned long* source_node_ids,
+       size_t               num_sources,
+       direction_t          direction,
+       bool                 log,
+       FILE*                log_file)
+{
+    if (!hf || !source_node_ids || num_sources == 0) {
+        // LCOV_EXCL_START
+        printf("ms bfs: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    for (size_t i = 0; i < num_sources; ++i) {
+        if (!check_record_exists(hf, source_node_ids[i], true, log)) {
+            // LCOV_EXCL_START
+            printf("ms bfs: Source node %lu does not exist!\n",
+                   source_node_ids[i]);
+            print_trace();
+
+            exit(EXIT_FAILURE);
+            // LCOV_EXCL_STOP
+        }
+    }
+
+    traversal_result** results =
+          calloc(num_sources, sizeof(traversal_result*));
+
+    if (!results) {
+        // LCOV_EXCL_START
+        printf("ms bfs: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    array_list_node* nodes = get_nodes(hf, log);
+    for (size_t i = 0; i < num_sources; ++i) {
+        dict_ul_ul* traversal_numbers = d_ul_ul_create();
+        for (size_t j = 0; j < array_list_node_size(nodes); ++j) {
+            dict_ul_ul_insert(traversal_numbers,
+                              array_list_node_get(nodes, j)->id,
+                              ULONG_MAX);
+        }
+        results[i] = create_traversal_result(
+              source_node_ids[i], traversal_numbers, d_ul_ul_create());
+    }
+    array_list_node_destroy(nodes);
+
+    size_t batch_size;
+    for (size_t i = 0; i < num_sources; i += MS_BFS_BATCH_SIZE) {
+        batch_size = num_sources - i < MS_BFS_BATCH_SIZE ? num_sources - i
+                                                         : MS_BFS_BATCH_SIZE;
+        ms_bfs_batch(hf,
+                     source_node_ids + i,
+                     batch_size,
+                     direction,
+                     results + i,
+                     log,
+                     log_file);
+    }
+
+    return results;
+}
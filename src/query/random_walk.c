@@ -12,15 +12,42 @@
  */
 #include "query/random_walk.h"
 
+#include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "access/csr_graph.h"
 #include "access/relationship.h"
 #include "constants.h"
 #include "data-struct/array_list.h"
 #include "query/result_types.h"
 #include "strace.h"
 
+/* Batches with fewer walks per thread run on the calling thread. */
+#define RANDOM_WALK_MIN_WALKS_PER_THREAD (64)
+
+/* Number of rejected node2vec proposals after which the transition
+ * probabilities of the current node are computed exactly. Bounds the cost of
+ * nodes where most proposals are rejected, e.g. dead ends with a large p. */
+#define NODE2VEC_MAX_TRIALS (32)
+
+typedef struct
+{
+    const csr_graph*     graph;
+    direction_t          direction;
+    walk_type            type;
+    double               inv_p;
+    double               inv_q;
+    const double*        alias_prob;
+    const unsigned long* alias_idx;
+    const unsigned long* start_idxs;
+    unsigned long        seed;
+    walk_batch*          batch;
+    size_t               begin;
+    size_t               end;
+} walk_task;
+
 path*
 random_walk(heap_file*    hf,
             unsigned long node_id,
@@ -74,3 +101,505 @@ random_walk(heap_file*    hf,
 
     return create_path(node_id, current_node, distance, visited_rels);
 }
+
+/* SplitMix64 (Steele et al.), one state per walk. */
+static uint64_t
+walk_rand(uint64_t* state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15UL);
+    z          = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9UL;
+    z          = (z ^ (z >> 27)) * 0x94D049BB133111EBUL;
+    return z ^ (z >> 31);
+}
+
+static double
+walk_rand_unit(uint64_t* state)
+{
+    return (double)(walk_rand(state) >> 11) * 0x1.0p-53;
+}
+
+/* For direction BOTH the row of a node consists of its outgoing edges
+ * followed by its incoming ones, so the rows of all nodes are consecutive in
+ * the arrays of the alias tables. */
+static size_t
+walk_row_start(const csr_graph* graph, direction_t direction, size_t node)
+{
+    if (direction != BOTH) {
+        return graph->offsets[direction][node];
+    }
+
+    return graph->offsets[OUTGOING][node] + graph->offsets[INCOMING][node];
+}
+
+static const csr_edge*
+walk_row_edge(const csr_graph* graph,
+              direction_t      direction,
+              size_t           node,
+              size_t           offset)
+{
+    if (direction != BOTH) {
+        return graph->edges[direction] + graph->offsets[direction][node]
+               + offset;
+    }
+
+    size_t out_degree = csr_graph_degree(graph, node, OUTGOING);
+    return offset < out_degree
+                 ? &graph->edges[OUTGOING][graph->offsets[OUTGOING][node]
+                                           + offset]
+                 : &graph->edges[INCOMING][graph->offsets[INCOMING][node]
+                                           + offset - out_degree];
+}
+
+static bool
+walk_adjacent(const csr_graph* graph,
+              direction_t      direction,
+              size_t           from,
+              size_t           to)
+{
+    size_t low;
+    size_t high;
+    size_t mid;
+    for (direction_t d = OUTGOING; d <= INCOMING; ++d) {
+        if (direction != BOTH && direction != d) {
+            continue;
+        }
+
+        // The rows are sorted by neighbour
+        low  = graph->offsets[d][from];
+        high = graph->offsets[d][from + 1];
+        while (low < high) {
+            mid = low + (high - low) / 2;
+            if (graph->edges[d][mid].neighbour < to) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+
+        if (low < graph->offsets[d][from + 1]
+            && graph->edges[d][low].neighbour == to) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Vose's alias method: Every offset k of a row keeps its own edge with
+ * probability prob[k] and takes the edge alias[k] otherwise. */
+static void
+build_alias_tables(const csr_graph* graph,
+                   direction_t      direction,
+                   double*          prob,
+                   unsigned long*   alias)
+{
+    size_t max_degree = 0;
+    for (size_t v = 0; v < graph->n_nodes; ++v) {
+        if (csr_graph_degree(graph, v, direction) > max_degree) {
+            max_degree = csr_graph_degree(graph, v, direction);
+        }
+    }
+
+    unsigned long* small = malloc(max_degree * sizeof(unsigned long));
+    unsigned long* large = malloc(max_degree * sizeof(unsigned long));
+
+    if (max_degree > 0 && (!small || !large)) {
+        // LCOV_EXCL_START
+        printf("random walks - alias tables: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    size_t degree;
+    size_t start;
+    double sum;
+    size_t n_small;
+    size_t n_large;
+    size_t s;
+    size_t l;
+    for (size_t v = 0; v < graph->n_nodes; ++v) {
+        degree = csr_graph_degree(graph, v, direction);
+        start  = walk_row_start(graph, direction, v);
+
+        sum = 0;
+        for (size_t k = 0; k < degree; ++k) {
+            sum += walk_row_edge(graph, direction, v, k)->weight;
+        }
+
+        n_small = 0;
+        n_large = 0;
+        for (size_t k = 0; k < degree; ++k) {
+            prob[start + k] =
+                  sum > 0 ? walk_row_edge(graph, direction, v, k)->weight
+                                  * (double)degree / sum
+                          : 1;
+            alias[start + k] = k;
+
+            if (prob[start + k] < 1) {
+                small[n_small++] = k;
+            } else {
+                large[n_large++] = k;
+            }
+        }
+
+        while (n_small > 0 && n_large > 0) {
+            s = small[--n_small];
+            l = large[n_large - 1];
+
+            alias[start + s] = l;
+            prob[start + l] -= 1 - prob[start + s];
+
+            if (prob[start + l] < 1) {
+                n_large--;
+                small[n_small++] = l;
+            }
+        }
+
+        // Whatever remains is 1 up to rounding
+        while (n_large > 0) {
+            prob[start + large[--n_large]] = 1;
+        }
+        while (n_small > 0) {
+            prob[start + small[--n_small]] = 1;
+        }
+    }
+
+    free(small);
+    free(large);
+}
+
+static size_t
+walk_first_order(const walk_task* task,
+                 size_t           node,
+                 size_t           degree,
+                 uint64_t*        state)
+{
+    size_t offset = walk_rand(state) % degree;
+
+    if (task->type == uniform_walk) {
+        return offset;
+    }
+
+    size_t start = walk_row_start(task->graph, task->direction, node);
+    return walk_rand_unit(state) < task->alias_prob[start + offset]
+                 ? offset
+                 : task->alias_idx[start + offset];
+}
+
+static double
+node2vec_bias(const walk_task* task, size_t prev, size_t next)
+{
+    if (next == prev) {
+        return task->inv_p;
+    }
+
+    return walk_adjacent(task->graph, task->direction, prev, next)
+                 ? 1
+                 : task->inv_q;
+}
+
+static size_t
+walk_node2vec(const walk_task* task,
+              size_t           prev,
+              size_t           node,
+              size_t           degree,
+              uint64_t*        state)
+{
+    double max_bias = task->inv_p > 1 ? task->inv_p : 1;
+    max_bias        = task->inv_q > max_bias ? task->inv_q : max_bias;
+
+    size_t offset;
+    size_t next;
+    for (size_t trial = 0; trial < NODE2VEC_MAX_TRIALS; ++trial) {
+        offset = walk_first_order(task, node, degree, state);
+        next   = walk_row_edge(task->graph, task->direction, node, offset)
+                     ->neighbour;
+
+        if (walk_rand_unit(state) * max_bias
+            < node2vec_bias(task, prev, next)) {
+            return offset;
+        }
+    }
+
+    // Sample from the exact distribution of the node
+    const csr_edge* edge;
+    double          sum        = 0;
+    double          any_weight = 0;
+    for (size_t k = 0; k < degree; ++k) {
+        edge = walk_row_edge(task->graph, task->direction, node, k);
+        any_weight += edge->weight;
+    }
+
+    for (size_t k = 0; k < degree; ++k) {
+        edge = walk_row_edge(task->graph, task->direction, node, k);
+        sum += (any_weight > 0 ? edge->weight : 1)
+               * node2vec_bias(task, prev, edge->neighbour);
+    }
+
+    double target = walk_rand_unit(state) * sum;
+    for (size_t k = 0; k < degree; ++k) {
+        edge = walk_row_edge(task->graph, task->direction, node, k);
+        target -= (any_weight > 0 ? edge->weight : 1)
+                  * node2vec_bias(task, prev, edge->neighbour);
+
+        if (target < 0) {
+            return k;
+        }
+    }
+
+    return degree - 1;
+}
+
+static void*
+walk_range(void* arg)
+{
+    walk_task*       task  = arg;
+    const csr_graph* graph = task->graph;
+    size_t           width = task->batch->walk_length + 1;
+
+    uint64_t       state;
+    unsigned long* walk;
+    size_t         node;
+    size_t         prev;
+    size_t         degree;
+    size_t         offset;
+    for (size_t i = task->begin; i < task->end; ++i) {
+        // Decorrelate the states of neighbouring walks
+        state = task->seed ^ (i * 0xD1B54A32D192ED03UL);
+        walk_rand(&state);
+
+        walk    = task->batch->nodes + i * width;
+        node    = task->start_idxs[i];
+        prev    = UNINITIALIZED_LONG;
+        walk[0] = graph->node_ids[node];
+
+        for (size_t j = 1; j < width; ++j) {
+            degree = csr_graph_degree(graph, node, task->direction);
+
+            if (degree == 0) {
+                for (; j < width; ++j) {
+                    walk[j] = UNINITIALIZED_LONG;
+                }
+                break;
+            }
+
+            offset = task->type == node2vec_walk && prev != UNINITIALIZED_LONG
+                           ? walk_node2vec(task, prev, node, degree, &state)
+                           : walk_first_order(task, node, degree, &state);
+
+            prev    = node;
+            node    = walk_row_edge(graph, task->direction, node, offset)
+                           ->neighbour;
+            walk[j] = graph->node_ids[node];
+        }
+    }
+
+    return NULL;
+}
+
+walk_batch*
+random_walks_csr(const csr_graph*     graph,
+                 const unsigned long* start_node_ids,
+                 size_t               num_walks,
+                 size_t               walk_length,
+                 direction_t          direction,
+                 walk_type            type,
+                 double               p,
+                 double               q,
+                 unsigned long        seed)
+{
+    if (!graph || (!start_node_ids && num_walks > 0) || direction > BOTH
+        || type >= invalid_walk
+        || (type == node2vec_walk && (!(p > 0) || !(q > 0)))) {
+        // LCOV_EXCL_START
+        printf("random walks: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    walk_batch*    batch      = malloc(sizeof(walk_batch));
+    unsigned long* start_idxs = malloc(num_walks * sizeof(unsigned long));
+
+    if (!batch || (num_walks > 0 && !start_idxs)) {
+        // LCOV_EXCL_START
+        printf("random walks: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    batch->num_walks   = num_walks;
+    batch->walk_length = walk_length;
+    batch->nodes =
+          malloc(num_walks * (walk_length + 1) * sizeof(unsigned long));
+
+    if (num_walks > 0 && !batch->nodes) {
+        // LCOV_EXCL_START
+        printf("random walks: Failed to allocate memory!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    for (size_t i = 0; i < num_walks; ++i) {
+        start_idxs[i] = csr_graph_index(graph, start_node_ids[i]);
+
+        if (start_idxs[i] == UNINITIALIZED_LONG) {
+            // LCOV_EXCL_START
+            printf("random walks: Start node %lu does not exist!\n",
+                   start_node_ids[i]);
+            print_trace();
+
+            exit(EXIT_FAILURE);
+            // LCOV_EXCL_STOP
+        }
+    }
+
+    double*        alias_prob = NULL;
+    unsigned long* alias_idx  = NULL;
+
+    if (type != uniform_walk) {
+        size_t n_entries = direction == BOTH
+                                 ? 2 * graph->n_rels
+                                 : graph->offsets[direction][graph->n_nodes];
+        alias_prob = malloc(n_entries * sizeof(double));
+        alias_idx  = malloc(n_entries * sizeof(unsigned long));
+
+        if (n_entries > 0 && (!alias_prob || !alias_idx)) {
+            // LCOV_EXCL_START
+            printf("random walks: Failed to allocate memory!\n");
+            print_trace();
+
+            exit(EXIT_FAILURE);
+            // LCOV_EXCL_STOP
+        }
+
+        build_alias_tables(graph, direction, alias_prob, alias_idx);
+    }
+
+    size_t n_threads = num_walks / RANDOM_WALK_MIN_WALKS_PER_THREAD;
+    if (n_threads > N_THREADS) {
+        n_threads = N_THREADS;
+    } else if (n_threads == 0) {
+        n_threads = 1;
+    }
+
+    walk_task tasks[n_threads];
+    for (size_t t = 0; t < n_threads; ++t) {
+        tasks[t].graph      = graph;
+        tasks[t].direction  = direction;
+        tasks[t].type       = type;
+        tasks[t].inv_p      = type == node2vec_walk ? 1 / p : 1;
+        tasks[t].inv_q      = type == node2vec_walk ? 1 / q : 1;
+        tasks[t].alias_prob = alias_prob;
+        tasks[t].alias_idx  = alias_idx;
+        tasks[t].start_idxs = start_idxs;
+        tasks[t].seed       = seed;
+        tasks[t].batch      = batch;
+        tasks[t].begin      = num_walks * t / n_threads;
+        tasks[t].end        = num_walks * (t + 1) / n_threads;
+    }
+
+    pthread_t threads[n_threads];
+    for (size_t t = 1; t < n_threads; ++t) {
+        if (pthread_create(&threads[t], NULL, walk_range, &tasks[t]) != 0) {
+            // LCOV_EXCL_START
+            printf("random walks: Failed to create thread!\n");
+            print_trace();
+
+            exit(EXIT_FAILURE);
+            // LCOV_EXCL_STOP
+        }
+    }
+
+    walk_range(&tasks[0]);
+
+    for (size_t t = 1; t < n_threads; ++t) {
+        pthread_join(threads[t], NULL);
+    }
+
+    free(alias_prob);
+    free(alias_idx);
+    free(start_idxs);
+
+    return batch;
+}
+
+walk_batch*
+random_walks(heap_file*           hf,
+             const unsigned long* start_node_ids,
+             size_t               num_walks,
+             size_t               walk_length,
+             direction_t          direction,
+             walk_type            type,
+             double               p,
+             double               q,
+             unsigned long        seed,
+             bool                 log,
+             FILE*                log_file)
+{
+    if (!hf) {
+        // LCOV_EXCL_START
+        printf("random walks: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    csr_graph* graph = csr_graph_create(hf, log);
+
+    if (log) {
+        for (size_t i = 0; i < graph->n_nodes; ++i) {
+            fprintf(log_file,
+                    "random_walks %s %lu\n",
+                    "N",
+                    graph->node_ids[i]);
+
+            for (size_t j = graph->offsets[OUTGOING][i];
+                 j < graph->offsets[OUTGOING][i + 1];
+                 ++j) {
+                fprintf(log_file,
+                        "random_walks %s %lu\n",
+                        "R",
+                        graph->edges[OUTGOING][j].rel_id);
+            }
+        }
+        fflush(log_file);
+    }
+
+    walk_batch* batch = random_walks_csr(graph,
+                                         start_node_ids,
+                                         num_walks,
+                                         walk_length,
+                                         direction,
+                                         type,
+                                         p,
+                                         q,
+                                         seed);
+    csr_graph_destroy(graph);
+
+    return batch;
+}
+
+void
+walk_batch_destroy(walk_batch* batch)
+{
+    if (!batch) {
+        // LCOV_EXCL_START
+        printf("random walks - destroy batch: Invalid Arguments!\n");
+        print_trace();
+
+        exit(EXIT_FAILURE);
+        // LCOV_EXCL_STOP
+    }
+
+    free(batch->nodes);
+    free(batch);
+}
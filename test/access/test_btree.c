@@ -0,0 +1,181 @@
+/*
+ * test_btree.c   1.0   Sep 15, 2021
+ *
+ * Copyright (c) 2021- University of Konstanz.
+ *
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "access/btree.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "constants.h"
+#include "page_cache.h"
+#include "physical_database.h"
+
+/* Enough keys for three levels with half full nodes */
+#define TEST_N_KEYS (100003)
+#define TEST_STRIDE (7919)
+
+static void
+check_range(page_cache*   pc,
+            const bool*   present,
+            unsigned long low,
+            unsigned long high)
+{
+    btree_iterator* it = btree_range(pc, btree_ft, low, high, false);
+    unsigned long   key;
+    unsigned long   value;
+    unsigned long   expected = low;
+
+    while (btree_iterator_next(it, &key, &value)) {
+        while (expected < TEST_N_KEYS && !present[expected]) {
+            expected++;
+        }
+        assert(key == expected);
+        assert(value == key * 2);
+        expected++;
+    }
+    btree_iterator_destroy(it);
+
+    while (expected <= high && expected < TEST_N_KEYS) {
+        assert(!present[expected]);
+        expected++;
+    }
+}
+
+static void
+check_tree(page_cache* pc, const bool* present, unsigned long n_present)
+{
+    assert(btree_size(pc, btree_ft, false) == n_present);
+
+    for (unsigned long k = 0; k < TEST_N_KEYS; ++k) {
+        assert(btree_find(pc, btree_ft, k, false)
+               == (present[k] ? k * 2 : UNINITIALIZED_LONG));
+    }
+
+    check_range(pc, present, 0, TEST_N_KEYS);
+    check_range(pc, present, 500, 1500);
+    check_range(pc, present, TEST_N_KEYS / 2, TEST_N_KEYS / 2);
+    check_range(pc, present, 7, 3);
+}
+
+void
+test_btree_insert_remove(void)
+{
+    phy_database* pdb = phy_database_create("test", "log_test_pdb");
+    page_cache*   pc  = page_cache_create(pdb, CACHE_N_PAGES, "log_test_pc");
+
+    bool* present = calloc(TEST_N_KEYS, sizeof(bool));
+
+    assert(btree_height(pc, btree_ft, false) == 0);
+    check_tree(pc, present, 0);
+
+    // The stride is coprime to the number of keys, so all keys are inserted
+    unsigned long key;
+    for (unsigned long i = 0; i < TEST_N_KEYS; ++i) {
+        key = (i * TEST_STRIDE) % TEST_N_KEYS;
+        btree_insert(pc, btree_ft, key, key == 42 ? 0 : key * 2, false);
+        present[key] = true;
+    }
+    assert(btree_height(pc, btree_ft, false) == 3);
+
+    // Inserting a present key replaces its value
+    btree_insert(pc, btree_ft, 42, 84, false);
+    check_tree(pc, present, TEST_N_KEYS);
+
+    unsigned long n_present = TEST_N_KEYS;
+    for (unsigned long k = 0; k < TEST_N_KEYS; k += 3) {
+        assert(btree_remove(pc, btree_ft, k, false));
+        present[k] = false;
+        n_present--;
+    }
+    assert(!btree_remove(pc, btree_ft, 3, false));
+    assert(!btree_remove(pc, btree_ft, TEST_N_KEYS, false));
+
+    // Emptied leaves are skipped by scans
+    for (unsigned long k = 1000; k < 3000; ++k) {
+        if (present[k]) {
+            assert(btree_remove(pc, btree_ft, k, false));
+            present[k] = false;
+            n_present--;
+        }
+    }
+    check_tree(pc, present, n_present);
+
+    for (unsigned long k = 0; k < TEST_N_KEYS; k += 6) {
+        btree_insert(pc, btree_ft, k, k * 2, false);
+        present[k] = true;
+        n_present++;
+    }
+    check_tree(pc, present, n_present);
+
+    free(present);
+    page_cache_destroy(pc);
+    phy_database_delete(pdb);
+}
+
+void
+test_btree_bulk_load(void)
+{
+    phy_database* pdb = phy_database_create("test", "log_test_pdb");
+    page_cache*   pc  = page_cache_create(pdb, CACHE_N_PAGES, "log_test_pc");
+
+    unsigned long* keys    = calloc(TEST_N_KEYS, sizeof(unsigned long));
+    unsigned long* values  = calloc(TEST_N_KEYS, sizeof(unsigned long));
+    bool*          present = calloc(TEST_N_KEYS, sizeof(bool));
+    size_t         n_keys  = 0;
+
+    for (unsigned long k = 0; k < TEST_N_KEYS; k += 2) {
+        keys[n_keys]   = k;
+        values[n_keys] = k * 2;
+        present[k]     = true;
+        n_keys++;
+    }
+
+    btree_bulk_load(pc, btree_ft, keys, values, n_keys, false);
+    assert(btree_height(pc, btree_ft, false) == 2);
+    check_tree(pc, present, n_keys);
+
+    // The loaded tree accepts inserts between the loaded keys
+    for (unsigned long k = 1; k < TEST_N_KEYS; k += 2) {
+        btree_insert(pc, btree_ft, k, k * 2, false);
+        present[k] = true;
+    }
+    check_tree(pc, present, TEST_N_KEYS);
+
+    free(keys);
+    free(values);
+    free(present);
+    page_cache_destroy(pc);
+    phy_database_delete(pdb);
+
+    // Loading nothing leaves an empty tree that can be filled later
+    pdb = phy_database_create("test", "log_test_pdb");
+    pc  = page_cache_create(pdb, CACHE_N_PAGES, "log_test_pc");
+
+    btree_bulk_load(pc, btree_ft, NULL, NULL, 0, false);
+    assert(btree_size(pc, btree_ft, false) == 0);
+    assert(btree_find(pc, btree_ft, 1, false) == UNINITIALIZED_LONG);
+    btree_insert(pc, btree_ft, 1, 2, false);
+    assert(btree_find(pc, btree_ft, 1, false) == 2);
+
+    page_cache_destroy(pc);
+    phy_database_delete(pdb);
+}
+
+int
+main(void)
+{
+    test_btree_insert_remove();
+    printf("finished test btree insert and remove\n");
+    test_btree_bulk_load();
+    printf("finished test btree bulk load\n");
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+/*
+ * test_hash_index.c   1.0   Sep 15, 2021
+ *
+ * Copyright (c) 2021- University of Konstanz.
+ *
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "access/hash_index.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "constants.h"
+#include "page_cache.h"
+#include "physical_database.h"
+
+#define TEST_N_NODES   (40)
+#define TEST_N_ENTRIES (3000)
+
+static bool
+expected_find(const unsigned long* sources,
+              const unsigned long* targets,
+              const bool*          present,
+              unsigned long        source,
+              unsigned long        target,
+              unsigned long        rel_id)
+{
+    return present[rel_id] && sources[rel_id] == source
+           && targets[rel_id] == target;
+}
+
+static void
+check_index(page_cache*          pc,
+            const unsigned long* sources,
+            const unsigned long* targets,
+            const bool*          present,
+            unsigned long        n_present)
+{
+    assert(hash_index_size(pc, adjacency_ft, false) == n_present);
+
+    unsigned long rel_id;
+    bool          exists;
+    for (unsigned long s = 0; s < TEST_N_NODES; ++s) {
+        for (unsigned long t = 0; t < TEST_N_NODES; ++t) {
+            exists = false;
+            for (unsigned long i = 0; i < TEST_N_ENTRIES; ++i) {
+                exists = exists
+                         || expected_find(sources, targets, present, s, t, i);
+            }
+
+            rel_id = hash_index_find(pc, adjacency_ft, s, t, false);
+            assert(exists
+                         ? expected_find(
+                                 sources, targets, present, s, t, rel_id)
+                         : rel_id == UNINITIALIZED_LONG);
+        }
+    }
+}
+
+void
+test_hash_index(void)
+{
+    phy_database* pdb = phy_database_create("test", "log_test_pdb");
+    page_cache*   pc  = page_cache_create(pdb, CACHE_N_PAGES, "log_test_pc");
+
+    assert(hash_index_size(pc, adjacency_ft, false) == 0);
+    assert(hash_index_find(pc, adjacency_ft, 1, 2, false)
+           == UNINITIALIZED_LONG);
+
+    unsigned long* sources   = calloc(TEST_N_ENTRIES, sizeof(unsigned long));
+    unsigned long* targets   = calloc(TEST_N_ENTRIES, sizeof(unsigned long));
+    bool*          present   = calloc(TEST_N_ENTRIES, sizeof(bool));
+    unsigned long  n_present = 0;
+    unsigned long  state     = 7;
+
+    // Parallel entries and self loops included, the table grows repeatedly
+    for (unsigned long i = 0; i < TEST_N_ENTRIES; ++i) {
+        state      = state * 6364136223846793005UL + 1442695040888963407UL;
+        sources[i] = (state >> 33) % TEST_N_NODES;
+        state      = state * 6364136223846793005UL + 1442695040888963407UL;
+        targets[i] = i % 17 == 0 ? sources[i] : (state >> 33) % TEST_N_NODES;
+        present[i] = true;
+        n_present++;
+
+        hash_index_insert(pc, adjacency_ft, sources[i], targets[i], i, false);
+    }
+    assert(pdb->records[adjacency_ft]->num_pages * HASH_ENTRIES_PER_PAGE
+           >= 2 * TEST_N_ENTRIES);
+    check_index(pc, sources, targets, present, n_present);
+
+    for (unsigned long i = 0; i < TEST_N_ENTRIES; i += 3) {
+        hash_index_remove(pc, adjacency_ft, sources[i], targets[i], i, false);
+        present[i] = false;
+        n_present--;
+    }
+    check_index(pc, sources, targets, present, n_present);
+
+    // The removed ids are reused for other pairs
+    for (unsigned long i = 0; i < TEST_N_ENTRIES; i += 3) {
+        sources[i] = (i * 7) % TEST_N_NODES;
+        targets[i] = (i * 13) % TEST_N_NODES;
+        present[i] = true;
+        n_present++;
+
+        hash_index_insert(pc, adjacency_ft, sources[i], targets[i], i, false);
+    }
+    check_index(pc, sources, targets, present, n_present);
+
+    for (unsigned long i = 0; i < TEST_N_ENTRIES; ++i) {
+        hash_index_remove(pc, adjacency_ft, sources[i], targets[i], i, false);
+    }
+    assert(hash_index_size(pc, adjacency_ft, false) == 0);
+    assert(hash_index_find(pc, adjacency_ft, sources[0], targets[0], false)
+           == UNINITIALIZED_LONG);
+
+    free(sources);
+    free(targets);
+    free(present);
+    page_cache_destroy(pc);
+    phy_database_delete(pdb);
+}
+
+int
+main(void)
+{
+    test_hash_index();
+    printf("finished test hash index\n");
+
+    return 0;
+}
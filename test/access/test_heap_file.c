@@ -12,12 +12,15 @@
 #include "access/header_page.h"
 #include "access/node.h"
 #include "access/relationship.h"
+#include "access/relationship_group.h"
 #include "constants.h"
 #include "page_cache.h"
 #include "physical_database.h"
 
 #include <assert.h>
 #include <limits.h>
+#include <stdlib.h>
+#include <string.h>
 
 static const double test_weight_1 = 2.0;
 static const double test_weight_2 = 3.0;
@@ -51,7 +54,16 @@ test_heap_file_create(void)
     assert(hf->num_updates_nodes == 0);
     assert(hf->num_reads_rels == 0);
     assert(hf->num_update_rels == 0);
+    assert(hf->n_self_loops == 0);
+    assert(set_ul_size(hf->unsorted_nodes) == 0);
 
+    for (direction_t d = OUTGOING; d <= BOTH; ++d) {
+        assert(hf->degree_hist[d].min == 0);
+        assert(hf->degree_hist[d].max == 0);
+        free(hf->degree_hist[d].counts);
+    }
+
+    set_ul_destroy(hf->unsorted_nodes);
     free(hf);
     page_cache_destroy(pc);
     phy_database_delete(pdb);
@@ -643,6 +655,70 @@ test_update_node(void)
     phy_database_delete(pdb);
 }
 
+static void
+test_relabel_dense_node(void)
+{
+    char* file_name = "test";
+
+    char* log_name_pdb   = "log_test_pdb";
+    char* log_name_cache = "log_test_pc";
+    char* log_name_file  = "log_test_hf";
+
+    phy_database* pdb = phy_database_create(file_name, log_name_pdb);
+
+    page_cache* pc = page_cache_create(pdb, CACHE_N_PAGES, log_name_cache);
+
+    heap_file* hf = heap_file_create(pc, log_name_file);
+
+    static const size_t n_rels = 60;
+
+    unsigned long hub   = create_node(hf, 0, false);
+    unsigned long other = create_node(hf, 0, false);
+    unsigned long rel_id;
+    for (size_t i = 0; i < n_rels; ++i) {
+        rel_id = create_relationship(hf, hub, other, 1.0, 1, false);
+    }
+    assert(node_degree(hf, hub, BOTH, false) > DENSE_NODE_THRESHOLD);
+
+    relationship_t* rel = read_relationship(hf, rel_id, false);
+    rel->label          = 2;
+    update_relationship(hf, rel, false);
+    free(rel);
+
+    array_list_relationship* rels =
+          expand_with_label(hf, hub, OUTGOING, 2, false);
+    assert(array_list_relationship_size(rels) == 1);
+    assert(array_list_relationship_get(rels, 0)->id == rel_id);
+    array_list_relationship_destroy(rels);
+
+    rels = expand_with_label(hf, hub, OUTGOING, 1, false);
+    assert(array_list_relationship_size(rels) == n_rels - 1);
+    array_list_relationship_destroy(rels);
+
+    rels = expand(hf, hub, OUTGOING, false);
+    assert(array_list_relationship_size(rels) == n_rels);
+    array_list_relationship_destroy(rels);
+
+    // A new target leaves the adjacency index entry of the old one
+    rel              = read_relationship(hf, rel_id, false);
+    rel->target_node = hub;
+    update_relationship(hf, rel, false);
+    free(rel);
+
+    relationship_t* found =
+          contains_relationship_from_to(hf, hub, hub, OUTGOING, false);
+    assert(found && found->id == rel_id);
+    free(found);
+
+    rels = expand(hf, other, INCOMING, false);
+    assert(array_list_relationship_size(rels) == n_rels - 1);
+    array_list_relationship_destroy(rels);
+
+    heap_file_destroy(hf);
+    page_cache_destroy(pc);
+    phy_database_delete(pdb);
+}
+
 void
 test_update_relationship(void)
 {
@@ -663,24 +739,43 @@ test_update_relationship(void)
     unsigned long id  = create_relationship(hf, n_1, n_2, 1.0, 0, false);
     static const unsigned long label = 123;
 
+    // The relationship is linked anew, as its label and end points changed
     relationship_t* rel  = read_relationship(hf, id, false);
-    rel->source_node     = 1;
-    rel->target_node     = 0;
+    rel->source_node     = n_2;
+    rel->target_node     = n_1;
     rel->prev_rel_source = 2;
     rel->next_rel_source = 3;
     rel->prev_rel_target = 4;
     rel->next_rel_target = 1;
     rel->label           = label;
+    rel->weight          = 2.0;
     update_relationship(hf, rel, true);
+    free(rel);
 
-    assert(rel->source_node == 1);
-    assert(rel->target_node == 0);
+    rel = read_relationship(hf, id, false);
+    assert(rel->source_node == n_2);
+    assert(rel->target_node == n_1);
+    assert(rel->prev_rel_source == id);
+    assert(rel->next_rel_source == id);
+    assert(rel->prev_rel_target == id);
+    assert(rel->next_rel_target == id);
+    assert(rel->weight == 2.0);
+    assert(rel->label == label);
+
+    // The record is written as given
+    rel->prev_rel_source = 2;
+    rel->next_rel_source = 3;
+    rel->prev_rel_target = 4;
+    rel->next_rel_target = 1;
+    write_relationship_record(hf, rel, true);
+    free(rel);
+
+    rel = read_relationship(hf, id, false);
     assert(rel->prev_rel_source == 2);
     assert(rel->next_rel_source == 3);
     assert(rel->prev_rel_target == 4);
     assert(rel->next_rel_target == 1);
-
-    assert(rel->label == 123);
+    assert(rel->label == label);
     free(rel);
 
     heap_file_destroy(hf);
@@ -1144,6 +1239,597 @@ test_contains_relationship_from_to(void)
     phy_database_delete(pdb);
 }
 
+static void
+check_degrees(heap_file* hf)
+{
+    array_list_node*         nodes = get_nodes(hf, false);
+    array_list_relationship* rels;
+    unsigned long            node_id;
+    unsigned long            n_self_loops = 0;
+
+    unsigned long** counts = calloc(BOTH + 1, sizeof(unsigned long*));
+    for (direction_t d = OUTGOING; d <= BOTH; ++d) {
+        counts[d] = calloc(hf->n_rels + 1, sizeof(unsigned long));
+    }
+
+    for (size_t i = 0; i < array_list_node_size(nodes); ++i) {
+        node_id = array_list_node_get(nodes, i)->id;
+
+        for (direction_t d = OUTGOING; d <= BOTH; ++d) {
+            rels = expand(hf, node_id, d, false);
+            assert(node_degree(hf, node_id, d, false)
+                   == array_list_relationship_size(rels));
+            counts[d][array_list_relationship_size(rels)]++;
+
+            if (d == OUTGOING) {
+                for (size_t j = 0; j < array_list_relationship_size(rels);
+                     ++j) {
+                    relationship_t* rel = array_list_relationship_get(rels, j);
+                    n_self_loops += rel->source_node == rel->target_node;
+                }
+            }
+            array_list_relationship_destroy(rels);
+        }
+    }
+    array_list_node_destroy(nodes);
+
+    assert(hf->n_self_loops == n_self_loops);
+
+    for (direction_t d = OUTGOING; d <= BOTH; ++d) {
+        const degree_histogram* hist = &hf->degree_hist[d];
+
+        assert(counts[d][hist->min] > 0 && counts[d][hist->max] > 0);
+        for (unsigned long i = 0; i <= hf->n_rels; ++i) {
+            assert(i < hist->capacity ? hist->counts[i] == counts[d][i]
+                                      : counts[d][i] == 0);
+            assert(counts[d][i] == 0 || (hist->min <= i && i <= hist->max));
+        }
+        free(counts[d]);
+    }
+    free(counts);
+}
+
+void
+test_node_degree(void)
+{
+    char* file_name = "test";
+
+    char* log_name_pdb   = "log_test_pdb";
+    char* log_name_cache = "log_test_pc";
+    char* log_name_file  = "log_test_hf";
+
+    phy_database* pdb = phy_database_create(file_name, log_name_pdb);
+
+    page_cache* pc = page_cache_create(pdb, CACHE_N_PAGES, log_name_cache);
+
+    heap_file* hf = heap_file_create(pc, log_name_file);
+
+    static const size_t n_nodes = 600;
+    static const size_t n_rels  = 3000;
+
+    for (size_t i = 0; i < n_nodes; ++i) {
+        create_node(hf, i, false);
+    }
+
+    // A few hubs, self loops and parallel edges
+    unsigned long* rel_ids = calloc(n_rels, sizeof(unsigned long));
+    unsigned long  state   = 5;
+    unsigned long  from;
+    unsigned long  to;
+    for (size_t i = 0; i < n_rels; ++i) {
+        state = state * 6364136223846793005UL + 1442695040888963407UL;
+        from  = i % 7 == 0 ? 3 : (state >> 33) % n_nodes;
+        state = state * 6364136223846793005UL + 1442695040888963407UL;
+        to    = i % 53 == 0 ? from : (state >> 33) % n_nodes;
+
+        rel_ids[i] = create_relationship(hf, from, to, 1.0, 0, false);
+    }
+    check_degrees(hf);
+
+    for (size_t i = 0; i < n_rels; i += 3) {
+        delete_relationship(hf, rel_ids[i], false);
+    }
+    delete_node(hf, 3, false);
+    create_node(hf, 0, false);
+    check_degrees(hf);
+    free(rel_ids);
+
+    // The aggregates are restored from the degree file
+    degree_histogram hist[BOTH + 1];
+    for (direction_t d = OUTGOING; d <= BOTH; ++d) {
+        hist[d] = hf->degree_hist[d];
+        hist[d].counts =
+              calloc(hf->degree_hist[d].capacity, sizeof(unsigned long));
+        memcpy(hist[d].counts,
+               hf->degree_hist[d].counts,
+               hist[d].capacity * sizeof(unsigned long));
+    }
+    unsigned long n_self_loops = hf->n_self_loops;
+
+    heap_file_destroy(hf);
+    hf = heap_file_create(pc, log_name_file);
+
+    assert(hf->n_self_loops == n_self_loops);
+    for (direction_t d = OUTGOING; d <= BOTH; ++d) {
+        assert(hf->degree_hist[d].min == hist[d].min);
+        assert(hf->degree_hist[d].max == hist[d].max);
+        for (unsigned long i = hist[d].min; i <= hist[d].max; ++i) {
+            assert(hf->degree_hist[d].counts[i] == hist[d].counts[i]);
+        }
+        free(hist[d].counts);
+    }
+    check_degrees(hf);
+
+    heap_file_destroy(hf);
+    page_cache_destroy(pc);
+    phy_database_delete(pdb);
+}
+
+static bool
+in_direction(const relationship_t* rel,
+             unsigned long         node_id,
+             direction_t           direction)
+{
+    return (rel->source_node == node_id && direction != INCOMING)
+           || (rel->target_node == node_id && direction != OUTGOING);
+}
+
+static void
+check_groups(heap_file* hf, size_t n_nodes, size_t n_labels)
+{
+    array_list_relationship* all = get_relationships(hf, false);
+    array_list_relationship* rels;
+    relationship_t*          rel;
+    relationship_t*          found;
+    size_t                   expected;
+    size_t                   total;
+    unsigned long            reads;
+
+    for (unsigned long node_id = 0; node_id < n_nodes; ++node_id) {
+        for (direction_t d = OUTGOING; d <= BOTH; ++d) {
+            total = 0;
+
+            for (unsigned long label = 0; label < n_labels; ++label) {
+                expected = 0;
+                for (size_t i = 0; i < array_list_relationship_size(all); ++i) {
+                    rel = array_list_relationship_get(all, i);
+                    expected += rel->label == label
+                                && in_direction(rel, node_id, d);
+                }
+
+                // Dense nodes read nothing but the matching relationships
+                reads = hf->num_reads_rels;
+                rels  = expand_with_label(hf, node_id, d, label, false);
+                assert(array_list_relationship_size(rels) == expected);
+                assert(node_degree(hf, node_id, BOTH, false)
+                             <= DENSE_NODE_THRESHOLD
+                       || hf->num_reads_rels - reads == expected);
+
+                for (size_t i = 0; i < expected; ++i) {
+                    rel = array_list_relationship_get(rels, i);
+                    assert(rel->label == label);
+                    assert(in_direction(rel, node_id, d));
+                }
+                array_list_relationship_destroy(rels);
+                total += expected;
+            }
+
+            rels = expand(hf, node_id, d, false);
+            assert(array_list_relationship_size(rels) == total);
+            assert(node_degree(hf, node_id, d, false) == total);
+            array_list_relationship_destroy(rels);
+        }
+    }
+
+    for (unsigned long from = 0; from < n_nodes; from += 7) {
+        for (unsigned long to = 0; to < n_nodes; ++to) {
+            for (direction_t d = OUTGOING; d <= BOTH; ++d) {
+                expected = 0;
+                for (size_t i = 0; i < array_list_relationship_size(all); ++i) {
+                    rel = array_list_relationship_get(all, i);
+                    expected += (d != INCOMING && rel->source_node == from
+                                 && rel->target_node == to)
+                                || (d != OUTGOING && rel->source_node == to
+                                    && rel->target_node == from);
+                }
+
+                found = contains_relationship_from_to(hf, from, to, d, false);
+                assert((found != NULL) == (expected > 0));
+                free(found);
+            }
+        }
+    }
+    array_list_relationship_destroy(all);
+}
+
+void
+test_relationship_groups(void)
+{
+    char* file_name = "test";
+
+    char* log_name_pdb   = "log_test_pdb";
+    char* log_name_cache = "log_test_pc";
+    char* log_name_file  = "log_test_hf";
+
+    phy_database* pdb = phy_database_create(file_name, log_name_pdb);
+
+    page_cache* pc = page_cache_create(pdb, CACHE_N_PAGES, log_name_cache);
+
+    heap_file* hf = heap_file_create(pc, log_name_file);
+
+    static const size_t n_nodes  = 120;
+    static const size_t n_rels   = 2000;
+    static const size_t n_labels = 4;
+
+    for (size_t i = 0; i < n_nodes; ++i) {
+        create_node(hf, i, false);
+    }
+
+    // Four hubs with mixed labels, directions, self loops and parallel edges
+    unsigned long* rel_ids = calloc(n_rels, sizeof(unsigned long));
+    unsigned long  state   = 17;
+    unsigned long  from;
+    unsigned long  to;
+    for (size_t i = 0; i < n_rels; ++i) {
+        state = state * 6364136223846793005UL + 1442695040888963407UL;
+        from  = i % 3 == 0 ? i % 4 : (state >> 33) % n_nodes;
+        state = state * 6364136223846793005UL + 1442695040888963407UL;
+        to    = i % 5 == 0 ? i % 4 : (state >> 33) % n_nodes;
+        to    = i % 37 == 0 ? from : to;
+
+        rel_ids[i] = create_relationship(
+              hf, from, to, 1.0, (state >> 40) % n_labels, false);
+    }
+    assert(node_degree(hf, 0, BOTH, false) > DENSE_NODE_THRESHOLD);
+    check_groups(hf, n_nodes, n_labels);
+
+    // Groups are emptied and refilled
+    for (size_t i = 0; i < n_rels; i += 2) {
+        delete_relationship(hf, rel_ids[i], false);
+    }
+    for (size_t i = 0; i < n_rels / 4; ++i) {
+        create_relationship(hf, i % 4, (i * 7) % n_nodes, 2.0, i % 2, false);
+    }
+    check_groups(hf, n_nodes, n_labels);
+    check_degrees(hf);
+
+    // Relabeled relationships and ones with new end points move to the
+    // groups that match them
+    relationship_t* rel;
+    for (size_t i = 1; i < n_rels; i += 6) {
+        rel        = read_relationship(hf, rel_ids[i], false);
+        rel->label = (rel->label + 1) % n_labels;
+        if (i % 4 == 1) {
+            rel->source_node = i % 3;
+            rel->target_node = (i * 13) % n_nodes;
+        }
+        update_relationship(hf, rel, false);
+        free(rel);
+    }
+    check_groups(hf, n_nodes, n_labels);
+    check_degrees(hf);
+
+    delete_node(hf, 1, false);
+    create_node(hf, 0, false);
+    check_groups(hf, n_nodes, n_labels);
+    free(rel_ids);
+
+    heap_file_destroy(hf);
+    page_cache_destroy(pc);
+    phy_database_delete(pdb);
+}
+
+static void
+check_id_order(array_list_relationship* rels)
+{
+    for (size_t i = 1; i < array_list_relationship_size(rels); ++i) {
+        assert(array_list_relationship_get(rels, i - 1)->id
+               < array_list_relationship_get(rels, i)->id);
+    }
+}
+
+void
+test_id_order_insert(void)
+{
+    char* file_name = "test";
+
+    char* log_name_pdb   = "log_test_pdb";
+    char* log_name_cache = "log_test_pc";
+    char* log_name_file  = "log_test_hf";
+
+    phy_database* pdb = phy_database_create(file_name, log_name_pdb);
+
+    page_cache* pc = page_cache_create(pdb, CACHE_N_PAGES, log_name_cache);
+
+    heap_file* hf = heap_file_create(pc, log_name_file);
+
+    static const size_t n_nodes  = 200;
+    static const size_t n_rels   = 1000;
+    static const size_t n_hubs   = 4;
+    static const size_t n_labels = 3;
+
+    hf->rel_insertion = ID_ORDER_INSERT;
+
+    for (size_t i = 0; i < n_nodes; ++i) {
+        create_node(hf, i, false);
+    }
+
+    // Deleting every other relationship frees slots in the middle of the
+    // file, which the next relationships reuse with smaller ids
+    unsigned long* rel_ids = calloc(n_rels, sizeof(unsigned long));
+    unsigned long  state   = 23;
+    unsigned long  from;
+    unsigned long  to;
+    for (size_t round = 0; round < 3; ++round) {
+        for (size_t i = 0; i < n_rels; ++i) {
+            if (round > 0 && i % 2 == 1) {
+                continue;
+            }
+            state = state * 6364136223846793005UL + 1442695040888963407UL;
+            from  = i % 3 == 0 ? i % n_hubs : (state >> 33) % n_nodes;
+            state = state * 6364136223846793005UL + 1442695040888963407UL;
+            to    = i % 5 == 0 ? (from + 1) % n_hubs : (state >> 33) % n_nodes;
+            to    = to == from ? (to + 1) % n_nodes : to;
+
+            if (round > 0) {
+                delete_relationship(hf, rel_ids[i], false);
+            }
+            rel_ids[i] = create_relationship(
+                  hf, from, to, 1.0, (state >> 40) % n_labels, false);
+        }
+    }
+    free(rel_ids);
+
+    assert(set_ul_size(hf->unsorted_nodes) == 0);
+    check_groups(hf, n_nodes, n_labels);
+    check_degrees(hf);
+
+    // Sparse lists are sorted as a whole, dense ones within each group
+    array_list_relationship* rels;
+    for (unsigned long node_id = 0; node_id < n_nodes; ++node_id) {
+        if (node_id >= n_hubs) {
+            assert(node_degree(hf, node_id, BOTH, false)
+                   <= DENSE_NODE_THRESHOLD);
+            rels = expand(hf, node_id, BOTH, false);
+            check_id_order(rels);
+            array_list_relationship_destroy(rels);
+            continue;
+        }
+
+        assert(node_degree(hf, node_id, BOTH, false) > DENSE_NODE_THRESHOLD);
+        for (unsigned long label = 0; label < n_labels; ++label) {
+            for (direction_t d = OUTGOING; d < BOTH; ++d) {
+                rels = expand_with_label(hf, node_id, d, label, false);
+                check_id_order(rels);
+                array_list_relationship_destroy(rels);
+            }
+        }
+    }
+
+    heap_file_destroy(hf);
+    page_cache_destroy(pc);
+    phy_database_delete(pdb);
+}
+
+/* A relationship page holds the relationships of node 2 and 3, the next one
+ * those of node 0 and 1. After freeing a slot on either page, id order reuses
+ * the one on the page of the list, appending the first free one. */
+void
+test_id_order_slot_choice(void)
+{
+    const size_t rels_per_page = SLOTS_PER_PAGE / NUM_SLOTS_PER_REL;
+
+    for (insertion_mode mode = APPEND_INSERT; mode <= ID_ORDER_INSERT;
+         ++mode) {
+        phy_database* pdb = phy_database_create("test", "log_test_pdb");
+        page_cache*   pc =
+              page_cache_create(pdb, CACHE_N_PAGES, "log_test_pc");
+        heap_file* hf     = heap_file_create(pc, "log_test_hf");
+        hf->rel_insertion = mode;
+
+        for (size_t i = 0; i < 4; ++i) {
+            create_node(hf, i, false);
+        }
+
+        unsigned long* rel_ids =
+              calloc(2 * rels_per_page, sizeof(unsigned long));
+        for (size_t i = 0; i < 2 * rels_per_page; ++i) {
+            rel_ids[i] = i < rels_per_page
+                               ? create_relationship(hf, 2, 3, 1.0, 0, false)
+                               : create_relationship(hf, 0, 1, 1.0, 0, false);
+        }
+
+        unsigned long other_page = rel_ids[1];
+        unsigned long list_page  = rel_ids[rels_per_page + 1];
+        assert(other_page >> CHAR_BIT != list_page >> CHAR_BIT);
+
+        delete_relationship(hf, other_page, false);
+        delete_relationship(hf, list_page, false);
+
+        unsigned long rel_id = create_relationship(hf, 0, 1, 1.0, 0, false);
+        assert(rel_id == (mode == ID_ORDER_INSERT ? list_page : other_page));
+        relationship_t* rel =
+              contains_relationship_from_to(hf, 0, 1, OUTGOING, false);
+        assert(rel);
+        free(rel);
+
+        free(rel_ids);
+        heap_file_destroy(hf);
+        page_cache_destroy(pc);
+        phy_database_delete(pdb);
+    }
+}
+
+static void
+check_labels(heap_file* hf, unsigned long n_labels)
+{
+    array_list_node* all   = get_nodes(hf, false);
+    size_t           found = 0;
+    array_list_node* with_label;
+    node_t*          node;
+
+    for (unsigned long l = 0; l < n_labels; ++l) {
+        with_label = find_nodes_by_label(hf, l, false);
+
+        for (size_t i = 0; i < array_list_node_size(with_label); ++i) {
+            node = array_list_node_get(with_label, i);
+            assert(node->label == l);
+            assert(check_record_exists(hf, node->id, true, false));
+        }
+
+        if (array_list_node_size(with_label) > 0) {
+            node = find_node(hf, l, false);
+            assert(node->id == array_list_node_get(with_label, 0)->id);
+            free(node);
+        }
+
+        found += array_list_node_size(with_label);
+        array_list_node_destroy(with_label);
+    }
+    assert(found == array_list_node_size(all));
+    array_list_node_destroy(all);
+}
+
+void
+test_find_by_label(void)
+{
+    char* file_name = "test";
+
+    char* log_name_pdb   = "log_test_pdb";
+    char* log_name_cache = "log_test_pc";
+    char* log_name_file  = "log_test_hf";
+
+    phy_database* pdb = phy_database_create(file_name, log_name_pdb);
+
+    page_cache* pc = page_cache_create(pdb, CACHE_N_PAGES, log_name_cache);
+
+    heap_file* hf = heap_file_create(pc, log_name_file);
+
+    static const size_t n_nodes  = 600;
+    static const size_t n_labels = 7;
+
+    for (size_t i = 0; i < n_nodes; ++i) {
+        create_node(hf, i % n_labels, false);
+    }
+    for (size_t i = 0; i < n_nodes; ++i) {
+        create_relationship(hf, i, (i * 13) % n_nodes, 1.0, i % 3, false);
+    }
+    check_labels(hf, n_labels);
+
+    node_t* node = find_node(hf, 3, false);
+    assert(node->id == 3);
+    free(node);
+
+    relationship_t* rel = find_relationships(hf, 2, false);
+    assert(rel->label == 2);
+    free(rel);
+
+    // Relabelled nodes move to the end of their new chain
+    node        = read_node(hf, 3, false);
+    node->label = n_labels;
+    update_node(hf, node, false);
+    free(node);
+
+    node = find_node(hf, 3, false);
+    assert(node->id == 3 + n_labels);
+    free(node);
+    node = find_node(hf, n_labels, false);
+    assert(node->id == 3);
+    free(node);
+
+    for (size_t i = 0; i < n_nodes; i += 5) {
+        delete_node(hf, i, false);
+    }
+    check_labels(hf, n_labels + 1);
+
+    // Freed slots are indexed again with their new label
+    for (size_t i = 0; i < n_nodes / 10; ++i) {
+        create_node(hf, n_labels - 1, false);
+    }
+    check_labels(hf, n_labels + 1);
+
+    heap_file_destroy(hf);
+    page_cache_destroy(pc);
+    phy_database_delete(pdb);
+}
+
+/* Files without slots that are missing on open, e.g. as the database was
+ * written before they existed, are rebuilt from the records. */
+void
+test_open_without_side_files(void)
+{
+    char* file_name = "test";
+
+    char* log_name_pdb   = "log_test_pdb";
+    char* log_name_cache = "log_test_pc";
+    char* log_name_file  = "log_test_hf";
+
+    phy_database* pdb = phy_database_create(file_name, log_name_pdb);
+
+    page_cache* pc = page_cache_create(pdb, CACHE_N_PAGES, log_name_cache);
+
+    heap_file* hf = heap_file_create(pc, log_name_file);
+
+    static const size_t n_nodes  = 120;
+    static const size_t n_rels   = 1000;
+    static const size_t n_labels = 3;
+
+    for (size_t i = 0; i < n_nodes; ++i) {
+        create_node(hf, i % n_labels, false);
+    }
+
+    // Two hubs, so that the rebuilt groups are checked as well
+    unsigned long state = 23;
+    unsigned long from;
+    unsigned long to;
+    for (size_t i = 0; i < n_rels; ++i) {
+        state = state * 6364136223846793005UL + 1442695040888963407UL;
+        from  = i % 3 == 0 ? i % 2 : (state >> 33) % n_nodes;
+        state = state * 6364136223846793005UL + 1442695040888963407UL;
+        to    = i % 41 == 0 ? from : (state >> 33) % n_nodes;
+
+        create_relationship(hf, from, to, 1.0, (state >> 40) % n_labels, false);
+    }
+    assert(node_degree(hf, 0, BOTH, false) > DENSE_NODE_THRESHOLD);
+
+    heap_file_destroy(hf);
+    page_cache_destroy(pc);
+    phy_database_close(pdb);
+
+    assert(remove("test_degrees.db") == 0);
+    assert(remove("test_groups.db") == 0);
+    assert(remove("test_adjacency.db") == 0);
+    assert(remove("test_node_labels.db") == 0);
+
+    pdb = phy_database_open(file_name, log_name_pdb);
+    assert(pdb->recreated[degree_ft] && pdb->recreated[group_ft]);
+    assert(pdb->recreated[adjacency_ft]);
+
+    // The label index is recreated as a whole
+    assert(pdb->recreated[label_ft] && pdb->recreated[node_label_ft]
+           && pdb->recreated[relationship_label_ft]);
+    assert(!pdb->recreated[btree_ft]);
+
+    pc = page_cache_create(pdb, CACHE_N_PAGES, log_name_cache);
+    hf = heap_file_create(pc, log_name_file);
+
+    assert(hf->n_nodes == n_nodes && hf->n_rels == n_rels);
+    check_degrees(hf);
+    check_groups(hf, n_nodes, n_labels);
+    check_labels(hf, n_labels);
+
+    relationship_t* rel;
+    for (unsigned long l = 0; l < n_labels; ++l) {
+        rel = find_relationships(hf, l, false);
+        assert(rel && rel->label == l);
+        free(rel);
+    }
+
+    heap_file_destroy(hf);
+    page_cache_destroy(pc);
+    phy_database_delete(pdb);
+}
+
 int
 main(void)
 {
@@ -1167,6 +1853,8 @@ main(void)
     printf("finished test update_node\n");
     test_update_relationship();
     printf("finished test update_relationship\n");
+    test_relabel_dense_node();
+    printf("finished test relabel dense node\n");
     test_delete_node();
     printf("finished test delete_node\n");
     test_delete_relationship();
@@ -1183,6 +1871,18 @@ main(void)
     printf("finished test expand\n");
     test_contains_relationship_from_to();
     printf("finished test contains rel\n");
+    test_node_degree();
+    printf("finished test node degree\n");
+    test_relationship_groups();
+
+    test_id_order_insert();
+    printf("finished test relationship groups\n");
+    test_id_order_slot_choice();
+    printf("finished test id order slot choice\n");
+    test_find_by_label();
+    printf("finished test find by label\n");
+    test_open_without_side_files();
+    printf("finished test open without side files\n");
 
     return 0;
 }
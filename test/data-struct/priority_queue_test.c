@@ -0,0 +1,178 @@
+/*
+ * priority_queue_test.c   1.0   Sep 15, 2021
+ *
+ * Copyright (c) 2021- University of Konstanz.
+ *
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "data-struct/priority_queue.h"
+
+#include <assert.h>
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST_N_VALUES (1000)
+
+static unsigned long
+next_random(unsigned long* state)
+{
+    *state = *state * 6364136223846793005UL + 1442695040888963407UL;
+    return *state >> 33;
+}
+
+void
+test_create(pq_type type)
+{
+    priority_queue* pq = priority_queue_create(type);
+
+    assert(pq);
+    assert(pq->type == type);
+    assert(priority_queue_size(pq) == 0);
+    assert(!priority_queue_contains(pq, 0));
+
+    priority_queue_destroy(pq);
+}
+
+void
+test_push_extract(pq_type type)
+{
+    priority_queue* pq = priority_queue_create(type);
+
+    priority_queue_push(pq, 3.0, 7);
+    priority_queue_push(pq, 1.0, 2);
+    priority_queue_push(pq, 2.0, 42);
+
+    assert(priority_queue_size(pq) == 3);
+    assert(priority_queue_contains(pq, 42));
+    assert(priority_queue_min_key(pq) == 1.0);
+
+    double key;
+    assert(priority_queue_extract_min(pq, &key) == 2);
+    assert(key == 1.0);
+    assert(!priority_queue_contains(pq, 2));
+    assert(priority_queue_extract_min(pq, &key) == 42);
+    assert(key == 2.0);
+    assert(priority_queue_extract_min(pq, &key) == 7);
+    assert(key == 3.0);
+    assert(priority_queue_size(pq) == 0);
+
+    priority_queue_destroy(pq);
+}
+
+void
+test_decrease_key(pq_type type)
+{
+    priority_queue* pq = priority_queue_create(type);
+
+    priority_queue_push(pq, 5.0, 1);
+    priority_queue_push(pq, 6.0, 2);
+    priority_queue_push(pq, 7.0, 3);
+
+    // Pushing a contained value with a larger key must not change anything.
+    priority_queue_push(pq, 8.0, 1);
+    assert(priority_queue_size(pq) == 3);
+    assert(priority_queue_min_key(pq) == 5.0);
+
+    priority_queue_push(pq, 4.0, 3);
+    assert(priority_queue_size(pq) == 3);
+
+    double key;
+    assert(priority_queue_extract_min(pq, &key) == 3);
+    assert(key == 4.0);
+    assert(priority_queue_extract_min(pq, &key) == 1);
+    assert(key == 5.0);
+    assert(priority_queue_extract_min(pq, &key) == 2);
+    assert(key == 6.0);
+
+    priority_queue_destroy(pq);
+}
+
+/* Simulates the access pattern of Dijkstra's algorithm: keys pushed after an
+ * extract are never smaller than the extracted one, which the radix heap
+ * relies on. The extracted keys have to be non-decreasing and every value
+ * has to leave the queue with its smallest pushed key. */
+void
+test_monotone_sequence(pq_type type)
+{
+    priority_queue* pq          = priority_queue_create(type);
+    double          best[TEST_N_VALUES];
+    bool            extracted[TEST_N_VALUES];
+    unsigned long   state = 3;
+
+    for (size_t i = 0; i < TEST_N_VALUES; ++i) {
+        best[i]      = DBL_MAX;
+        extracted[i] = false;
+    }
+
+    unsigned long value;
+    double        key;
+    double        last_key = 0;
+
+    for (size_t i = 0; i < TEST_N_VALUES / 10; ++i) {
+        value = next_random(&state) % TEST_N_VALUES;
+        key   = (double)(next_random(&state) % 100);
+        if (key < best[value]) {
+            best[value] = key;
+        }
+        priority_queue_push(pq, key, value);
+    }
+
+    while (priority_queue_size(pq) > 0) {
+        value = priority_queue_extract_min(pq, &key);
+
+        assert(key >= last_key);
+        assert(!extracted[value]);
+        assert(key == best[value]);
+        extracted[value] = true;
+        last_key         = key;
+
+        for (size_t j = 0; j < 3; ++j) {
+            value = next_random(&state) % TEST_N_VALUES;
+            key   = last_key + (double)(next_random(&state) % 100) / 10.0;
+
+            if (!extracted[value]) {
+                if (key < best[value]) {
+                    best[value] = key;
+                }
+                priority_queue_push(pq, key, value);
+            }
+        }
+    }
+
+    priority_queue_destroy(pq);
+}
+
+void
+test_destroy_non_empty(pq_type type)
+{
+    priority_queue* pq = priority_queue_create(type);
+
+    for (unsigned long i = 0; i < TEST_N_VALUES; ++i) {
+        priority_queue_push(pq, (double)(TEST_N_VALUES - i), i);
+    }
+    priority_queue_extract_min(pq, NULL);
+
+    priority_queue_destroy(pq);
+}
+
+int
+main(void)
+{
+    for (pq_type type = fibonacci_pq; type < invalid_pq; ++type) {
+        test_create(type);
+        printf("%s: Create passed\n", priority_queue_type_name(type));
+        test_push_extract(type);
+        printf("%s: Push and extract passed\n",
+               priority_queue_type_name(type));
+        test_decrease_key(type);
+        printf("%s: Decrease key passed\n", priority_queue_type_name(type));
+        test_monotone_sequence(type);
+        printf("%s: Monotone sequence passed\n",
+               priority_queue_type_name(type));
+        test_destroy_non_empty(type);
+        printf("%s: Destroy passed\n", priority_queue_type_name(type));
+    }
+}
@@ -121,11 +121,21 @@ test_phy_database_create(void)
 
     assert(pdb);
     assert(pdb->catalogue);
-    for (file_type i = 0; i < invalid_ft; ++i) {
+    for (file_type i = 0; i < NUM_SLOTTED_FILE_TYPES; ++i) {
         assert(pdb->header[i]);
         assert(pdb->records[i]);
         assert(pdb->remaining_header_bits[i] == PAGE_SIZE * CHAR_BIT);
     }
+    assert(pdb->records[degree_ft]);
+    assert(pdb->records[degree_ft]->num_pages == 0);
+    assert(pdb->records[group_ft]);
+    assert(pdb->records[group_ft]->num_pages == 0);
+    assert(pdb->records[adjacency_ft]);
+    assert(pdb->records[adjacency_ft]->num_pages == 0);
+    for (file_type i = label_ft; i <= btree_ft; ++i) {
+        assert(pdb->records[i]);
+        assert(pdb->records[i]->num_pages == 0);
+    }
 
     phy_database_delete(pdb);
     printf("test phy db create successfull!\n");
@@ -149,6 +159,13 @@ test_phy_database_delete(void)
     assert(!fopen("test_relationships.db", "r"));
     assert(!fopen("test_nodes.idx", "r"));
     assert(!fopen("test_relationships.idx", "r"));
+    assert(!fopen("test_degrees.db", "r"));
+    assert(!fopen("test_groups.db", "r"));
+    assert(!fopen("test_adjacency.db", "r"));
+    assert(!fopen("test_labels.db", "r"));
+    assert(!fopen("test_node_labels.db", "r"));
+    assert(!fopen("test_relationship_labels.db", "r"));
+    assert(!fopen("test_btree.db", "r"));
 
     printf("test phy db delete successfull!\n");
 }
@@ -171,18 +188,39 @@ test_phy_database_close(void)
     FILE* rels      = fopen("test_relationships.db", "r");
     FILE* nheader   = fopen("test_nodes.idx", "r");
     FILE* rheader   = fopen("test_relationships.idx", "r");
+    FILE* degrees   = fopen("test_degrees.db", "r");
+    FILE* groups    = fopen("test_groups.db", "r");
+    FILE* adjacency = fopen("test_adjacency.db", "r");
+    FILE* labels    = fopen("test_labels.db", "r");
+    FILE* nlabels   = fopen("test_node_labels.db", "r");
+    FILE* rlabels   = fopen("test_relationship_labels.db", "r");
+    FILE* btree     = fopen("test_btree.db", "r");
 
     assert(catalogue);
     assert(nodes);
     assert(rels);
     assert(nheader);
     assert(rheader);
+    assert(degrees);
+    assert(groups);
+    assert(adjacency);
+    assert(labels);
+    assert(nlabels);
+    assert(rlabels);
+    assert(btree);
 
     remove("test.info");
     remove("test_nodes.db");
     remove("test_relationships.db");
     remove("test_nodes.idx");
     remove("test_relationships.idx");
+    remove("test_degrees.db");
+    remove("test_groups.db");
+    remove("test_adjacency.db");
+    remove("test_labels.db");
+    remove("test_node_labels.db");
+    remove("test_relationship_labels.db");
+    remove("test_btree.db");
 
     printf("test phy db close successfull!\n");
 }
@@ -204,6 +242,9 @@ test_allocate_pages(void)
     assert(pdb->header[node_ft]->file_size == PAGE_SIZE);
     assert(pdb->remaining_header_bits[node_ft]
            == PAGE_SIZE * CHAR_BIT - PAGE_SIZE / SLOT_SIZE);
+    assert(pdb->records[degree_ft]->num_pages
+           == SLOTS_PER_PAGE / DEGREE_ENTRIES_PER_PAGE
+                    + (SLOTS_PER_PAGE % DEGREE_ENTRIES_PER_PAGE != 0));
 
     // PAGE_SIZE is here just to test sth. larger than 1
     allocate_pages(pdb, node_ft, PAGE_SIZE - 1, false);
@@ -222,6 +263,10 @@ test_allocate_pages(void)
           - PAGE_SIZE * (PAGE_SIZE / SLOT_SIZE);
 
     assert(pdb->remaining_header_bits[node_ft] == remaining_bits);
+    assert(pdb->records[degree_ft]->num_pages * DEGREE_ENTRIES_PER_PAGE
+           >= PAGE_SIZE * SLOTS_PER_PAGE);
+    assert((pdb->records[degree_ft]->num_pages - 1) * DEGREE_ENTRIES_PER_PAGE
+           < PAGE_SIZE * SLOTS_PER_PAGE);
 
     phy_database_delete(pdb);
 
@@ -257,6 +302,77 @@ test_phy_database_open(void)
     phy_database_delete(pdb);
 }
 
+void
+test_phy_database_replace(void)
+{
+    phy_database* pdb         = phy_database_create("test", "test_log");
+    phy_database* replacement = phy_database_create_next(pdb, "test_log");
+
+    assert(replacement->generation == 1);
+    assert(strcmp(replacement->catalogue->file_name, "test.1.info") == 0);
+
+    allocate_pages(replacement, relationship_ft, 2, false);
+    allocate_pages(replacement, btree_ft, 1, false);
+    unsigned char data[PAGE_SIZE];
+    memset(data, 1, PAGE_SIZE);
+    write_page(replacement->records[btree_ft], 0, data, false);
+
+    phy_database_replace(pdb, replacement);
+
+    // The old files are gone, the new ones keep the names of their generation
+    assert(!fopen("test.1.info", "r"));
+    assert(!fopen("test_relationships.db", "r"));
+    assert(strcmp(pdb->catalogue->file_name, "test.info") == 0);
+    assert(strcmp(pdb->records[btree_ft]->file_name, "test.1_btree.db") == 0);
+    assert(pdb->generation == 1);
+    assert(pdb->records[relationship_ft]->num_pages == 2);
+    assert(pdb->remaining_header_bits[relationship_ft]
+           == PAGE_SIZE * CHAR_BIT - 2 * SLOTS_PER_PAGE);
+
+    phy_database_close(pdb);
+    pdb = phy_database_open("test", "test_log");
+    assert(pdb->generation == 1);
+
+    memset(data, 0, PAGE_SIZE);
+    read_page(pdb->records[btree_ft], 0, data, false);
+    for (size_t i = 0; i < PAGE_SIZE; ++i) {
+        assert(data[i] == 1);
+    }
+    assert(pdb->records[relationship_ft]->num_pages == 2);
+
+    // A further replacement starts from the reopened generation
+    replacement = phy_database_create_next(pdb, "test_log");
+    phy_database_replace(pdb, replacement);
+    assert(pdb->generation == 2);
+    assert(pdb->records[relationship_ft]->num_pages == 0);
+    assert(!fopen("test.1_btree.db", "r"));
+
+    phy_database_delete(pdb);
+    assert(!fopen("test.info", "r"));
+    assert(!fopen("test.2_nodes.db", "r"));
+    printf("test phy db replace successfull!\n");
+}
+
+void
+test_phy_database_changes(void)
+{
+    phy_database* pdb = phy_database_create("test", "test_log");
+    assert(pdb->n_changes == 0);
+    pdb->n_changes = 5;
+    phy_database_close(pdb);
+
+    pdb = phy_database_open("test", "test_log");
+    assert(pdb->n_changes == 5);
+
+    // Opened again without closing it first, the changes are unknown
+    phy_database* unclosed = phy_database_open("test", "test_log");
+    assert(unclosed->n_changes == 5 + UNCLOSED_CHANGES);
+    phy_database_close(unclosed);
+
+    phy_database_delete(pdb);
+    printf("test phy db changes successfull!\n");
+}
+
 void
 test_deallocate_pages(void)
 {
@@ -279,6 +395,8 @@ main(void)
     test_phy_database_close();
     test_allocate_pages();
     test_phy_database_open();
+    test_phy_database_replace();
+    test_phy_database_changes();
     test_deallocate_pages();
     test_defragment();
 
@@ -0,0 +1,203 @@
+/*
+ * draw_test.c   1.0   Sep 15, 2021
+ *
+ * Copyright (c) 2021- University of Konstanz.
+ *
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "order/draw.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "access/heap_file.h"
+#include "access/node.h"
+#include "access/relationship.h"
+
+#define TEST_N_PAGES      (4)
+#define TEST_N_NODES      (TEST_N_PAGES * SLOTS_PER_PAGE)
+#define TEST_N_GROUPS     (8)
+#define TEST_N_ROUNDS     (8)
+#define TEST_LOG_PATH     "log_test_draw_access"
+
+static heap_file*
+prepare(void)
+{
+    phy_database* pdb = phy_database_create("test", "log_test_pdb");
+    page_cache*   pc  = page_cache_create(pdb, CACHE_N_PAGES, "log_test_pc");
+    heap_file*    hf  = heap_file_create(pc, "log_test_hf");
+
+    for (size_t i = 0; i < TEST_N_NODES; ++i) {
+        create_node(hf, i, false);
+    }
+
+    // A ring, so that the test can check that the relationships follow
+    for (size_t i = 0; i < TEST_N_NODES; ++i) {
+        create_relationship(hf, i, (i + 1) % TEST_N_NODES, 1, 0, false);
+    }
+
+    return hf;
+}
+
+static void
+clean_up(heap_file* hf)
+{
+    page_cache*   pc  = hf->cache;
+    phy_database* pdb = pc->pdb;
+    heap_file_destroy(hf);
+    page_cache_destroy(pc);
+    phy_database_delete(pdb);
+}
+
+/* The members of group g have the labels g + k * SLOTS_PER_PAGE, one on each
+ * page before the reorganization. */
+static void
+run_queries(heap_file* hf)
+{
+    node_t* node;
+    for (size_t r = 0; r < TEST_N_ROUNDS; ++r) {
+        for (size_t g = 0; g < TEST_N_GROUPS; ++g) {
+            for (size_t k = 0; k < TEST_N_PAGES; ++k) {
+                node = read_node(hf, g + k * SLOTS_PER_PAGE, false);
+                free(node);
+            }
+        }
+    }
+}
+
+static unsigned long*
+ids_by_label(heap_file* hf)
+{
+    unsigned long*   ids   = calloc(TEST_N_NODES, sizeof(unsigned long));
+    array_list_node* nodes = get_nodes(hf, false);
+
+    node_t* node;
+    for (size_t i = 0; i < array_list_node_size(nodes); ++i) {
+        node             = array_list_node_get(nodes, i);
+        ids[node->label] = node->id;
+    }
+    array_list_node_destroy(nodes);
+
+    return ids;
+}
+
+static void
+check_ring(heap_file* hf, const unsigned long* ids)
+{
+    array_list_relationship* rels;
+    relationship_t*          rel;
+    node_t*                  target;
+
+    for (size_t i = 0; i < TEST_N_NODES; ++i) {
+        rels = expand(hf, ids[i], OUTGOING, false);
+        assert(array_list_relationship_size(rels) == 1);
+        rel = array_list_relationship_get(rels, 0);
+        assert(rel->source_node == ids[i]);
+
+        target = read_node(hf, rel->target_node, false);
+        assert(target->label == (i + 1) % TEST_N_NODES);
+        free(target);
+        array_list_relationship_destroy(rels);
+    }
+}
+
+static void
+test_reorganize(void)
+{
+    heap_file*        hf          = prepare();
+    draw_reorganizer* reorganizer = draw_reorganizer_create(hf, 4, 1);
+
+    run_queries(hf);
+    assert(reorganizer->n_accesses
+           == TEST_N_ROUNDS * TEST_N_GROUPS * TEST_N_PAGES);
+
+    // Incremental: Each call moves at most the given number of records
+    assert(draw_reorganize(reorganizer, 5, false) == 5);
+    while (draw_reorganize(reorganizer, 5, false) > 0) {
+    }
+
+    // The reads of the migration itself are not counted
+    assert(reorganizer->n_accesses
+           == TEST_N_ROUNDS * TEST_N_GROUPS * TEST_N_PAGES);
+
+    unsigned long* ids = ids_by_label(hf);
+    for (size_t g = 0; g < TEST_N_GROUPS; ++g) {
+        for (size_t k = 1; k < TEST_N_PAGES; ++k) {
+            assert(ids[g + k * SLOTS_PER_PAGE] >> CHAR_BIT
+                   == ids[g] >> CHAR_BIT);
+        }
+    }
+    check_ring(hf, ids);
+    free(ids);
+
+    draw_reorganizer_destroy(reorganizer);
+    assert(hf->access_hook == NULL);
+    clean_up(hf);
+}
+
+static void
+test_sampling(void)
+{
+    heap_file*        hf          = prepare();
+    draw_reorganizer* reorganizer = draw_reorganizer_create(hf, 4, 2);
+
+    node_t* node;
+    for (size_t i = 0; i < 10; ++i) {
+        node = read_node(hf, 7, false);
+        free(node);
+    }
+
+    assert(reorganizer->n_accesses == 10);
+    assert(dict_ul_ul_get_direct(reorganizer->stats[node_ft].heat, 7) == 5);
+    // Repeated reads of one record are no co-accesses
+    assert(dict_ul_ul_size(reorganizer->stats[node_ft].co_access) == 0);
+
+    draw_reorganizer_destroy(reorganizer);
+    clean_up(hf);
+}
+
+static void
+test_read_log(void)
+{
+    heap_file*        hf          = prepare();
+    draw_reorganizer* reorganizer = draw_reorganizer_create(hf, 4, 1);
+
+    FILE* log_file = fopen(TEST_LOG_PATH, "w");
+    fprintf(log_file, "bfs N 3\n");
+    fprintf(log_file, "read_node 300 300\n");
+    fprintf(log_file, "Pin 0 0 1\n");
+    fprintf(log_file, "dijkstra R 4\n");
+    fprintf(log_file, "read_rel 4 1\n");
+    fprintf(log_file, "get_degree N  3\n");
+    fclose(log_file);
+
+    draw_read_log(reorganizer, TEST_LOG_PATH);
+    remove(TEST_LOG_PATH);
+
+    draw_statistics* nodes = &reorganizer->stats[node_ft];
+    draw_statistics* rels  = &reorganizer->stats[relationship_ft];
+    assert(dict_ul_ul_get_direct(nodes->heat, 3) == 2);
+    assert(dict_ul_ul_get_direct(nodes->heat, 300) == 1);
+    assert(dict_ul_ul_size(nodes->heat) == 2);
+    assert(dict_ul_ul_get_direct(rels->heat, 4) == 2);
+    assert(dict_ul_ul_size(nodes->co_access) == 1);
+    assert(dict_ul_ul_get_direct(nodes->co_access, 3UL << 32 | 300) == 1);
+
+    draw_reorganizer_destroy(reorganizer);
+    clean_up(hf);
+}
+
+int
+main(void)
+{
+    test_reorganize();
+    test_sampling();
+    test_read_log();
+
+    return 0;
+}
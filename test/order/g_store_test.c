@@ -0,0 +1,217 @@
+/*
+ * g_store_test.c   1.0   Sep 15, 2021
+ *
+ * Copyright (c) 2021- University of Konstanz.
+ *
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "order/g_store.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "access/csr_graph.h"
+#include "access/heap_file.h"
+#include "access/node.h"
+#include "access/relationship.h"
+#include "order/reorder_records.h"
+
+#define TEST_N_GROUPS      (4)
+#define TEST_EDGES_PER_NODE (3)
+#define TEST_CROSS_EVERY   (16)
+
+static unsigned long
+per_page(void)
+{
+    return SLOTS_PER_PAGE / NUM_SLOTS_PER_NODE;
+}
+
+static unsigned long
+next_random(unsigned long* state)
+{
+    *state = *state * 6364136223846793005UL + 1442695040888963407UL;
+    return *state >> 33;
+}
+
+/* Groups of one page each, interleaved so that the ids do not give them
+ * away. */
+static heap_file*
+prepare(void)
+{
+    phy_database* pdb = phy_database_create("test", "log_test_pdb");
+    page_cache*   pc  = page_cache_create(pdb, CACHE_N_PAGES, "log_test_pc");
+    heap_file*    hf  = heap_file_create(pc, "log_test_hf");
+
+    unsigned long n = TEST_N_GROUPS * per_page();
+    for (size_t i = 0; i < n; ++i) {
+        create_node(hf, i, false);
+    }
+
+    unsigned long state = 42;
+    unsigned long to;
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < TEST_EDGES_PER_NODE; ++j) {
+            to = next_random(&state) % per_page() * TEST_N_GROUPS
+                 + i % TEST_N_GROUPS;
+            create_relationship(hf, i, to, 1, 0, false);
+        }
+
+        if (i % TEST_CROSS_EVERY == 0) {
+            create_relationship(hf, i, next_random(&state) % n, 1, 0, false);
+        }
+    }
+
+    return hf;
+}
+
+static void
+clean_up(heap_file* hf)
+{
+    page_cache*   pc  = hf->cache;
+    phy_database* pdb = pc->pdb;
+    heap_file_destroy(hf);
+    page_cache_destroy(pc);
+    phy_database_delete(pdb);
+}
+
+static unsigned long
+cross_page_relationships(const csr_graph* graph, dict_ul_ul* node_order)
+{
+    unsigned long cross = 0;
+    unsigned long from;
+    unsigned long to;
+
+    for (size_t v = 0; v < graph->n_nodes; ++v) {
+        for (size_t e = graph->offsets[OUTGOING][v];
+             e < graph->offsets[OUTGOING][v + 1];
+             ++e) {
+            from = graph->node_ids[v];
+            to   = graph->node_ids[graph->edges[OUTGOING][e].neighbour];
+
+            if (node_order) {
+                from = dict_ul_ul_get_direct(node_order, from);
+                to   = dict_ul_ul_get_direct(node_order, to);
+            }
+            cross += (from >> CHAR_BIT) != (to >> CHAR_BIT);
+        }
+    }
+
+    return cross;
+}
+
+static void
+check_dense(dict_ul_ul* order, size_t n, size_t n_slots)
+{
+    assert(dict_ul_ul_size(order) == n);
+
+    bool*                seen = calloc(n, sizeof(bool));
+    dict_ul_ul_iterator* it   = dict_ul_ul_iterator_create(order);
+    unsigned long        key;
+    unsigned long        value;
+    size_t               position;
+    size_t               records_per_page = SLOTS_PER_PAGE / n_slots;
+
+    while (dict_ul_ul_iterator_next(it, &key, &value) == 0) {
+        assert((value & UCHAR_MAX) % n_slots == 0);
+        position = (value >> CHAR_BIT) * records_per_page
+                   + (value & UCHAR_MAX) / n_slots;
+        assert(position < n);
+        assert(!seen[position]);
+        seen[position] = true;
+    }
+    dict_ul_ul_iterator_destroy(it);
+    free(seen);
+}
+
+static int
+compare_ends(const void* fst, const void* snd)
+{
+    const unsigned long* a = fst;
+    const unsigned long* b = snd;
+
+    if (a[0] != b[0]) {
+        return a[0] < b[0] ? -1 : 1;
+    }
+
+    return (a[1] > b[1]) - (a[1] < b[1]);
+}
+
+/* The labels of the source and target of each relationship, sorted. */
+static unsigned long*
+relationship_ends(heap_file* hf)
+{
+    array_list_relationship* rels = get_relationships(hf, false);
+    unsigned long* ends = calloc(2 * hf->n_rels, sizeof(unsigned long));
+    relationship_t*          rel;
+    node_t*                  node;
+
+    assert(array_list_relationship_size(rels) == hf->n_rels);
+    for (size_t i = 0; i < hf->n_rels; ++i) {
+        rel  = array_list_relationship_get(rels, i);
+        node = read_node(hf, rel->source_node, false);
+        ends[2 * i] = node->label;
+        free(node);
+        node = read_node(hf, rel->target_node, false);
+        ends[2 * i + 1] = node->label;
+        free(node);
+    }
+    array_list_relationship_destroy(rels);
+
+    qsort(ends, hf->n_rels, 2 * sizeof(unsigned long), compare_ends);
+
+    return ends;
+}
+
+static void
+test_g_store_order(void)
+{
+    heap_file*      hf     = prepare();
+    csr_graph*      graph  = csr_graph_create(hf, false);
+    g_store_layout* layout = g_store_order(hf, false);
+
+    check_dense(layout->node_order, hf->n_nodes, NUM_SLOTS_PER_NODE);
+    check_dense(layout->relationship_order, hf->n_rels, NUM_SLOTS_PER_REL);
+
+    // Almost all relationships within a group end up on one page
+    unsigned long before = cross_page_relationships(graph, NULL);
+    unsigned long after  = cross_page_relationships(graph, layout->node_order);
+    assert(after * 4 < before);
+    csr_graph_destroy(graph);
+
+    unsigned long* before_ends = relationship_ends(hf);
+
+    reorder_nodes(hf, layout->node_order, false);
+    reorder_relationships(hf, layout->relationship_order, false);
+
+    // The relationships keep their endpoints and are sorted by their source
+    unsigned long* after_ends = relationship_ends(hf);
+    for (size_t i = 0; i < 2 * hf->n_rels; ++i) {
+        assert(before_ends[i] == after_ends[i]);
+    }
+    free(before_ends);
+    free(after_ends);
+
+    array_list_relationship* rels = get_relationships(hf, false);
+    for (size_t i = 1; i < array_list_relationship_size(rels); ++i) {
+        assert(array_list_relationship_get(rels, i - 1)->source_node
+               <= array_list_relationship_get(rels, i)->source_node);
+    }
+    array_list_relationship_destroy(rels);
+
+    g_store_layout_destroy(layout);
+    clean_up(hf);
+}
+
+int
+main(void)
+{
+    test_g_store_order();
+    printf("finished test g-store order\n");
+
+    return 0;
+}
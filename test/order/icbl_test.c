@@ -0,0 +1,156 @@
+/*
+ * icbl_test.c   1.0   Sep 15, 2021
+ *
+ * Copyright (c) 2021- University of Konstanz.
+ *
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "order/icbl.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "access/heap_file.h"
+#include "access/node.h"
+#include "access/relationship.h"
+#include "page_cache.h"
+
+#define TEST_N_NODES   (200)
+#define TEST_MAX_RUN   (40)
+#define TEST_HUB       (0)
+#define TEST_HUB_RUN   (150)
+#define TEST_SINK      (TEST_N_NODES - 1)
+#define TEST_HALF      (TEST_N_NODES / 2)
+#define TEST_PER_PAGE  (SLOTS_PER_PAGE / NUM_SLOTS_PER_REL)
+
+static unsigned long
+run_length(size_t node)
+{
+    return node == TEST_HUB ? TEST_HUB_RUN : node * 7 % TEST_MAX_RUN;
+}
+
+/* Only the upper half of the nodes has incoming relationships. */
+static unsigned long
+target(size_t node, size_t k)
+{
+    return TEST_HALF + (node + k) % TEST_HALF;
+}
+
+/* The relationships of the nodes are inserted interleaved, so that the runs
+ * are scattered over all pages before the layout. The last node is a sink,
+ * the label of a relationship is its position in the run. */
+static heap_file*
+prepare(void)
+{
+    phy_database* pdb = phy_database_create("test", "log_test_pdb");
+    page_cache*   pc  = page_cache_create(pdb, CACHE_N_PAGES, "log_test_pc");
+    heap_file*    hf  = heap_file_create(pc, "log_test_hf");
+
+    for (size_t i = 0; i < TEST_N_NODES; ++i) {
+        create_node(hf, i, false);
+    }
+
+    for (size_t k = 0; k < TEST_HUB_RUN; ++k) {
+        for (size_t i = 0; i < TEST_SINK; ++i) {
+            if (k < run_length(i)) {
+                create_relationship(hf, i, target(i, k), 1, k, false);
+            }
+        }
+    }
+
+    return hf;
+}
+
+static void
+clean_up(heap_file* hf)
+{
+    page_cache*   pc  = hf->cache;
+    phy_database* pdb = pc->pdb;
+    heap_file_destroy(hf);
+    page_cache_destroy(pc);
+    phy_database_delete(pdb);
+}
+
+static unsigned long
+position(unsigned long rel_id)
+{
+    return (rel_id >> CHAR_BIT) * TEST_PER_PAGE
+           + (rel_id & UCHAR_MAX) / NUM_SLOTS_PER_REL;
+}
+
+static void
+test_runs(void)
+{
+    heap_file* hf = prepare();
+
+    icbl_layout(hf, false);
+
+    array_list_relationship* rels;
+    relationship_t*          rel;
+    unsigned long            first;
+    unsigned long            last;
+    unsigned long            n;
+    for (size_t i = 0; i < TEST_N_NODES; ++i) {
+        rels = expand(hf, i, OUTGOING, false);
+        n    = array_list_relationship_size(rels);
+        assert(n == (i == TEST_SINK ? 0 : run_length(i)));
+
+        first = UNINITIALIZED_LONG;
+        last  = 0;
+        for (size_t j = 0; j < n; ++j) {
+            rel = array_list_relationship_get(rels, j);
+            assert(rel->target_node == target(i, rel->label));
+            first = position(rel->id) < first ? position(rel->id) : first;
+            last  = position(rel->id) > last ? position(rel->id) : last;
+        }
+
+        // The run is contiguous and lies on one page, hubs start a page
+        if (n > 0) {
+            assert(last - first + 1 == n);
+        }
+        if (n > TEST_PER_PAGE) {
+            assert(first % TEST_PER_PAGE == 0);
+        } else if (n > 0) {
+            assert(first / TEST_PER_PAGE == last / TEST_PER_PAGE);
+        }
+        array_list_relationship_destroy(rels);
+    }
+
+    clean_up(hf);
+}
+
+static void
+test_single_pin(void)
+{
+    heap_file* hf = prepare();
+
+    icbl_layout(hf, false);
+
+    // Node 2 has only outgoing relationships, which all lie on one page
+    size_t  pins = hf->cache->num_pins;
+    node_t* node = read_node(hf, 2, false);
+    free(node);
+    size_t node_pins = hf->cache->num_pins - pins;
+
+    pins                          = hf->cache->num_pins;
+    array_list_relationship* rels = expand(hf, 2, BOTH, false);
+    assert(array_list_relationship_size(rels) == run_length(2));
+    assert(hf->cache->num_pins - pins == node_pins + 1);
+    array_list_relationship_destroy(rels);
+
+    clean_up(hf);
+}
+
+int
+main(void)
+{
+    test_runs();
+    test_single_pin();
+
+    return 0;
+}
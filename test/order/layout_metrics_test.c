@@ -0,0 +1,142 @@
+/*
+ * layout_metrics_test.c   1.0   Sep 15, 2021
+ *
+ * Copyright (c) 2021- University of Konstanz.
+ *
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "order/layout_metrics.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "access/csr_graph.h"
+#include "access/heap_file.h"
+#include "access/relationship.h"
+
+#define TEST_N_NODES (2 * SLOTS_PER_PAGE)
+#define TEST_EPSILON (1e-9)
+
+/* A directed path over two pages of nodes and eight of relationships. */
+static heap_file*
+prepare(void)
+{
+    phy_database* pdb = phy_database_create("test", "log_test_pdb");
+    page_cache*   pc  = page_cache_create(pdb, CACHE_N_PAGES, "log_test_pc");
+    heap_file*    hf  = heap_file_create(pc, "log_test_hf");
+
+    for (size_t i = 0; i < TEST_N_NODES; ++i) {
+        create_node(hf, i, false);
+    }
+
+    for (size_t i = 0; i + 1 < TEST_N_NODES; ++i) {
+        create_relationship(hf, i, i + 1, 1, 0, false);
+    }
+
+    return hf;
+}
+
+static void
+clean_up(heap_file* hf)
+{
+    page_cache*   pc  = hf->cache;
+    phy_database* pdb = pc->pdb;
+    heap_file_destroy(hf);
+    page_cache_destroy(pc);
+    phy_database_delete(pdb);
+}
+
+/* Alternates the nodes between the two pages. */
+static dict_ul_ul*
+interleaved(void)
+{
+    dict_ul_ul* order = d_ul_ul_create();
+
+    for (size_t i = 0; i < TEST_N_NODES; ++i) {
+        dict_ul_ul_insert(order, i, (i % 2) * SLOTS_PER_PAGE + i / 2);
+    }
+
+    return order;
+}
+
+static void
+test_metrics(void)
+{
+    heap_file*  hf    = prepare();
+    csr_graph*  graph = csr_graph_create(hf, false);
+    dict_ul_ul* order = interleaved();
+
+    layout_metrics* natural = layout_metrics_compute(graph, NULL, NULL);
+    assert(natural->n_node_pages == 2);
+    assert(natural->n_rel_pages == 8);
+    assert(fabs(natural->linear_arrangement - (TEST_N_NODES - 1))
+           < TEST_EPSILON);
+    assert(natural->cross_page_rels == 1);
+    // The two relationships of a node share a page, except at the seven
+    // borders between the relationship pages
+    assert(natural->incidence_pages == TEST_N_NODES + 7);
+
+    // Per page one of 256 relationships leaves, 255 of 256 * 255 / 2 pairs
+    // are adjacent
+    double conductance  = 1.0 / SLOTS_PER_PAGE;
+    double cohesiveness = 2.0 / SLOTS_PER_PAGE;
+    assert(fabs(natural->conductance - conductance) < TEST_EPSILON);
+    assert(fabs(natural->cohesiveness - cohesiveness) < TEST_EPSILON);
+    assert(fabs(natural->block_locality
+                - sqrt(conductance * (1 - cohesiveness)))
+           < TEST_EPSILON);
+
+    layout_metrics* mixed = layout_metrics_compute(graph, order, NULL);
+    assert(mixed->n_node_pages == 2);
+    assert(mixed->cross_page_rels == TEST_N_NODES - 1);
+    assert(mixed->linear_arrangement > natural->linear_arrangement);
+    assert(fabs(mixed->conductance - 1) < TEST_EPSILON);
+    assert(fabs(mixed->cohesiveness) < TEST_EPSILON);
+    assert(mixed->incidence_pages == natural->incidence_pages);
+
+    free(natural);
+    free(mixed);
+    dict_ul_ul_destroy(order);
+    csr_graph_destroy(graph);
+    clean_up(hf);
+}
+
+static void
+test_simulate_misses(void)
+{
+    heap_file*  hf    = prepare();
+    csr_graph*  graph = csr_graph_create(hf, false);
+    dict_ul_ul* order = interleaved();
+
+    // With enough frames, every page is read once
+    assert(fabs(layout_simulate_misses(graph, NULL, NULL, LAYOUT_BFS, 1, 100)
+                - 10)
+           < TEST_EPSILON);
+    assert(fabs(layout_simulate_misses(
+                      graph, NULL, NULL, LAYOUT_DIJKSTRA, 1, 100)
+                - 10)
+           < TEST_EPSILON);
+
+    for (layout_traversal t = LAYOUT_BFS; t <= LAYOUT_DIJKSTRA; ++t) {
+        assert(layout_simulate_misses(graph, NULL, NULL, t, 8, 2)
+               < layout_simulate_misses(graph, order, NULL, t, 8, 2));
+    }
+
+    dict_ul_ul_destroy(order);
+    csr_graph_destroy(graph);
+    clean_up(hf);
+}
+
+int
+main(void)
+{
+    test_metrics();
+    test_simulate_misses();
+
+    return 0;
+}
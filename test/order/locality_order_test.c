@@ -0,0 +1,251 @@
+/*
+ * locality_order_test.c   1.0   Sep 15, 2021
+ *
+ * Copyright (c) 2021- University of Konstanz.
+ *
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "order/locality_order.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "access/heap_file.h"
+#include "access/node.h"
+#include "order/reorder_records.h"
+
+#define TEST_PATH_LENGTH   (300)
+#define TEST_N_CLIQUES     (8)
+#define TEST_CLIQUE_SIZE   (20)
+#define TEST_N_CLIQUE_NODES (TEST_N_CLIQUES * TEST_CLIQUE_SIZE)
+#define TEST_STAR_SIZE     (50)
+
+static heap_file*
+create_heap_file(void)
+{
+    phy_database* pdb = phy_database_create("test", "log_test_pdb");
+    page_cache*   pc  = page_cache_create(pdb, CACHE_N_PAGES, "log_test_pc");
+    return heap_file_create(pc, "log_test_hf");
+}
+
+static void
+clean_up(heap_file* hf)
+{
+    page_cache*   pc  = hf->cache;
+    phy_database* pdb = pc->pdb;
+    heap_file_destroy(hf);
+    page_cache_destroy(pc);
+    phy_database_delete(pdb);
+}
+
+/* A path through the nodes in a scrambled order. */
+static heap_file*
+prepare_path(void)
+{
+    heap_file* hf = create_heap_file();
+
+    for (size_t i = 0; i < TEST_PATH_LENGTH; ++i) {
+        create_node(hf, i, false);
+    }
+
+    // 7 is coprime to the length, so the path visits every node once
+    for (size_t i = 0; i + 1 < TEST_PATH_LENGTH; ++i) {
+        create_relationship(hf,
+                            i * 7 % TEST_PATH_LENGTH,
+                            (i + 1) * 7 % TEST_PATH_LENGTH,
+                            1,
+                            0,
+                            false);
+    }
+
+    return hf;
+}
+
+/* Interleaved cliques linked in a ring. */
+static heap_file*
+prepare_cliques(void)
+{
+    heap_file* hf = create_heap_file();
+
+    for (size_t i = 0; i < TEST_N_CLIQUE_NODES; ++i) {
+        create_node(hf, i, false);
+    }
+
+    for (size_t i = 0; i < TEST_N_CLIQUE_NODES; ++i) {
+        for (size_t j = i + TEST_N_CLIQUES; j < TEST_N_CLIQUE_NODES;
+             j += TEST_N_CLIQUES) {
+            create_relationship(hf, i, j, 1, 0, false);
+        }
+    }
+
+    for (size_t c = 0; c < TEST_N_CLIQUES; ++c) {
+        create_relationship(hf, c, (c + 1) % TEST_N_CLIQUES, 1, 0, false);
+    }
+
+    return hf;
+}
+
+/* Returns the new position of each node, which are dense ids as the node
+ * records use one slot. */
+static unsigned long*
+positions(dict_ul_ul* order, size_t n)
+{
+    unsigned long* pos  = calloc(n, sizeof(unsigned long));
+    bool*          seen = calloc(n, sizeof(bool));
+
+    assert(dict_ul_ul_size(order) == n);
+    for (size_t i = 0; i < n; ++i) {
+        pos[i] = dict_ul_ul_get_direct(order, i);
+        assert(pos[i] < n);
+        assert(!seen[pos[i]]);
+        seen[pos[i]] = true;
+    }
+    free(seen);
+
+    return pos;
+}
+
+static unsigned long
+path_bandwidth(const unsigned long* pos)
+{
+    unsigned long bandwidth = 0;
+    unsigned long from;
+    unsigned long to;
+
+    for (size_t i = 0; i + 1 < TEST_PATH_LENGTH; ++i) {
+        from = pos[i * 7 % TEST_PATH_LENGTH];
+        to   = pos[(i + 1) * 7 % TEST_PATH_LENGTH];
+
+        if ((from > to ? from - to : to - from) > bandwidth) {
+            bandwidth = from > to ? from - to : to - from;
+        }
+    }
+
+    return bandwidth;
+}
+
+/* Checks that all but max_outliers nodes of each clique are stored in one
+ * run. */
+static void
+check_cliques(const unsigned long* pos, size_t max_outliers)
+{
+    bool*  taken = calloc(TEST_N_CLIQUE_NODES, sizeof(bool));
+    size_t run;
+    size_t longest;
+
+    for (size_t c = 0; c < TEST_N_CLIQUES; ++c) {
+        for (size_t i = c; i < TEST_N_CLIQUE_NODES; i += TEST_N_CLIQUES) {
+            taken[pos[i]] = true;
+        }
+
+        run     = 0;
+        longest = 0;
+        for (size_t i = 0; i < TEST_N_CLIQUE_NODES; ++i) {
+            run     = taken[i] ? run + 1 : 0;
+            longest = run > longest ? run : longest;
+            taken[i] = false;
+        }
+        assert(longest + max_outliers >= TEST_CLIQUE_SIZE);
+    }
+    free(taken);
+}
+
+static void
+test_bfs_rcm(void)
+{
+    heap_file* hf = prepare_path();
+
+    // Starting at a peripheral node, each level holds a single node
+    dict_ul_ul*    order = rcm_node_order(hf, false);
+    unsigned long* pos   = positions(order, TEST_PATH_LENGTH);
+    assert(path_bandwidth(pos) == 1);
+    free(pos);
+    dict_ul_ul_destroy(order);
+
+    // Starting in the middle, the two directions alternate
+    order = bfs_node_order(hf, false);
+    pos   = positions(order, TEST_PATH_LENGTH);
+    assert(path_bandwidth(pos) <= 2);
+
+    reorder_nodes(hf, order, false);
+    dict_ul_ul_destroy(order);
+
+    node_t* node;
+    for (size_t i = 0; i < TEST_PATH_LENGTH; ++i) {
+        node = read_node(hf, pos[i], false);
+        assert(node->label == i);
+        free(node);
+    }
+    free(pos);
+
+    clean_up(hf);
+}
+
+static void
+test_degree(void)
+{
+    heap_file* hf = create_heap_file();
+
+    for (size_t i = 0; i < 2 * TEST_STAR_SIZE; ++i) {
+        create_node(hf, i, false);
+    }
+
+    // Two stars with different sizes around the last nodes
+    for (size_t i = 0; i < TEST_STAR_SIZE; ++i) {
+        create_relationship(hf, i, 2 * TEST_STAR_SIZE - 1, 1, 0, false);
+    }
+    for (size_t i = TEST_STAR_SIZE; i < 2 * TEST_STAR_SIZE - 10; ++i) {
+        create_relationship(hf, i, 2 * TEST_STAR_SIZE - 2, 1, 0, false);
+    }
+
+    dict_ul_ul*    order = degree_node_order(hf, false);
+    unsigned long* pos   = positions(order, 2 * TEST_STAR_SIZE);
+
+    assert(pos[2 * TEST_STAR_SIZE - 1] == 0);
+    assert(pos[2 * TEST_STAR_SIZE - 2] == 1);
+    for (size_t i = 0; i < 2 * TEST_STAR_SIZE - 2; ++i) {
+        assert(pos[i] == i + 2);
+    }
+
+    free(pos);
+    dict_ul_ul_destroy(order);
+    clean_up(hf);
+}
+
+static void
+test_gorder_rabbit(void)
+{
+    heap_file* hf = prepare_cliques();
+
+    dict_ul_ul*    order = gorder_node_order(hf, GORDER_DEFAULT_WINDOW, false);
+    unsigned long* pos   = positions(order, TEST_N_CLIQUE_NODES);
+    // The ring between the cliques pulls single nodes out of their clique
+    check_cliques(pos, 1);
+    free(pos);
+    dict_ul_ul_destroy(order);
+
+    order = rabbit_node_order(hf, false);
+    pos   = positions(order, TEST_N_CLIQUE_NODES);
+    check_cliques(pos, 0);
+    free(pos);
+    dict_ul_ul_destroy(order);
+
+    clean_up(hf);
+}
+
+int
+main(void)
+{
+    test_bfs_rcm();
+    printf("finished test bfs and rcm order\n");
+    test_degree();
+    printf("finished test degree order\n");
+    test_gorder_rabbit();
+    printf("finished test gorder and rabbit order\n");
+
+    return 0;
+}
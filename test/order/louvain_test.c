@@ -0,0 +1,142 @@
+/*
+ * louvain_test.c   1.0   Sep 15, 2021
+ *
+ * Copyright (c) 2021- University of Konstanz.
+ *
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "order/louvain.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "access/heap_file.h"
+#include "access/node.h"
+#include "order/reorder_records.h"
+
+#define TEST_N_CLIQUES     (8)
+#define TEST_CLIQUE_SIZE   (20)
+#define TEST_N_NODES       (TEST_N_CLIQUES * TEST_CLIQUE_SIZE)
+#define TEST_MIN_MODULARITY (0.8)
+
+static heap_file*
+prepare(void)
+{
+    phy_database* pdb = phy_database_create("test", "log_test_pdb");
+    page_cache*   pc  = page_cache_create(pdb, CACHE_N_PAGES, "log_test_pc");
+    heap_file*    hf  = heap_file_create(pc, "log_test_hf");
+
+    for (size_t i = 0; i < TEST_N_NODES; ++i) {
+        create_node(hf, i, false);
+    }
+
+    // Interleaves the cliques, so that the ids do not give them away
+    for (size_t i = 0; i < TEST_N_NODES; ++i) {
+        for (size_t j = i + TEST_N_CLIQUES; j < TEST_N_NODES;
+             j += TEST_N_CLIQUES) {
+            create_relationship(hf, i, j, 1, 0, false);
+        }
+    }
+
+    // Links the cliques in a ring
+    for (size_t c = 0; c < TEST_N_CLIQUES; ++c) {
+        create_relationship(hf, c, (c + 1) % TEST_N_CLIQUES, 1, 0, false);
+    }
+
+    return hf;
+}
+
+static void
+clean_up(heap_file* hf)
+{
+    page_cache*   pc  = hf->cache;
+    phy_database* pdb = pc->pdb;
+    heap_file_destroy(hf);
+    page_cache_destroy(pc);
+    phy_database_delete(pdb);
+}
+
+static void
+check_cliques(const community_result* result)
+{
+    assert(result->n_nodes == TEST_N_NODES);
+    assert(result->n_communities == TEST_N_CLIQUES);
+    assert(result->modularity > TEST_MIN_MODULARITY);
+
+    for (size_t i = 0; i < TEST_N_NODES; ++i) {
+        assert(result->community[i] < TEST_N_CLIQUES);
+        assert(result->community[i]
+               == result->community[i % TEST_N_CLIQUES]);
+    }
+
+    // The sequence is a permutation that stores the cliques one after another
+    bool* seen = calloc(TEST_N_NODES, sizeof(bool));
+    for (size_t i = 0; i < TEST_N_NODES; ++i) {
+        assert(result->sequence[i] < TEST_N_NODES);
+        assert(!seen[result->sequence[i]]);
+        seen[result->sequence[i]] = true;
+        assert(result->community[result->sequence[i]]
+               == i / TEST_CLIQUE_SIZE);
+    }
+    free(seen);
+}
+
+static void
+test_communities(community_method method)
+{
+    heap_file*        hf     = prepare();
+    community_result* result = communities(hf, method, 1.0, false);
+    check_cliques(result);
+
+    // A low resolution favours few large communities
+    community_result* coarse = communities(hf, method, 0.01, false);
+    assert(coarse->n_communities < TEST_N_CLIQUES);
+    community_result_destroy(coarse);
+
+    reorder_nodes_by_sequence(hf, result->sequence, false);
+
+    node_t* node;
+    for (size_t i = 0; i < TEST_N_NODES; ++i) {
+        node = read_node(hf, i, false);
+        assert(node->label % TEST_N_CLIQUES
+               == result->sequence[i / TEST_CLIQUE_SIZE * TEST_CLIQUE_SIZE]
+                        % TEST_N_CLIQUES);
+        free(node);
+    }
+
+    community_result_destroy(result);
+    clean_up(hf);
+}
+
+static void
+test_empty(void)
+{
+    phy_database* pdb = phy_database_create("test", "log_test_pdb");
+    page_cache*   pc  = page_cache_create(pdb, CACHE_N_PAGES, "log_test_pc");
+    heap_file*    hf  = heap_file_create(pc, "log_test_hf");
+
+    community_result* result = communities(hf, leiden_method, 1.0, false);
+    assert(result->n_nodes == 0);
+    assert(result->n_communities == 0);
+    assert(result->modularity == 0);
+
+    community_result_destroy(result);
+    clean_up(hf);
+}
+
+int
+main(void)
+{
+    test_communities(louvain_method);
+    printf("finished test louvain\n");
+    test_communities(leiden_method);
+    printf("finished test leiden\n");
+    test_empty();
+    printf("finished test empty graph\n");
+
+    return 0;
+}
@@ -16,7 +16,9 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "access/btree.h"
 #include "access/heap_file.h"
+#include "access/label_index.h"
 #include "access/node.h"
 #include "access/relationship.h"
 #include "data-struct/array_list.h"
@@ -64,6 +66,372 @@ clean_up(heap_file* hf)
     phy_database_delete(pdb);
 }
 
+/* Enough records for several passes over the files with a tiny cache and a
+ * hub that is dense, so that its relationships are grouped. */
+#define TEST_REBUILD_N_NODES  (600)
+#define TEST_REBUILD_N_RELS   (2000)
+#define TEST_REBUILD_N_LABELS (3)
+#define TEST_REBUILD_N_FRAMES (8)
+
+static unsigned long
+rebuild_random(unsigned long* state)
+{
+    *state = *state * 6364136223846793005UL + 1442695040888963407UL;
+    return *state >> 33;
+}
+
+static int
+double_cmp(const void* a, const void* b)
+{
+    double fst = *(const double*)a;
+    double snd = *(const double*)b;
+    return (fst > snd) - (fst < snd);
+}
+
+/* The weights identify the relationships, the labels of the nodes identify
+ * the nodes. */
+static double*
+incident_weights(heap_file* hf, unsigned long node_id, size_t* n)
+{
+    array_list_relationship* rels = expand(hf, node_id, BOTH, false);
+    *n                            = array_list_relationship_size(rels);
+    double* weights               = calloc(*n + 1, sizeof(double));
+
+    for (size_t i = 0; i < *n; ++i) {
+        weights[i] = array_list_relationship_get(rels, i)->weight;
+    }
+    array_list_relationship_destroy(rels);
+    qsort(weights, *n, sizeof(double), double_cmp);
+
+    return weights;
+}
+
+void
+test_rebuild_records(void)
+{
+    phy_database* pdb = phy_database_create("test", "log_test_pdb");
+    page_cache*   pc =
+          page_cache_create(pdb, TEST_REBUILD_N_FRAMES, "log_test_pc");
+    heap_file* hf = heap_file_create(pc, "log_test_hf");
+
+    unsigned long node_ids[TEST_REBUILD_N_NODES];
+    for (size_t i = 0; i < TEST_REBUILD_N_NODES; ++i) {
+        node_ids[i] = create_node(hf, i, false);
+    }
+
+    unsigned long  state = 7;
+    unsigned long* rel_ids =
+          calloc(TEST_REBUILD_N_RELS, sizeof(unsigned long));
+    unsigned long* sources =
+          calloc(TEST_REBUILD_N_RELS, sizeof(unsigned long));
+    unsigned long* targets =
+          calloc(TEST_REBUILD_N_RELS, sizeof(unsigned long));
+
+    for (size_t i = 0; i < TEST_REBUILD_N_RELS; ++i) {
+        // Every fourth relationship is incident to the hub, some are loops
+        sources[i] = i % 4 == 0 ? 0
+                                : rebuild_random(&state) % TEST_REBUILD_N_NODES;
+        targets[i] = i % 50 == 1
+                           ? sources[i]
+                           : rebuild_random(&state) % TEST_REBUILD_N_NODES;
+        rel_ids[i] = create_relationship(hf,
+                                         node_ids[sources[i]],
+                                         node_ids[targets[i]],
+                                         (double)i,
+                                         i % TEST_REBUILD_N_LABELS,
+                                         false);
+    }
+
+    for (unsigned long k = 0; k < TEST_REBUILD_N_NODES; ++k) {
+        btree_insert(pc, btree_ft, k, k * 2, false);
+    }
+
+    size_t        n_before[TEST_REBUILD_N_NODES];
+    double*       weights_before[TEST_REBUILD_N_NODES];
+    unsigned long degrees[TEST_REBUILD_N_NODES][BOTH + 1];
+    for (size_t i = 0; i < TEST_REBUILD_N_NODES; ++i) {
+        weights_before[i] = incident_weights(hf, node_ids[i], &n_before[i]);
+        for (direction_t d = OUTGOING; d <= BOTH; ++d) {
+            degrees[i][d] = node_degree(hf, node_ids[i], d, false);
+        }
+    }
+
+    array_list_ul* chains_before[TEST_REBUILD_N_LABELS];
+    for (unsigned long l = 0; l < TEST_REBUILD_N_LABELS; ++l) {
+        chains_before[l] = label_index_find_all(pc, relationship_ft, l, false);
+    }
+
+    // Reverse the nodes and shuffle the relationships
+    dict_ul_ul* new_node_ids = d_ul_ul_create();
+    for (size_t i = 0; i < TEST_REBUILD_N_NODES; ++i) {
+        dict_ul_ul_insert(new_node_ids,
+                          node_ids[i],
+                          node_ids[TEST_REBUILD_N_NODES - 1 - i]);
+    }
+
+    unsigned long* shuffled =
+          calloc(TEST_REBUILD_N_RELS, sizeof(unsigned long));
+    memcpy(shuffled, rel_ids, TEST_REBUILD_N_RELS * sizeof(unsigned long));
+    unsigned long tmp;
+    size_t        j;
+    for (size_t i = TEST_REBUILD_N_RELS - 1; i > 0; --i) {
+        j           = rebuild_random(&state) % (i + 1);
+        tmp         = shuffled[i];
+        shuffled[i] = shuffled[j];
+        shuffled[j] = tmp;
+    }
+
+    dict_ul_ul* new_rel_ids = d_ul_ul_create();
+    for (size_t i = 0; i < TEST_REBUILD_N_RELS; ++i) {
+        dict_ul_ul_insert(new_rel_ids, rel_ids[i], shuffled[i]);
+    }
+
+    rebuild_records(hf, new_node_ids, new_rel_ids, false);
+    dict_ul_ul_destroy(new_node_ids);
+
+    // The label chains keep their order
+    array_list_ul* chain;
+    for (unsigned long l = 0; l < TEST_REBUILD_N_LABELS; ++l) {
+        chain = label_index_find_all(pc, relationship_ft, l, false);
+        assert(array_list_ul_size(chain)
+               == array_list_ul_size(chains_before[l]));
+        for (size_t k = 0; k < array_list_ul_size(chain); ++k) {
+            assert(array_list_ul_get(chain, k)
+                   == dict_ul_ul_get_direct(
+                         new_rel_ids,
+                         array_list_ul_get(chains_before[l], k)));
+        }
+        array_list_ul_destroy(chain);
+        array_list_ul_destroy(chains_before[l]);
+    }
+    dict_ul_ul_destroy(new_rel_ids);
+
+    assert(hf->n_nodes == TEST_REBUILD_N_NODES);
+    assert(hf->n_rels == TEST_REBUILD_N_RELS);
+
+    node_t*          node;
+    relationship_t*  rel;
+    unsigned long    moved;
+    size_t           n_after;
+    double*          weights_after;
+    array_list_node* found;
+    for (size_t i = 0; i < TEST_REBUILD_N_NODES; ++i) {
+        moved = node_ids[TEST_REBUILD_N_NODES - 1 - i];
+        node  = read_node(hf, moved, false);
+        assert(node->label == i);
+        free(node);
+
+        weights_after = incident_weights(hf, moved, &n_after);
+        assert(n_after == n_before[i]);
+        assert(memcmp(weights_after,
+                      weights_before[i],
+                      n_after * sizeof(double))
+               == 0);
+        free(weights_after);
+        free(weights_before[i]);
+
+        for (direction_t d = OUTGOING; d <= BOTH; ++d) {
+            assert(node_degree(hf, moved, d, false) == degrees[i][d]);
+        }
+
+        found = find_nodes_by_label(hf, i, false);
+        assert(array_list_node_size(found) == 1);
+        assert(array_list_node_get(found, 0)->id == moved);
+        array_list_node_destroy(found);
+    }
+
+    for (size_t i = 0; i < TEST_REBUILD_N_RELS; ++i) {
+        rel = read_relationship(hf, shuffled[i], false);
+        assert(rel->weight == (double)i);
+        assert(rel->label == i % TEST_REBUILD_N_LABELS);
+        assert(rel->source_node
+               == node_ids[TEST_REBUILD_N_NODES - 1 - sources[i]]);
+        assert(rel->target_node
+               == node_ids[TEST_REBUILD_N_NODES - 1 - targets[i]]);
+        free(rel);
+
+        rel = contains_relationship_from_to(
+              hf,
+              node_ids[TEST_REBUILD_N_NODES - 1 - sources[i]],
+              node_ids[TEST_REBUILD_N_NODES - 1 - targets[i]],
+              OUTGOING,
+              false);
+        assert(rel);
+        free(rel);
+    }
+
+    // The groups of the hub point to the moved relationships
+    unsigned long            hub = node_ids[TEST_REBUILD_N_NODES - 1];
+    array_list_relationship* labelled;
+    size_t                   n_labelled = 0;
+    for (unsigned long l = 0; l < TEST_REBUILD_N_LABELS; ++l) {
+        labelled = expand_with_label(hf, hub, BOTH, l, false);
+        for (size_t k = 0; k < array_list_relationship_size(labelled); ++k) {
+            assert(array_list_relationship_get(labelled, k)->label == l);
+        }
+        n_labelled += array_list_relationship_size(labelled);
+        array_list_relationship_destroy(labelled);
+    }
+    assert(n_labelled == n_before[0]);
+
+    for (unsigned long k = 0; k < TEST_REBUILD_N_NODES; ++k) {
+        assert(btree_find(pc, btree_ft, k, false) == k * 2);
+    }
+
+    // The rebuilt database stays writable and can be reopened
+    delete_relationship(hf, shuffled[0], false);
+    unsigned long new_node = create_node(hf, TEST_REBUILD_N_NODES, false);
+    create_relationship(hf, new_node, hub, 0.5, 0, false);
+    assert(node_degree(hf, hub, BOTH, false) == degrees[0][BOTH]);
+
+    heap_file_destroy(hf);
+    page_cache_destroy(pc);
+    phy_database_close(pdb);
+
+    pdb = phy_database_open("test", "log_test_pdb");
+    pc  = page_cache_create(pdb, TEST_REBUILD_N_FRAMES, "log_test_pc");
+    hf  = heap_file_create(pc, "log_test_hf");
+    assert(hf->n_nodes == TEST_REBUILD_N_NODES + 1);
+    assert(hf->n_rels == TEST_REBUILD_N_RELS);
+
+    free(rel_ids);
+    free(sources);
+    free(targets);
+    free(shuffled);
+    clean_up(hf);
+}
+
+/* The incidence lists of the sparse nodes are sorted by id and correctly
+ * linked backwards, those of the hub hold the same relationships. */
+static void
+check_sorted(heap_file* hf, array_list_ul** lists)
+{
+    array_list_relationship* rels;
+    relationship_t*          rel;
+    relationship_t*          prev;
+    node_t*                  node;
+    size_t                   n;
+
+    for (size_t i = 0; i < TEST_REBUILD_N_NODES; ++i) {
+        rels = expand(hf, i, BOTH, false);
+        n    = array_list_relationship_size(rels);
+        assert(n == array_list_ul_size(lists[i]));
+
+        for (size_t j = 0; j < n; ++j) {
+            rel = array_list_relationship_get(rels, j);
+            assert(array_list_ul_contains(lists[i], rel->id));
+
+            if (i == 0) {
+                continue;
+            }
+            prev = array_list_relationship_get(rels, (j + n - 1) % n);
+            assert(j == 0 || prev->id < rel->id);
+            assert((rel->source_node == i ? rel->prev_rel_source
+                                          : rel->prev_rel_target)
+                   == prev->id);
+        }
+
+        if (i != 0 && n > 0) {
+            node = read_node(hf, i, false);
+            assert(node->first_relationship
+                   == array_list_relationship_get(rels, 0)->id);
+            free(node);
+        }
+        array_list_relationship_destroy(rels);
+    }
+}
+
+static void
+incidence_lists(heap_file* hf, array_list_ul** lists)
+{
+    array_list_relationship* rels;
+    for (size_t i = 0; i < TEST_REBUILD_N_NODES; ++i) {
+        lists[i] = al_ul_create();
+        rels     = expand(hf, i, BOTH, false);
+        for (size_t j = 0; j < array_list_relationship_size(rels); ++j) {
+            array_list_ul_append(lists[i],
+                                 array_list_relationship_get(rels, j)->id);
+        }
+        array_list_relationship_destroy(rels);
+    }
+}
+
+void
+test_sort_incidence_list_batched(void)
+{
+    phy_database* pdb = phy_database_create("test", "log_test_pdb");
+    page_cache*   pc =
+          page_cache_create(pdb, TEST_REBUILD_N_FRAMES, "log_test_pc");
+    heap_file* hf = heap_file_create(pc, "log_test_hf");
+
+    for (size_t i = 0; i < TEST_REBUILD_N_NODES; ++i) {
+        create_node(hf, i, false);
+    }
+
+    unsigned long state = 11;
+    unsigned long from;
+    unsigned long to;
+    for (size_t i = 0; i < TEST_REBUILD_N_RELS; ++i) {
+        from = i % 4 == 0 ? 0 : rebuild_random(&state) % TEST_REBUILD_N_NODES;
+        to   = i % 50 == 1 ? from
+                           : rebuild_random(&state) % TEST_REBUILD_N_NODES;
+        create_relationship(hf, from, to, 1, 0, false);
+    }
+
+    // The lists of all nodes with relationships changed
+    assert(set_ul_size(hf->unsorted_nodes) > 0);
+
+    array_list_ul* lists[TEST_REBUILD_N_NODES];
+    incidence_lists(hf, lists);
+
+    // Every relationship is written once, not once per endpoint, except for
+    // those of the hub, whose groups are relinked on their own
+    unsigned long updates = hf->num_update_rels;
+    sort_incidence_list(hf, false);
+    assert(hf->num_update_rels - updates
+           <= TEST_REBUILD_N_RELS + array_list_ul_size(lists[0]));
+    assert(set_ul_size(hf->unsorted_nodes) == 0);
+    check_sorted(hf, lists);
+
+    // Only the lists of the endpoints of the new relationships are relinked
+    unsigned long new_rel = create_relationship(hf, 3, 7, 1, 0, false);
+    array_list_ul_append(lists[3], new_rel);
+    array_list_ul_append(lists[7], new_rel);
+    assert(set_ul_size(hf->unsorted_nodes) == 2);
+
+    updates = hf->num_update_rels;
+    sort_incidence_list_incremental(hf, false);
+    assert(hf->num_update_rels - updates
+           <= array_list_ul_size(lists[3]) + array_list_ul_size(lists[7]));
+    assert(set_ul_size(hf->unsorted_nodes) == 0);
+    check_sorted(hf, lists);
+
+    for (size_t i = 0; i < TEST_REBUILD_N_NODES; ++i) {
+        array_list_ul_destroy(lists[i]);
+    }
+
+    // Moving the relationships leaves the lists in their old order
+    unsigned long*           sequence = calloc(hf->n_rels, sizeof(long));
+    array_list_relationship* rels     = get_relationships(hf, false);
+    for (size_t i = 0; i < hf->n_rels; ++i) {
+        sequence[hf->n_rels - 1 - i] =
+              array_list_relationship_get(rels, i)->id;
+    }
+    array_list_relationship_destroy(rels);
+    reorder_relationships_by_sequence(hf, sequence, false);
+    free(sequence);
+    assert(set_ul_size(hf->unsorted_nodes) > 0);
+
+    incidence_lists(hf, lists);
+    sort_incidence_list_incremental(hf, false);
+    check_sorted(hf, lists);
+
+    for (size_t i = 0; i < TEST_REBUILD_N_NODES; ++i) {
+        array_list_ul_destroy(lists[i]);
+    }
+    clean_up(hf);
+}
+
 void
 test_swap_nodes(void)
 {
@@ -726,6 +1094,10 @@ test_sort_incidence_array_list(void)
 int
 main(void)
 {
+    test_rebuild_records();
+    printf("finished test rebuild records\n");
+    test_sort_incidence_list_batched();
+    printf("finished test sort incidence list batched\n");
     test_swap_nodes();
     printf("finished test swap nodes\n");
     test_swap_relationships();
@@ -0,0 +1,181 @@
+/*
+ * stream_partition_test.c   1.0   Sep 15, 2021
+ *
+ * Copyright (c) 2021- University of Konstanz.
+ *
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "order/stream_partition.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "access/heap_file.h"
+#include "access/node.h"
+#include "access/relationship.h"
+#include "order/reorder_records.h"
+
+#define TEST_N_GROUPS    (8)
+#define TEST_GROUP_SIZE  (16)
+#define TEST_N_MEMBERS   (TEST_N_GROUPS * TEST_GROUP_SIZE)
+/* One more node without relationships */
+#define TEST_N_NODES     (TEST_N_MEMBERS + 1)
+#define TEST_N_RESTREAMS (2)
+
+/* Group i % TEST_N_GROUPS is a clique, so that the groups are interleaved in
+ * the ids. Each node has one more relationship to a random node. The
+ * relationships are created by source, as from a sorted edge list. */
+static heap_file*
+prepare(void)
+{
+    phy_database* pdb = phy_database_create("test", "log_test_pdb");
+    page_cache*   pc  = page_cache_create(pdb, CACHE_N_PAGES, "log_test_pc");
+    heap_file*    hf  = heap_file_create(pc, "log_test_hf");
+
+    for (size_t i = 0; i < TEST_N_NODES; ++i) {
+        create_node(hf, i, false);
+    }
+
+    unsigned long state = 5;
+    for (size_t i = 0; i < TEST_N_MEMBERS; ++i) {
+        for (size_t j = i % TEST_N_GROUPS; j < TEST_N_MEMBERS;
+             j += TEST_N_GROUPS) {
+            if (j != i) {
+                create_relationship(hf, i, j, 1, 0, false);
+            }
+        }
+
+        state = state * 6364136223846793005UL + 1442695040888963407UL;
+        create_relationship(
+              hf, i, (state >> 33) % TEST_N_MEMBERS, 1, 0, false);
+    }
+
+    return hf;
+}
+
+static void
+clean_up(heap_file* hf)
+{
+    page_cache*   pc  = hf->cache;
+    phy_database* pdb = pc->pdb;
+    heap_file_destroy(hf);
+    page_cache_destroy(pc);
+    phy_database_delete(pdb);
+}
+
+/* Returns the number of relationships within a group whose end points are
+ * in different partitions. */
+static size_t
+check_partition(const unsigned int* partition, size_t n_partitions)
+{
+    size_t* sizes    = calloc(n_partitions, sizeof(size_t));
+    size_t  capacity = (TEST_N_NODES + n_partitions - 1) / n_partitions;
+
+    for (size_t i = 0; i < SLOTS_PER_PAGE; ++i) {
+        if (i >= TEST_N_NODES) {
+            assert(partition[i] == STREAM_NO_PARTITION);
+            continue;
+        }
+        assert(partition[i] < n_partitions);
+        sizes[partition[i]]++;
+    }
+
+    for (size_t p = 0; p < n_partitions; ++p) {
+        assert(sizes[p] <= capacity);
+    }
+    free(sizes);
+
+    size_t cut = 0;
+    for (size_t i = 0; i < TEST_N_MEMBERS; ++i) {
+        for (size_t j = i % TEST_N_GROUPS; j < TEST_N_MEMBERS;
+             j += TEST_N_GROUPS) {
+            cut += partition[i] != partition[j];
+        }
+    }
+
+    return cut;
+}
+
+static void
+test_partition(stream_partitioner partitioner)
+{
+    heap_file* hf = prepare();
+
+    unsigned int* one_pass =
+          stream_partition(hf, TEST_N_GROUPS, partitioner, 0, false);
+    size_t one_pass_cut = check_partition(one_pass, TEST_N_GROUPS);
+    free(one_pass);
+
+    unsigned int* restreamed = stream_partition(
+          hf, TEST_N_GROUPS, partitioner, TEST_N_RESTREAMS, false);
+    size_t cut = check_partition(restreamed, TEST_N_GROUPS);
+    free(restreamed);
+
+    // Nearly all of the TEST_N_MEMBERS * (TEST_GROUP_SIZE - 1) relationships
+    // within the groups stay within the partitions
+    assert(cut * 10 <= TEST_N_MEMBERS * (TEST_GROUP_SIZE - 1));
+    assert(cut <= one_pass_cut);
+
+    // One partition per page of nodes
+    unsigned int* per_page = stream_partition(hf, 0, partitioner, 0, false);
+    for (size_t i = 0; i < TEST_N_NODES; ++i) {
+        assert(per_page[i] == 0);
+    }
+    free(per_page);
+
+    clean_up(hf);
+}
+
+static void
+test_order(void)
+{
+    heap_file* hf = prepare();
+
+    unsigned long* sequence = stream_partition_order(
+          hf, TEST_N_GROUPS, LDG_PARTITIONER, TEST_N_RESTREAMS, false);
+
+    bool* seen = calloc(TEST_N_NODES, sizeof(bool));
+    for (size_t i = 0; i < TEST_N_NODES; ++i) {
+        assert(sequence[i] < TEST_N_NODES && !seen[sequence[i]]);
+        seen[sequence[i]] = true;
+    }
+    free(seen);
+
+    reorder_nodes_by_sequence(hf, sequence, false);
+    free(sequence);
+
+    // Most members of a group are now stored next to each other
+    unsigned long* group = calloc(TEST_N_NODES, sizeof(unsigned long));
+    node_t*        node;
+    for (size_t i = 0; i < TEST_N_NODES; ++i) {
+        node     = read_node(hf, i, false);
+        group[i] = node->label % TEST_N_GROUPS;
+        free(node);
+    }
+
+    size_t adjacent = 0;
+    for (size_t i = 0; i + 1 < TEST_N_NODES; ++i) {
+        adjacent += group[i] == group[i + 1];
+    }
+    assert(adjacent * 10 >= TEST_N_NODES * 8);
+    free(group);
+
+    clean_up(hf);
+}
+
+int
+main(void)
+{
+    test_partition(LDG_PARTITIONER);
+    printf("finished test LDG\n");
+    test_partition(FENNEL_PARTITIONER);
+    printf("finished test Fennel\n");
+    test_order();
+    printf("finished test order\n");
+
+    return 0;
+}
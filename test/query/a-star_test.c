@@ -58,7 +58,14 @@ main(void)
         exit(EXIT_FAILURE);
     }
 
-    path* result = a_star(hf, heuristic, n(11), n(111), BOTH, true, log_file);
+    path* result = a_star(hf,
+                          a_star_dict_heuristic,
+                          heuristic,
+                          n(11),
+                          n(111),
+                          BOTH,
+                          true,
+                          log_file);
 
     assert(result->source == n(11));
     assert(result->target == n(111));
@@ -70,29 +70,10 @@ main(void)
         exit(EXIT_FAILURE);
     }
 
-    dict_ul_d* heuristic[num_landmarks];
+    alt_landmarks* landmarks = alt_preprocess(
+          hf, BOTH, num_landmarks, alt_random_avg_degree, true, log_file);
 
-    alt_preprocess(hf,
-                   BOTH,
-                   num_landmarks,
-                   heuristic,
-                   true,
-
-                   log_file
-
-    );
-
-    path* result = alt(hf,
-                       heuristic,
-                       num_landmarks,
-                       n(11),
-                       n(111),
-                       BOTH,
-                       true,
-
-                       log_file
-
-    );
+    path* result = alt(hf, landmarks, n(11), n(111), true, log_file);
 
     assert(result->source == n(11));
     assert(result->target == n(111));
@@ -103,9 +84,7 @@ main(void)
     dict_ul_ul_destroy(map[1]);
     free(map);
 
-    for (size_t i = 0; i < num_landmarks; ++i) {
-        dict_ul_d_destroy(heuristic[i]);
-    }
+    alt_landmarks_destroy(landmarks);
 
     heap_file_destroy(hf);
     page_cache_destroy(pc);
@@ -0,0 +1,291 @@
+/*
+ * bidirectional_test.c   1.0   Sep 15, 2021
+ *
+ * Copyright (c) 2021- University of Konstanz.
+ *
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "query/bidirectional.h"
+
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+
+#include "access/heap_file.h"
+#include "data-struct/htable.h"
+#include "order/reorder_records.h"
+#include "query/a-star.h"
+#include "query/alt.h"
+#include "query/dijkstra.h"
+#include "query/result_types.h"
+
+#define TEST_N_NODES     (200)
+#define TEST_N_RELS      (800)
+#define TEST_N_LANDMARKS (3)
+
+static heap_file*
+prepare(void)
+{
+    char* file_name = "test";
+
+    char* log_name_pdb   = "log_test_pdb";
+    char* log_name_cache = "log_test_pc";
+    char* log_name_file  = "log_test_hf";
+
+    phy_database* pdb = phy_database_create(file_name, log_name_pdb);
+    page_cache*   pc  = page_cache_create(pdb, CACHE_N_PAGES, log_name_cache);
+    heap_file*    hf  = heap_file_create(pc, log_name_file);
+
+    for (size_t i = 0; i < TEST_N_NODES; ++i) {
+        create_node(hf, i, false);
+    }
+
+    unsigned long state = 7;
+    unsigned long from;
+    unsigned long to;
+    double        weight;
+    for (size_t i = 0; i < TEST_N_RELS; ++i) {
+        state  = state * 6364136223846793005UL + 1442695040888963407UL;
+        from   = (state >> 33) % TEST_N_NODES;
+        state  = state * 6364136223846793005UL + 1442695040888963407UL;
+        to     = (state >> 33) % TEST_N_NODES;
+        state  = state * 6364136223846793005UL + 1442695040888963407UL;
+        weight = 1.0 + (double)((state >> 33) % 100);
+        create_relationship(hf, from, to, weight, 0, false);
+    }
+
+    return hf;
+}
+
+static void
+clean_up(heap_file* hf)
+{
+    page_cache*   pc  = hf->cache;
+    phy_database* pdb = pc->pdb;
+    heap_file_destroy(hf);
+    page_cache_destroy(pc);
+    phy_database_delete(pdb);
+}
+
+static void
+check_path(heap_file* hf, path* p, double expected, direction_t direction)
+{
+    if (expected == DBL_MAX) {
+        assert(p->distance == DBL_MAX);
+        assert(array_list_ul_size(p->edges) == 0);
+        return;
+    }
+
+    assert(fabs(p->distance - expected) < 1e-9);
+
+    unsigned long   node_id = p->source;
+    double          sum     = 0;
+    relationship_t* rel;
+    for (size_t i = 0; i < array_list_ul_size(p->edges); ++i) {
+        rel = read_relationship(hf, array_list_ul_get(p->edges, i), false);
+
+        assert((direction != INCOMING && rel->source_node == node_id)
+               || (direction != OUTGOING && rel->target_node == node_id));
+        node_id = rel->source_node == node_id ? rel->target_node
+                                              : rel->source_node;
+        sum += rel->weight;
+        free(rel);
+    }
+
+    assert(node_id == p->target);
+    assert(fabs(sum - expected) < 1e-9);
+}
+
+static void
+test_dijkstra_p2p(direction_t direction)
+{
+    heap_file* hf = prepare();
+
+    sssp_result* expected;
+    sssp_result* other;
+    path*        result;
+    for (unsigned long s = 0; s < TEST_N_NODES; s += 13) {
+        expected = dijkstra(hf, s, direction, false, NULL);
+
+        for (pq_type type = d_ary_pq; type < invalid_pq; ++type) {
+            other = dijkstra_pq(hf, s, direction, type, false, NULL);
+            for (unsigned long t = 0; t < TEST_N_NODES; ++t) {
+                assert(dict_ul_d_get_direct(other->distances, t)
+                       == dict_ul_d_get_direct(expected->distances, t));
+            }
+            sssp_result_destroy(other);
+        }
+
+        for (unsigned long t = 0; t < TEST_N_NODES; t += 7) {
+            result = dijkstra_p2p(hf, s, t, direction, false, NULL);
+            check_path(hf,
+                       result,
+                       dict_ul_d_get_direct(expected->distances, t),
+                       direction);
+            path_destroy(result);
+
+            for (pq_type type = fibonacci_pq; type < invalid_pq; ++type) {
+                result =
+                      dijkstra_p2p_pq(hf, s, t, direction, type, false, NULL);
+                check_path(hf,
+                           result,
+                           dict_ul_d_get_direct(expected->distances, t),
+                           direction);
+                path_destroy(result);
+            }
+        }
+
+        sssp_result_destroy(expected);
+    }
+
+    clean_up(hf);
+}
+
+static void
+test_alt(direction_t direction, alt_landmark_strategy strategy)
+{
+    heap_file*     hf = prepare();
+    alt_landmarks* preprocessed = alt_preprocess(
+          hf, direction, TEST_N_LANDMARKS, strategy, false, NULL);
+
+    assert(preprocessed->num_landmarks == TEST_N_LANDMARKS);
+    assert(preprocessed->num_sides == (direction == BOTH ? 1 : 2));
+
+    // The queries run on the landmarks read back from disk
+    alt_landmarks_delete_file("test");
+    assert(!alt_landmarks_load(hf, "test"));
+    alt_landmarks_save(preprocessed, "test");
+    alt_landmarks* landmarks = alt_landmarks_load(hf, "test");
+    alt_landmarks_delete_file("test");
+
+    assert(landmarks->direction == direction);
+    assert(landmarks->num_landmarks == TEST_N_LANDMARKS);
+    assert(landmarks->n_nodes == TEST_N_NODES);
+    for (size_t i = 0; i < TEST_N_LANDMARKS; ++i) {
+        assert(landmarks->landmark_ids[i] == preprocessed->landmark_ids[i]);
+    }
+    alt_landmarks_destroy(preprocessed);
+
+    sssp_result* expected;
+    path*        result;
+    double       dist;
+    for (unsigned long s = 0; s < TEST_N_NODES; s += 17) {
+        expected = dijkstra(hf, s, direction, false, NULL);
+
+        for (unsigned long t = 0; t < TEST_N_NODES; t += 11) {
+            dist = dict_ul_d_get_direct(expected->distances, t);
+
+            assert(dist == DBL_MAX
+                   || alt_heuristic(s, t, landmarks) <= dist + 1e-9);
+
+            result = alt(hf, landmarks, s, t, false, NULL);
+            check_path(hf, result, dist, direction);
+            path_destroy(result);
+
+            result = a_star(hf, NULL, NULL, s, t, direction, false, NULL);
+            check_path(hf, result, dist, direction);
+            path_destroy(result);
+
+            result = alt_bidirectional(hf, landmarks, s, t, false, NULL);
+            check_path(hf, result, dist, direction);
+            path_destroy(result);
+
+            for (pq_type type = fibonacci_pq; type < invalid_pq; ++type) {
+                result = alt_pq(hf, landmarks, s, t, type, false, NULL);
+                check_path(hf, result, dist, direction);
+                path_destroy(result);
+
+                if (type != radix_pq) {
+                    result = alt_bidirectional_pq(
+                          hf, landmarks, s, t, type, false, NULL);
+                    check_path(hf, result, dist, direction);
+                    path_destroy(result);
+                }
+            }
+        }
+
+        sssp_result_destroy(expected);
+    }
+
+    alt_landmarks_destroy(landmarks);
+    clean_up(hf);
+}
+
+/* Saved landmarks are only loaded for the state of the graph they were
+ * computed on. */
+static void
+test_stale_landmarks(void)
+{
+    heap_file*     hf        = prepare();
+    alt_landmarks* landmarks = alt_preprocess(
+          hf, OUTGOING, TEST_N_LANDMARKS, alt_farthest, false, NULL);
+    alt_landmarks_save(landmarks, "test");
+
+    // Closing and reopening keeps the state
+    page_cache*   pc  = hf->cache;
+    phy_database* pdb = pc->pdb;
+    heap_file_destroy(hf);
+    page_cache_destroy(pc);
+    phy_database_close(pdb);
+
+    pdb = phy_database_open("test", "log_test_pdb");
+    pc  = page_cache_create(pdb, CACHE_N_PAGES, "log_test_pc");
+    hf  = heap_file_create(pc, "log_test_hf");
+
+    alt_landmarks* loaded = alt_landmarks_load(hf, "test");
+    assert(loaded);
+    alt_landmarks_destroy(loaded);
+
+    // A new weight keeps the number of nodes and relationships
+    relationship_t* rel = read_relationship(hf, 0, false);
+    rel->weight += 1.0;
+    update_relationship(hf, rel, false);
+    free(rel);
+    assert(!alt_landmarks_load(hf, "test"));
+
+    // So does moving the records
+    alt_landmarks_destroy(landmarks);
+    landmarks = alt_preprocess(
+          hf, OUTGOING, TEST_N_LANDMARKS, alt_farthest, false, NULL);
+    alt_landmarks_save(landmarks, "test");
+    swap_nodes(hf, 0, 1, false);
+    assert(!alt_landmarks_load(hf, "test"));
+
+    alt_landmarks_destroy(landmarks);
+    landmarks = alt_preprocess(
+          hf, OUTGOING, TEST_N_LANDMARKS, alt_farthest, false, NULL);
+    alt_landmarks_save(landmarks, "test");
+
+    unsigned long* sequence = calloc(TEST_N_NODES, sizeof(unsigned long));
+    for (size_t i = 0; i < TEST_N_NODES; ++i) {
+        sequence[i] = TEST_N_NODES - 1 - i;
+    }
+    reorder_nodes_by_sequence(hf, sequence, false);
+    free(sequence);
+    assert(!alt_landmarks_load(hf, "test"));
+
+    alt_landmarks_delete_file("test");
+    alt_landmarks_destroy(landmarks);
+    clean_up(hf);
+}
+
+int
+main(void)
+{
+    test_dijkstra_p2p(OUTGOING);
+    test_dijkstra_p2p(INCOMING);
+    test_dijkstra_p2p(BOTH);
+
+    const alt_landmark_strategy strategies[] = {
+        alt_random_avg_degree, alt_farthest, alt_avoid, alt_planar
+    };
+    for (size_t i = 0; i < sizeof(strategies) / sizeof(strategies[0]); ++i) {
+        test_alt(OUTGOING, strategies[i]);
+        test_alt(INCOMING, strategies[i]);
+        test_alt(BOTH, strategies[i]);
+    }
+
+    test_stale_landmarks();
+}
@@ -0,0 +1,154 @@
+/*
+ * contraction_hierarchies_test.c   1.0   Sep 15, 2021
+ *
+ * Copyright (c) 2021- University of Konstanz.
+ *
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "query/contraction_hierarchies.h"
+
+#include <assert.h>
+#include <float.h>
+#include <stdlib.h>
+
+#include "access/heap_file.h"
+#include "data-struct/htable.h"
+#include "query/dijkstra.h"
+#include "query/result_types.h"
+
+#define TEST_N_NODES (300)
+#define TEST_N_RELS  (1000)
+
+static heap_file*
+prepare(void)
+{
+    char* file_name = "test";
+
+    char* log_name_pdb   = "log_test_pdb";
+    char* log_name_cache = "log_test_pc";
+    char* log_name_file  = "log_test_hf";
+
+    phy_database* pdb = phy_database_create(file_name, log_name_pdb);
+    page_cache*   pc  = page_cache_create(pdb, CACHE_N_PAGES, log_name_cache);
+    heap_file*    hf  = heap_file_create(pc, log_name_file);
+
+    for (size_t i = 0; i < TEST_N_NODES; ++i) {
+        create_node(hf, i, false);
+    }
+
+    // Includes self loops, parallel edges and zero weights
+    unsigned long state = 3;
+    unsigned long from;
+    unsigned long to;
+    double        weight;
+    for (size_t i = 0; i < TEST_N_RELS; ++i) {
+        state  = state * 6364136223846793005UL + 1442695040888963407UL;
+        from   = (state >> 33) % TEST_N_NODES;
+        state  = state * 6364136223846793005UL + 1442695040888963407UL;
+        to     = i % 89 == 0 ? from : (state >> 33) % TEST_N_NODES;
+        state  = state * 6364136223846793005UL + 1442695040888963407UL;
+        weight = (double)((state >> 33) % 50);
+        create_relationship(hf, from, to, weight, 0, false);
+
+        if (i % 101 == 0) {
+            create_relationship(hf, from, to, weight + 1, 0, false);
+        }
+    }
+
+    return hf;
+}
+
+static void
+clean_up(heap_file* hf)
+{
+    page_cache*   pc  = hf->cache;
+    phy_database* pdb = pc->pdb;
+    heap_file_destroy(hf);
+    page_cache_destroy(pc);
+    phy_database_delete(pdb);
+}
+
+static void
+check_path(heap_file* hf, path* p, double expected, direction_t direction)
+{
+    assert(p->distance == expected);
+
+    if (expected == DBL_MAX) {
+        assert(array_list_ul_size(p->edges) == 0);
+        return;
+    }
+
+    unsigned long   node_id = p->source;
+    double          sum     = 0;
+    relationship_t* rel;
+    for (size_t i = 0; i < array_list_ul_size(p->edges); ++i) {
+        rel = read_relationship(hf, array_list_ul_get(p->edges, i), false);
+
+        assert((direction != INCOMING && rel->source_node == node_id)
+               || (direction != OUTGOING && rel->target_node == node_id));
+        node_id = rel->source_node == node_id ? rel->target_node
+                                              : rel->source_node;
+        sum += rel->weight;
+        free(rel);
+    }
+
+    assert(node_id == p->target);
+    assert(sum == expected);
+}
+
+static void
+test_ch(direction_t direction)
+{
+    heap_file*             hf = prepare();
+    contraction_hierarchy* ch = ch_preprocess(hf, direction, false);
+
+    assert(ch->n_nodes == TEST_N_NODES);
+
+    // The ranks are a permutation and the upward graphs lead upwards
+    bool* ranked = calloc(TEST_N_NODES, sizeof(bool));
+    for (size_t i = 0; i < TEST_N_NODES; ++i) {
+        assert(ch->rank[i] < TEST_N_NODES && !ranked[ch->rank[i]]);
+        ranked[ch->rank[i]] = true;
+
+        for (size_t side = 0; side < 2; ++side) {
+            for (size_t j = ch->up_offsets[side][i];
+                 j < ch->up_offsets[side][i + 1];
+                 ++j) {
+                assert(ch->rank[ch->up_arcs[side][j].head] > ch->rank[i]);
+            }
+        }
+    }
+    free(ranked);
+
+    sssp_result* expected;
+    path*        result;
+    for (unsigned long s = 0; s < TEST_N_NODES; s += 11) {
+        expected = dijkstra(hf, s, direction, false, NULL);
+
+        for (unsigned long t = 0; t < TEST_N_NODES; t += 3) {
+            result = ch_query(ch, s, t, false, NULL);
+            check_path(hf,
+                       result,
+                       dict_ul_d_get_direct(expected->distances, t),
+                       direction);
+            path_destroy(result);
+        }
+
+        sssp_result_destroy(expected);
+    }
+
+    ch_destroy(ch);
+    clean_up(hf);
+}
+
+int
+main(void)
+{
+    test_ch(OUTGOING);
+    test_ch(INCOMING);
+    test_ch(BOTH);
+
+    return 0;
+}
@@ -0,0 +1,198 @@
+/*
+ * delta_stepping_test.c   1.0   Sep 15, 2021
+ *
+ * Copyright (c) 2021- University of Konstanz.
+ *
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "query/delta_stepping.h"
+
+#include <assert.h>
+#include <float.h>
+
+#include "access/csr_graph.h"
+#include "access/heap_file.h"
+#include "data-struct/htable.h"
+#include "query/dijkstra.h"
+#include "query/result_types.h"
+
+#define TEST_N_NODES (3000)
+#define TEST_N_RELS  (15000)
+
+static heap_file*
+prepare(void)
+{
+    char* file_name = "test";
+
+    char* log_name_pdb   = "log_test_pdb";
+    char* log_name_cache = "log_test_pc";
+    char* log_name_file  = "log_test_hf";
+
+    phy_database* pdb = phy_database_create(file_name, log_name_pdb);
+    page_cache*   pc  = page_cache_create(pdb, CACHE_N_PAGES, log_name_cache);
+    heap_file*    hf  = heap_file_create(pc, log_name_file);
+
+    for (size_t i = 0; i < TEST_N_NODES; ++i) {
+        create_node(hf, i, false);
+    }
+
+    // Integral weights keep the sums exact, zero weights and self loops are
+    // included on purpose.
+    unsigned long state = 11;
+    unsigned long from;
+    unsigned long to;
+    double        weight;
+    for (size_t i = 0; i < TEST_N_RELS; ++i) {
+        state  = state * 6364136223846793005UL + 1442695040888963407UL;
+        from   = (state >> 33) % TEST_N_NODES;
+        state  = state * 6364136223846793005UL + 1442695040888963407UL;
+        to     = i % 97 == 0 ? from : (state >> 33) % TEST_N_NODES;
+        state  = state * 6364136223846793005UL + 1442695040888963407UL;
+        weight = (double)((state >> 33) % 20);
+        create_relationship(hf, from, to, weight, 0, false);
+    }
+
+    return hf;
+}
+
+static void
+clean_up(heap_file* hf)
+{
+    page_cache*   pc  = hf->cache;
+    phy_database* pdb = pc->pdb;
+    heap_file_destroy(hf);
+    page_cache_destroy(pc);
+    phy_database_delete(pdb);
+}
+
+static void
+check_result(heap_file*   hf,
+             sssp_result* result,
+             sssp_result* expected,
+             direction_t  direction)
+{
+    assert(result->source == expected->source);
+
+    relationship_t* rel;
+    unsigned long   node_id;
+    unsigned long   pred_id;
+    size_t          n_hops;
+    for (unsigned long v = 0; v < TEST_N_NODES; ++v) {
+        assert(dict_ul_d_get_direct(result->distances, v)
+               == dict_ul_d_get_direct(expected->distances, v));
+
+        if (v == result->source
+            || dict_ul_d_get_direct(result->distances, v) == DBL_MAX) {
+            assert(!dict_ul_ul_contains(result->pred_edges, v));
+            continue;
+        }
+
+        // Every predecessor edge is tight and the chain ends at the source
+        node_id = v;
+        n_hops  = 0;
+        while (node_id != result->source) {
+            rel = read_relationship(
+                  hf, dict_ul_ul_get_direct(result->pred_edges, node_id), false);
+
+            assert((direction != OUTGOING && rel->source_node == node_id)
+                   || (direction != INCOMING && rel->target_node == node_id));
+            pred_id = rel->target_node == node_id ? rel->source_node
+                                                  : rel->target_node;
+
+            assert(dict_ul_d_get_direct(result->distances, pred_id)
+                         + rel->weight
+                   == dict_ul_d_get_direct(result->distances, node_id));
+            free(rel);
+
+            node_id = pred_id;
+            assert(++n_hops < TEST_N_NODES);
+        }
+    }
+}
+
+static void
+test_delta_stepping(direction_t direction)
+{
+    heap_file* hf    = prepare();
+    csr_graph* graph = csr_graph_create(hf, false);
+
+    const double deltas[] = { 0, 0.5, 3, 1000 };
+
+    sssp_result* expected;
+    sssp_result* result;
+    for (unsigned long s = 0; s < TEST_N_NODES; s += 1499) {
+        expected = dijkstra(hf, s, direction, false, NULL);
+
+        for (size_t i = 0; i < sizeof(deltas) / sizeof(deltas[0]); ++i) {
+            result = delta_stepping_csr(graph, s, direction, deltas[i]);
+            check_result(hf, result, expected, direction);
+            sssp_result_destroy(result);
+        }
+
+        result = delta_stepping(hf, s, direction, 0, false, NULL);
+        check_result(hf, result, expected, direction);
+        sssp_result_destroy(result);
+
+        sssp_result_destroy(expected);
+    }
+
+    csr_graph_destroy(graph);
+    clean_up(hf);
+}
+
+static void
+test_csr_graph(void)
+{
+    heap_file* hf    = prepare();
+    csr_graph* graph = csr_graph_create(hf, false);
+
+    assert(graph->n_nodes == TEST_N_NODES);
+    assert(graph->n_rels == TEST_N_RELS);
+    assert(graph->offsets[OUTGOING][graph->n_nodes] == TEST_N_RELS);
+    assert(graph->offsets[INCOMING][graph->n_nodes] == TEST_N_RELS);
+
+    array_list_relationship* rels;
+    unsigned long            n_self_loops;
+    for (unsigned long v = 0; v < TEST_N_NODES; ++v) {
+        assert(csr_graph_index(graph, v) == v);
+        assert(graph->node_ids[v] == v);
+        assert(graph->node_labels[v] == v);
+
+        rels         = expand(hf, v, BOTH, false);
+        n_self_loops = 0;
+        for (size_t i = 0; i < array_list_relationship_size(rels); ++i) {
+            relationship_t* rel = array_list_relationship_get(rels, i);
+            n_self_loops += rel->source_node == rel->target_node;
+        }
+
+        // Self loops are contained once by expand but in both csr rows
+        assert(csr_graph_degree(graph, v, BOTH)
+               == array_list_relationship_size(rels) + n_self_loops);
+        array_list_relationship_destroy(rels);
+
+        for (size_t j = graph->offsets[OUTGOING][v] + 1;
+             j < graph->offsets[OUTGOING][v + 1];
+             ++j) {
+            assert(graph->edges[OUTGOING][j - 1].neighbour
+                   <= graph->edges[OUTGOING][j].neighbour);
+        }
+    }
+
+    assert(csr_graph_index(graph, UNINITIALIZED_LONG) == UNINITIALIZED_LONG);
+
+    csr_graph_destroy(graph);
+    clean_up(hf);
+}
+
+int
+main(void)
+{
+    test_csr_graph();
+    test_delta_stepping(OUTGOING);
+    test_delta_stepping(INCOMING);
+    test_delta_stepping(BOTH);
+
+    return 0;
+}
@@ -0,0 +1,192 @@
+/*
+ * k_hop_test.c   1.0   Sep 15, 2021
+ *
+ * Copyright (c) 2021- University of Konstanz.
+ *
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "query/k_hop.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <stdlib.h>
+
+#include "access/heap_file.h"
+#include "data-struct/htable.h"
+#include "query/bfs.h"
+#include "query/result_types.h"
+
+#define TEST_N_NODES   (600)
+#define TEST_N_RELS    (1500)
+#define TEST_N_LABELS  (3)
+#define TEST_K         (3)
+#define TEST_N_SOURCES (4)
+
+static heap_file*
+prepare(void)
+{
+    char* file_name = "test";
+
+    char* log_name_pdb   = "log_test_pdb";
+    char* log_name_cache = "log_test_pc";
+    char* log_name_file  = "log_test_hf";
+
+    phy_database* pdb = phy_database_create(file_name, log_name_pdb);
+    page_cache*   pc  = page_cache_create(pdb, CACHE_N_PAGES, log_name_cache);
+    heap_file*    hf  = heap_file_create(pc, log_name_file);
+
+    for (size_t i = 0; i < TEST_N_NODES; ++i) {
+        create_node(hf, i % TEST_N_LABELS, false);
+    }
+
+    unsigned long state = 17;
+    unsigned long from;
+    unsigned long to;
+    for (size_t i = 0; i < TEST_N_RELS; ++i) {
+        state = state * 6364136223846793005UL + 1442695040888963407UL;
+        from  = (state >> 33) % TEST_N_NODES;
+        state = state * 6364136223846793005UL + 1442695040888963407UL;
+        to    = i % 71 == 0 ? from : (state >> 33) % TEST_N_NODES;
+        create_relationship(hf, from, to, 1, i % TEST_N_LABELS, false);
+    }
+
+    return hf;
+}
+
+static void
+clean_up(heap_file* hf)
+{
+    page_cache*   pc  = hf->cache;
+    phy_database* pdb = pc->pdb;
+    heap_file_destroy(hf);
+    page_cache_destroy(pc);
+    phy_database_delete(pdb);
+}
+
+static bool
+matches(const relationship_t* rel, unsigned long from_node_id, void* data)
+{
+    (void)data;
+    unsigned long to_node_id = rel->source_node == from_node_id
+                                     ? rel->target_node
+                                     : rel->source_node;
+
+    // Node ids are the creation indices, so the label is id % TEST_N_LABELS
+    return rel->label == 1 && to_node_id % TEST_N_LABELS == 2;
+}
+
+static void
+check_levels(k_hop_result* result, unsigned long* expected_hop)
+{
+    size_t n_expected = 0;
+    for (unsigned long v = 0; v < TEST_N_NODES; ++v) {
+        n_expected += expected_hop[v] <= TEST_K;
+    }
+
+    size_t        n_reported = 0;
+    unsigned long node_id;
+    for (unsigned long hop = 0; hop <= TEST_K; ++hop) {
+        for (size_t i = 0; i < array_list_ul_size(result->hops[hop]); ++i) {
+            node_id = array_list_ul_get(result->hops[hop], i);
+            assert(expected_hop[node_id] == hop);
+            assert(i == 0
+                   || array_list_ul_get(result->hops[hop], i - 1) < node_id);
+            n_reported++;
+        }
+    }
+    assert(n_reported == n_expected);
+}
+
+static void
+test_k_hop(direction_t direction)
+{
+    heap_file* hf = prepare();
+
+    const unsigned long sources[TEST_N_SOURCES] = { 5, 300, 5, 599 };
+    unsigned long       expected_hop[TEST_N_NODES];
+    traversal_step      step;
+
+    // The nearest source determines the hop, duplicates are ignored
+    for (unsigned long v = 0; v < TEST_N_NODES; ++v) {
+        expected_hop[v] = ULONG_MAX;
+    }
+
+    for (size_t i = 0; i < TEST_N_SOURCES; ++i) {
+        bfs_cursor* cursor = bfs_cursor_create(
+              hf, sources[i], direction, TEST_K, NULL, NULL, NULL, false, NULL);
+        while (bfs_cursor_next(cursor, &step)) {
+            if (step.depth < expected_hop[step.node_id]) {
+                expected_hop[step.node_id] = step.depth;
+            }
+        }
+        bfs_cursor_destroy(cursor);
+    }
+
+    k_hop_result* result = k_hop(hf,
+                                 sources,
+                                 TEST_N_SOURCES,
+                                 TEST_K,
+                                 direction,
+                                 K_HOP_ANY_LABEL,
+                                 K_HOP_ANY_LABEL,
+                                 false,
+                                 NULL);
+    assert(array_list_ul_size(result->hops[0]) == TEST_N_SOURCES - 1);
+    check_levels(result, expected_hop);
+    k_hop_result_destroy(result);
+
+    // Unbounded: k is reduced to the number of nodes
+    result = k_hop(hf,
+                   sources,
+                   TEST_N_SOURCES,
+                   ULONG_MAX,
+                   direction,
+                   K_HOP_ANY_LABEL,
+                   K_HOP_ANY_LABEL,
+                   false,
+                   NULL);
+    assert(result->k == TEST_N_NODES);
+    k_hop_result_destroy(result);
+
+    // With filters, only nodes reached over matching edges and nodes count
+    for (unsigned long v = 0; v < TEST_N_NODES; ++v) {
+        expected_hop[v] = ULONG_MAX;
+    }
+
+    for (size_t i = 0; i < TEST_N_SOURCES; ++i) {
+        bfs_cursor* cursor = bfs_cursor_create(hf,
+                                               sources[i],
+                                               direction,
+                                               TEST_K,
+                                               matches,
+                                               NULL,
+                                               NULL,
+                                               false,
+                                               NULL);
+        while (bfs_cursor_next(cursor, &step)) {
+            if (step.depth < expected_hop[step.node_id]) {
+                expected_hop[step.node_id] = step.depth;
+            }
+        }
+        bfs_cursor_destroy(cursor);
+    }
+
+    result = k_hop(
+          hf, sources, TEST_N_SOURCES, TEST_K, direction, 1, 2, false, NULL);
+    check_levels(result, expected_hop);
+    k_hop_result_destroy(result);
+
+    clean_up(hf);
+}
+
+int
+main(void)
+{
+    test_k_hop(OUTGOING);
+    test_k_hop(INCOMING);
+    test_k_hop(BOTH);
+
+    return 0;
+}
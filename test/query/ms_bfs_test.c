@@ -0,0 +1,156 @@
+/*
+ * ms_bfs_test.c   1.0   Sep 15, 2021
+ *
+ * Copyright (c) 2021- University of Konstanz.
+ *
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "query/ms_bfs.h"
+
+#include <assert.h>
+#include <limits.h>
+
+#include "access/heap_file.h"
+#include "data-struct/htable.h"
+#include "query/bfs.h"
+#include "query/result_types.h"
+
+#define TEST_N_NODES (300)
+#define TEST_N_RELS  (600)
+
+static heap_file*
+prepare(void)
+{
+    char* file_name = "test";
+
+    char* log_name_pdb   = "log_test_pdb";
+    char* log_name_cache = "log_test_pc";
+    char* log_name_file  = "log_test_hf";
+
+    phy_database* pdb = phy_database_create(file_name, log_name_pdb);
+    page_cache*   pc  = page_cache_create(pdb, CACHE_N_PAGES, log_name_cache);
+    heap_file*    hf  = heap_file_create(pc, log_name_file);
+
+    for (size_t i = 0; i < TEST_N_NODES; ++i) {
+        create_node(hf, i, false);
+    }
+
+    /* A deterministic pseudo random graph with a few unreachable nodes. */
+    unsigned long state = 42;
+    unsigned long from;
+    unsigned long to;
+    for (size_t i = 0; i < TEST_N_RELS; ++i) {
+        state = state * 6364136223846793005UL + 1442695040888963407UL;
+        from  = (state >> 33) % (TEST_N_NODES - 10);
+        state = state * 6364136223846793005UL + 1442695040888963407UL;
+        to    = (state >> 33) % (TEST_N_NODES - 10);
+        create_relationship(hf, from, to, 1.0, 0, false);
+    }
+
+    return hf;
+}
+
+static void
+clean_up(heap_file* hf)
+{
+    page_cache*   pc  = hf->cache;
+    phy_database* pdb = pc->pdb;
+    heap_file_destroy(hf);
+    page_cache_destroy(pc);
+    phy_database_delete(pdb);
+}
+
+static void
+check_against_bfs(heap_file*        hf,
+                  traversal_result* expected,
+                  traversal_result* actual,
+                  direction_t       direction)
+{
+    assert(expected->source == actual->source);
+
+    relationship_t* rel;
+    unsigned long   parent;
+    unsigned long   level;
+    for (unsigned long i = 0; i < TEST_N_NODES; ++i) {
+        level = dict_ul_ul_get_direct(actual->traversal_numbers, i);
+        assert(dict_ul_ul_get_direct(expected->traversal_numbers, i) == level);
+
+        if (level == 0 || level == ULONG_MAX) {
+            assert(!dict_ul_ul_contains(actual->parents, i));
+            continue;
+        }
+
+        rel    = read_relationship(
+              hf, dict_ul_ul_get_direct(actual->parents, i), false);
+        parent = rel->source_node == i ? rel->target_node : rel->source_node;
+
+        assert(direction != OUTGOING || rel->target_node == i);
+        assert(direction != INCOMING || rel->source_node == i);
+        assert(dict_ul_ul_get_direct(actual->traversal_numbers, parent)
+               == level - 1);
+
+        free(rel);
+    }
+}
+
+static void
+test_ms_bfs(direction_t direction)
+{
+    heap_file* hf = prepare();
+
+    unsigned long sources[TEST_N_NODES];
+    for (size_t i = 0; i < TEST_N_NODES; ++i) {
+        sources[i] = TEST_N_NODES - 1 - i;
+    }
+
+    traversal_result** results =
+          ms_bfs(hf, sources, TEST_N_NODES, direction, false, NULL);
+
+    traversal_result* expected;
+    for (size_t i = 0; i < TEST_N_NODES; ++i) {
+        expected = bfs(hf, sources[i], direction, false, NULL);
+        check_against_bfs(hf, expected, results[i], direction);
+        traversal_result_destroy(expected);
+        traversal_result_destroy(results[i]);
+    }
+    free(results);
+
+    clean_up(hf);
+}
+
+static void
+test_ms_bfs_duplicate_sources(void)
+{
+    heap_file* hf = prepare();
+
+    unsigned long sources[] = { 3, 3, 7 };
+
+    traversal_result** results = ms_bfs(hf, sources, 3, BOTH, false, NULL);
+
+    traversal_result* expected = bfs(hf, 3, BOTH, false, NULL);
+    check_against_bfs(hf, expected, results[0], BOTH);
+    check_against_bfs(hf, expected, results[1], BOTH);
+    traversal_result_destroy(expected);
+
+    expected = bfs(hf, 7, BOTH, false, NULL);
+    check_against_bfs(hf, expected, results[2], BOTH);
+    traversal_result_destroy(expected);
+
+    for (size_t i = 0; i < 3; ++i) {
+        traversal_result_destroy(results[i]);
+    }
+    free(results);
+
+    clean_up(hf);
+}
+
+int
+main(void)
+{
+    test_ms_bfs(OUTGOING);
+    test_ms_bfs(INCOMING);
+    test_ms_bfs(BOTH);
+    test_ms_bfs_duplicate_sources();
+}
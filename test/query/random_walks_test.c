@@ -0,0 +1,279 @@
+/*
+ * random_walks_test.c   1.0   Sep 15, 2021
+ *
+ * Copyright (c) 2021- University of Konstanz.
+ *
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include "query/random_walk.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "access/csr_graph.h"
+#include "access/heap_file.h"
+
+#define TEST_N_NODES    (500)
+#define TEST_N_RELS     (1500)
+#define TEST_N_WALKS    (1000)
+#define TEST_WALK_LEN   (20)
+#define TEST_PATH_LEN   (10)
+#define TEST_STAR_WALKS (40000)
+
+static heap_file*
+create_heap_file(void)
+{
+    char* file_name = "test";
+
+    char* log_name_pdb   = "log_test_pdb";
+    char* log_name_cache = "log_test_pc";
+    char* log_name_file  = "log_test_hf";
+
+    phy_database* pdb = phy_database_create(file_name, log_name_pdb);
+    page_cache*   pc  = page_cache_create(pdb, CACHE_N_PAGES, log_name_cache);
+    return heap_file_create(pc, log_name_file);
+}
+
+static heap_file*
+prepare(void)
+{
+    heap_file* hf = create_heap_file();
+
+    for (size_t i = 0; i < TEST_N_NODES; ++i) {
+        create_node(hf, i, false);
+    }
+
+    // Leaves some nodes without outgoing or incoming edges
+    unsigned long state = 23;
+    unsigned long from;
+    unsigned long to;
+    double        weight;
+    for (size_t i = 0; i < TEST_N_RELS; ++i) {
+        state  = state * 6364136223846793005UL + 1442695040888963407UL;
+        from   = (state >> 33) % TEST_N_NODES;
+        state  = state * 6364136223846793005UL + 1442695040888963407UL;
+        to     = i % 61 == 0 ? from : (state >> 33) % TEST_N_NODES;
+        state  = state * 6364136223846793005UL + 1442695040888963407UL;
+        weight = (double)((state >> 33) % 10);
+        create_relationship(hf, from, to, weight, 0, false);
+    }
+
+    return hf;
+}
+
+static void
+clean_up(heap_file* hf)
+{
+    page_cache*   pc  = hf->cache;
+    phy_database* pdb = pc->pdb;
+    heap_file_destroy(hf);
+    page_cache_destroy(pc);
+    phy_database_delete(pdb);
+}
+
+static bool
+has_edge(const csr_graph* graph,
+         direction_t      direction,
+         unsigned long    from,
+         unsigned long    to)
+{
+    for (direction_t d = OUTGOING; d <= INCOMING; ++d) {
+        if (direction != BOTH && direction != d) {
+            continue;
+        }
+
+        for (size_t i = graph->offsets[d][from];
+             i < graph->offsets[d][from + 1];
+             ++i) {
+            if (graph->edges[d][i].neighbour == to) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+static void
+test_walks(direction_t direction, walk_type type)
+{
+    heap_file* hf    = prepare();
+    csr_graph* graph = csr_graph_create(hf, false);
+
+    unsigned long* starts = malloc(TEST_N_WALKS * sizeof(unsigned long));
+    for (size_t i = 0; i < TEST_N_WALKS; ++i) {
+        starts[i] = i % TEST_N_NODES;
+    }
+
+    walk_batch* batch = random_walks_csr(graph,
+                                         starts,
+                                         TEST_N_WALKS,
+                                         TEST_WALK_LEN,
+                                         direction,
+                                         type,
+                                         0.5,
+                                         2,
+                                         42);
+
+    assert(batch->num_walks == TEST_N_WALKS);
+    assert(batch->walk_length == TEST_WALK_LEN);
+
+    unsigned long* walk;
+    for (size_t i = 0; i < TEST_N_WALKS; ++i) {
+        walk = batch->nodes + i * (TEST_WALK_LEN + 1);
+        assert(walk[0] == starts[i]);
+
+        for (size_t j = 1; j <= TEST_WALK_LEN; ++j) {
+            if (walk[j] == UNINITIALIZED_LONG) {
+                // Walks only end at nodes without edges
+                assert(walk[j - 1] == UNINITIALIZED_LONG
+                       || csr_graph_degree(graph, walk[j - 1], direction) == 0);
+                continue;
+            }
+
+            assert(has_edge(graph, direction, walk[j - 1], walk[j]));
+        }
+    }
+
+    // The same seed yields the same walks, independent of the snapshot
+    walk_batch* again = random_walks(hf,
+                                     starts,
+                                     TEST_N_WALKS,
+                                     TEST_WALK_LEN,
+                                     direction,
+                                     type,
+                                     0.5,
+                                     2,
+                                     42,
+                                     false,
+                                     NULL);
+    assert(memcmp(batch->nodes,
+                  again->nodes,
+                  TEST_N_WALKS * (TEST_WALK_LEN + 1) * sizeof(unsigned long))
+           == 0);
+
+    walk_batch_destroy(again);
+    walk_batch_destroy(batch);
+    free(starts);
+    csr_graph_destroy(graph);
+    clean_up(hf);
+}
+
+static void
+test_weighted_walks(void)
+{
+    heap_file* hf = create_heap_file();
+
+    for (size_t i = 0; i < 4; ++i) {
+        create_node(hf, i, false);
+    }
+    create_relationship(hf, 0, 1, 1, 0, false);
+    create_relationship(hf, 0, 2, 3, 0, false);
+    create_relationship(hf, 0, 3, 0, 0, false);
+
+    unsigned long* starts = calloc(TEST_STAR_WALKS, sizeof(unsigned long));
+    walk_batch*    batch  = random_walks(hf,
+                                     starts,
+                                     TEST_STAR_WALKS,
+                                     1,
+                                     OUTGOING,
+                                     weighted_walk,
+                                     1,
+                                     1,
+                                     7,
+                                     false,
+                                     NULL);
+
+    size_t counts[4] = { 0 };
+    for (size_t i = 0; i < TEST_STAR_WALKS; ++i) {
+        counts[batch->nodes[2 * i + 1]]++;
+    }
+
+    assert(counts[0] == 0 && counts[3] == 0);
+    assert(counts[2] > 27 * counts[1] / 10 && counts[2] < 33 * counts[1] / 10);
+
+    walk_batch_destroy(batch);
+    free(starts);
+    clean_up(hf);
+}
+
+static void
+test_node2vec_walks(void)
+{
+    heap_file* hf = create_heap_file();
+
+    for (size_t i = 0; i < TEST_PATH_LEN; ++i) {
+        create_node(hf, i, false);
+    }
+    for (size_t i = 0; i + 1 < TEST_PATH_LEN; ++i) {
+        create_relationship(hf, i, i + 1, 1, 0, false);
+    }
+
+    unsigned long starts[TEST_PATH_LEN];
+    for (size_t i = 0; i < TEST_PATH_LEN; ++i) {
+        starts[i] = i;
+    }
+
+    // A large p avoids returning unless at the end of the path
+    walk_batch* batch = random_walks(hf,
+                                     starts,
+                                     TEST_PATH_LEN,
+                                     TEST_WALK_LEN,
+                                     BOTH,
+                                     node2vec_walk,
+                                     1e12,
+                                     1,
+                                     3,
+                                     false,
+                                     NULL);
+
+    unsigned long* walk;
+    for (size_t i = 0; i < TEST_PATH_LEN; ++i) {
+        walk = batch->nodes + i * (TEST_WALK_LEN + 1);
+        for (size_t j = 2; j <= TEST_WALK_LEN; ++j) {
+            assert(walk[j] != walk[j - 2] || walk[j - 1] == 0
+                   || walk[j - 1] == TEST_PATH_LEN - 1);
+        }
+    }
+    walk_batch_destroy(batch);
+
+    // A large q keeps the walk close to the previous node
+    batch = random_walks(hf,
+                         starts,
+                         TEST_PATH_LEN,
+                         TEST_WALK_LEN,
+                         BOTH,
+                         node2vec_walk,
+                         1,
+                         1e12,
+                         3,
+                         false,
+                         NULL);
+
+    for (size_t i = 0; i < TEST_PATH_LEN; ++i) {
+        walk = batch->nodes + i * (TEST_WALK_LEN + 1);
+        for (size_t j = 2; j <= TEST_WALK_LEN; ++j) {
+            assert(walk[j] == walk[j - 2]);
+        }
+    }
+    walk_batch_destroy(batch);
+
+    clean_up(hf);
+}
+
+int
+main(void)
+{
+    for (walk_type type = uniform_walk; type < invalid_walk; ++type) {
+        test_walks(OUTGOING, type);
+        test_walks(INCOMING, type);
+        test_walks(BOTH, type);
+    }
+    test_weighted_walks();
+    test_node2vec_walks();
+
+    return 0;
+}
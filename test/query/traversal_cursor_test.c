@@ -0,0 +1,260 @@
+/*
+ * traversal_cursor_test.c   1.0   Sep 15, 2021
+ *
+ * Copyright (c) 2021- University of Konstanz.
+ *
+ * This software is the proprietary information of the above-mentioned
+ * institutions. Use is subject to license terms. Please refer to the included
+ * copyright notice.
+ */
+#include <assert.h>
+#include <float.h>
+#include <limits.h>
+#include <stdlib.h>
+
+#include "access/heap_file.h"
+#include "data-struct/htable.h"
+#include "query/bfs.h"
+#include "query/dfs.h"
+#include "query/dijkstra.h"
+#include "query/result_types.h"
+
+#define TEST_N_NODES (400)
+#define TEST_N_RELS  (1200)
+#define TEST_LABEL   (7)
+
+static heap_file*
+prepare(void)
+{
+    char* file_name = "test";
+
+    char* log_name_pdb   = "log_test_pdb";
+    char* log_name_cache = "log_test_pc";
+    char* log_name_file  = "log_test_hf";
+
+    phy_database* pdb = phy_database_create(file_name, log_name_pdb);
+    page_cache*   pc  = page_cache_create(pdb, CACHE_N_PAGES, log_name_cache);
+    heap_file*    hf  = heap_file_create(pc, log_name_file);
+
+    for (size_t i = 0; i < TEST_N_NODES; ++i) {
+        create_node(hf, i % 50, false);
+    }
+
+    unsigned long state = 5;
+    unsigned long from;
+    unsigned long to;
+    double        weight;
+    for (size_t i = 0; i < TEST_N_RELS; ++i) {
+        state  = state * 6364136223846793005UL + 1442695040888963407UL;
+        from   = (state >> 33) % TEST_N_NODES;
+        state  = state * 6364136223846793005UL + 1442695040888963407UL;
+        to     = i % 83 == 0 ? from : (state >> 33) % TEST_N_NODES;
+        state  = state * 6364136223846793005UL + 1442695040888963407UL;
+        weight = (double)((state >> 33) % 30);
+        create_relationship(hf, from, to, weight, 0, false);
+    }
+
+    return hf;
+}
+
+static void
+clean_up(heap_file* hf)
+{
+    page_cache*   pc  = hf->cache;
+    phy_database* pdb = pc->pdb;
+    heap_file_destroy(hf);
+    page_cache_destroy(pc);
+    phy_database_delete(pdb);
+}
+
+static bool
+light_edge(const relationship_t* rel, unsigned long from_node_id, void* data)
+{
+    (void)from_node_id;
+    (void)data;
+    return rel->weight < 15;
+}
+
+static bool
+even_node(const traversal_step* step, void* data)
+{
+    (void)data;
+    return step->node_id % 2 == 0;
+}
+
+static bool
+has_test_label(const traversal_step* step, void* data)
+{
+    node_t* node  = read_node(data, step->node_id, false);
+    bool    match = node->label == TEST_LABEL;
+    free(node);
+
+    return match;
+}
+
+static void
+test_traversal_cursors(direction_t direction)
+{
+    heap_file*        hf = prepare();
+    traversal_result* expected_bfs;
+    traversal_result* expected_dfs;
+    traversal_step    step;
+    unsigned long     n_reached;
+
+    for (unsigned long s = 0; s < TEST_N_NODES; s += 97) {
+        // Without bounds the cursors number the nodes like bfs and dfs
+        expected_bfs       = bfs(hf, s, direction, false, NULL);
+        bfs_cursor* cursor = bfs_cursor_create(
+              hf, s, direction, ULONG_MAX, NULL, NULL, NULL, false, NULL);
+
+        n_reached = 0;
+        while (bfs_cursor_next(cursor, &step)) {
+            assert(step.depth
+                   == dict_ul_ul_get_direct(expected_bfs->traversal_numbers,
+                                            step.node_id));
+            assert(step.node_id == s
+                   || step.parent_edge
+                            == dict_ul_ul_get_direct(expected_bfs->parents,
+                                                     step.node_id));
+            n_reached++;
+        }
+        assert(n_reached == dict_ul_ul_size(expected_bfs->parents) + 1);
+        bfs_cursor_destroy(cursor);
+
+        expected_dfs           = dfs(hf, s, direction, false, NULL);
+        dfs_cursor* dfs_cursor = dfs_cursor_create(
+              hf, s, direction, ULONG_MAX, NULL, NULL, NULL, false, NULL);
+
+        n_reached = 0;
+        while (dfs_cursor_next(dfs_cursor, &step)) {
+            assert(step.depth
+                   == dict_ul_ul_get_direct(expected_dfs->traversal_numbers,
+                                            step.node_id));
+            n_reached++;
+        }
+        assert(n_reached == dict_ul_ul_size(expected_dfs->parents) + 1);
+        dfs_cursor_destroy(dfs_cursor);
+        traversal_result_destroy(expected_dfs);
+
+        // Bounded depth and filters
+        cursor = bfs_cursor_create(
+              hf, s, direction, 2, NULL, even_node, NULL, false, NULL);
+
+        n_reached = 0;
+        while (bfs_cursor_next(cursor, &step)) {
+            assert(step.node_id % 2 == 0 && step.depth <= 2);
+            n_reached++;
+        }
+        bfs_cursor_destroy(cursor);
+
+        for (unsigned long v = 0; v < TEST_N_NODES; v += 2) {
+            n_reached -= dict_ul_ul_get_direct(expected_bfs->traversal_numbers,
+                                               v)
+                         <= 2;
+        }
+        assert(n_reached == 0);
+        traversal_result_destroy(expected_bfs);
+
+        // Stopping early
+        cursor = bfs_cursor_create(
+              hf, s, direction, ULONG_MAX, light_edge, NULL, NULL, false, NULL);
+        for (size_t i = 0; i < 5 && bfs_cursor_next(cursor, &step); ++i) {
+            if (step.node_id != s) {
+                relationship_t* rel =
+                      read_relationship(hf, step.parent_edge, false);
+                assert(rel->weight < 15);
+                free(rel);
+            }
+        }
+        bfs_cursor_destroy(cursor);
+    }
+
+    clean_up(hf);
+}
+
+static void
+test_dijkstra_cursor(direction_t direction)
+{
+    heap_file*     hf = prepare();
+    sssp_result*   expected;
+    traversal_step step;
+    double         last_dist;
+    double         nearest;
+    unsigned long  n_reached;
+    node_t*        node;
+
+    for (unsigned long s = 0; s < TEST_N_NODES; s += 97) {
+        expected = dijkstra(hf, s, direction, false, NULL);
+
+        dijkstra_cursor* cursor = dijkstra_cursor_create(
+              hf, s, direction, DBL_MAX, NULL, NULL, NULL, false, NULL);
+
+        last_dist = 0;
+        n_reached = 0;
+        while (dijkstra_cursor_next(cursor, &step)) {
+            assert(step.distance
+                   == dict_ul_d_get_direct(expected->distances, step.node_id));
+            assert(step.distance >= last_dist);
+            assert((step.node_id == s)
+                   == (step.parent_edge == UNINITIALIZED_LONG));
+            last_dist = step.distance;
+            n_reached++;
+        }
+        dijkstra_cursor_destroy(cursor);
+
+        nearest = DBL_MAX;
+        for (unsigned long v = 0; v < TEST_N_NODES; ++v) {
+            if (dict_ul_d_get_direct(expected->distances, v) == DBL_MAX) {
+                continue;
+            }
+            n_reached--;
+
+            node = read_node(hf, v, false);
+            if (node->label == TEST_LABEL
+                && dict_ul_d_get_direct(expected->distances, v) < nearest) {
+                nearest = dict_ul_d_get_direct(expected->distances, v);
+            }
+            free(node);
+        }
+        assert(n_reached == 0);
+
+        // The first node with the label is the nearest one
+        cursor = dijkstra_cursor_create(
+              hf, s, direction, DBL_MAX, NULL, has_test_label, hf, false, NULL);
+        assert(dijkstra_cursor_next(cursor, &step) == (nearest != DBL_MAX));
+        assert(nearest == DBL_MAX || step.distance == nearest);
+        dijkstra_cursor_destroy(cursor);
+
+        // Bounded distance
+        cursor = dijkstra_cursor_create(
+              hf, s, direction, 20, NULL, NULL, NULL, false, NULL);
+        n_reached = 0;
+        while (dijkstra_cursor_next(cursor, &step)) {
+            assert(step.distance <= 20);
+            n_reached++;
+        }
+        dijkstra_cursor_destroy(cursor);
+
+        for (unsigned long v = 0; v < TEST_N_NODES; ++v) {
+            n_reached -= dict_ul_d_get_direct(expected->distances, v) <= 20;
+        }
+        assert(n_reached == 0);
+
+        sssp_result_destroy(expected);
+    }
+
+    clean_up(hf);
+}
+
+int
+main(void)
+{
+    test_traversal_cursors(OUTGOING);
+    test_traversal_cursors(INCOMING);
+    test_traversal_cursors(BOTH);
+    test_dijkstra_cursor(OUTGOING);
+    test_dijkstra_cursor(INCOMING);
+    test_dijkstra_cursor(BOTH);
+
+    return 0;
+}